@@ -32,6 +32,11 @@ DataSetter        * data_setter;
 MenuController    * menu_controller;
 GlobalController  * controller;
 
+StaticInstance<CommandProcessor>  command_processor_instance;
+StaticInstance<DataSetter>        data_setter_instance;
+StaticInstance<MenuController>    menu_controller_instance;
+StaticInstance<GlobalController>  controller_instance;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** SETUP METHODS ***
@@ -41,10 +46,10 @@ GlobalController  * controller;
 void setup()
 {
     //  Zaladowanie globalnego kontrolera.
-    controller = new GlobalController();
-    command_processor = new CommandProcessor(controller);
-    data_setter = new DataSetter(controller);
-    menu_controller = new MenuController(controller);
+    controller = controller_instance.Create();
+    command_processor = command_processor_instance.Create(controller);
+    data_setter = data_setter_instance.Create(controller);
+    menu_controller = menu_controller_instance.Create(controller);
 
     //  Wyswietlenie pierwszej opcji.
     controller->SetDisplayingState(DISPLAY_DATETIME_STATE);
@@ -57,6 +62,8 @@ void setup()
 //  Przetworzenie danych wejsciowycyh.
 void ProcessInput()
 {
+    PROFILE_SCOPE(PROFILE_SECTION_INPUT);
+
     controller->ProcessInput();
 
     //  Przetworzenie danych z konsoli.
@@ -95,12 +102,12 @@ void ProcessAlarmDisplay()
 
     if (blink)
     {
-        dsp_str_l->text = "ALARM";
+        dsp_str_l->text = F("ALARM");
         dsp_str_l->offset =   10;
         dsp_str_l->_xpos  =   8;
         dsp_str_l->_width +=  2;
             
-        dsp_str_r->text = controller->clock_ctrl->GetTime("HM", ':', false);
+        controller->clock_ctrl->GetTime(dsp_str_r->text, "HM", ':', false);
         dsp_str_r->offset = 1;
 
         controller->display_ctrl->DrawSprite(SPRITE_CLOCK, 0, 0);
@@ -127,13 +134,13 @@ void ProcessLedsDisplay(bool ignore_change = false)
 {
     if (ignore_change || controller->led_controller->HasChanged())
     {
-        String color_name = controller->led_controller->GetName();
+        const char * color_name = controller->led_controller->GetName();
         int text_length = controller->display_ctrl->GetTextWidth(0, color_name) + 2;
         int text_xpos = controller->display_ctrl->GetWidth();
         
         controller->display_ctrl->Clear();
         controller->display_ctrl->DrawSprite(SPRITE_LEDS, 0, 0);
-        controller->display_ctrl->PrintText(0, 9, "Leds");
+        controller->display_ctrl->PrintText_P(0, 9, PSTR("Leds"));
         controller->display_ctrl->PrintText(0, text_xpos - text_length, color_name);
     }
 }
@@ -141,6 +148,8 @@ void ProcessLedsDisplay(bool ignore_change = false)
 //  ----------------------------------------------------------------------------
 void ProcessDisplay()
 {
+    PROFILE_SCOPE(PROFILE_SECTION_DISPLAY);
+
     //  Przerwanie z powodu blokady serwisowej.
     if (controller->IsServiceLocked())
         return;
@@ -162,6 +171,9 @@ void ProcessDisplay()
     else if (machine_state == GLOBAL_STATE_SONG_PLAY)
         controller->song_controller->ProcessPlaying();
     
+    else if (machine_state == GLOBAL_STATE_VPLAYER)
+        controller->vplayer_ctrl->UpdateDisplay();
+    
     else if (machine_state == GLOBAL_STATE_LEDS)
         ProcessLedsDisplay();
 }
@@ -270,6 +282,11 @@ void ProcessMenuState(int input)
             data_setter->OpenSetter(ALARM_SETTER);
             break;
         
+        case SETTINGS_ITEM_NIGHT:
+            controller->SetMachineState(GLOBAL_STATE_SETTER);
+            data_setter->OpenSetter(NIGHT_SETTER);
+            break;
+        
         case MENU_NOTHING:
         default:
             break;
@@ -310,6 +327,11 @@ void ProcessSetterState(int input, int mode)
                 controller->SetMachineState(GLOBAL_STATE_MENU);
                 menu_controller->OpenMenu(LEVEL_SETTINGS, SETTINGS_ITEM_ALARM);
                 break;
+
+            case NIGHT_SETTER:
+                controller->SetMachineState(GLOBAL_STATE_MENU);
+                menu_controller->OpenMenu(LEVEL_SETTINGS, SETTINGS_ITEM_NIGHT);
+                break;
         }
     }
     else if (input == SETTER_FULL_EXIT)
@@ -324,6 +346,8 @@ void ProcessAlarmState(int input)
 {
     if (input == ALARM_DISARMED || input == ALARM_SUSPENDED)
     {
+        controller->journal->AppendEvent(input == ALARM_DISARMED ? JOURNAL_ALARM_DISMISS : JOURNAL_ALARM_SNOOZE);
+
         if (controller->buzzer_ctrl->UpdateToneAsync())
             controller->buzzer_ctrl->StopToneAsync();
 
@@ -354,6 +378,17 @@ void ProcessSongPlayState(int input)
     }
 }
 
+//  ----------------------------------------------------------------------------
+void ProcessVPlayerState(int input)
+{
+    if (input == VPLAYER_FINISHED)
+    {
+        controller->SetMachineState(GLOBAL_STATE_NORMAL);
+        controller->display_ctrl->Clear();
+        controller->SetDisplayingState(DISPLAY_DATETIME_STATE);
+    }
+}
+
 //  ----------------------------------------------------------------------------
 void ProcessLedsState(int input)
 {
@@ -434,6 +469,8 @@ void ProcessLedsState(int input)
 //  ----------------------------------------------------------------------------
 void ProcessFunctionalities()
 {
+    PROFILE_SCOPE(PROFILE_SECTION_FUNCTIONALITIES);
+
     //  Przerwanie z powodu blokady serwisowej.
     if (controller->IsServiceLocked())
         return;
@@ -474,6 +511,20 @@ void ProcessFunctionalities()
             ProcessLedsState(input_key);
         }
     }
+    else if (machine_state == GLOBAL_STATE_SETTER)
+    {
+        //  Powtorzenia i zwolnienia przytrzymanych przyciskow (zmiana wartosci z przyspieszeniem).
+        KeypadEvent key_event = controller->GetInputKeyEvent();
+
+        if (key_event.type == KEYPAD_EVENT_REPEAT || key_event.type == KEYPAD_EVENT_RELEASE)
+        {
+            controller->update_timer->Reset();
+
+            int setter_output = data_setter->ProcessKeyEvent(key_event);
+            int setter_mode = data_setter->GetMode();
+            ProcessSetterState(setter_output, setter_mode);
+        }
+    }
 
     //  Tryby pozwalajace na 0 input.
     if (machine_state == GLOBAL_STATE_MESSAGE)
@@ -488,7 +539,8 @@ void ProcessFunctionalities()
     }
     else if (machine_state == GLOBAL_STATE_VPLAYER)
     {
-        //
+        int vplayer_output = controller->vplayer_ctrl->ProcessInput(input_key);
+        ProcessVPlayerState(vplayer_output);
     }
 }
 
@@ -499,9 +551,18 @@ void ProcessFunctionalities()
 //  Glowna petla programu.
 void loop()
 {
-    ProcessInput();
-    ProcessFunctionalities();
-    ProcessDisplay();
+    PROFILE_LOOP();
+
+    {
+        PROFILE_SCOPE(PROFILE_SECTION_LOOP);
+
+        ProcessInput();
+        ProcessFunctionalities();
+        ProcessDisplay();
+
+        controller->FinalizeCycle();
+    }
 
-    controller->FinalizeCycle();
+    //  Uspienie poza pomiarem petli - "loop" w /stats zawiera tylko czas pracy.
+    controller->Idle();
 }
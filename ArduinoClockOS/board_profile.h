@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+//  BOARD PROFILE
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOARD_PROFILE_H
+#define BOARD_PROFILE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define BOARD_PORT_NONE   0
+#define BOARD_PORT_A      1
+#define BOARD_PORT_B      2
+#define BOARD_PORT_C      3
+#define BOARD_PORT_D      4
+#define BOARD_PORT_E      5
+#define BOARD_PORT_F      6
+#define BOARD_PORT_G      7
+#define BOARD_PORT_H      8   //  Porty H, J, K, L leza poza przestrzenia I/O (brak sbi/cbi).
+#define BOARD_PORT_J      9
+#define BOARD_PORT_K      10
+#define BOARD_PORT_L      11
+
+#define BOARD_MEGA2560_PINS   70
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** ATMEGA2560 PIN MAPPING ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Port i bit kazdego pinu Arduino Mega 2560 (jak w pins_arduino.h, wariant "mega").
+//  Tablice sa uzywane tylko w wyrazeniach stalych i nie trafiaja do pamieci.
+constexpr byte MEGA2560_PIN_PORT[BOARD_MEGA2560_PINS] = {
+    BOARD_PORT_E, BOARD_PORT_E, BOARD_PORT_E, BOARD_PORT_E, BOARD_PORT_G, BOARD_PORT_E, BOARD_PORT_H, BOARD_PORT_H,   //  0 - 7
+    BOARD_PORT_H, BOARD_PORT_H, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_J, BOARD_PORT_J,   //  8 - 15
+    BOARD_PORT_H, BOARD_PORT_H, BOARD_PORT_D, BOARD_PORT_D, BOARD_PORT_D, BOARD_PORT_D, BOARD_PORT_A, BOARD_PORT_A,   //  16 - 23
+    BOARD_PORT_A, BOARD_PORT_A, BOARD_PORT_A, BOARD_PORT_A, BOARD_PORT_A, BOARD_PORT_A, BOARD_PORT_C, BOARD_PORT_C,   //  24 - 31
+    BOARD_PORT_C, BOARD_PORT_C, BOARD_PORT_C, BOARD_PORT_C, BOARD_PORT_C, BOARD_PORT_C, BOARD_PORT_D, BOARD_PORT_G,   //  32 - 39
+    BOARD_PORT_G, BOARD_PORT_G, BOARD_PORT_L, BOARD_PORT_L, BOARD_PORT_L, BOARD_PORT_L, BOARD_PORT_L, BOARD_PORT_L,   //  40 - 47
+    BOARD_PORT_L, BOARD_PORT_L, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_B, BOARD_PORT_F, BOARD_PORT_F,   //  48 - 55
+    BOARD_PORT_F, BOARD_PORT_F, BOARD_PORT_F, BOARD_PORT_F, BOARD_PORT_F, BOARD_PORT_F, BOARD_PORT_K, BOARD_PORT_K,   //  56 - 63
+    BOARD_PORT_K, BOARD_PORT_K, BOARD_PORT_K, BOARD_PORT_K, BOARD_PORT_K, BOARD_PORT_K                                //  64 - 69
+};
+
+constexpr byte MEGA2560_PIN_BIT[BOARD_MEGA2560_PINS] = {
+    0, 1, 4, 5, 5, 3, 3, 4,     //  0 - 7
+    5, 6, 4, 5, 6, 7, 1, 0,     //  8 - 15
+    1, 0, 3, 2, 1, 0, 0, 1,     //  16 - 23
+    2, 3, 4, 5, 6, 7, 7, 6,     //  24 - 31
+    5, 4, 3, 2, 1, 0, 7, 2,     //  32 - 39
+    1, 0, 7, 6, 5, 4, 3, 2,     //  40 - 47
+    1, 0, 3, 2, 1, 0, 0, 1,     //  48 - 55
+    2, 3, 4, 5, 6, 7, 0, 1,     //  56 - 63
+    2, 3, 4, 5, 6, 7            //  64 - 69
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Szybka obsluga pinu o numerze znanym w czasie kompilacji. Na ATmega2560 zapis
+//  kompiluje sie do pojedynczej instrukcji sbi/cbi (porty A-G) zamiast wyszukiwania
+//  portu w digitalWrite. Na innych platformach uzywane sa funkcje Arduino.
+template <int PIN>
+class FastPin
+{
+    private:
+#if defined(__AVR_ATmega2560__)
+        static const byte port = MEGA2560_PIN_PORT[PIN];
+        static const byte mask = 1 << MEGA2560_PIN_BIT[PIN];
+
+        /*  Pobranie rejestru wyjsciowego portu.
+         *  @return: Rejestr PORTx.
+         */
+        static inline volatile uint8_t & Port()
+        {
+            switch (port)
+            {
+                case BOARD_PORT_A:  return PORTA;
+                case BOARD_PORT_B:  return PORTB;
+                case BOARD_PORT_C:  return PORTC;
+                case BOARD_PORT_D:  return PORTD;
+                case BOARD_PORT_E:  return PORTE;
+                case BOARD_PORT_F:  return PORTF;
+                case BOARD_PORT_G:  return PORTG;
+                case BOARD_PORT_H:  return PORTH;
+                case BOARD_PORT_J:  return PORTJ;
+                case BOARD_PORT_K:  return PORTK;
+                default:            return PORTL;
+            }
+        }
+
+        /*  Pobranie rejestru kierunku portu.
+         *  @return: Rejestr DDRx.
+         */
+        static inline volatile uint8_t & Ddr()
+        {
+            switch (port)
+            {
+                case BOARD_PORT_A:  return DDRA;
+                case BOARD_PORT_B:  return DDRB;
+                case BOARD_PORT_C:  return DDRC;
+                case BOARD_PORT_D:  return DDRD;
+                case BOARD_PORT_E:  return DDRE;
+                case BOARD_PORT_F:  return DDRF;
+                case BOARD_PORT_G:  return DDRG;
+                case BOARD_PORT_H:  return DDRH;
+                case BOARD_PORT_J:  return DDRJ;
+                case BOARD_PORT_K:  return DDRK;
+                default:            return DDRL;
+            }
+        }
+
+        /*  Ustawienie lub wyzerowanie bitu rejestru (atomowo dla portow poza przestrzenia I/O).
+         *  @param reg: Rejestr portu.
+         *  @param value: Wartosc bitu.
+         */
+        static inline void WriteBit(volatile uint8_t & reg, bool value)
+        {
+            uint8_t sreg = SREG;
+
+            if (port >= BOARD_PORT_H)
+                cli();
+
+            if (value)
+                reg |= mask;
+            else
+                reg &= ~mask;
+
+            if (port >= BOARD_PORT_H)
+                SREG = sreg;
+        }
+#endif
+
+    public:
+        static const int pin = PIN;
+
+        //  Ustawienie stanu wysokiego.
+        static inline void High()
+        {
+#if defined(__AVR_ATmega2560__)
+            WriteBit(Port(), true);
+#else
+            digitalWrite(PIN, HIGH);
+#endif
+        }
+
+        //  Ustawienie stanu niskiego.
+        static inline void Low()
+        {
+#if defined(__AVR_ATmega2560__)
+            WriteBit(Port(), false);
+#else
+            digitalWrite(PIN, LOW);
+#endif
+        }
+
+        //  Ustawienie pinu jako wyjscie.
+        static inline void Output()
+        {
+#if defined(__AVR_ATmega2560__)
+            WriteBit(Ddr(), true);
+#else
+            pinMode(PIN, OUTPUT);
+#endif
+        }
+
+        /*  Ustawienie stanu pinu.
+         *  @param value: Stan pinu (true - wysoki).
+         */
+        static inline void Write(bool value)
+        {
+            if (value)
+                High();
+            else
+                Low();
+        }
+};
+
+//  ----------------------------------------------------------------------------
+//  Arduino Mega 2560 - Arduino Clock 3.0 (matryca 8 segmentow MAX7219, klawiatura 4x4).
+struct Mega2560ClockV3
+{
+    static const int  BUZZER_PIN_OUT              =   A12;
+
+    static const int  CLOCK_PIN_SDA               =   SDA;
+    static const int  CLOCK_PIN_SCL               =   SCL;
+    static const int  CLOCK_PIN_SQW               =   -1;     //  Niepodlaczony (piny przerwan: 2, 3, 18, 19).
+
+    static const int  DISPLAY_PIN_CLK             =   10;
+    static const int  DISPLAY_PIN_CS              =   11;
+    static const int  DISPLAY_PIN_DIN             =   12;
+    static const int  DISPLAY_SEGMENTS            =   8;
+
+    static const int  IR_PIN_SENDER               =   9;
+
+    static constexpr byte KEYPAD_PIN_COLS[4]      =   { 30, 32, 34, 36 };
+    static constexpr byte KEYPAD_PIN_ROWS[4]      =   { 22, 24, 26, 28 };
+
+    static const int  LIGHT_SENSOR_PIN_L          =   A10;
+    static const int  LIGHT_SENSOR_PIN_R          =   A11;
+
+    static const int  SDCARD_PIN_MISO             =   50;
+    static const int  SDCARD_PIN_MOSI             =   51;
+    static const int  SDCARD_PIN_SCK              =   52;
+    static const int  SDCARD_PIN_CS               =   53;
+
+    //  Osobne piny - kazdy czujnik na wlasnej magistrali OneWire. Przy wspolnym pinie czujniki
+    //  sa rozrozniane adresami ROM z conf.ini (sensor_in, sensor_out) lub kolejnoscia wyszukiwania.
+    static const int  TEMPERATURE_SENSOR_PIN_IN   =   A9;
+    static const int  TEMPERATURE_SENSOR_PIN_OUT  =   A8;
+};
+
+constexpr byte Mega2560ClockV3::KEYPAD_PIN_COLS[4];
+constexpr byte Mega2560ClockV3::KEYPAD_PIN_ROWS[4];
+
+//  ----------------------------------------------------------------------------
+//  Profil plytki - stale sprzetowe wybranego wariantu oraz piny o szybkiej obsludze.
+template <typename BOARD>
+struct BoardProfile : public BOARD
+{
+    typedef FastPin<BOARD::DISPLAY_PIN_CLK>   DisplayClk;
+    typedef FastPin<BOARD::DISPLAY_PIN_CS>    DisplayCs;
+    typedef FastPin<BOARD::DISPLAY_PIN_DIN>   DisplayDin;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SELECTED BOARD ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Inny wariant plytki mozna wybrac flaga kompilacji -DBOARD_VARIANT=NazwaStruktury.
+#ifndef BOARD_VARIANT
+#define BOARD_VARIANT   Mega2560ClockV3
+#endif
+
+typedef BoardProfile<BOARD_VARIANT> Board;
+
+#endif
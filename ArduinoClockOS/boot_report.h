@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////////
+//  BOOT REPORT
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOT_REPORT_H
+#define BOOT_REPORT_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "fixed_string.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define BOOT_DEVICE_BUZZER          0
+#define BOOT_DEVICE_SERIAL          1
+#define BOOT_DEVICE_KEYPAD          2
+#define BOOT_DEVICE_CLOCK           3
+#define BOOT_DEVICE_LIGHT           4
+#define BOOT_DEVICE_IRLED           5
+#define BOOT_DEVICE_DISPLAY         6
+#define BOOT_DEVICE_SDCARD          7
+#define BOOT_DEVICE_SENSORS         8
+#define BOOT_DEVICE_CONFIG          9
+#define BOOT_DEVICE_JOURNAL         10
+#define BOOT_DEVICES                11
+#define BOOT_DEVICE_NAME_SIZE       8
+
+#define BOOT_STATUS_PENDING         0           //  Inicjalizacja nie zostala jeszcze wykonana.
+#define BOOT_STATUS_OK              1
+#define BOOT_STATUS_WARN            2           //  Urzadzenie dziala czesciowo (np. brak jednego czujnika).
+#define BOOT_STATUS_FAIL            3
+
+const char boot_device_names[BOOT_DEVICES][BOOT_DEVICE_NAME_SIZE] PROGMEM = {
+    "buzzer", "serial", "keypad", "rtc", "light", "ir/led", "display", "sdcard", "ds18b20", "config", "journal"
+};
+
+//  Czas inicjalizacji, powyzej ktorego urzadzenie jest oznaczane jako wolne [ms].
+const uint16_t boot_slow_limits[BOOT_DEVICES] PROGMEM = {
+    20, 20, 10, 50, 20, 20, 100, 500, 300, 500, 300
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Wynik inicjalizacji jednego urzadzenia.
+struct BootEntry
+{
+    byte        status;
+    uint16_t    duration;   //  [ms]
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Raport uruchomienia - status i czas inicjalizacji kazdego urzadzenia oraz czasy
+//  wyswietlenia pierwszej klatki z zegarem i zakonczenia uruchamiania w tle.
+class BootReport
+{
+    private:
+        BootEntry       entries[BOOT_DEVICES];
+        byte            current             =   BOOT_DEVICES;
+        unsigned long   start_time          =   0;
+
+        unsigned long   clock_time          =   0;
+        unsigned long   ready_time          =   0;
+
+    public:
+        BootReport();
+
+        void            Begin(byte device);
+        void            End(byte status);
+        unsigned long   GetClockTime();
+        int             GetCount(byte status);
+        void            GetEntry(FixedStringBase & result, byte device);
+        unsigned long   GetReadyTime();
+        int             GetSlowCount();
+        byte            GetStatus(byte device);
+        void            GetSummary(FixedStringBase & result);
+        bool            IsSlow(byte device);
+        void            MarkClock();
+        void            MarkReady();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Konstruktor klasy raportu uruchomienia.
+BootReport::BootReport()
+{
+    memset(this->entries, 0, sizeof(this->entries));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rozpoczecie pomiaru inicjalizacji urzadzenia.
+ *  @param device: Indeks urzadzenia BOOT_DEVICE_*.
+ */
+void BootReport::Begin(byte device)
+{
+    this->current = device;
+    this->start_time = micros();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zakonczenie pomiaru inicjalizacji rozpoczetej przez Begin().
+ *  @param status: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+void BootReport::End(byte status)
+{
+    if (this->current >= BOOT_DEVICES)
+        return;
+
+    unsigned long duration = (micros() - this->start_time + 500) / 1000;
+
+    this->entries[this->current].status = status;
+    this->entries[this->current].duration = min(duration, 65535UL);
+    this->current = BOOT_DEVICES;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie czasu od uruchomienia do wyswietlenia pierwszej klatki z zegarem.
+ *  @return: Czas [ms] lub 0 gdy zegar nie zostal jeszcze wyswietlony.
+ */
+unsigned long BootReport::GetClockTime()
+{
+    return this->clock_time;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci urzadzen z okreslonym wynikiem inicjalizacji.
+ *  @param status: Wynik inicjalizacji BOOT_STATUS_*.
+ *  @return: Ilosc urzadzen.
+ */
+int BootReport::GetCount(byte status)
+{
+    int count = 0;
+
+    for (int i = 0; i < BOOT_DEVICES; i++)
+        if (this->entries[i].status == status)
+            count++;
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie opisu inicjalizacji urzadzenia, np. "sdcard   FAIL  3012 ms SLOW".
+ *  @param result: Tekst wynikowy.
+ *  @param device: Indeks urzadzenia BOOT_DEVICE_*.
+ */
+void BootReport::GetEntry(FixedStringBase & result, byte device)
+{
+    if (device >= BOOT_DEVICES)
+        return;
+
+    BootEntry & entry = this->entries[device];
+    int name_length = strlen_P(boot_device_names[device]);
+
+    result.Append_P(boot_device_names[device]);
+
+    for (int i = name_length; i < BOOT_DEVICE_NAME_SIZE + 1; i++)
+        result.Append(' ');
+
+    switch (entry.status)
+    {
+        case BOOT_STATUS_OK:
+            result.Append_P(PSTR("OK  "));
+            break;
+
+        case BOOT_STATUS_WARN:
+            result.Append_P(PSTR("WARN"));
+            break;
+
+        case BOOT_STATUS_FAIL:
+            result.Append_P(PSTR("FAIL"));
+            break;
+
+        default:
+            result.Append_P(PSTR("--"));
+            return;
+    }
+
+    result.Append(' ').AppendNumber(entry.duration).Append_P(PSTR(" ms"));
+
+    if (this->IsSlow(device))
+        result.Append_P(PSTR(" SLOW"));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie czasu od uruchomienia do zakonczenia uruchamiania w tle.
+ *  @return: Czas [ms] lub 0 gdy uruchamianie trwa.
+ */
+unsigned long BootReport::GetReadyTime()
+{
+    return this->ready_time;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci urzadzen, ktorych inicjalizacja przekroczyla limit czasu.
+ *  @return: Ilosc urzadzen.
+ */
+int BootReport::GetSlowCount()
+{
+    int count = 0;
+
+    for (int i = 0; i < BOOT_DEVICES; i++)
+        if (this->IsSlow(i))
+            count++;
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie wyniku inicjalizacji urzadzenia.
+ *  @param device: Indeks urzadzenia BOOT_DEVICE_*.
+ *  @return: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+byte BootReport::GetStatus(byte device)
+{
+    return device < BOOT_DEVICES ? this->entries[device].status : BOOT_STATUS_PENDING;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie podsumowania uruchomienia.
+ *  @param result: Tekst wynikowy.
+ */
+void BootReport::GetSummary(FixedStringBase & result)
+{
+    result.Append_P(PSTR("boot: clock ")).AppendNumber(this->clock_time).Append_P(PSTR(" ms, ready "));
+
+    if (this->ready_time > 0)
+        result.AppendNumber(this->ready_time).Append_P(PSTR(" ms"));
+    else
+        result.Append_P(PSTR("pending"));
+
+    result.Append_P(PSTR(", failed ")).AppendNumber(this->GetCount(BOOT_STATUS_FAIL));
+    result.Append_P(PSTR(", warnings ")).AppendNumber(this->GetCount(BOOT_STATUS_WARN));
+    result.Append_P(PSTR(", slow ")).AppendNumber(this->GetSlowCount());
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy inicjalizacja urzadzenia przekroczyla limit czasu.
+ *  @param device: Indeks urzadzenia BOOT_DEVICE_*.
+ *  @return: True - urzadzenie wolne.
+ */
+bool BootReport::IsSlow(byte device)
+{
+    if (device >= BOOT_DEVICES || this->entries[device].status == BOOT_STATUS_PENDING)
+        return false;
+
+    return this->entries[device].duration > pgm_read_word(&boot_slow_limits[device]);
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapamietanie czasu wyswietlenia pierwszej klatki z zegarem (tylko pierwsze wywolanie).
+void BootReport::MarkClock()
+{
+    if (this->clock_time == 0)
+        this->clock_time = max(millis(), 1UL);
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapamietanie czasu zakonczenia uruchamiania w tle.
+void BootReport::MarkReady()
+{
+    this->ready_time = millis();
+}
+
+#endif
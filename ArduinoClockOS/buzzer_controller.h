@@ -9,6 +9,7 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "board_profile.h"
 #include "src/notes.h"
 
 
@@ -16,7 +17,7 @@
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#define BUZZER_PIN_OUT    A12
+#define BUZZER_PIN_OUT    Board::BUZZER_PIN_OUT
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,7 +127,7 @@ bool BuzzerController::UpdateToneAsync()
 {
     if (this->is_playing)
     {
-        if (millis() - this->start_time >= this->current_note_duration)
+        if (millis() - this->start_time >= (unsigned long) this->current_note_duration)
         {
             this->StopToneAsync();
             return false;            
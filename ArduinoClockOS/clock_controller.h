@@ -10,16 +10,23 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <DS3231.h>
+#include "board_profile.h"
+#include "fixed_string.h"
+#include "static_instance.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#define CLOCK_PIN_SDA   SDA
-#define CLOCK_PIN_SCL   SCL
+#define CLOCK_PIN_SDA   Board::CLOCK_PIN_SDA
+#define CLOCK_PIN_SCL   Board::CLOCK_PIN_SCL
+#define CLOCK_TEXT_SIZE 24
 
-const String  week_names[7]   = {"Pon", "Wto", "Sro", "Czw", "Pia", "Sob", "Nie"};
+#define CLOCK_WEEK_NAME_SIZE  4
+
+//  Nazwy dni tygodnia w pamieci programu (odczyt przez FixedStringBase::Append_P).
+const char week_names[7][CLOCK_WEEK_NAME_SIZE] PROGMEM = {"Pon", "Wto", "Sro", "Czw", "Pia", "Sob", "Nie"};
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,13 +40,19 @@ class ClockController
         Time          previous_time;
         DS3231        *rtc;
 
+        StaticInstance<DS3231>  rtc_instance;
+
     public:
         ClockController(int sda, int scl);
 
         Time    Now();
+        void    EnableSquareWave();
         bool    GetBlink();
+        unsigned long GetUnixTime(Time time);
         bool    HasDayChanged();
+        void    GetDate(FixedStringBase & result, const char * format, char separator);
         String  GetDate(String format, char separator);
+        void    GetTime(FixedStringBase & result, const char * format, char separator, bool blinking = false);
         String  GetTime(String format, char separator, bool blinking = false);
         void    SetDate(int day, int day_week, int month, int year);
         void    SetDate(int day, int month, int year);
@@ -65,11 +78,19 @@ class ClockController
  */
 ClockController::ClockController(int sda = CLOCK_PIN_SDA, int scl = CLOCK_PIN_SCL)
 {
-    this->rtc = new DS3231(sda, scl);
+    this->rtc = this->rtc_instance.Create(sda, scl);
     this->rtc->begin();
     this->previous_time = this->rtc->getTime();
 }
 
+//  ----------------------------------------------------------------------------
+//  Wlaczenie sygnalu prostokatnego 1Hz na wyjsciu SQW (przerwanie co sekunde).
+void ClockController::EnableSquareWave()
+{
+    this->rtc->setOutput(OUTPUT_SQW);
+    this->rtc->setSQWRate(SQW_RATE_1);
+}
+
 //  ----------------------------------------------------------------------------
 /* Pobranie aktualnej daty i godziny jako struktury Time.
  * @return: Aktualna data i godzina jako struktura Time.
@@ -96,6 +117,16 @@ bool ClockController::GetBlink()
     return this->Now().sec % 2;
 }
 
+//  ----------------------------------------------------------------------------
+/* Konwersja daty i godziny na czas unix.
+ * @param time: Data i godzina.
+ * @return: Ilosc sekund od 1970-01-01 00:00:00.
+ */
+unsigned long ClockController::GetUnixTime(Time time)
+{
+    return this->rtc->getUnixTime(time);
+}
+
 //  ----------------------------------------------------------------------------
 /* Pobranie informacje o tym czy data zostala zmieniona (wartosc mozna pobrac raz na dzien).
  * @return: Informacja o zmianie daty (po polnocy).
@@ -108,7 +139,8 @@ bool ClockController::HasDayChanged()
 }
 
 //  ----------------------------------------------------------------------------
-/*  Pobiera aktualna date w odpowiednim formacie.
+/*  Pobiera aktualna date w odpowiednim formacie (bez alokacji pamieci).
+ *  @param result: Tekst wynikowy (nadpisywany).
  *  @param format: Format daty:
  *    D/d - dzien (01 - 31)
  *    M/m - miesiac (01 - 12)
@@ -117,59 +149,84 @@ bool ClockController::HasDayChanged()
  *    W - nazwa tygodnia (Pon, Wto, Sro, itd)
  *    w - tydzien (1 - 7)
  *  @param separator: Znak odzielajacy kolejne segmenty day.
- *  @return: Aktualna data jako tekst.
  */
-String ClockController::GetDate(String format, char separator)
+void ClockController::GetDate(FixedStringBase & result, const char * format, char separator)
 {
     //  Inicjalizacja zmiennych roboczych/wynikowych.
     Time date_time = this->Now();
-    String result = "";
+    result.Clear();
 
     //  Formatowanie daty.
-    for (int i = 0; i < format.length(); i++)
+    for (int i = 0; format[i] != '\0'; i++)
     {
-        if (format[i] == 'D' || format[i] == 'd') result += ((date_time.date < 10) ? "0" : "") + String(date_time.date);
-        if (format[i] == 'M' || format[i] == 'm') result += ((date_time.mon < 10) ? "0" : "") + String(date_time.mon);
-        if (format[i] == 'Y') result += String(date_time.year);
-        if (format[i] == 'y') result += String(date_time.year).substring(2, 4);
-        if (format[i] == 'W') result += week_names[max(0, min(date_time.dow-1, 6))];
-        if (format[i] == 'w') result += String(date_time.dow);
-
-        if (i < format.length() - 1) result += separator;
+        if (format[i] == 'D' || format[i] == 'd') result.AppendNumber(date_time.date, 2);
+        if (format[i] == 'M' || format[i] == 'm') result.AppendNumber(date_time.mon, 2);
+        if (format[i] == 'Y') result.AppendNumber(date_time.year);
+        if (format[i] == 'y') result.AppendNumber(date_time.year % 100, 2);
+        if (format[i] == 'W') result.Append_P(week_names[max(0, min(date_time.dow-1, 6))]);
+        if (format[i] == 'w') result.AppendNumber(date_time.dow);
+
+        if (format[i + 1] != '\0') result.Append(separator);
     }
+}
 
-    return result;
+//  ----------------------------------------------------------------------------
+/*  Pobiera aktualna date w odpowiednim formacie.
+ *  @param format: Format daty (jak wyzej).
+ *  @param separator: Znak odzielajacy kolejne segmenty day.
+ *  @return: Aktualna data jako tekst.
+ */
+String ClockController::GetDate(String format, char separator)
+{
+    FixedString<CLOCK_TEXT_SIZE> result;
+
+    this->GetDate(result, format.c_str(), separator);
+    return String(result.c_str());
 }
 
 //  ----------------------------------------------------------------------------
-/*  Pobiera aktualny czas w odpowiednim formacie.
+/*  Pobiera aktualny czas w odpowiednim formacie (bez alokacji pamieci).
+ *  @param result: Tekst wynikowy (nadpisywany).
  *  @param format: Format czasu:
  *    H/h - godzina (00 - 23)
  *    M/m - minuta (00 - 59)
  *    S/s - sekunda (00 - 59)
  *  @param separator: Znak odzielajacy kolejne segmenty czasu.
- *  @return: Aktualny czas jako tekst.
+ *  @param blinking: Zastapienie separatora spacja (migajacy wskaznik).
  */
-String ClockController::GetTime(String format, char separator, bool blinking = false)
+void ClockController::GetTime(FixedStringBase & result, const char * format, char separator, bool blinking = false)
 {
     //  Inicjalizacja zmiennych roboczych/wynikowych.
     Time date_time = this->Now();
-    String result = "";
+    result.Clear();
 
     //  Formatowanie separatora i dostosowanie do migajacego wskaznika.
     char sep = blinking ? ' ' : separator;
 
     //  Formatowanie czasu.
-    for (int i = 0; i < format.length(); i++)
+    for (int i = 0; format[i] != '\0'; i++)
     {
-        if (format[i] == 'H' || format[i] == 'h') result += ((date_time.hour < 10) ? "0" : "") + String(date_time.hour);
-        if (format[i] == 'M' || format[i] == 'm') result += ((date_time.min < 10) ? "0" : "") + String(date_time.min);
-        if (format[i] == 'S' || format[i] == 's') result += ((date_time.sec < 10) ? "0" : "") + String(date_time.sec);
+        if (format[i] == 'H' || format[i] == 'h') result.AppendNumber(date_time.hour, 2);
+        if (format[i] == 'M' || format[i] == 'm') result.AppendNumber(date_time.min, 2);
+        if (format[i] == 'S' || format[i] == 's') result.AppendNumber(date_time.sec, 2);
 
-        if (i < format.length() - 1) result += sep;
+        if (format[i + 1] != '\0') result.Append(sep);
     }
+}
 
-    return result;
+//  ----------------------------------------------------------------------------
+/*  Pobiera aktualny czas w odpowiednim formacie.
+ *  @param format: Format czasu (jak wyzej).
+ *  @param separator: Znak odzielajacy kolejne segmenty czasu.
+ *  @param blinking: Zastapienie separatora spacja (migajacy wskaznik).
+ *  @return: Aktualny czas jako tekst.
+ */
+String ClockController::GetTime(String format, char separator, bool blinking = false)
+{
+    FixedString<CLOCK_TEXT_SIZE> result;
+
+    this->GetTime(result, format.c_str(), separator, blinking);
+    return String(result.c_str());
 }
 
 //  ----------------------------------------------------------------------------
@@ -10,6 +10,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "global_controller.h"
+#include "display_benchmark.h"
+#include "frame_snapshot.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,10 +26,12 @@ class CommandProcessor
         String  params_data     =   "";
         String  raw_data        =   "";
         int     params_idx_pos  =   0;
+        bool    replaying       =   false;
 
         //  Utility methods.
         void  Clear();
         bool  IsCharacterADigit(char c);
+        bool  IsReplaySkipped(String command);
         int   ParseMultiNumberData(int *data_array, int data_size, int start_index = 0);
         int   ParseNumberData(int &value);
         bool  ValidateCommand(String command);
@@ -39,24 +43,43 @@ class CommandProcessor
 
         //  Management methods.
         int   ProcessAlarmGetCommand();
+        int   ProcessBaudGetCommand();
         int   ProcessBeepGetCommand();
+        int   ProcessBootCommand();
         int   ProcessBrightnessGetCommand();
         int   ProcessDateGetCommand();
+        int   ProcessFrameCommand();
         int   ProcessIsInitializedCommand();
+        int   ProcessJournalCommand();
+        int   ProcessMemoryCommand();
+        int   ProcessSerialStatsCommand();
+        int   ProcessStatsCommand();
         int   ProcessTimeGetCommand();
 
         int   ProcessAlarmSetCommand();
+        int   ProcessBaudBluetoothCommand();
+        int   ProcessBaudConfirmCommand();
+        int   ProcessBaudNegotiateCommand();
+        int   ProcessBaudSetCommand();
+        int   ProcessBenchCommand();
         int   ProcessBeepSetCommand();
+        int   ProcessCaptureCommand();
         int   ProcessBrightnessSetCommand();
         int   ProcessDateSetCommand();
         int   ProcessLedSetCommand();
         int   ProcessMessageCommand();
+        int   ProcessNightCommand();
         int   ProcessPlayCommand();
+        int   ProcessPowerCommand();
+        int   ProcessReplayCommand();
+        int   ProcessSensorsCommand();
         int   ProcessServiceLockCommand();
         int   ProcessServiceUnlockCommand();
+        int   ProcessTempLogCommand();
         int   ProcessTest();
         int   ProcessTimeSetCommand();
         int   ProcessVpStart();
+        int   ProcessVpStatsCommand();
         int   ProcessWeatherAddCommand();
         int   ProcessWeatherClearCommand();
         int   ProcessWeatherSetCommand();
@@ -91,6 +114,21 @@ bool CommandProcessor::IsCharacterADigit(char c)
     return false;
 }
 
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy polecenie z nagrania ma zostac pominiete przy odtwarzaniu
+ * (polecenia zmieniajace polaczenie lub sterujace samym nagrywaniem).
+ * @param command: Polecenie z nagrania.
+ * @return: Informacja czy polecenie ma zostac pominiete.
+ */
+bool CommandProcessor::IsReplaySkipped(String command)
+{
+    return command.startsWith("/capture")
+        || command.startsWith("/replay")
+        || command.startsWith("/baud")
+        || command.startsWith("/bench")
+        || command.startsWith("/vp");
+}
+
 //  ----------------------------------------------------------------------------
 /* Konwersja ciaglych argumentow na argumenty liczbowe w postaci tablicy.
  * @param *data_array: Wskaznik do tablicy bedacej tablica wynikowa.
@@ -182,8 +220,8 @@ bool CommandProcessor::ValidateCommand(String command)
 //  Powiadomienie o poprawnym wykonaniu polecenia.
 void CommandProcessor::NotifyConfigurationUpdated()
 {
-    this->controller->serial_ctrl->WriteRawData(
-        "OK",
+    this->controller->serial_ctrl->WriteRawData_P(
+        PSTR("OK"),
         this->controller->serial_ctrl->GetLastInputDevice());
 }
 
@@ -191,8 +229,8 @@ void CommandProcessor::NotifyConfigurationUpdated()
 //  Wyswietlenie bledu - niepoprawne polecenie.
 void CommandProcessor::RaiseInvalidCommandError()
 {
-    this->controller->serial_ctrl->WriteRawData(
-        "Entered invalid command.",
+    this->controller->serial_ctrl->WriteRawData_P(
+        PSTR("Entered invalid command."),
         this->controller->serial_ctrl->GetLastInputDevice());
 }
 
@@ -202,9 +240,9 @@ void CommandProcessor::RaiseInvalidCommandError()
  */
 void CommandProcessor::RaiseInvalidParameterError(String command)
 {
-    this->controller->serial_ctrl->WriteRawData(
-        "Entered invalid parameters for '" + command + "' command.",
-        this->controller->serial_ctrl->GetLastInputDevice());
+    this->controller->serial_ctrl->WriteFormat_P(
+        this->controller->serial_ctrl->GetLastInputDevice(), SERIAL_PRIORITY_RESPONSE,
+        PSTR("Entered invalid parameters for '%s' command."), command.c_str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -227,6 +265,111 @@ int CommandProcessor::ProcessAlarmGetCommand()
     return COMMAND_NONE;
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania predkosci transmisji.
+int CommandProcessor::ProcessBaudGetCommand()
+{
+    this->controller->serial_ctrl->WriteRawData(
+        "PC: " + String(this->controller->serial_ctrl->GetBaudrate(SERIAL_COM))
+            + " bps, BT: " + String(this->controller->serial_ctrl->GetBaudrate(SERIAL_BLUETOOTH)) + " bps",
+        this->controller->serial_ctrl->GetLastInputDevice());
+    
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia zapisu, odczytu i porownania ramki wyswietlacza.
+int CommandProcessor::ProcessFrameCommand()
+{
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+    FrameSnapshot snapshot = FrameSnapshot(
+        this->controller->display_ctrl,
+        this->controller->sdcard_ctrl,
+        this->controller->serial_ctrl);
+
+    if (this->params_data == NULL || this->params_data == "")
+    {
+        snapshot.Dump(device);
+        return COMMAND_NONE;
+    }
+
+    if (this->params_data.startsWith("save "))
+    {
+        if (snapshot.Save(this->params_data.substring(5)))
+            this->NotifyConfigurationUpdated();
+        else
+            this->RaiseInvalidParameterError("frame save");
+    }
+    else if (this->params_data.startsWith("check "))
+    {
+        if (snapshot.Check(this->params_data.substring(6), device) == FRAME_SNAPSHOT_NONE)
+            this->RaiseInvalidParameterError("frame check");
+    }
+    else if (this->params_data.startsWith("diff "))
+    {
+        if (snapshot.Diff(this->params_data.substring(5), device) == FRAME_SNAPSHOT_NONE)
+            this->RaiseInvalidParameterError("frame diff");
+    }
+    else
+        this->RaiseInvalidParameterError("frame");
+
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania informacji o wykorzystaniu pamieci RAM.
+int CommandProcessor::ProcessMemoryCommand()
+{
+    char buffer[MEMORY_REPORT_SIZE];
+
+    this->controller->memory_monitor->GetReport(buffer, sizeof(buffer));
+    this->controller->serial_ctrl->WriteRawData(
+        buffer,
+        this->controller->serial_ctrl->GetLastInputDevice());
+    
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania statystyk kolejek danych wyjsciowych.
+int CommandProcessor::ProcessSerialStatsCommand()
+{
+    this->controller->serial_ctrl->WriteRawData(
+        this->controller->serial_ctrl->GetOutputStatistics(),
+        this->controller->serial_ctrl->GetLastInputDevice());
+    
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania (lub wyczyszczenia) pomiarow czasu wykonania.
+int CommandProcessor::ProcessStatsCommand()
+{
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+
+#if PROFILER_ENABLED
+    if (this->params_data == "reset")
+    {
+        profiler.Reset();
+        this->NotifyConfigurationUpdated();
+        return COMMAND_NONE;
+    }
+
+    char buffer[PROFILER_REPORT_SIZE];
+
+    for (int section = 0; section < PROFILE_SECTIONS; section++)
+        if (profiler.GetSectionReport(section, buffer, sizeof(buffer)))
+            this->controller->serial_ctrl->WriteRawData(buffer, device);
+    
+    this->controller->serial_ctrl->WriteFormat_P(
+        device, SERIAL_PRIORITY_RESPONSE, PSTR("loops/s: %lu"), profiler.GetLoopsPerSecond());
+#else
+    this->controller->serial_ctrl->WriteRawData_P(PSTR("Profiler disabled."), device);
+#endif
+
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 //  Przetworzenie polecenia pobrania ustawien brzeczyka godzinowego.
 int CommandProcessor::ProcessBeepGetCommand()
@@ -240,11 +383,32 @@ int CommandProcessor::ProcessBeepGetCommand()
     return COMMAND_NONE;
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania raportu uruchomienia (wynik i czas inicjalizacji urzadzen).
+int CommandProcessor::ProcessBootCommand()
+{
+    BootReport * boot_report = this->controller->boot_report;
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+    FixedString<96> result;
+
+    boot_report->GetSummary(result);
+    this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+
+    for (int i = 0; i < BOOT_DEVICES; i++)
+    {
+        result.Clear();
+        boot_report->GetEntry(result, i);
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+    }
+
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 //  Przetworzenie polecenia pobrania ustawien jasnosci ekranu.
 int CommandProcessor::ProcessBrightnessGetCommand()
 {
-    int value = this->controller->display_ctrl->GetBrightness();
+    int value = this->controller->GetBrightness();
 
     this->controller->serial_ctrl->WriteRawData(
         (this->controller->IsAutoBrightness() ? "AUTO" : String(value)),
@@ -275,6 +439,57 @@ int CommandProcessor::ProcessIsInitializedCommand()
     return COMMAND_NONE;
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia dziennika zdarzen: stan, ostatnie rekordy ("tail [n]") lub punkt kontrolny.
+int CommandProcessor::ProcessJournalCommand()
+{
+    Journal * journal = this->controller->journal;
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+    FixedString<96> result;
+
+    if (this->params_data == "" || this->params_data == "get")
+    {
+        journal->GetStatus(result);
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+    }
+    else if (this->params_data.startsWith("tail"))
+    {
+        int count = this->params_data.length() > 5 ? this->params_data.substring(5).toInt() : JOURNAL_RECORDS;
+        JournalRecord record;
+
+        //  Od najstarszego z wybranych rekordow.
+        for (int back = max(count, 1) - 1; back >= 0; back--)
+        {
+            if (!journal->GetRecord(back, record))
+                continue;
+
+            result.Clear();
+            Journal::AppendRecord(result, record);
+            this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+        }
+    }
+    else if (this->params_data == "checkpoint")
+    {
+        if (!journal->IsReady())
+        {
+            this->RaiseInvalidParameterError("journal");
+            return COMMAND_NONE;
+        }
+
+        if (!this->controller->ProcessJournal(true))
+        {
+            this->controller->serial_ctrl->WriteRawData_P(PSTR("Checkpoint failed: conf.ini not saved."), device);
+            return COMMAND_NONE;
+        }
+
+        this->NotifyConfigurationUpdated();
+    }
+    else
+        this->RaiseInvalidParameterError("journal");
+
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 //  Przetworzenie polecenia pobrania ustawien czasu.
 int CommandProcessor::ProcessTimeGetCommand()
@@ -314,8 +529,8 @@ int CommandProcessor::ProcessAlarmSetCommand()
         this->params_data = this->params_data.substring(4);
     }
 
-    int *data_array = new int[2] {0, 0};
-    int last_step = this->ParseMultiNumberData(data_array, 23);
+    int data_array[2] = {0, 0};
+    int last_step = this->ParseMultiNumberData(data_array, 2);
 
     if (last_step >= 2)
     {
@@ -331,6 +546,112 @@ int CommandProcessor::ProcessAlarmSetCommand()
     return COMMAND_NONE;
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia zmiany predkosci transmisji modulu bluetooth (AT+BAUDn).
+int CommandProcessor::ProcessBaudBluetoothCommand()
+{
+    long baudrate = this->params_data.toInt();
+
+    if (!this->controller->serial_ctrl->BeginBaudrateNegotiation(baudrate, SERIAL_BLUETOOTH))
+    {
+        this->RaiseInvalidParameterError("baud bt");
+        return COMMAND_NONE;
+    }
+
+    return COMMAND_PROCESSED_OK;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia potwierdzenia nowej predkosci transmisji.
+int CommandProcessor::ProcessBaudConfirmCommand()
+{
+    if (!this->controller->serial_ctrl->ConfirmBaudrate(this->controller->serial_ctrl->GetLastInputDevice()))
+    {
+        this->RaiseInvalidParameterError("baud ok");
+        return COMMAND_NONE;
+    }
+
+    //  Potwierdzana jest tylko predkosc portu PC (modul bluetooth zapisuje ja przy SERIAL_BAUD_COMMITTED).
+    this->controller->SaveSetting(PENDING_SETTING_BAUD_PC);
+    this->NotifyConfigurationUpdated();
+    return COMMAND_PROCESSED_OK;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia negocjacji najwyzszej predkosci transmisji z PC.
+int CommandProcessor::ProcessBaudNegotiateCommand()
+{
+    if (!this->controller->serial_ctrl->BeginBaudrateNegotiation(SERIAL_MAX_BAUDRATE_PC, SERIAL_COM))
+    {
+        this->RaiseInvalidParameterError("baud negotiate");
+        return COMMAND_NONE;
+    }
+
+    return COMMAND_PROCESSED_OK;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia zmiany predkosci transmisji z PC.
+int CommandProcessor::ProcessBaudSetCommand()
+{
+    long baudrate = this->params_data.toInt();
+
+    if (!this->controller->serial_ctrl->BeginBaudrateNegotiation(baudrate, SERIAL_COM))
+    {
+        this->RaiseInvalidParameterError("baud set");
+        return COMMAND_NONE;
+    }
+
+    return COMMAND_PROCESSED_OK;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia uruchomienia testu wydajnosci (wyniki w formacie JSON).
+int CommandProcessor::ProcessBenchCommand()
+{
+    if (this->params_data != "display")
+    {
+        this->RaiseInvalidParameterError("bench");
+        return COMMAND_NONE;
+    }
+
+    DisplayBenchmark benchmark = DisplayBenchmark(this->controller->display_ctrl, this->controller->serial_ctrl);
+    benchmark.Run(this->controller->serial_ctrl->GetLastInputDevice());
+
+    return COMMAND_DISPLAY_DATETIME;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia wlaczenia/wylaczenia nagrywania polecen na karte SD.
+int CommandProcessor::ProcessCaptureCommand()
+{
+    CommandRecorder * recorder = this->controller->command_recorder;
+
+    if (this->params_data == "on")
+    {
+        if (!recorder->Start())
+        {
+            this->RaiseInvalidParameterError("capture on");
+            return COMMAND_NONE;
+        }
+    }
+    else if (this->params_data == "off")
+    {
+        recorder->Stop();
+        this->controller->serial_ctrl->WriteFormat_P(
+            this->controller->serial_ctrl->GetLastInputDevice(), SERIAL_PRIORITY_RESPONSE,
+            PSTR("Captured %lu commands."), recorder->GetEntriesCount());
+    }
+    else
+    {
+        this->RaiseInvalidParameterError("capture");
+        return COMMAND_NONE;
+    }
+
+    this->NotifyConfigurationUpdated();
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 //  Przetworzenie polecenia ustawienia brzeczyka godzinowego.
 int CommandProcessor::ProcessBeepSetCommand()
@@ -395,8 +716,7 @@ int CommandProcessor::ProcessBrightnessSetCommand()
     else if (this->IsCharacterADigit(this->params_data[0]))
     {
         int brightness = max(DISPLAY_MIN_BRIGHTNESS, min(this->params_data[0] - 48, DISPLAY_MAX_BRIGHTNESS));
-        this->controller->SetAutoBrightness(false);
-        this->controller->display_ctrl->SetBrightness(brightness);
+        this->controller->SetBrightness(brightness);
         this->NotifyConfigurationUpdated();
         return COMMAND_PROCESSED_OK;
     }
@@ -415,7 +735,7 @@ int CommandProcessor::ProcessDateSetCommand()
         return COMMAND_NONE;
     }
     
-    int *data_array = new int[4] {0, 0, 0, 0};
+    int data_array[4] = {0, 0, 0, 0};
     int last_step = this->ParseMultiNumberData(data_array, 4);
 
     if (last_step == 4)
@@ -508,6 +828,177 @@ int CommandProcessor::ProcessPlayCommand()
     return COMMAND_PROCESSED_OK;    
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia odtworzenia nagranych polecen z pomiarem kosztu ich wykonania.
+int CommandProcessor::ProcessReplayCommand()
+{
+    SerialController * serial_ctrl = this->controller->serial_ctrl;
+    int device = serial_ctrl->GetLastInputDevice();
+    File capture_file;
+
+    if (!this->controller->command_recorder->OpenCapture(capture_file))
+    {
+        this->RaiseInvalidParameterError("replay");
+        return COMMAND_NONE;
+    }
+
+    unsigned long timestamp = 0;
+    int entry_device = 0;
+    String command = "";
+
+    unsigned long count = 0;
+    unsigned long total_time = 0;
+    unsigned long max_time = 0;
+    unsigned long total_sd_opens = 0;
+    unsigned long total_sd_blocks = 0;
+    long total_heap_delta = 0;
+
+    this->replaying = true;
+
+    while (this->controller->command_recorder->ReadEntry(capture_file, timestamp, entry_device, command))
+    {
+        if (this->IsReplaySkipped(command))
+            continue;
+
+        int heap_before = this->controller->memory_monitor->GetHeapUsed();
+        unsigned long opens_before = this->controller->sdcard_ctrl->GetWriteOpenCount();
+        unsigned long blocks_before = this->controller->sdcard_ctrl->GetBlockWriteCount();
+        unsigned long start_time = micros();
+
+        this->ProcessCommand(command);
+
+        unsigned long elapsed = micros() - start_time;
+        int heap_delta = this->controller->memory_monitor->GetHeapUsed() - heap_before;
+        unsigned long sd_opens = this->controller->sdcard_ctrl->GetWriteOpenCount() - opens_before;
+        unsigned long sd_blocks = this->controller->sdcard_ctrl->GetBlockWriteCount() - blocks_before;
+
+        count++;
+        total_time += elapsed;
+        max_time = max(max_time, elapsed);
+        total_sd_opens += sd_opens;
+        total_sd_blocks += sd_blocks;
+        total_heap_delta += heap_delta;
+
+        serial_ctrl->WriteFormat_P(device, SERIAL_PRIORITY_RESPONSE,
+            PSTR("replay @%lu: %lu us, heap %d B, sd %lu opens, %lu blocks: %s"),
+            timestamp, elapsed, heap_delta, sd_opens, sd_blocks, command.c_str());
+    }
+
+    capture_file.close();
+    this->replaying = false;
+
+    serial_ctrl->WriteFormat_P(device, SERIAL_PRIORITY_RESPONSE,
+        PSTR("replayed: %lu, total: %lu us, avg: %lu us, max: %lu us, heap: %ld B, sd: %lu opens, %lu blocks"),
+        count, total_time, count > 0 ? total_time / count : 0, max_time, total_heap_delta, total_sd_opens, total_sd_blocks);
+
+    return COMMAND_DISPLAY_DATETIME;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia trybu nocnego (stan lub konfiguracja "<off|dim|blank> [light|hh-hh]").
+int CommandProcessor::ProcessNightCommand()
+{
+    this->params_data.toLowerCase();
+
+    if (this->params_data == "" || this->params_data == "get")
+    {
+        FixedString<64> result;
+        this->controller->night_mode->GetStatus(result);
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), this->controller->serial_ctrl->GetLastInputDevice());
+    }
+    else if (this->controller->SetNightMode(this->params_data.c_str()))
+        this->NotifyConfigurationUpdated();
+    else
+        this->RaiseInvalidParameterError("night");
+
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia zarzadzania energia (raport wypelnienia i poboru pradu, usypianie).
+int CommandProcessor::ProcessPowerCommand()
+{
+    PowerManager * power_mgr = this->controller->power_mgr;
+
+    if (this->params_data == "" || this->params_data == "get")
+    {
+        FixedString<96> result;
+        power_mgr->GetStatus(result);
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), this->controller->serial_ctrl->GetLastInputDevice());
+    }
+    else if (this->params_data == "idle on" || this->params_data == "idle off")
+    {
+        power_mgr->SetEnabled(this->params_data == "idle on");
+        this->NotifyConfigurationUpdated();
+    }
+    else
+        this->RaiseInvalidParameterError("power");
+
+    return COMMAND_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wypisanie czujnikow temperatury wykrytych na magistralach OneWire (adres i ostatni odczyt).
+int CommandProcessor::ProcessSensorsCommand()
+{
+    OneWireBus * buses[2] = { this->controller->onewire_bus_in, this->controller->onewire_bus_out };
+    TemperatureSensorController * sensor_in = this->controller->temp_sensor_ctrl_in;
+    TemperatureSensorController * sensor_out = this->controller->temp_sensor_ctrl_out;
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+
+    //  Przypisanie czujnika po adresie ROM: "in <adres|auto>" lub "out <adres|auto>".
+    if (this->params_data.startsWith("in ") || this->params_data.startsWith("out "))
+    {
+        bool outside = this->params_data.startsWith("out ");
+
+        if (!this->controller->SetTemperatureSensor(outside, this->params_data.c_str() + (outside ? 4 : 3)))
+        {
+            this->RaiseInvalidParameterError("sensors");
+            return COMMAND_NONE;
+        }
+
+        this->NotifyConfigurationUpdated();
+        return COMMAND_NONE;
+    }
+    else if (this->params_data != "")
+    {
+        this->RaiseInvalidParameterError("sensors");
+        return COMMAND_NONE;
+    }
+
+    for (int b = 0; b < 2; b++)
+    {
+        //  Wspoldzielona magistrala jest wypisywana tylko raz.
+        if (b == 1 && buses[1] == buses[0])
+            break;
+
+        for (int i = 0; i < buses[b]->GetDeviceCount(); i++)
+        {
+            FixedString<48> result;
+            int16_t raw_value = buses[b]->GetRawValue(i);
+
+            result.Append_P(b == 0 ? PSTR("bus IN #") : PSTR("bus OUT #")).AppendNumber(i).Append(' ');
+            OneWireBus::AppendAddress(result, buses[b]->GetAddress(i));
+            result.Append(' ');
+
+            if (raw_value <= ONEWIRE_BUS_RAW_NULL)
+                result.Append('-');
+            else
+                TemperatureLogger::AppendTenths(result, (long) raw_value * 10 / 128);
+
+            if (sensor_in->GetBus() == buses[b] && sensor_in->GetIndex() == i)
+                result.Append_P(sensor_in->GetAssignedAddress() != NULL ? PSTR(" in (rom)") : PSTR(" in"));
+
+            if (sensor_out->GetBus() == buses[b] && sensor_out->GetIndex() == i)
+                result.Append_P(sensor_out->GetAssignedAddress() != NULL ? PSTR(" out (rom)") : PSTR(" out"));
+
+            this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+        }
+    }
+
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 //  Przetworzenie polecenia blokady serwisowej.
 int CommandProcessor::ProcessServiceLockCommand()
@@ -518,7 +1009,7 @@ int CommandProcessor::ProcessServiceLockCommand()
     DisplayString * dsp_str = this->controller->GetDisplayString(TEXT_ALIGN_CENTER);
 
     if (this->params_data == NULL || this->params_data == "")
-        dsp_str->text = "SERVICE LOCK";
+        dsp_str->text = F("SERVICE LOCK");
     else
         dsp_str->text = this->params_data;
     
@@ -539,6 +1030,87 @@ int CommandProcessor::ProcessServiceUnlockCommand()
     return COMMAND_PROCESSED_OK;
 }
 
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia historii temperatur (stan, zapis bufora, podsumowanie dnia).
+int CommandProcessor::ProcessTempLogCommand()
+{
+    TemperatureLogger * logger = this->controller->temp_logger;
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+    FixedString<128> result;
+
+    if (this->params_data == "" || this->params_data == "get")
+    {
+        logger->GetStatus(result);
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+    }
+    else if (this->params_data == "flush")
+    {
+        if (!logger->Flush())
+        {
+            this->RaiseInvalidParameterError("templog flush");
+            return COMMAND_NONE;
+        }
+
+        this->NotifyConfigurationUpdated();
+    }
+    else if (this->params_data.startsWith("day"))
+    {
+        //  Format: /templog day dd.mm.yyyy
+        int data_array[3] = {0, 0, 0};
+
+        if (this->ParseMultiNumberData(data_array, 3, 4) != 3)
+        {
+            this->RaiseInvalidParameterError("templog day");
+            return COMMAND_NONE;
+        }
+
+        Time date;
+        date.date = max(1, min(31, data_array[0]));
+        date.mon = max(1, min(12, data_array[1]));
+        date.year = max(2000, min(2035, data_array[2]));
+        date.hour = 0;
+        date.min = 0;
+        date.sec = 0;
+
+        unsigned int day = this->controller->clock_ctrl->GetUnixTime(date) / 86400UL;
+        TempLogStats stats_in, stats_out;
+        int hours = 0;
+
+        if (!logger->GetDaySummary(day, stats_in, stats_out, hours))
+        {
+            this->controller->serial_ctrl->WriteRawData_P(PSTR("templog: no data"), device);
+            return COMMAND_NONE;
+        }
+
+        result.Append_P(PSTR("templog: ")).AppendNumber(hours).Append_P(PSTR("h"));
+
+        TempLogStats * sensors[2] = { &stats_in, &stats_out };
+
+        for (int i = 0; i < 2; i++)
+        {
+            result.Append_P(i == 0 ? PSTR(", IN ") : PSTR(", OUT "));
+
+            if (sensors[i]->count == 0)
+            {
+                result.Append('-');
+                continue;
+            }
+
+            TemperatureLogger::AppendTenths(result, sensors[i]->min_value);
+            result.Append('/');
+            TemperatureLogger::AppendTenths(result, sensors[i]->max_value);
+            result.Append('/');
+            TemperatureLogger::AppendTenths(result, sensors[i]->sum / sensors[i]->count);
+        }
+
+        this->controller->serial_ctrl->WriteRawData(result.c_str(), device);
+    }
+    else
+        this->RaiseInvalidParameterError("templog");
+
+    return COMMAND_NONE;
+}
+
 //  ----------------------------------------------------------------------------
 int CommandProcessor::ProcessTest()
 {
@@ -561,7 +1133,7 @@ int CommandProcessor::ProcessTimeSetCommand()
         return COMMAND_NONE;
     }
     
-    int *data_array = new int[3] {0, 0, 0};
+    int data_array[3] = {0, 0, 0};
     int last_step = this->ParseMultiNumberData(data_array, 3);
 
     if (last_step >= 2)
@@ -591,7 +1163,27 @@ int CommandProcessor::ProcessTimeSetCommand()
 //  Przetworzenie polecenia uruchomienia połączenia z Visual Playerem.
 int CommandProcessor::ProcessVpStart()
 {
-    //
+    int device = this->controller->serial_ctrl->GetLastInputDevice();
+    int start_result = this->controller->vplayer_ctrl->Start(device);
+
+    if (start_result == VPLAYER_PLAYING)
+    {
+        this->controller->SetMachineState(GLOBAL_STATE_VPLAYER);
+        this->NotifyConfigurationUpdated();
+    }
+
+    return COMMAND_PROCESSED_OK;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przetworzenie polecenia pobrania statystyk transmisji Visual Playera.
+int CommandProcessor::ProcessVpStatsCommand()
+{
+    this->controller->serial_ctrl->WriteRawData(
+        this->controller->vplayer_ctrl->GetStatistics(),
+        this->controller->serial_ctrl->GetLastInputDevice());
+    
+    return COMMAND_NONE;
 }
 
 //  ----------------------------------------------------------------------------
@@ -604,12 +1196,12 @@ int CommandProcessor::ProcessWeatherAddCommand()
         return COMMAND_NONE;
     }
 
-    int *date_array = new int[3] {0, 0, 0};
+    int date_array[3] = {0, 0, 0};
     int last_step = this->ParseMultiNumberData(date_array, 3);
 
     if (last_step == 3)
     {
-        int *weather_array = new int[25] { 0 };
+        int weather_array[25] = { 0 };
         last_step = this->ParseMultiNumberData(weather_array, 25, this->params_idx_pos);
 
         if (last_step > 0 && last_step <= 25)
@@ -665,48 +1257,109 @@ int CommandProcessor::ProcessCommand(String raw_data)
     this->params_data = "";
     this->raw_data = raw_data;
 
+    //  Zapisanie polecenia do nagrania i dziennika (bez polecen odtwarzanych z nagrania).
+    if (!this->replaying && !raw_data.startsWith("/capture"))
+        this->controller->command_recorder->Record(raw_data, this->controller->serial_ctrl->GetLastInputDevice());
+
+    if (!this->replaying)
+        this->controller->journal->AppendCommand(raw_data.c_str(), this->controller->serial_ctrl->GetLastInputDevice());
+
     if (this->ValidateCommand("/alarm get"))
         return this->ProcessAlarmGetCommand();
         
     else if (this->ValidateCommand("/alarm set"))
         return this->ProcessAlarmSetCommand();
     
+    else if (this->ValidateCommand("/baud bt"))
+        return this->ProcessBaudBluetoothCommand();
+    
+    else if (this->ValidateCommand("/baud get"))
+        return this->ProcessBaudGetCommand();
+    
+    else if (this->ValidateCommand("/baud negotiate"))
+        return this->ProcessBaudNegotiateCommand();
+    
+    else if (this->ValidateCommand("/baud ok"))
+        return this->ProcessBaudConfirmCommand();
+    
+    else if (this->ValidateCommand("/baud set"))
+        return this->ProcessBaudSetCommand();
+    
+    else if (this->ValidateCommand("/bench"))
+        return this->ProcessBenchCommand();
+    
     else if (this->ValidateCommand("/beep get"))
         return this->ProcessBeepGetCommand();
         
     else if (this->ValidateCommand("/beep set"))
         return this->ProcessBeepSetCommand();
     
+    else if (this->ValidateCommand("/boot"))
+        return this->ProcessBootCommand();
+    
     else if (this->ValidateCommand("/brightness get"))
         return this->ProcessBrightnessGetCommand();
     
     else if (this->ValidateCommand("/brightness set"))
         return this->ProcessBrightnessSetCommand();
 
+    else if (this->ValidateCommand("/capture"))
+        return this->ProcessCaptureCommand();
+    
     else if (this->ValidateCommand("/date get"))
         return this->ProcessDateGetCommand();
         
     else if (this->ValidateCommand("/date set"))
         return this->ProcessDateSetCommand();
     
+    else if (this->ValidateCommand("/frame"))
+        return this->ProcessFrameCommand();
+    
     else if (this->ValidateCommand("/led"))
         return this->ProcessLedSetCommand();
     
     else if (this->ValidateCommand("/init"))
         return this->ProcessIsInitializedCommand();
     
+    else if (this->ValidateCommand("/journal"))
+        return this->ProcessJournalCommand();
+    
+    else if (this->ValidateCommand("/mem"))
+        return this->ProcessMemoryCommand();
+    
     else if (this->ValidateCommand("/msg"))
         return this->ProcessMessageCommand();
     
     else if (this->ValidateCommand("/play"))
         return this->ProcessPlayCommand();
     
+    else if (this->ValidateCommand("/stats"))
+        return this->ProcessStatsCommand();
+    
+    else if (this->ValidateCommand("/serial stats"))
+        return this->ProcessSerialStatsCommand();
+    
+    else if (this->ValidateCommand("/replay"))
+        return this->ProcessReplayCommand();
+    
+    else if (this->ValidateCommand("/night"))
+        return this->ProcessNightCommand();
+    
+    else if (this->ValidateCommand("/power"))
+        return this->ProcessPowerCommand();
+    
+    else if (this->ValidateCommand("/sensors"))
+        return this->ProcessSensorsCommand();
+    
     else if (this->ValidateCommand("/lock"))
         return this->ProcessServiceLockCommand();
     
     else if (this->ValidateCommand("/unlock"))
         return this->ProcessServiceUnlockCommand();
     
+    else if (this->ValidateCommand("/templog"))
+        return this->ProcessTempLogCommand();
+    
     else if (this->ValidateCommand("/test"))
         return this->ProcessTest();
     
@@ -719,6 +1372,9 @@ int CommandProcessor::ProcessCommand(String raw_data)
     else if (this->ValidateCommand("/vp start"))
         return this->ProcessVpStart();
     
+    else if (this->ValidateCommand("/vp stats"))
+        return this->ProcessVpStatsCommand();
+    
     else if (this->ValidateCommand("/weather add"))
         return this->ProcessWeatherAddCommand();
     
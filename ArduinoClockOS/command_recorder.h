@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//  COMMAND RECORDER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMMAND_RECORDER_H
+#define COMMAND_RECORDER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sd_card_controller.h"
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Format linii: <czas od rozpoczecia nagrywania w ms>\t<urzadzenie>\t<polecenie>
+#define CAPTURE_FILE_NAME   F("capture.log")
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class CommandRecorder
+{
+    private:
+        SdCardController  * sdcard_ctrl;
+
+        bool            capturing       =   false;
+        File            file;
+        unsigned long   entries         =   0;
+        unsigned long   start_time      =   0;
+
+    public:
+        CommandRecorder(SdCardController * sdcard_ctrl);
+
+        unsigned long   GetEntriesCount();
+        bool            IsCapturing();
+        bool            OpenCapture(File & capture_file);
+        bool            ReadEntry(File & capture_file, unsigned long & timestamp, int & device, String & command);
+        void            Record(String command, int device);
+        bool            Start();
+        void            Stop();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy nagrywajacej polecenia przychodzace z urzadzen zewnetrznych.
+ *  @param sdcard_ctrl: Kontroler karty SD.
+ */
+CommandRecorder::CommandRecorder(SdCardController * sdcard_ctrl)
+{
+    this->sdcard_ctrl = sdcard_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci zapisanych polecen w trwajacym lub ostatnim nagraniu.
+ *  @return: Ilosc zapisanych polecen.
+ */
+unsigned long CommandRecorder::GetEntriesCount()
+{
+    return this->entries;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy trwa nagrywanie polecen.
+ *  @return: Informacja czy trwa nagrywanie.
+ */
+bool CommandRecorder::IsCapturing()
+{
+    return this->capturing;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Otwarcie pliku nagrania do odczytu.
+ *  @param capture_file: Plik nagrania (wynik).
+ *  @return: Informacja czy plik zostal otwarty.
+ */
+bool CommandRecorder::OpenCapture(File & capture_file)
+{
+    if (this->capturing || !this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
+        return false;
+
+    capture_file = this->sdcard_ctrl->OpenFileToRead(CAPTURE_FILE_NAME);
+    return capture_file;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odczytanie kolejnego polecenia z pliku nagrania.
+ *  @param capture_file: Plik nagrania.
+ *  @param timestamp: Czas odebrania polecenia od rozpoczecia nagrywania w ms (wynik).
+ *  @param device: Typ urzadzenia z ktorego polecenie zostalo odebrane (wynik).
+ *  @param command: Polecenie (wynik).
+ *  @return: Informacja czy polecenie zostalo odczytane.
+ */
+bool CommandRecorder::ReadEntry(File & capture_file, unsigned long & timestamp, int & device, String & command)
+{
+    while (capture_file.available())
+    {
+        String line = capture_file.readStringUntil('\n');
+        line.trim();
+
+        int first_tab = line.indexOf('\t');
+        int second_tab = line.indexOf('\t', first_tab + 1);
+
+        if (first_tab < 0 || second_tab < 0)
+            continue;
+
+        timestamp = line.substring(0, first_tab).toInt();
+        device = line.substring(first_tab + 1, second_tab).toInt();
+        command = line.substring(second_tab + 1);
+        return true;
+    }
+
+    return false;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapisanie polecenia do pliku nagrania (jezeli trwa nagrywanie).
+ *  @param command: Polecenie.
+ *  @param device: Typ urzadzenia z ktorego polecenie zostalo odebrane.
+ */
+void CommandRecorder::Record(String command, int device)
+{
+    if (!this->capturing)
+        return;
+
+    this->file.print(millis() - this->start_time);
+    this->file.print('\t');
+    this->file.print(device);
+    this->file.print('\t');
+    this->file.println(command);
+    this->file.flush();
+
+    this->entries++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rozpoczecie nagrywania polecen (poprzednie nagranie jest usuwane).
+ *  @return: Informacja czy nagrywanie zostalo rozpoczete.
+ */
+bool CommandRecorder::Start()
+{
+    if (this->capturing || !this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
+        return false;
+
+    this->file = this->sdcard_ctrl->OpenFileToWrite(CAPTURE_FILE_NAME);
+
+    if (!this->file)
+        return false;
+
+    this->capturing = true;
+    this->entries = 0;
+    this->start_time = millis();
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zakonczenie nagrywania polecen.
+void CommandRecorder::Stop()
+{
+    if (!this->capturing)
+        return;
+
+    this->file.close();
+    this->capturing = false;
+}
+
+#endif
@@ -16,12 +16,13 @@
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#define SETTERS           5
+#define SETTERS           6
 #define DATE_SETTER       0
 #define TIME_SETTER       1
 #define BRIGHTNESS_SETTER 2
 #define BEEP_SETTER       3
 #define ALARM_SETTER      4
+#define NIGHT_SETTER      5
 
 #define SETTER_NOTHING    -1
 #define SETTER_SAVE       -2
@@ -36,15 +37,21 @@
 #define SETTER_BRIGHNESS_AUTO       10
 #define SETTER_BEEP_POSITIONS       7
 #define SETTER_ALARM_POSITIONS      6
+#define SETTER_NIGHT_POSITIONS      4
 
 #define SETTER_INPUT_MAX            2
 
-const String SETTER_AUTO_STR = "<AUTO>";
-const String SETTER_SAVE_STR = "<SAVE>";
-const String SETTER_ALARM_SET_LED_STR = "<LED>";
-const String SETTER_EXIT_STR = "<EXIT>";
-const String SETTER_SET_STR = "<SET>";
-const String SETTER_OFF_STR = "<OFF>";
+#define SETTER_REPEAT_FAST          8     //  Powtorzenie od ktorego krok zmiany wartosci wynosi 2.
+#define SETTER_REPEAT_FASTER        20    //  Powtorzenie od ktorego krok zmiany wartosci wynosi 5.
+
+const char SETTER_AUTO_STR[] PROGMEM = "<AUTO>";
+const char SETTER_SAVE_STR[] PROGMEM = "<SAVE>";
+const char SETTER_ALARM_SET_LED_STR[] PROGMEM = "<LED>";
+const char SETTER_EXIT_STR[] PROGMEM = "<EXIT>";
+const char SETTER_SET_STR[] PROGMEM = "<SET>";
+const char SETTER_OFF_STR[] PROGMEM = "<OFF>";
+const char SETTER_DIM_STR[] PROGMEM = "<DIM>";
+const char SETTER_BLANK_STR[] PROGMEM = "<BLANK>";
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,27 +66,35 @@ class DataSetter
         int     mode                  = 0;
         bool    allow_keyboard_input  = false;
         String  current_input         = "";
-        int   * data                  = new int[16] { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        int     data[16]              = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
         bool    edit_started          = true;
+        bool    held_adjusted         = false;
+        char    held_key              = KEYPAD_NO_KEY;
         int     input_index           = 0;
         int     setter_position       = 1;
+        bool    redraw_pending        = false;
         bool    underline_blink       = false;
 
         DisplayString * data_dsp_string;
 
+        StaticInstance<DisplayString> data_dsp_string_instance;
+
         int     GetBeepValuePosition();
         int     GetBrightnessValuePosition();
+        bool    GetFieldRange(int pos, int & low, int & high);
 
         void    DisplayData(DisplayController * dsp_ctrl);
         void    DisplayTitle(DisplayController * dsp_ctrl);
         void    DisplaySetter(bool clear = false, bool only_data_update = false);
-        String  GetEditableString(int pos, int spaces);
+        void    RequestRedraw();
+        void    GetEditableString(FixedStringBase & result, int pos, int spaces);
 
         int   NavigateForward();
         int   NavigateBack();
         int   NavigatePrevious();
         int   NavigateNext();
 
+        void  AdjustValue(int direction, int repeats);
         bool  IsManualInputAllowed();
         int   NavigateManualInput(char input_key);
         void  SetManualInputValue();
@@ -92,6 +107,7 @@ class DataSetter
 
         void  OpenSetter(int mode);
         int   ProcessInput(int input);
+        int   ProcessKeyEvent(KeypadEvent event);
         void  UpdateDisplay();
 };
 
@@ -129,7 +145,53 @@ int DataSetter::GetBeepValuePosition()
  */
 int DataSetter::GetBrightnessValuePosition()
 {
-    return controller->IsAutoBrightness() ? SETTER_BRIGHNESS_AUTO : controller->display_ctrl->GetBrightness() + 1;
+    return controller->IsAutoBrightness() ? SETTER_BRIGHNESS_AUTO : controller->GetBrightness() + 1;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie zakresu wartosci edytowalnego pola liczbowego.
+ *  @param pos: Pozycja pola w konfiguratorze.
+ *  @param low: Najmniejsza wartosc pola.
+ *  @param high: Najwieksza wartosc pola.
+ *  @return: True - pole liczbowe; False - w innym wypadku.
+ */
+bool DataSetter::GetFieldRange(int pos, int & low, int & high)
+{
+    low = 0;
+
+    switch (this->mode)
+    {
+        case DATE_SETTER:
+            if (pos == 1)
+            {
+                low = 1;
+                high = this->controller->clock_ctrl->ValidateDay(31, this->data[2], 2000 + this->data[3]);
+            }
+            else if (pos == 2 || pos == 4)
+            {
+                low = 1;
+                high = pos == 2 ? 12 : 7;
+            }
+            else if (pos == 3)
+                high = this->controller->clock_ctrl->ValidateYear(9999) - 2000;
+            else
+                return false;
+
+            return true;
+
+        case TIME_SETTER:
+        case ALARM_SETTER:
+            if (pos == 1)
+                high = 23;
+            else if (pos == 2 || (pos == 3 && this->mode == TIME_SETTER))
+                high = 59;
+            else
+                return false;
+
+            return true;
+    }
+
+    return false;
 }
 
 //  ----------------------------------------------------------------------------
@@ -223,6 +285,17 @@ int DataSetter::NavigateForward()
                 return SETTER_EXIT;
             
             break;
+        
+        case NIGHT_SETTER:
+            if (pos >= 1 && pos <= 3)
+            {
+                this->controller->SetNightModeLevel(value);
+                return SETTER_EXIT;
+            }
+            else if (value == SETTER_EXIT)
+                return SETTER_EXIT;
+
+            break;
     }
 
     return SETTER_NOTHING;
@@ -251,7 +324,7 @@ int DataSetter::NavigatePrevious()
 
     this->edit_started = true;
     this->ResetManualInput();
-    this->DisplaySetter(false, true);
+    this->RequestRedraw();
 
     return SETTER_NOTHING;
 }
@@ -270,11 +343,42 @@ int DataSetter::NavigateNext()
 
     this->edit_started = true;
     this->ResetManualInput();
-    this->DisplaySetter(false, true);
+    this->RequestRedraw();
 
     return SETTER_NOTHING;
 }
 
+//  ----------------------------------------------------------------------------
+/*  Zmiana wartosci wybranego pola liczbowego przytrzymanym przyciskiem (z przyspieszeniem).
+ *  @param direction: Kierunek zmiany (1 - zwiekszenie; -1 - zmniejszenie).
+ *  @param repeats: Numer powtorzenia przytrzymanego przycisku.
+ */
+void DataSetter::AdjustValue(int direction, int repeats)
+{
+    int pos = this->setter_position;
+    int low, high;
+
+    if (!this->GetFieldRange(pos, low, high))
+        return;
+
+    int span = high - low + 1;
+    int step = repeats >= SETTER_REPEAT_FASTER ? 5 : (repeats >= SETTER_REPEAT_FAST ? 2 : 1);
+
+    //  Krok nie moze przeskakiwac znacznej czesci zakresu (np. miesiace, dni tygodnia).
+    step = max(1, min(step, span / 8));
+
+    int value = this->data[pos] - low + direction * step;
+    this->data[pos] = low + ((value % span) + span) % span;
+
+    if (this->mode == DATE_SETTER && (pos == 2 || pos == 3))
+        this->data[1] = controller->clock_ctrl->ValidateDay(this->data[1], this->data[2], 2000 + this->data[3]);
+
+    //  Wyswietlenie wartosci zamiast pola wprowadzania.
+    this->edit_started = false;
+    this->ResetManualInput();
+    this->RequestRedraw();
+}
+
 //  ----------------------------------------------------------------------------
 /*  Sprawdzenie czy dozwolone jest wpisywanie wartosci z klawiatury numerycznej.
  *  @return: True - dozwolone wpisanie wartosci z klawiatury numerycznej; False - w innym wypadku.
@@ -320,7 +424,7 @@ int DataSetter::NavigateManualInput(char input_key)
                 this->edit_started = false;          
         }
 
-        this->DisplaySetter(false, true);
+        this->RequestRedraw();
     }
 
     return SETTER_NOTHING;
@@ -393,42 +497,42 @@ void DataSetter::ResetManualInput()
 }
 
 //  ----------------------------------------------------------------------------
-/*  Wygenerowanie pola edycji tekstu wraz z wpisanym tekstem i wolnymi polami.
+/*  Wygenerowanie pola edycji tekstu wraz z wpisanym tekstem i wolnymi polami (bez alokacji pamieci).
+ *  @param result: Tekst wynikowy (nadpisywany).
  *  @param pos: Pozycja kursora.
  *  @param spaces: Puste miejsca.
- *  @return: Pole edycji tekstu wraz z wpisanym tekstem i wolnymi polami.
  */
-String DataSetter::GetEditableString(int pos, int spaces)
+void DataSetter::GetEditableString(FixedStringBase & result, int pos, int spaces)
 {
-    String display_string = "";
-    String underlined = underline_blink
-        ? (spaces >= 2 ? "    " : (spaces == 1 ? this->current_input + "  " : this->current_input))
-        : (spaces >= 2 ? "__" : (spaces == 1 ? this->current_input + "_" : this->current_input));
+    int fields = this->mode == ALARM_SETTER ? 2 : 3;
+    char separator = this->mode == DATE_SETTER ? '.' : ':';
 
-    if (this->mode == DATE_SETTER)
-    {
-        display_string = pos == 0 && this->edit_started ? underlined : ((this->data[1] < 10) ? "0" : "") + String(this->data[1]);
-        display_string += ".";
-        display_string += pos == 1 && this->edit_started ? underlined : ((this->data[2] < 10) ? "0" : "") + String(this->data[2]);
-        display_string += ".";
-        display_string += pos == 2 && this->edit_started ? underlined : ((this->data[3] < 10) ? "0" : "") + String(this->data[3]);
-    }
-    else if (this->mode == TIME_SETTER)
-    {
-        display_string = pos == 0 && this->edit_started ? underlined : ((this->data[1] < 10) ? "0" : "") + String(this->data[1]);
-        display_string += ":";
-        display_string += pos == 1 && this->edit_started ? underlined : ((this->data[2] < 10) ? "0" : "") + String(this->data[2]);
-        display_string += ":";
-        display_string += pos == 2 && this->edit_started ? underlined : ((this->data[3] < 10) ? "0" : "") + String(this->data[3]);
-    }
-    else if (this->mode == ALARM_SETTER)
+    result.Clear();
+
+    if (this->mode != DATE_SETTER && this->mode != TIME_SETTER && this->mode != ALARM_SETTER)
+        return;
+
+    for (int field = 0; field < fields; field++)
     {
-        display_string = pos == 0 && this->edit_started ? underlined : ((this->data[1] < 10) ? "0" : "") + String(this->data[1]);
-        display_string += ":";
-        display_string += pos == 1 && this->edit_started ? underlined : ((this->data[2] < 10) ? "0" : "") + String(this->data[2]);
-    }
+        if (field > 0)
+            result.Append(separator);
+
+        //  Pole edytowane - wpisany tekst i podkreslenie wolnych miejsc.
+        if (pos == field && this->edit_started)
+        {
+            if (spaces >= 2)
+                result.Append(underline_blink ? "    " : "__");
+            else
+            {
+                result.Append(this->current_input.c_str());
 
-    return display_string;
+                if (spaces == 1)
+                    result.Append(underline_blink ? "  " : "_");
+            }
+        }
+        else
+            result.AppendNumber(this->data[field + 1], 2);
+    }
 }
 
 //  ----------------------------------------------------------------------------
@@ -438,81 +542,102 @@ String DataSetter::GetEditableString(int pos, int spaces)
 void DataSetter::DisplayData(DisplayController * dsp_ctrl)
 {
     int pos = this->setter_position;
-    String display_string = "";
+    FixedString<DISPLAY_TEXT_SIZE> display_string;
+
+    display_string.Clear();
 
     switch (this->mode)
     {
         case DATE_SETTER:
             if (pos >= 1 && pos <= 3)
-                display_string = this->GetEditableString(pos - 1, min(2, max(0, 2 - input_index)));
+                this->GetEditableString(display_string, pos - 1, min(2, max(0, 2 - input_index)));
                 
             else if (pos == 4)
-                display_string = "<" + week_names[max(0, min(this->data[4]-1, 6))] + ">";
+                display_string.Append('<').Append_P(week_names[max(0, min(this->data[4]-1, 6))]).Append('>');
             
             else if (pos == 5)
-                display_string = SETTER_SAVE_STR;
+                display_string.Append_P(SETTER_SAVE_STR);
             
             else if (pos == 6)
-                display_string = SETTER_EXIT_STR;
+                display_string.Append_P(SETTER_EXIT_STR);
                             
             break;
         
         case TIME_SETTER:
             if (pos >= 1 && pos <= 3)
-                display_string = this->GetEditableString(pos - 1, min(2, max(0, 2 - input_index)));
+                this->GetEditableString(display_string, pos - 1, min(2, max(0, 2 - input_index)));
 
             else if (pos == 4)
-                display_string = SETTER_SAVE_STR;
+                display_string.Append_P(SETTER_SAVE_STR);
             
             else if (pos == 5)
-                display_string = SETTER_EXIT_STR;
+                display_string.Append_P(SETTER_EXIT_STR);
 
             break;
         
         case BRIGHTNESS_SETTER:
             if (pos >= 1 && pos <= 9)
             {
-                display_string = "<" + String(this->data[setter_position]) + ">";
+                display_string.Append('<').AppendNumber(this->data[setter_position]).Append('>');
             }
             else if (pos == 10)
-                display_string = SETTER_AUTO_STR;
+                display_string.Append_P(SETTER_AUTO_STR);
 
             else if (pos == 11)
-                display_string = SETTER_EXIT_STR;
+                display_string.Append_P(SETTER_EXIT_STR);
             
             break;
         
         case BEEP_SETTER:
             if (pos == 1)
-                display_string = SETTER_OFF_STR;
+                display_string.Append_P(SETTER_OFF_STR);
             
             else if (pos >= 2 && pos <= 6)
-                display_string = "<" + String(data[pos]) + "h>";
+                display_string.Append('<').AppendNumber(data[pos]).Append("h>");
             
             else if (pos == 7)
-                display_string = SETTER_EXIT_STR;
+                display_string.Append_P(SETTER_EXIT_STR);
 
             break;
         
         case ALARM_SETTER:
             if (pos >= 1 && pos <= 2)
-                display_string = this->GetEditableString(pos - 1, min(2, max(0, 2 - input_index)));
+                this->GetEditableString(display_string, pos - 1, min(2, max(0, 2 - input_index)));
             
             else if (pos == 3)
-                display_string = SETTER_OFF_STR;
+                display_string.Append_P(SETTER_OFF_STR);
 
             else if (pos == 4)
-                display_string = SETTER_SET_STR;
+                display_string.Append_P(SETTER_SET_STR);
             
             else if (pos == 5)
-                display_string = SETTER_ALARM_SET_LED_STR;
+                display_string.Append_P(SETTER_ALARM_SET_LED_STR);
             
             else if (pos == 6)
-                display_string = SETTER_EXIT_STR;
+                display_string.Append_P(SETTER_EXIT_STR);
+
+            break;
+        
+        case NIGHT_SETTER:
+            if (pos == 1)
+                display_string.Append_P(SETTER_OFF_STR);
+            
+            else if (pos == 2)
+                display_string.Append_P(SETTER_DIM_STR);
+            
+            else if (pos == 3)
+                display_string.Append_P(SETTER_BLANK_STR);
+            
+            else if (pos == 4)
+                display_string.Append_P(SETTER_EXIT_STR);
 
             break;
     }
 
+    //  Pole bez zmian nie jest ponownie wysylane do wyswietlacza.
+    if (display_string == this->data_dsp_string->text.c_str())
+        return;
+
     this->data_dsp_string->text = display_string;
     dsp_ctrl->PrintDS(data_dsp_string);
 }
@@ -529,27 +654,32 @@ void DataSetter::DisplayTitle(DisplayController * dsp_ctrl)
     {
         case DATE_SETTER:
             dsp_ctrl->DrawSprite(SPRITE_CALENDAR, 0, 0);
-            dsp_ctrl->PrintText(0, _text_offset, "Date");
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Date"));
             break;
         
         case TIME_SETTER:
             dsp_ctrl->DrawSprite(SPRITE_CLOCK, 0, 0);
-            dsp_ctrl->PrintText(0, _text_offset, "Time");
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Time"));
             break;
         
         case BRIGHTNESS_SETTER:
             dsp_ctrl->DrawSprite(SPRITE_BRIGHTNESS, 0, 0);
-            dsp_ctrl->PrintText(0, _text_offset, "Bright...");
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Bright..."));
             break;
         
         case BEEP_SETTER:
             dsp_ctrl->DrawSprite(SPRITE_MUSIC, 0, 0);
-            dsp_ctrl->PrintText(0, _text_offset, "Beep");
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Beep"));
             break;
         
         case ALARM_SETTER:
             dsp_ctrl->DrawSprite(SPRITE_ALARM, 0, 0);
-            dsp_ctrl->PrintText(0, _text_offset, "Alarm");
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Alarm"));
+            break;
+        
+        case NIGHT_SETTER:
+            dsp_ctrl->DrawSprite(SPRITE_NIGHT, 0, 0);
+            dsp_ctrl->PrintText_P(0, _text_offset, PSTR("Night"));
             break;
     }
 }
@@ -566,10 +696,22 @@ void DataSetter::DisplaySetter(bool clear = false, bool only_data_update = false
     if (clear)
         dsp_ctrl->Clear();
 
+    //  Po narysowaniu tytulu pole danych jest rysowane w calosci.
     if (!only_data_update)
+    {
         this->DisplayTitle(dsp_ctrl);
+        this->data_dsp_string->text.Clear();
+    }
     
     this->DisplayData(dsp_ctrl);
+    this->redraw_pending = false;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zgloszenie potrzeby odswiezenia pola danych - wykonywane raz na cykl w UpdateDisplay().
+void DataSetter::RequestRedraw()
+{
+    this->redraw_pending = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -583,7 +725,7 @@ DataSetter::DataSetter(GlobalController * controller)
 {
     this->controller = controller;
 
-    this->data_dsp_string = new DisplayString(0, TEXT_ALIGN_RIGHT, "");
+    this->data_dsp_string = this->data_dsp_string_instance.Create(0, TEXT_ALIGN_RIGHT, "");
     this->data_dsp_string->offset = 1;
     this->data_dsp_string->_xpos = this->controller->display_ctrl->GetWidth()-1;
 }
@@ -605,6 +747,7 @@ void DataSetter::OpenSetter(int mode)
 {
     this->mode = mode % SETTERS;
     this->setter_position = 1;
+    this->held_key = KEYPAD_NO_KEY;
 
     Time _date_time = controller->clock_ctrl->Now();
 
@@ -671,6 +814,16 @@ void DataSetter::OpenSetter(int mode)
             this->data[6] = SETTER_EXIT;            
             this->allow_keyboard_input = true;
             break;
+        
+        case NIGHT_SETTER:
+            this->data[0] = SETTER_NIGHT_POSITIONS;
+            this->data[1] = NIGHT_MODE_OFF;
+            this->data[2] = NIGHT_MODE_DIM;
+            this->data[3] = NIGHT_MODE_BLANK;
+            this->data[4] = SETTER_EXIT;
+            this->allow_keyboard_input = false;
+            this->setter_position = this->controller->night_mode->GetLevel() + 1;
+            break;
     }
 
     this->DisplaySetter();
@@ -683,9 +836,25 @@ void DataSetter::OpenSetter(int mode)
  */
 int DataSetter::ProcessInput(int input)
 {
+    this->held_key = KEYPAD_NO_KEY;
+
     if (this->allow_keyboard_input && input >= KEYPAD_0_KEY && input <= KEYPAD_9_KEY)
         return this->NavigateManualInput(input);
 
+    //  Na polu liczbowym przejscie do nastepnej opcji nastepuje po zwolnieniu przycisku,
+    //  przytrzymanie przycisku zmienia wartosc pola (ProcessKeyEvent).
+    if ((input == KEYPAD_NEXT_KEY || input == KEYPAD_PREV_KEY) && this->input_index == 0)
+    {
+        int low, high;
+
+        if (this->GetFieldRange(this->setter_position, low, high))
+        {
+            this->held_key = input;
+            this->held_adjusted = false;
+            return SETTER_NOTHING;
+        }
+    }
+
     switch (input)
     {
         case KEYPAD_SELECT_KEY:
@@ -708,8 +877,44 @@ int DataSetter::ProcessInput(int input)
     return SETTER_NOTHING;
 }
 
+/*  Przetworzenie powtorzen i zwolnien przytrzymanych przyciskow.
+ *  @param event: Zdarzenie klawiatury.
+ *  @return: Indeks wykonanego procesu przez konfiguratora.
+ */
+int DataSetter::ProcessKeyEvent(KeypadEvent event)
+{
+    if (event.key != KEYPAD_NEXT_KEY && event.key != KEYPAD_PREV_KEY)
+        return SETTER_NOTHING;
+
+    int direction = event.key == KEYPAD_NEXT_KEY ? 1 : -1;
+
+    if (event.type == KEYPAD_EVENT_REPEAT)
+    {
+        //  Przytrzymany przycisk na polu liczbowym - zmiana wartosci z przyspieszeniem.
+        if (event.key == this->held_key)
+        {
+            this->held_adjusted = true;
+            this->AdjustValue(direction, event.repeats);
+            return SETTER_NOTHING;
+        }
+
+        //  Na pozostalych opcjach - automatyczne przewijanie listy.
+        return direction > 0 ? this->NavigateNext() : this->NavigatePrevious();
+    }
+
+    if (event.type == KEYPAD_EVENT_RELEASE && event.key == this->held_key)
+    {
+        this->held_key = KEYPAD_NO_KEY;
+
+        if (!this->held_adjusted)
+            return direction > 0 ? this->NavigateNext() : this->NavigatePrevious();
+    }
+
+    return SETTER_NOTHING;
+}
+
 //  ----------------------------------------------------------------------------
-//  Odswiezenie ekranu i ponowne wyswietlenie konfiguratora.
+//  Odswiezenie ekranu - najwyzej jedno przerysowanie pola danych na cykl petli.
 void DataSetter::UpdateDisplay()
 {
     if (this->IsManualInputAllowed() && this->edit_started)
@@ -717,10 +922,14 @@ void DataSetter::UpdateDisplay()
         bool _blink = this->controller->clock_ctrl->GetBlink();
 
         if (_blink != this->underline_blink)
+        {
             this->underline_blink = _blink;
-        
-        this->DisplaySetter(false, true);
+            this->redraw_pending = true;
+        }
     }
+
+    if (this->redraw_pending)
+        this->DisplaySetter(false, true);
 }
 
 #endif
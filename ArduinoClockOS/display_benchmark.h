@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////
+//  DISPLAY BENCHMARK
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISPLAY_BENCHMARK_H
+#define DISPLAY_BENCHMARK_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "display_controller.h"
+#include "profiler.h"
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_CLOCK_TICK          0
+#define BENCH_PAGE_SWITCH         1
+#define BENCH_SCROLL_200          2
+#define BENCH_MENU_REDRAW         3
+#define BENCH_TEXT_WIDTH          4
+#define BENCH_PRINT_DS_ALIGN      5
+#define BENCH_WORKLOADS           6
+
+#define BENCH_CLOCK_TICK_OPS      10
+#define BENCH_PAGE_SWITCH_OPS     6
+#define BENCH_SCROLL_LENGTH       200
+#define BENCH_SCROLL_OPS          64
+#define BENCH_MENU_REDRAW_OPS     8
+#define BENCH_TEXT_WIDTH_OPS      20
+#define BENCH_PRINT_DS_ALIGN_OPS  9
+
+#define BENCH_REPORT_SIZE         192
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class DisplayBenchmark
+{
+    private:
+        DisplayController * display_ctrl;
+        SerialController  * serial_ctrl;
+        int                 output_device;
+
+        int           ExecuteWorkload(int workload);
+        const char  * GetWorkloadName(int workload);
+        void          RunWorkload(int workload, bool last);
+
+    public:
+        DisplayBenchmark(DisplayController * display_ctrl, SerialController * serial_ctrl);
+
+        void  Run(int output_device);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Wykonanie scenariusza obciazenia wyswietlacza.
+ *  @param workload: Indeks scenariusza.
+ *  @return: Ilosc wykonanych operacji.
+ */
+int DisplayBenchmark::ExecuteWorkload(int workload)
+{
+    switch (workload)
+    {
+        //  Odswiezenie zegara co sekunde - wycentrowany tekst zmieniajacy ostatnia cyfre.
+        case BENCH_CLOCK_TICK:
+        {
+            DisplayString ds = DisplayString(FONT_DIGITAL, TEXT_ALIGN_CENTER, "");
+            ds._xpos = this->display_ctrl->GetWidth() / 2;
+
+            for (int op = 0; op < BENCH_CLOCK_TICK_OPS; op++)
+            {
+                ds.text = "12:3";
+                ds.text.AppendNumber(op % 10);
+                this->display_ctrl->PrintDS(&ds, false);
+            }
+
+            return BENCH_CLOCK_TICK_OPS;
+        }
+
+        //  Zmiana strony trybu normalnego - wyczyszczenie, ikona i tekst.
+        case BENCH_PAGE_SWITCH:
+            for (int op = 0; op < BENCH_PAGE_SWITCH_OPS; op++)
+            {
+                this->display_ctrl->Clear();
+                this->display_ctrl->DrawSprite(SPRITE_HOME, 0, 0);
+                this->display_ctrl->PrintText_P(FONT_DIGITAL, 9, op % 2 == 0 ? PSTR("In 23.5 C") : PSTR("Out -4.0 C"));
+            }
+
+            return BENCH_PAGE_SWITCH_OPS;
+
+        //  Przewijanie wiadomosci 200 znakow - kolejne kroki jak w MessageController.
+        case BENCH_SCROLL_200:
+        {
+            String message = "";
+            int position = this->display_ctrl->GetWidth();
+            int shift = 0;
+
+            message.reserve(BENCH_SCROLL_LENGTH);
+
+            for (int c = 0; c < BENCH_SCROLL_LENGTH; c++)
+                message += (char) ('A' + (c % 26));
+
+            for (int op = 0; op < BENCH_SCROLL_OPS; op++)
+            {
+                this->display_ctrl->PrintMessage(FONT_DIGITAL, position, 9, message, shift);
+
+                if (position > 9)
+                    position -= 1;
+            }
+
+            return BENCH_SCROLL_OPS;
+        }
+
+        //  Przerysowanie menu - wyczyszczenie, ikona i etykieta.
+        case BENCH_MENU_REDRAW:
+            for (int op = 0; op < BENCH_MENU_REDRAW_OPS; op++)
+            {
+                this->display_ctrl->Clear();
+                this->display_ctrl->DrawSprite(op % 2 == 0 ? SPRITE_SETTINGS : SPRITE_CLOCK, 0, 0);
+                this->display_ctrl->PrintText_P(FONT_DIGITAL, 10, op % 2 == 0 ? PSTR("Settings") : PSTR("Brightness"));
+            }
+
+            return BENCH_MENU_REDRAW_OPS;
+
+        //  Obliczanie szerokosci tekstu (bez zapisow do wyswietlacza).
+        case BENCH_TEXT_WIDTH:
+        {
+            int width = 0;
+
+            for (int op = 0; op < BENCH_TEXT_WIDTH_OPS; op++)
+                width += this->display_ctrl->GetTextWidth(FONT_DIGITAL, "Wednesday 12.05.2021");
+
+            return width > 0 ? BENCH_TEXT_WIDTH_OPS : 1;
+        }
+
+        //  Wyswietlanie tekstu z wyrownaniem do lewej, srodka i prawej.
+        case BENCH_PRINT_DS_ALIGN:
+            for (int op = 0; op < BENCH_PRINT_DS_ALIGN_OPS; op++)
+            {
+                int align = op % 3;
+                DisplayString ds = DisplayString(FONT_DIGITAL, align, "21.08.2021");
+
+                if (align == TEXT_ALIGN_CENTER)
+                    ds._xpos = this->display_ctrl->GetWidth() / 2;
+                else if (align == TEXT_ALIGN_RIGHT)
+                    ds._xpos = this->display_ctrl->GetLastColumnIndex();
+
+                this->display_ctrl->PrintDS(&ds, true);
+            }
+
+            return BENCH_PRINT_DS_ALIGN_OPS;
+    }
+
+    return 1;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie nazwy scenariusza obciazenia.
+ *  @param workload: Indeks scenariusza.
+ *  @return: Nazwa scenariusza (w pamieci programu).
+ */
+const char * DisplayBenchmark::GetWorkloadName(int workload)
+{
+    switch (workload)
+    {
+        case BENCH_CLOCK_TICK:      return PSTR("clock_tick");
+        case BENCH_PAGE_SWITCH:     return PSTR("page_switch");
+        case BENCH_SCROLL_200:      return PSTR("scroll_200");
+        case BENCH_MENU_REDRAW:     return PSTR("menu_redraw");
+        case BENCH_TEXT_WIDTH:      return PSTR("text_width");
+        case BENCH_PRINT_DS_ALIGN:  return PSTR("print_ds_align");
+        default:                    return PSTR("?");
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wykonanie scenariusza z pomiarem czasu i licznikow oraz wyslanie wyniku (obiekt JSON).
+ *  @param workload: Indeks scenariusza.
+ *  @param last: Informacja czy jest to ostatni element tablicy wynikow.
+ */
+void DisplayBenchmark::RunWorkload(int workload, bool last)
+{
+    char name[20];
+    char buffer[BENCH_REPORT_SIZE];
+
+    this->display_ctrl->Clear();
+    this->display_ctrl->ResetCounters();
+
+    unsigned long start_time = micros();
+    int ops = this->ExecuteWorkload(workload);
+    unsigned long elapsed = micros() - start_time;
+
+    DisplayCounters counters = this->display_ctrl->GetCounters();
+
+    strncpy_P(name, this->GetWorkloadName(workload), sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    snprintf_P(buffer, sizeof(buffer),
+        PSTR("{\"name\":\"%s\",\"ops\":%d,\"us\":%lu,\"us_per_op\":%lu,\"register_writes\":%lu,\"bytes_shifted\":%lu,\"latches\":%lu,\"memcpy_p\":%lu}%s"),
+        name,
+        ops,
+        elapsed,
+        elapsed / ops,
+        counters.register_writes,
+        counters.bytes_shifted,
+        counters.latches,
+        counters.memcpy_p,
+        last ? "" : ",");
+
+    this->serial_ctrl->WriteRawData(buffer, this->output_device);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy testu wydajnosci wyswietlacza.
+ *  @param display_ctrl: Kontroler wyswietlacza.
+ *  @param serial_ctrl: Kontroler polaczenia szeregowego (wyniki).
+ */
+DisplayBenchmark::DisplayBenchmark(DisplayController * display_ctrl, SerialController * serial_ctrl)
+{
+    this->display_ctrl = display_ctrl;
+    this->serial_ctrl = serial_ctrl;
+    this->output_device = SERIAL_COM;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wykonanie wszystkich scenariuszy i wyslanie wynikow w formacie JSON.
+ *  @param output_device: Typ urzadzenia do ktorego wyniki zostana wyslane.
+ */
+void DisplayBenchmark::Run(int output_device)
+{
+    this->output_device = output_device;
+
+#if PROFILER_ENABLED
+    this->serial_ctrl->WriteFormat_P(output_device, SERIAL_PRIORITY_RESPONSE,
+        PSTR("{\"bench\":\"display\",\"segments\":%d,\"results\":["), this->display_ctrl->GetWidth() / DISPLAY_SEGMENT_WIDTH);
+
+    for (int workload = 0; workload < BENCH_WORKLOADS; workload++)
+        this->RunWorkload(workload, workload == BENCH_WORKLOADS - 1);
+
+    this->serial_ctrl->WriteRawData_P(PSTR("]}"), output_device);
+    this->display_ctrl->Clear();
+#else
+    this->serial_ctrl->WriteRawData_P(PSTR("{\"bench\":\"display\",\"error\":\"profiler disabled\"}"), output_device);
+#endif
+}
+
+#endif
@@ -10,6 +10,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <MaxMatrix.h>
+#include "board_profile.h"
+#include "fixed_string.h"
+#include "profiler.h"
+#include "static_instance.h"
 #include "src/fonts.h"
 #include "src/sprites.h"
 
@@ -20,16 +24,22 @@
 
 #define FONT_DIGITAL              0
 
-#define DISPLAY_INIT_DELAY        1000
+#define DISPLAY_INIT_DELAY        10        //  Stabilizacja matryc po konfiguracji [ms].
 #define DISPLAY_MIN_BRIGHTNESS    0
 #define DISPLAY_MAX_BRIGHTNESS    8
-#define DISPLAY_PIN_CLK           10
-#define DISPLAY_PIN_CS            11
-#define DISPLAY_PIN_DIN           12
+#define DISPLAY_REG_SHUTDOWN      0x0C      //  Rejestr trybu uspienia MAX7219 (0 - uspienie, 1 - praca).
+#define DISPLAY_PIN_CLK           Board::DISPLAY_PIN_CLK
+#define DISPLAY_PIN_CS            Board::DISPLAY_PIN_CS
+#define DISPLAY_PIN_DIN           Board::DISPLAY_PIN_DIN
 #define DISPLAY_SEGMETNS          1
 #define DISPLAY_SEGMENT_HEIGHT    8
 #define DISPLAY_SEGMENT_WIDTH     8
 
+#define DISPLAY_FRAME_BUFFERS     2
+#define DISPLAY_FRAME_SIZE        64
+
+#define DISPLAY_TEXT_SIZE         32
+
 #define TEXT_ALIGN_LEFT           0
 #define TEXT_ALIGN_CENTER         1
 #define TEXT_ALIGN_RIGHT          2
@@ -49,7 +59,8 @@ struct DisplayString
     int offset      =   0;
     int step_delay  =   0;
     int text_align  =   TEXT_ALIGN_LEFT;
-    String text     =   "";
+    int suffix_width =  0;      //  Miejsce za tekstem (np. na obrazek) wliczane do _width.
+    FixedString<DISPLAY_TEXT_SIZE> text;
 
     //  --- METHODS: ---
     DisplayString()
@@ -64,12 +75,13 @@ struct DisplayString
      *  @param text: Tekst ktory ma zostac wyswietlony.
      *  @param step_delay: Czas oczekiwania w milisekundach pomiedzy wyswietlaniem pojedynczych znakow.
      */
-    DisplayString(int font, int offset, int text_align, String text, int step_delay)
+    DisplayString(int font, int offset, int text_align, const char * text, int step_delay)
     {
         this->font = font;
         this->offset = offset;
         this->text_align = max(TEXT_ALIGN_LEFT, min(text_align, TEXT_ALIGN_RIGHT));
         this->text = text;
+        this->step_delay = step_delay;
     }
 
     /*  Konstruktor struktury tekstu wyswietlacza - prosty.
@@ -78,7 +90,7 @@ struct DisplayString
      *  @param text_align: Wyrownanie tekstu do okreslonej pozycji na ekranie.
      *  @param text: Tekst ktory ma zostac wyswietlony.
      */
-    DisplayString(int font, int text_align, String text)
+    DisplayString(int font, int text_align, const char * text)
     {
         this->font = font;
         this->text_align = max(TEXT_ALIGN_LEFT, min(text_align, TEXT_ALIGN_RIGHT));
@@ -86,6 +98,15 @@ struct DisplayString
     }
 };
 
+//  Liczniki operacji wyswietlacza (aktualizowane gdy PROFILER_ENABLED).
+struct DisplayCounters
+{
+    unsigned long   register_writes;    //  Zapisy rejestrow MAX7219 (suma dla wszystkich segmentow).
+    unsigned long   bytes_shifted;      //  Bajty wyslane przez linie DIN.
+    unsigned long   latches;            //  Cykle zatrzasku (CS LOW -> HIGH).
+    unsigned long   memcpy_p;           //  Kopiowania znakow i obrazkow z pamieci programu.
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
@@ -95,16 +116,30 @@ class DisplayController
 {
     private:
         MaxMatrix *base;
+
+        StaticInstance<MaxMatrix> base_instance;
         
         bool  custom_segmentation  =  false;
         bool  initialized          =  false;
         byte  buffer[10]           =  { 0, 0, B00000000, B00000000, B00000000, B00000000, B00000000, B00000000, B00000000, B00000000 };
         int   brightness           =  DISPLAY_MIN_BRIGHTNESS;
+        bool  shutdown             =  false;
         int   segments             =  DISPLAY_SEGMETNS;
 
+        byte  frame_buffers[DISPLAY_FRAME_BUFFERS][DISPLAY_FRAME_SIZE];
+        byte  front_frame          =  0;
+
+        DisplayCounters counters;
+
+        void  CountSprite(int x, int width);
+        void  CountWrites(int latches);
+        void  ShadowColumn(int column, byte value, byte mask);
+        void  ShadowSprite(int x, const byte *sprite);
+        void  ShiftOut(byte value);
         const byte  *GetMappedFont(int font);
         void  Initialize();
         void  LoadCharacter(int font, int char_index);
+        void  WriteFrame(const byte *frame);
 
         void  PrintDSCenter(DisplayString *ds, bool force_clear);
         void  PrintDSLeft(DisplayString *ds, bool force_clear);
@@ -115,6 +150,8 @@ class DisplayController
         
         int     GetBrightness();
         void    SetBrightness(int brightness);
+        bool    IsShutdown();
+        void    SetShutdown(bool shutdown);
 
         int     GetLastColumnIndex();
         int     GetWidth();
@@ -124,28 +161,115 @@ class DisplayController
         void    ClearColumn(int column_index);
         void    ClearRange(int first_col_index, int last_col_index, int step_delay = 0);
 
+        void    DrawColumn(int column_index, byte value);
         void    DrawPoint(int x, int y, int value);
         int     DrawSprite(const byte *sprite, int x, int sprite_index);
         int     PrintChar(int font, int x, char character);
         int     PrintCharWithShift(int font, int x, char character, int shift = 0);
+        int     PrintText(int font, int x, const char * text, int step_delay);
         int     PrintText(int font, int x, String text, int step_delay);
+        int     PrintText_P(int font, int x, const char * text, int step_delay = 0);
         int     PrintMessage(int font, int x, int last_x, String & message, int & shift, int step_delay = 0);
 
+        int     GetTextWidth(int font, const char * text);
         int     GetTextWidth(int font, String text);
+        int     GetTextWidth_P(int font, const char * text);
         String  ClampText(int font, String text, int *width, int first_char, int left_offset, int right_offset);
         
         void    ClearDS(DisplayString *ds);
         void    PrintDS(DisplayString *ds, bool force_clear = true);
+
+        byte  * GetBackFrame();
+        byte  * GetFrontFrame();
+        int     GetFrameSize();
+        void    SwapFrames();
+
+        DisplayCounters GetCounters();
+        void            ResetCounters();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** PRIVATE METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+/* Zliczenie zapisow kolumn wykonanych przez MaxMatrix::writeSprite (kolumny 0..79).
+ * @param x: Indeks pierwszej kolumny obrazka.
+ * @param width: Szerokosc obrazka w kolumnach.
+ */
+void DisplayController::CountSprite(int x, int width)
+{
+#if PROFILER_ENABLED
+    int first = max(0, x);
+    int last = min(x + width, 80);
+
+    if (last > first)
+        this->CountWrites(last - first);
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+/* Zliczenie cykli zatrzasku wyswietlacza. Kazdy cykl wysyla pare (rejestr, wartosc)
+ * do kazdego segmentu w lancuchu.
+ * @param latches: Ilosc cykli zatrzasku.
+ */
+void DisplayController::CountWrites(int latches)
+{
+#if PROFILER_ENABLED
+    this->counters.latches += latches;
+    this->counters.register_writes += (unsigned long) latches * this->segments;
+    this->counters.bytes_shifted += (unsigned long) latches * this->segments * 2;
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+/* Odwzorowanie zapisu kolumny w buforze aktualnie wyswietlanej ramki.
+ * Bufor ramki odpowiada zawartosci wyswietlacza (bufor MaxMatrix nie jest dostepny).
+ * @param column: Indeks kolumny ekranu.
+ * @param value: Nowa wartosc kolumny (bit 0 - gorny wiersz).
+ * @param mask: Maska zmienianych bitow kolumny.
+ */
+void DisplayController::ShadowColumn(int column, byte value, byte mask)
+{
+    if (column < 0 || column >= this->GetFrameSize())
+        return;
+    
+    byte * frame = this->GetFrontFrame();
+    frame[column] = (frame[column] & ~mask) | (value & mask);
+}
+
+//  ----------------------------------------------------------------------------
+/* Odwzorowanie zapisu obrazka (MaxMatrix::writeSprite) w buforze wyswietlanej ramki.
+ * @param x: Indeks pierwszej kolumny obrazka.
+ * @param sprite: Obrazek - szerokosc, wysokosc i kolejne kolumny.
+ */
+void DisplayController::ShadowSprite(int x, const byte *sprite)
+{
+    byte mask = sprite[1] >= DISPLAY_SEGMENT_HEIGHT ? 0xFF : (1 << sprite[1]) - 1;
+
+    for (int i = 0; i < sprite[0]; i++)
+        this->ShadowColumn(x + i, sprite[i + 2], mask);
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie bajtu do wyswietlacza (MSB first) bezposrednio przez rejestry portow.
+ * Odpowiednik shiftOut dla pinow znanych w czasie kompilacji.
+ * @param value: Wysylany bajt.
+ */
+void DisplayController::ShiftOut(byte value)
+{
+    for (byte bit = 0x80; bit != 0; bit >>= 1)
+    {
+        Board::DisplayDin::Write(value & bit);
+        Board::DisplayClk::High();
+        Board::DisplayClk::Low();
+    }
+}
+
+//  ----------------------------------------------------------------------------
 //  Inicjalizacja wyswietla i jego podstawowa konfiguracje.
 void DisplayController::Initialize()
 {
-    this->base = new MaxMatrix(
+    this->base = this->base_instance.Create(
         DISPLAY_PIN_DIN,  //  Data input
         DISPLAY_PIN_CS,   //  Chip select
         DISPLAY_PIN_CLK,  //  Clock
@@ -161,6 +285,7 @@ void DisplayController::Initialize()
 
     //  Ustawienie poczatkowej jasnosci wyswietlacza.
     this->base->setIntensity(this->brightness);
+    this->CountWrites(1);
 }
 
 //  ----------------------------------------------------------------------------
@@ -186,6 +311,42 @@ const byte * DisplayController::GetMappedFont(int font)
 void DisplayController::LoadCharacter(int font, int char_index)
 {
     memcpy_P(this->buffer, this->GetMappedFont(font) + ((char_index - 32) * 10), 10);
+
+#if PROFILER_ENABLED
+    this->counters.memcpy_p++;
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie calej ramki obrazu do wyswietlacza z pominieciem renderowania znakow.
+ * Kazdy rejestr cyfry (kolumna w segmencie) jest wysylany jednoczesnie do wszystkich
+ * segmentow, co daje 8 cykli zatrzasku zamiast jednego na kazda kolumne.
+ * @param frame: Ramka obrazu - jeden bajt na kolumne (bit 0 - gorny wiersz).
+ */
+void DisplayController::WriteFrame(const byte *frame)
+{
+    if (!this->initialized)
+        return;
+
+    int frame_segments = min(this->segments, DISPLAY_FRAME_SIZE / DISPLAY_SEGMENT_WIDTH);
+
+    for (int digit = 0; digit < DISPLAY_SEGMENT_WIDTH; digit++)
+    {
+        Board::DisplayCs::Low();
+
+        //  Pierwszy wyslany bajt trafia do ostatniego segmentu w lancuchu (jak w MaxMatrix::setColumn).
+        for (int segment = 0; segment < this->segments; segment++)
+        {
+            byte value = segment < frame_segments ? frame[segment * DISPLAY_SEGMENT_WIDTH + digit] : 0;
+
+            this->ShiftOut(digit + 1);
+            this->ShiftOut(value);
+        }
+
+        Board::DisplayCs::High();
+    }
+
+    this->CountWrites(DISPLAY_SEGMENT_WIDTH);
 }
 
 //  ----------------------------------------------------------------------------
@@ -201,7 +362,7 @@ void DisplayController::PrintDSCenter(DisplayString *ds, bool force_clear = true
     int prev_width = ds->_width;
 
     //  Obliczenie pozycji startowej tekstu i jego dlugosc.
-    ds->_width = this->GetTextWidth(ds->font, ds->text);
+    ds->_width = this->GetTextWidth(ds->font, ds->text.c_str()) + ds->suffix_width;
     ds->_xpos = (display_width/2) - (ds->_width/2) + ds->offset;
 
     //  Wyczyszczenie poprzedniego tekstu (od lewej) jezeli flaga czyszczenia jest aktywna.
@@ -209,7 +370,7 @@ void DisplayController::PrintDSCenter(DisplayString *ds, bool force_clear = true
         this->ClearRange(prev_xpos, ds->_xpos);
 
     //  Wyswietlenie tekstu na ekranie.
-    this->PrintText(ds->font, ds->_xpos, ds->text, ds->step_delay);
+    this->PrintText(ds->font, ds->_xpos, ds->text.c_str(), ds->step_delay);
 
     //  Wyczyszczenie poprzedniego tekstu (od prawej) jezeli flaga czyszczenia jest aktywna.
     if (force_clear && ds->_xpos + ds->_width < prev_xpos + prev_width)
@@ -236,7 +397,7 @@ void DisplayController::PrintDSLeft(DisplayString *ds, bool force_clear = true)
         this->ClearRange(prev_xpos, ds->_xpos);
 
     //  Wyswietlenie tekstu na ekranie i obliczenie jego dlugosci.
-    ds->_width = this->PrintText(ds->font, ds->_xpos, ds->text, ds->step_delay);
+    ds->_width = this->PrintText(ds->font, ds->_xpos, ds->text.c_str(), ds->step_delay) + ds->suffix_width;
 
     //  Wyczyszczenie poprzedniego tekstu (od prawej) jezeli flaga czyszczenia jest aktywna.
     if (force_clear && ds->_xpos + ds->_width < prev_xpos + prev_width)
@@ -256,7 +417,7 @@ void DisplayController::PrintDSRight(DisplayString *ds, bool force_clear = true)
     int prev_width = ds->_width;
 
     //  Obliczenie pozycji startowej tekstu i jego dlugosc.
-    ds->_width = this->GetTextWidth(ds->font, ds->text);
+    ds->_width = this->GetTextWidth(ds->font, ds->text.c_str()) + ds->suffix_width;
     ds->_xpos = max(0, display_width - ds->_width - ds->offset);
     
     //  Wyczyszczenie poprzedniego tekstu (od lewej) jezeli flaga czyszczenia jest aktywna.
@@ -264,7 +425,7 @@ void DisplayController::PrintDSRight(DisplayString *ds, bool force_clear = true)
         this->ClearRange(prev_xpos, ds->_xpos);
 
     //  Wyswietlenie tekstu na ekranie i obliczenie jego dlugosci.
-    this->PrintText(ds->font, ds->_xpos, ds->text, ds->step_delay);
+    this->PrintText(ds->font, ds->_xpos, ds->text.c_str(), ds->step_delay);
 
     //  Wyczyszczenie poprzedniego tekstu (od prawej) jezeli flaga czyszczenia jest aktywna.
     if (force_clear && ds->_xpos + ds->_width < prev_xpos + prev_width)
@@ -286,6 +447,9 @@ DisplayController::DisplayController(
   int segments = DISPLAY_SEGMETNS)
 {
     this->segments = max(1, segments);
+
+    memset(this->frame_buffers, 0, sizeof(this->frame_buffers));
+    memset(&this->counters, 0, sizeof(this->counters));
     
     this->SetBrightness(brightness);
     this->Initialize();
@@ -311,7 +475,34 @@ void DisplayController::SetBrightness(int brightness = DISPLAY_MIN_BRIGHTNESS)
 
     //  Ustawienie nowej wartosci wyswietlacza jezeli zainicjalizowany.
     if (this->initialized)
+    {
         this->base->setIntensity(this->brightness);
+        this->CountWrites(1);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy wyswietlacz jest uspiony.
+ * @return: True - wyswietlacz uspiony (rejestr shutdown); False - w innym przypadku.
+ */
+bool DisplayController::IsShutdown()
+{
+    return this->shutdown;
+}
+
+//  ----------------------------------------------------------------------------
+/* Uspienie lub wybudzenie wyswietlacza rejestrem shutdown MAX7219. W uspieniu diody sa
+ * wygaszone, a zawartosc pamieci ukladu pozostaje bez zmian.
+ * @param shutdown: True - uspienie wyswietlacza; False - wybudzenie.
+ */
+void DisplayController::SetShutdown(bool shutdown)
+{
+    if (!this->initialized || this->shutdown == shutdown)
+        return;
+
+    this->shutdown = shutdown;
+    this->base->setCommand(DISPLAY_REG_SHUTDOWN, shutdown ? 0 : 1);
+    this->CountWrites(1);
 }
 
 //  ----------------------------------------------------------------------------
@@ -347,7 +538,11 @@ void DisplayController::Clear()
 {
     //  Wyczyszczenie ekranu jezeli jest zainicjalizowany.
     if (this->initialized)
+    {
         this->base->clear();
+        this->CountWrites(DISPLAY_SEGMENT_WIDTH);
+        memset(this->GetFrontFrame(), 0, DISPLAY_FRAME_SIZE);
+    }
 }
 
 //  ----------------------------------------------------------------------------
@@ -362,7 +557,30 @@ void DisplayController::ClearColumn(int column_index)
 
     //  Wyczyszczenie wybranej kolumny ekranu jezeli jest zainicjalizowany.
     if (this->initialized)
+    {
         this->base->setColumn(column_index, 0);
+        this->CountWrites(1);
+        this->ShadowColumn(column_index, 0, 0xFF);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Narysowanie calej kolumny ekranu.
+ * @param column_index: Indeks kolumny.
+ * @param value: Wartosc kolumny (bit 0 - gorny wiersz).
+ */
+void DisplayController::DrawColumn(int column_index, byte value)
+{
+    //  Sprawdzenie czy wybrany indeks kolumny nie wykracza poza granice ekranu.
+    if (column_index < 0 || column_index > this->GetLastColumnIndex())
+        return;
+
+    if (this->initialized)
+    {
+        this->base->setColumn(column_index, value);
+        this->CountWrites(1);
+        this->ShadowColumn(column_index, value, 0xFF);
+    }
 }
 
 //  ----------------------------------------------------------------------------
@@ -384,6 +602,8 @@ void DisplayController::ClearRange(int first_col_index, int last_col_index, int
         {
             //  Wyczyszczenie kolumny ekranu.
             this->base->setColumn(col, 0);
+            this->CountWrites(1);
+            this->ShadowColumn(col, 0, 0xFF);
 
             //  Opoznienie po wyczyszczeniu kolumny ekranu.
             if (step_delay > 0)
@@ -410,7 +630,11 @@ void DisplayController::DrawPoint(int x, int y, int value)
 
     //  Narysowanie badz wyczyszczenie punktu na ekranie jezeli zostal zainicjalizowany.
     if (this->initialized)
+    {
         this->base->setDot(x, y, max(0, min(value, 1)));
+        this->CountWrites(1);
+        this->ShadowColumn(x, value > 0 ? 0xFF : 0, 1 << y);
+    }
 }
 
 //  ----------------------------------------------------------------------------
@@ -425,10 +649,16 @@ int DisplayController::DrawSprite(const byte *sprite, int x, int sprite_index)
     //  Zaladowanie obrazka do pamieci podrecznej.
     memcpy_P(this->buffer, sprite + (sprite_index * 10), 10);
 
+#if PROFILER_ENABLED
+    this->counters.memcpy_p++;
+#endif
+
     //  Narysowanie obrazka na ekranie jezeli zostal zainicjalizowany.
     if (this->initialized)
     {
         this->base->writeSprite(x, 0, this->buffer);
+        this->CountSprite(x, this->buffer[0]);
+        this->ShadowSprite(x, this->buffer);
         return this->buffer[0];
     }
 
@@ -468,6 +698,8 @@ int DisplayController::PrintChar(int font, int x, char character)
                 //  Wyswietlenie fragmentu znaku na segmencie ekranu.
                 this->buffer[0] = prnt;
                 this->base->writeSprite(xpos, 0, this->buffer);
+                this->CountSprite(xpos, prnt);
+                this->ShadowSprite(xpos, this->buffer);
 
                 //  Oblicznie pozycji nastepnego fragmentu znaku.
                 xpos = xpos + comp;
@@ -488,11 +720,15 @@ int DisplayController::PrintChar(int font, int x, char character)
         else
         {
             this->base->writeSprite(x, 0, this->buffer);
+            this->CountSprite(x, this->buffer[0]);
+            this->ShadowSprite(x, this->buffer);
             return this->buffer[0];
         }
 
         return 0;
     }
+
+    return 0;
 }
 
 //  ----------------------------------------------------------------------------
@@ -545,6 +781,8 @@ int DisplayController::PrintCharWithShift(int font, int x, char character, int s
             //  Wyswietlenie fragmentu znaku na segmencie ekranu.
             this->buffer[0] = prnt;
             this->base->writeSprite(xpos, 0, this->buffer);
+            this->CountSprite(xpos, prnt);
+            this->ShadowSprite(xpos, this->buffer);
 
             //  Oblicznie pozycji nastepnego fragmentu znaku.
             xpos = xpos + comp;
@@ -560,6 +798,8 @@ int DisplayController::PrintCharWithShift(int font, int x, char character, int s
 
         return char_width - shift;
     }
+
+    return 0;
 }
 
 //  ----------------------------------------------------------------------------
@@ -569,7 +809,7 @@ int DisplayController::PrintCharWithShift(int font, int x, char character, int s
  * @param text: Tekst ktory ma zostac wyswietlony.
  * @param step_delay: Czas oczekiwania w milisekundach po wyswietleniu pojedynczego znaku.
  */
-int DisplayController::PrintText(int font, int x, String text, int step_delay = 0)
+int DisplayController::PrintText(int font, int x, const char * text, int step_delay = 0)
 {
     //  Wstepna konfiguracja zmiennych roboczych.
     int xpos = x;
@@ -578,7 +818,7 @@ int DisplayController::PrintText(int font, int x, String text, int step_delay =
     //  Wyswietlenie tekstu na ekranie jezeli zostal zainicjalizowany.
     if (this->initialized)
     {
-        for (int c = 0; c < text.length(); c++)
+        for (int c = 0; text[c] != '\0'; c++)
         {
             //  Wyswietlenie pojedynczego znaku na ekranie.
             int char_width = this->PrintChar(font, xpos, text[c]);
@@ -599,6 +839,33 @@ int DisplayController::PrintText(int font, int x, String text, int step_delay =
     return result_width;
 }
 
+//  ----------------------------------------------------------------------------
+/* Wyswietlenie tekstu na ekranie.
+ * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
+ * @param x: Indeks kolumny ekranu od ktorej text ma zostac wyswietlony w prawo.
+ * @param text: Tekst ktory ma zostac wyswietlony.
+ * @param step_delay: Czas oczekiwania w milisekundach po wyswietleniu pojedynczego znaku.
+ */
+int DisplayController::PrintText(int font, int x, String text, int step_delay = 0)
+{
+    return this->PrintText(font, x, text.c_str(), step_delay);
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyswietlenie tekstu zapisanego w pamieci programu (PSTR) na ekranie.
+ * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
+ * @param x: Indeks kolumny ekranu od ktorej text ma zostac wyswietlony w prawo.
+ * @param text: Tekst w pamieci programu (do DISPLAY_TEXT_SIZE znakow).
+ * @param step_delay: Czas oczekiwania w milisekundach po wyswietleniu pojedynczego znaku.
+ */
+int DisplayController::PrintText_P(int font, int x, const char * text, int step_delay = 0)
+{
+    FixedString<DISPLAY_TEXT_SIZE> buffer;
+
+    buffer.Append_P(text);
+    return this->PrintText(font, x, buffer.c_str(), step_delay);
+}
+
 //  ----------------------------------------------------------------------------
 /* Wyswietlenie wiadomosci na ekranie.
  * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
@@ -618,7 +885,7 @@ int DisplayController::PrintMessage(int font, int x, int last_x, String & messag
     //  Wyswietlenie tekstu na ekranie jezeli zostal zainicjalizowany.
     if (this->initialized)
     {
-        for (int c = 0; c < message.length(); c++)
+        for (int c = 0; c < (int) message.length(); c++)
         {
             //  Wyswietlenie pojedynczego znaku na ekranie.
             int current_shift = c == 0 ? shift : 0;
@@ -638,6 +905,10 @@ int DisplayController::PrintMessage(int font, int x, int last_x, String & messag
             //  Wyjscie z petli kiedy pozycja znajduje sie poza rozmiarem wyswietlacza.
             if (xpos > this->GetWidth())
                 break;
+
+            //  Opoznienie po wyswietleniu pojedynczego znaku na ekranie.
+            if (step_delay > 0)
+                delay(step_delay);
         }
     }
 
@@ -660,12 +931,12 @@ int DisplayController::PrintMessage(int font, int x, int last_x, String & messag
  * @param text: Tekst którego długosc ma zostac obliczona.
  * @return: Dlugosc tekstu, ile zajmie jego wyswietlenie na ekranie.
  */
-int DisplayController::GetTextWidth(int font, String text)
+int DisplayController::GetTextWidth(int font, const char * text)
 {
     //  Wstepna konfiguracja zmiennych roboczych.
     int result_width = 0;
 
-    for (int c = 0; c < text.length(); c++)
+    for (int c = 0; text[c] != '\0'; c++)
     {
         //  Zaladowanie znaku do pamieci podrecznej.
         this->LoadCharacter(font, text[c]);
@@ -674,7 +945,7 @@ int DisplayController::GetTextWidth(int font, String text)
         result_width = result_width + buffer[0];
 
         //  Dodanie odstepu miedzy znakami.
-        if (c != (text.length() - 1))
+        if (text[c + 1] != '\0')
         {
             result_width = result_width + 1;
         }
@@ -683,6 +954,31 @@ int DisplayController::GetTextWidth(int font, String text)
     return result_width;
 }
 
+//  ----------------------------------------------------------------------------
+/* Obliczenie dlugosci tekstu, ile zajmie jego wyswietlenie na ekranie.
+ * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
+ * @param text: Tekst którego długosc ma zostac obliczona.
+ * @return: Dlugosc tekstu, ile zajmie jego wyswietlenie na ekranie.
+ */
+int DisplayController::GetTextWidth(int font, String text)
+{
+    return this->GetTextWidth(font, text.c_str());
+}
+
+//  ----------------------------------------------------------------------------
+/* Obliczenie dlugosci tekstu zapisanego w pamieci programu (PSTR).
+ * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
+ * @param text: Tekst w pamieci programu (do DISPLAY_TEXT_SIZE znakow).
+ * @return: Dlugosc tekstu, ile zajmie jego wyswietlenie na ekranie.
+ */
+int DisplayController::GetTextWidth_P(int font, const char * text)
+{
+    FixedString<DISPLAY_TEXT_SIZE> buffer;
+
+    buffer.Append_P(text);
+    return this->GetTextWidth(font, buffer.c_str());
+}
+
 //  ----------------------------------------------------------------------------
 /* Obciecie tekstu do wybranego wolnego miejsca na ekranie.
  * @param font: Indeks tablicay zawierajacej czcionke w jakiej tekst ma zostac wyswietlony na ekranie.
@@ -708,7 +1004,7 @@ String DisplayController::ClampText(int font, String text, int *width, int first
         return "";
 
     //  Obciecie tekstu do wybranego wolnego miejsca na ekranie.
-    for (int c = min(first_char, text.length()); c < text.length(); c++)
+    for (int c = min(first_char, (int) text.length()); c < (int) text.length(); c++)
     {
         //  Zaladowanie znaku do pamieci podrecznej.
         this->LoadCharacter(font, text[c]);
@@ -750,7 +1046,7 @@ void DisplayController::ClearDS(DisplayString *ds)
     ds->_width = 0;
     ds->offset = 0;
     ds->step_delay = 0;
-    ds->text = "";
+    ds->text.Clear();
 }
 
 //  ----------------------------------------------------------------------------
@@ -784,4 +1080,55 @@ void DisplayController::PrintDS(DisplayString *ds, bool force_clear = true)
     }
 }
 
+//  ----------------------------------------------------------------------------
+/* Pobranie bufora ramki do ktorego zapisywana jest kolejna klatka obrazu.
+ * @return: Wskaznik do bufora ramki (GetFrameSize() bajtow, jeden bajt na kolumne).
+ */
+byte * DisplayController::GetBackFrame()
+{
+    return this->frame_buffers[(this->front_frame + 1) % DISPLAY_FRAME_BUFFERS];
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie bufora ramki aktualnie wyswietlanej na ekranie.
+ * @return: Wskaznik do bufora ramki (GetFrameSize() bajtow, jeden bajt na kolumne).
+ */
+byte * DisplayController::GetFrontFrame()
+{
+    return this->frame_buffers[this->front_frame];
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie rozmiaru bufora ramki w bajtach (kolumnach).
+ * @return: Rozmiar bufora ramki.
+ */
+int DisplayController::GetFrameSize()
+{
+    return min(this->GetWidth(), DISPLAY_FRAME_SIZE);
+}
+
+//  ----------------------------------------------------------------------------
+//  Zamiana buforow ramek i wyswietlenie nowej klatki obrazu na ekranie.
+void DisplayController::SwapFrames()
+{
+    this->front_frame = (this->front_frame + 1) % DISPLAY_FRAME_BUFFERS;
+    this->WriteFrame(this->frame_buffers[this->front_frame]);
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie licznikow operacji wyswietlacza.
+ * @return: Liczniki operacji od ostatniego wyzerowania.
+ */
+DisplayCounters DisplayController::GetCounters()
+{
+    return this->counters;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyzerowanie licznikow operacji wyswietlacza.
+void DisplayController::ResetCounters()
+{
+    memset(&this->counters, 0, sizeof(this->counters));
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,456 @@
+////////////////////////////////////////////////////////////////////////////////
+//  FIXED STRING
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define FIXED_STRING_NUMBER_SIZE    12  //  Najdluzsza liczba typu long ze znakiem.
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCT DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Fragment tekstu bez kopiowania danych (wskaznik do tekstu zrodlowego i dlugosc).
+struct FixedStringView
+{
+    //  --- VARIABLES: ---
+    const char  * data      =   NULL;
+    int           length    =   0;
+
+    //  --- METHODS: ---
+    FixedStringView()
+    {
+        //
+    }
+
+    /*  Konstruktor fragmentu tekstu.
+     *  @param data: Wskaznik do pierwszego znaku fragmentu.
+     *  @param length: Ilosc znakow fragmentu.
+     */
+    FixedStringView(const char * data, int length)
+    {
+        this->data = data;
+        this->length = length;
+    }
+
+    /*  Porownanie fragmentu z tekstem bez uwzglednienia wielkosci liter.
+     *  @param text: Tekst do porownania.
+     *  @return: Informacja czy teksty sa rowne.
+     */
+    bool EqualsIgnoreCase(const char * text) const
+    {
+        int text_length = strlen(text);
+
+        if (text_length != this->length)
+            return false;
+
+        return strncasecmp(this->data, text, this->length) == 0;
+    }
+
+    /*  Konwersja fragmentu na liczbe calkowita.
+     *  @return: Wartosc liczbowa fragmentu (0 jezeli fragment nie jest liczba).
+     */
+    long ToInt() const
+    {
+        long result = 0;
+        bool negative = false;
+
+        for (int i = 0; i < this->length; i++)
+        {
+            char c = this->data[i];
+
+            if (i == 0 && c == '-')
+                negative = true;
+            else if (c >= '0' && c <= '9')
+                result = result * 10 + (c - '0');
+            else
+                break;
+        }
+
+        return negative ? -result : result;
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Wspolna czesc tekstow o stalej pojemnosci - pozwala przekazywac teksty roznych
+//  rozmiarow do metod bez uzycia szablonow. Tekst jest zawsze zakonczony znakiem '\0',
+//  a dane nie mieszczace sie w buforze sa obcinane. Nazwy c_str() i length() sa zgodne
+//  z klasa String, aby obie klasy mogly byc uzywane zamiennie.
+class FixedStringBase
+{
+    protected:
+        char  * data;
+        int     capacity;
+        int     size        =   0;
+
+        FixedStringBase(char * data, int capacity);
+        FixedStringBase(const FixedStringBase & text) = delete;
+
+    public:
+        FixedStringBase & Append(const char * text);
+        FixedStringBase & Append(const char * text, int count);
+        FixedStringBase & Append(char c);
+        FixedStringBase & Append(const FixedStringView & view);
+        FixedStringBase & AppendFormat_P(const char * format, ...);
+        FixedStringBase & AppendNumber(long value, int width = 0, char pad = '0');
+        FixedStringBase & Append_P(const char * text);
+        void              Clear();
+        bool              EqualsIgnoreCase(const char * text) const;
+        int               GetCapacity() const;
+        bool              IsEmpty() const;
+        FixedStringView   Substring(int start) const;
+        FixedStringView   Substring(int start, int end) const;
+
+        const char      * c_str() const;
+        int               length() const;
+
+        FixedStringBase & operator=(const char * text);
+        FixedStringBase & operator=(const String & text);
+        FixedStringBase & operator=(const __FlashStringHelper * text);
+        FixedStringBase & operator=(const FixedStringBase & text);
+        FixedStringBase & operator+=(const char * text);
+        FixedStringBase & operator+=(char c);
+        bool              operator==(const char * text) const;
+        bool              operator!=(const char * text) const;
+        char              operator[](int index) const;
+};
+
+//  ----------------------------------------------------------------------------
+//  Tekst o stalej pojemnosci N znakow przechowywany na stosie lub wewnatrz struktury.
+template <int N>
+class FixedString : public FixedStringBase
+{
+    private:
+        char    buffer[N + 1];
+
+    public:
+        FixedString() : FixedStringBase(buffer, N)
+        {
+            //
+        }
+
+        FixedString(const char * text) : FixedStringBase(buffer, N)
+        {
+            this->Append(text);
+        }
+
+        FixedString(const FixedString & text) : FixedStringBase(buffer, N)
+        {
+            this->Append(text.c_str());
+        }
+
+        FixedString & operator=(const FixedString & text)
+        {
+            FixedStringBase::operator=(text);
+            return *this;
+        }
+
+        using FixedStringBase::operator=;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PROTECTED METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor wspolnej czesci tekstu o stalej pojemnosci.
+ *  @param data: Bufor tekstu (capacity + 1 bajtow).
+ *  @param capacity: Maksymalna ilosc znakow tekstu.
+ */
+FixedStringBase::FixedStringBase(char * data, int capacity)
+{
+    this->data = data;
+    this->capacity = capacity;
+    this->data[0] = '\0';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Dopisanie tekstu na koncu.
+ *  @param text: Dopisywany tekst.
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::Append(const char * text)
+{
+    if (text == NULL)
+        return *this;
+
+    while (*text != '\0' && this->size < this->capacity)
+        this->data[this->size++] = *text++;
+
+    this->data[this->size] = '\0';
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie okreslonej ilosci znakow tekstu na koncu.
+ *  @param text: Dopisywany tekst.
+ *  @param count: Maksymalna ilosc dopisywanych znakow.
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::Append(const char * text, int count)
+{
+    if (text == NULL)
+        return *this;
+
+    for (int i = 0; i < count && text[i] != '\0' && this->size < this->capacity; i++)
+        this->data[this->size++] = text[i];
+
+    this->data[this->size] = '\0';
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie znaku na koncu.
+ *  @param c: Dopisywany znak.
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::Append(char c)
+{
+    if (this->size < this->capacity)
+    {
+        this->data[this->size++] = c;
+        this->data[this->size] = '\0';
+    }
+
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie fragmentu tekstu na koncu.
+ *  @param view: Dopisywany fragment.
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::Append(const FixedStringView & view)
+{
+    return this->Append(view.data, view.length);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie sformatowanego tekstu (format printf w pamieci programu).
+ *  @param format: Format tekstu (PSTR).
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::AppendFormat_P(const char * format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf_P(this->data + this->size, this->capacity - this->size + 1, format, args);
+    va_end(args);
+
+    this->size += strlen(this->data + this->size);
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie liczby calkowitej z dopelnieniem do okreslonej szerokosci.
+ *  @param value: Dopisywana liczba.
+ *  @param width: Minimalna ilosc znakow liczby (bez znaku minus).
+ *  @param pad: Znak dopelnienia (np. '0' dla "07").
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::AppendNumber(long value, int width = 0, char pad = '0')
+{
+    char digits[FIXED_STRING_NUMBER_SIZE];
+    int count = 0;
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long) value : (unsigned long) value;
+
+    //  Cyfry zapisywane sa od konca.
+    do
+    {
+        digits[count++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    }
+    while (magnitude > 0 && count < FIXED_STRING_NUMBER_SIZE);
+
+    if (value < 0)
+        this->Append('-');
+
+    for (int i = count; i < width; i++)
+        this->Append(pad);
+
+    while (count > 0)
+        this->Append(digits[--count]);
+
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie tekstu z pamieci programu na koncu.
+ *  @param text: Dopisywany tekst (PSTR).
+ *  @return: Referencja do tekstu (laczenie wywolan).
+ */
+FixedStringBase & FixedStringBase::Append_P(const char * text)
+{
+    char c;
+
+    while ((c = pgm_read_byte(text++)) != '\0' && this->size < this->capacity)
+        this->data[this->size++] = c;
+
+    this->data[this->size] = '\0';
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyczyszczenie tekstu.
+void FixedStringBase::Clear()
+{
+    this->size = 0;
+    this->data[0] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+/*  Porownanie z tekstem bez uwzglednienia wielkosci liter.
+ *  @param text: Tekst do porownania.
+ *  @return: Informacja czy teksty sa rowne.
+ */
+bool FixedStringBase::EqualsIgnoreCase(const char * text) const
+{
+    return strcasecmp(this->data, text) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie maksymalnej ilosci znakow tekstu.
+ *  @return: Pojemnosc tekstu.
+ */
+int FixedStringBase::GetCapacity() const
+{
+    return this->capacity;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy tekst jest pusty.
+ *  @return: Informacja czy tekst jest pusty.
+ */
+bool FixedStringBase::IsEmpty() const
+{
+    return this->size == 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie fragmentu tekstu od wybranego znaku do konca (bez kopiowania).
+ *  @param start: Indeks pierwszego znaku.
+ *  @return: Fragment tekstu (wazny dopoki tekst nie zostanie zmieniony).
+ */
+FixedStringView FixedStringBase::Substring(int start) const
+{
+    return this->Substring(start, this->size);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie fragmentu tekstu (bez kopiowania).
+ *  @param start: Indeks pierwszego znaku.
+ *  @param end: Indeks znaku za ostatnim znakiem fragmentu.
+ *  @return: Fragment tekstu (wazny dopoki tekst nie zostanie zmieniony).
+ */
+FixedStringView FixedStringBase::Substring(int start, int end) const
+{
+    start = max(0, min(start, this->size));
+    end = max(start, min(end, this->size));
+
+    return FixedStringView(this->data + start, end - start);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie tekstu w postaci ciagu znakow zakonczonego '\0'.
+ *  @return: Wskaznik do tekstu.
+ */
+const char * FixedStringBase::c_str() const
+{
+    return this->data;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci znakow tekstu.
+ *  @return: Dlugosc tekstu.
+ */
+int FixedStringBase::length() const
+{
+    return this->size;
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator=(const char * text)
+{
+    this->Clear();
+    return this->Append(text);
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator=(const String & text)
+{
+    this->Clear();
+    return this->Append(text.c_str());
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator=(const __FlashStringHelper * text)
+{
+    this->Clear();
+    return this->Append_P(reinterpret_cast<const char *>(text));
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator=(const FixedStringBase & text)
+{
+    if (this != &text)
+    {
+        this->Clear();
+        this->Append(text.c_str());
+    }
+
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator+=(const char * text)
+{
+    return this->Append(text);
+}
+
+//  ----------------------------------------------------------------------------
+FixedStringBase & FixedStringBase::operator+=(char c)
+{
+    return this->Append(c);
+}
+
+//  ----------------------------------------------------------------------------
+bool FixedStringBase::operator==(const char * text) const
+{
+    return strcmp(this->data, text) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool FixedStringBase::operator!=(const char * text) const
+{
+    return strcmp(this->data, text) != 0;
+}
+
+//  ----------------------------------------------------------------------------
+char FixedStringBase::operator[](int index) const
+{
+    return index >= 0 && index < this->size ? this->data[index] : '\0';
+}
+
+#endif
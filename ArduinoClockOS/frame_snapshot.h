@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////////////////////
+//  FRAME SNAPSHOT
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "display_controller.h"
+#include "sd_card_controller.h"
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define FRAME_SNAPSHOT_NONE       -1
+#define FRAME_SNAPSHOT_MATCH      0
+#define FRAME_SNAPSHOT_DIFF       1
+
+#define FRAME_SNAPSHOT_NAME_SIZE  8   //  Nazwa pliku w formacie 8.3.
+#define FRAME_SNAPSHOT_HEX_SIZE   (DISPLAY_FRAME_SIZE * 2)
+
+#define FRAME_SNAPSHOT_DIRECTORY  F("frames")
+#define FRAME_SNAPSHOT_EXTENSION  F(".frm")
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameSnapshot
+{
+    private:
+        DisplayController * display_ctrl;
+        SdCardController  * sdcard_ctrl;
+        SerialController  * serial_ctrl;
+
+        String  GetFilePath(String name);
+        bool    ParseHex(const char * hex, byte * frame);
+        void    PrintDiff(const byte * expected, int output_device);
+        void    ToHex(const byte * frame, char * hex);
+
+    public:
+        FrameSnapshot(DisplayController * display_ctrl, SdCardController * sdcard_ctrl, SerialController * serial_ctrl);
+
+        int     Check(String name, int output_device);
+        int     Diff(String hex, int output_device);
+        void    Dump(int output_device);
+        bool    Save(String name);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Utworzenie sciezki pliku ramki wzorcowej.
+ *  @param name: Nazwa ramki (do 8 znakow).
+ *  @return: Sciezka pliku na karcie SD.
+ */
+String FrameSnapshot::GetFilePath(String name)
+{
+    return String(FRAME_SNAPSHOT_DIRECTORY) + "/" + name.substring(0, FRAME_SNAPSHOT_NAME_SIZE) + FRAME_SNAPSHOT_EXTENSION;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Konwersja zapisu szesnastkowego na ramke obrazu.
+ *  @param hex: Ramka w zapisie szesnastkowym (2 znaki na kolumne).
+ *  @param frame: Bufor wynikowy ramki (DISPLAY_FRAME_SIZE bajtow).
+ *  @return: Informacja czy zapis byl poprawny.
+ */
+bool FrameSnapshot::ParseHex(const char * hex, byte * frame)
+{
+    if (strlen(hex) < FRAME_SNAPSHOT_HEX_SIZE)
+        return false;
+
+    for (int i = 0; i < FRAME_SNAPSHOT_HEX_SIZE; i++)
+    {
+        char c = hex[i];
+        byte nibble;
+
+        if (c >= '0' && c <= '9')
+            nibble = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            nibble = c - 'A' + 10;
+        else
+            return false;
+
+        if (i % 2 == 0)
+            frame[i / 2] = nibble << 4;
+        else
+            frame[i / 2] |= nibble;
+    }
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyslanie roznic pomiedzy aktualna a wzorcowa ramka w postaci grafiki ASCII.
+ *  '#' - punkt w obu ramkach, '+' - tylko aktualna, '-' - tylko wzorcowa, '.' - pusty.
+ *  @param expected: Ramka wzorcowa.
+ *  @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ */
+void FrameSnapshot::PrintDiff(const byte * expected, int output_device)
+{
+    const byte * actual = this->display_ctrl->GetFrontFrame();
+    char line[DISPLAY_FRAME_SIZE + 1];
+
+    //  Znaczniki kolumn roznicy.
+    for (int x = 0; x < DISPLAY_FRAME_SIZE; x++)
+        line[x] = actual[x] != expected[x] ? 'v' : ' ';
+
+    line[DISPLAY_FRAME_SIZE] = '\0';
+    this->serial_ctrl->WriteRawData(line, output_device);
+
+    for (int y = 0; y < DISPLAY_SEGMENT_HEIGHT; y++)
+    {
+        for (int x = 0; x < DISPLAY_FRAME_SIZE; x++)
+        {
+            bool is_actual = bitRead(actual[x], y);
+            bool is_expected = bitRead(expected[x], y);
+
+            if (is_actual && is_expected)
+                line[x] = '#';
+            else if (is_actual)
+                line[x] = '+';
+            else if (is_expected)
+                line[x] = '-';
+            else
+                line[x] = '.';
+        }
+
+        this->serial_ctrl->WriteRawData(line, output_device);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Konwersja ramki obrazu na zapis szesnastkowy.
+ *  @param frame: Ramka obrazu.
+ *  @param hex: Bufor wynikowy (FRAME_SNAPSHOT_HEX_SIZE + 1 znakow).
+ */
+void FrameSnapshot::ToHex(const byte * frame, char * hex)
+{
+    const char digits[] = "0123456789abcdef";
+
+    for (int i = 0; i < DISPLAY_FRAME_SIZE; i++)
+    {
+        hex[i * 2] = digits[frame[i] >> 4];
+        hex[i * 2 + 1] = digits[frame[i] & 0x0F];
+    }
+
+    hex[FRAME_SNAPSHOT_HEX_SIZE] = '\0';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy zapisu i porownywania ramek wyswietlacza.
+ *  @param display_ctrl: Kontroler wyswietlacza.
+ *  @param sdcard_ctrl: Kontroler karty SD (ramki wzorcowe).
+ *  @param serial_ctrl: Kontroler polaczenia szeregowego.
+ */
+FrameSnapshot::FrameSnapshot(DisplayController * display_ctrl, SdCardController * sdcard_ctrl, SerialController * serial_ctrl)
+{
+    this->display_ctrl = display_ctrl;
+    this->sdcard_ctrl = sdcard_ctrl;
+    this->serial_ctrl = serial_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Porownanie aktualnej ramki z ramka wzorcowa zapisana na karcie SD.
+ *  @param name: Nazwa ramki wzorcowej.
+ *  @param output_device: Typ urzadzenia do ktorego wynik zostanie wyslany.
+ *  @return: Wynik porownania.
+ */
+int FrameSnapshot::Check(String name, int output_device)
+{
+    String file_path = this->GetFilePath(name);
+    char hex[FRAME_SNAPSHOT_HEX_SIZE + 1];
+    int length = 0;
+
+    if (!this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
+        return FRAME_SNAPSHOT_NONE;
+
+    File file = this->sdcard_ctrl->OpenFileToRead(file_path);
+
+    if (!file)
+        return FRAME_SNAPSHOT_NONE;
+
+    while (file.available() && length < FRAME_SNAPSHOT_HEX_SIZE)
+        hex[length++] = file.read();
+
+    hex[length] = '\0';
+    file.close();
+
+    return this->Diff(hex, output_device);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Porownanie aktualnej ramki z ramka przekazana w zapisie szesnastkowym.
+ *  @param hex: Ramka wzorcowa w zapisie szesnastkowym.
+ *  @param output_device: Typ urzadzenia do ktorego wynik zostanie wyslany.
+ *  @return: Wynik porownania.
+ */
+int FrameSnapshot::Diff(String hex, int output_device)
+{
+    byte expected[DISPLAY_FRAME_SIZE];
+    int differences = 0;
+
+    if (!this->ParseHex(hex.c_str(), expected))
+        return FRAME_SNAPSHOT_NONE;
+
+    const byte * actual = this->display_ctrl->GetFrontFrame();
+
+    for (int x = 0; x < DISPLAY_FRAME_SIZE; x++)
+        if (actual[x] != expected[x])
+            differences++;
+
+    if (differences == 0)
+    {
+        this->serial_ctrl->WriteRawData_P(PSTR("MATCH"), output_device);
+        return FRAME_SNAPSHOT_MATCH;
+    }
+
+    this->serial_ctrl->WriteFormat_P(output_device, SERIAL_PRIORITY_RESPONSE, PSTR("DIFF %d columns"), differences);
+    this->PrintDiff(expected, output_device);
+    return FRAME_SNAPSHOT_DIFF;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyslanie aktualnej ramki w zapisie szesnastkowym (kolumna 0 jako pierwsza, bit 0 - gorny wiersz).
+ *  @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ */
+void FrameSnapshot::Dump(int output_device)
+{
+    char hex[FRAME_SNAPSHOT_HEX_SIZE + 1];
+
+    this->ToHex(this->display_ctrl->GetFrontFrame(), hex);
+    this->serial_ctrl->WriteRawData(hex, output_device);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapisanie aktualnej ramki jako wzorcowej na karcie SD.
+ *  @param name: Nazwa ramki (do 8 znakow).
+ *  @return: Informacja czy ramka zostala zapisana.
+ */
+bool FrameSnapshot::Save(String name)
+{
+    char hex[FRAME_SNAPSHOT_HEX_SIZE + 1];
+
+    if (name.length() == 0 || !this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
+        return false;
+
+    if (!this->sdcard_ctrl->FileExists(FRAME_SNAPSHOT_DIRECTORY))
+        this->sdcard_ctrl->CreateDirectory(FRAME_SNAPSHOT_DIRECTORY);
+
+    this->ToHex(this->display_ctrl->GetFrontFrame(), hex);
+
+    File file = this->sdcard_ctrl->OpenFileToWrite(this->GetFilePath(name));
+    file.println(hex);
+    file.close();
+
+    return true;
+}
+
+#endif
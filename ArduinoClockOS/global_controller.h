@@ -9,19 +9,31 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "boot_report.h"
 #include "buzzer_controller.h"
 #include "clock_controller.h"
 #include "clock_timer.h"
+#include "command_recorder.h"
 #include "display_controller.h"
 #include "ir_controller.h"
+#include "journal.h"
 #include "led_controller.h"
 #include "keypad_controller.h"
+#include "memory_monitor.h"
 #include "message_controller.h"
+#include "night_mode.h"
+#include "onewire_bus.h"
 #include "photoresistor_controller.h"
+#include "power_manager.h"
+#include "profiler.h"
 #include "sd_card_controller.h"
+#include "sensor_sampler.h"
+#include "static_instance.h"
 #include "serial_controller.h"
+#include "temperature_logger.h"
 #include "temperature_sensor_controller.h"
 #include "song_controller.h"
+#include "vplayer_controller.h"
 #include "alarm.h"
 #include "weather.h"
 
@@ -37,10 +49,34 @@
 #define DISPLAY_MODE_INTERVAL           15
 #define DISPLAY_STRINGS                 3
 
-#define DISPLAY_STATES                  3
+#define DISPLAY_STATES                  7
 #define DISPLAY_DATETIME_STATE          0
 #define DISPLAY_TEMPERATURE_IN_STATE    1
-#define DISPLAY_TEMPERATURE_OUT_STATE   2
+#define DISPLAY_MINMAX_IN_STATE         2
+#define DISPLAY_SPARKLINE_IN_STATE      3
+#define DISPLAY_TEMPERATURE_OUT_STATE   4
+#define DISPLAY_MINMAX_OUT_STATE        5
+#define DISPLAY_SPARKLINE_OUT_STATE     6
+
+#define DISPLAY_PAGE_FULLSCREEN         0x00
+#define DISPLAY_PAGE_CLOCK              0x01    //  Strona z zegarem i ikonka alarmu po prawej stronie.
+
+#define BOOT_STAGE_SDCARD               0
+#define BOOT_STAGE_SENSORS              1
+#define BOOT_STAGE_CONFIG               2
+#define BOOT_STAGE_JOURNAL              3
+#define BOOT_STAGE_READY                4
+
+//  Ustawienia zmienione przed wczytaniem konfiguracji: bity 1 << JOURNAL_SETTING_* oraz
+//  ustawienia zapisywane tylko w conf.ini.
+#define PENDING_SETTING_BAUD_PC         0x10
+#define PENDING_SETTING_BAUD_BT         0x20
+#define PENDING_SETTING_SENSOR_IN       0x40
+#define PENDING_SETTING_SENSOR_OUT      0x80
+
+#define BOOT_FADE_INTERVAL              50      //  Odstep krokow rozjasniania ekranu po uruchomieniu [ms].
+#define BOOT_ERROR_BEEPS                3
+#define BOOT_ERROR_BEEP_INTERVAL        225     //  Sygnal 125ms i 100ms przerwy [ms].
 
 #define GLOBAL_STATES                   9
 #define GLOBAL_STATE_NORMAL             0
@@ -53,69 +89,160 @@
 #define GLOBAL_STATE_SERVICE_LOCK       7
 #define GLOBAL_STATE_LEDS               8
 
-const String CONFIG_FILE_NAME = "conf.ini";
+#define CONFIG_FILE_NAME  F("conf.ini")
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STATIC INSTANCES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Pamiec kontrolerow przydzielona statycznie (.bss) - obiekty sa tworzone w Initialize()
+//  w tej samej kolejnosci co wczesniej, ale bez uzycia sterty.
+StaticInstance<Alarm>                         alarm_instance;
+StaticInstance<BootReport>                    boot_report_instance;
+StaticInstance<BuzzerController>              buzzer_ctrl_instance;
+StaticInstance<ClockController>               clock_ctrl_instance;
+StaticInstance<ClockTimer>                    update_timer_instance;
+StaticInstance<CommandRecorder>               command_recorder_instance;
+StaticInstance<DisplayController>             display_ctrl_instance;
+StaticInstance<DisplayString>                 display_string_instances[DISPLAY_STRINGS];
+StaticInstance<IRController>                  ir_controller_instance;
+StaticInstance<Journal>                       journal_instance;
+StaticInstance<KeypadController>              keypad_ctrl_instance;
+StaticInstance<LedController>                 led_controller_instance;
+StaticInstance<MemoryMonitor>                 memory_monitor_instance;
+StaticInstance<MessageController>             msg_ctrl_instance;
+StaticInstance<NightMode>                     night_mode_instance;
+StaticInstance<OneWireBus>                    onewire_bus_in_instance;
+StaticInstance<OneWireBus>                    onewire_bus_out_instance;
+StaticInstance<PhotoresistorController>       photoresistor_ctrl_left_instance;
+StaticInstance<PhotoresistorController>       photoresistor_ctrl_right_instance;
+StaticInstance<PowerManager>                  power_mgr_instance;
+StaticInstance<SdCardController>              sdcard_ctrl_instance;
+StaticInstance<SensorSampler>                 sensor_sampler_instance;
+StaticInstance<SerialController>              serial_ctrl_instance;
+StaticInstance<SongController>                song_controller_instance;
+StaticInstance<TemperatureSensorController>   temp_sensor_ctrl_in_instance;
+StaticInstance<TemperatureSensorController>   temp_sensor_ctrl_out_instance;
+StaticInstance<TemperatureLogger>             temp_logger_instance;
+StaticInstance<VPlayerController>             vplayer_ctrl_instance;
+StaticInstance<Weather>                       weather_instance;
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
 ////////////////////////////////////////////////////////////////////////////////
 
+class GlobalController;
+
+//  Strona wyswietlana w trybie zapetlenia (tablica stron w pamieci programu).
+struct DisplayPage
+{
+    void  (GlobalController::*draw)();
+    byte  flags;
+};
+
 class GlobalController
 {
     private:
-        DisplayString * display_strings[3];
+        static const DisplayPage display_pages[DISPLAY_STATES];
 
+        DisplayString * display_strings[DISPLAY_STRINGS];
+
+        int   brightness                    =   DISPLAY_MAX_BRIGHTNESS;     //  Jasnosc reczna (przywracana po nocy).
         bool  brightness_auto               =   true;
+        int   boot_fade                     =   DISPLAY_MIN_BRIGHTNESS;     //  Ograniczenie jasnosci w trakcie rozjasniania.
+        unsigned long boot_fade_time        =   0;
+        byte  boot_beeps                    =   0;
+        unsigned long boot_beep_time        =   0;
+        byte  boot_stage                    =   BOOT_STAGE_SDCARD;
         int   buzzer_hour_change_interval   =   0;
         bool  buzzer_hour_change_complete   =   false;
         int   display_state                 =   DISPLAY_DATETIME_STATE;
+        byte  display_page_flags            =   DISPLAY_PAGE_CLOCK;
         bool  force_display_refresh         =   false;
         int   global_state                  =   GLOBAL_STATE_NORMAL;
         bool  initialized                   =   false;
+        byte  pending_settings              =   0;
 
         String  input_command_value         =   "";
         char    input_key                   =   0;
+        KeypadEvent  input_key_event;
 
         //  Display Management
         void  DisplayAlarmIsSet();
         void  DisplayClock();
         void  DisplayDate();
+        void  DisplayMinMax(TemperatureTrend & trend);
+        void  DisplayMinMaxInside();
+        void  DisplayMinMaxOutside();
+        void  DisplaySparkline(TemperatureTrend & trend);
+        void  DisplaySparklineInside();
+        void  DisplaySparklineOutside();
         void  DisplayTemperatureInside();
         void  DisplayTemperatureOutside();
+        void  FormatTemperature(FixedStringBase & text, int temp);
         void  SetNextDisplayingState();
 
         //  Initialization
+        byte  DiscoverTemperatureSensors();
         void  InitializeAlarm();
-        void  InitializeClock();
-        void  InitializeBuzzer();
-        void  InitializeDisplay();
-        void  InitializeIRLed();
-        void  InitializePhotoresistors();
-        void  InitializeSdCard();
+        byte  InitializeClock();
+        byte  InitializeBuzzer();
+        byte  InitializeDisplay();
+        byte  InitializeIRLed();
+        byte  InitializeJournal();
+        byte  InitializePhotoresistors();
+        byte  InitializeSdCard();
         void  InitializeTemperatureSensors();
         void  InitializeWeather();
         void  Initialize();
 
+        //  Journal
+        void  ApplyJournalSetting(byte setting, JournalState & state, bool save_to_file);
+        void  ApplyJournalState(JournalState & state);
+        void  ApplyPendingSettings(JournalState & state);
+        byte  GetPendingSetting(String & line);
+        void  GetJournalState(JournalState & state);
+        void  RecordSetting(byte setting);
+
+        //  Night Mode
+        void  ApplyNightMode(bool changed = false);
+
+        //  Power Management
+        bool  IsIdleAllowed();
+
     public:
         Alarm             * alarm;
         KeypadController  * keypad_ctrl;
         SerialController  * serial_ctrl;
         Weather           * weather;
 
+        BootReport                    * boot_report;
         BuzzerController              * buzzer_ctrl;
         ClockController               * clock_ctrl;
+        CommandRecorder               * command_recorder;
         DisplayController             * display_ctrl;
         IRController                  * ir_controller;
+        Journal                       * journal;
         LedController                 * led_controller;
+        MemoryMonitor                 * memory_monitor;
         MessageController             * msg_ctrl;
+        NightMode                     * night_mode;
+        OneWireBus                    * onewire_bus_in;
+        OneWireBus                    * onewire_bus_out;
         SdCardController              * sdcard_ctrl;
         PhotoresistorController       * photoresistor_ctrl_left;
         PhotoresistorController       * photoresistor_ctrl_right;
+        PowerManager                  * power_mgr;
+        SensorSampler                 * sensor_sampler;
         TemperatureSensorController   * temp_sensor_ctrl_in;
         TemperatureSensorController   * temp_sensor_ctrl_out;
+        TemperatureLogger             * temp_logger;
         ClockTimer                    * update_timer;
 
         SongController                * song_controller;
+        VPlayerController             * vplayer_ctrl;
 
         GlobalController();
 
@@ -124,6 +251,7 @@ class GlobalController
         void  SetAlarm(int hour, int minute, bool enabled = true, bool is_led = false, bool save_to_file = true);
 
         //  Brightness Management.
+        int   GetBrightness();
         bool  IsAutoBrightness();
         void  SetAutoBrightness(bool enabled, bool save_to_file = true);
         void  SetBrightness(int brightness, bool save_to_file = true);
@@ -136,6 +264,8 @@ class GlobalController
         void  ProcessAlarm();
         void  ProcessAutoBrightness(bool override = false);
         void  ProcessBeepHour();
+        bool  ProcessJournal(bool checkpoint = false);
+        void  ProcessNightMode();
         void  ProcessSecondLedBlinking();
         void  ProcessFunctionalities();
 
@@ -152,22 +282,33 @@ class GlobalController
         void            ProcessDisplay(bool force_refresh = false);
         void            SetDisplayingState(int displaying_state, bool reset_timer = true);
 
+        //  Night Mode Management.
+        bool  SetNightMode(const char * config, bool save_to_file = true);
+        void  SetNightModeLevel(byte level, bool save_to_file = true);
+
+        //  Temperature Sensors Management.
+        bool  SetTemperatureSensor(bool outside, const char * address, bool save_to_file = true);
+
         //  Input.
         String  GetInputCommand();
         char    GetInputKey();
+        KeypadEvent  GetInputKeyEvent();
         bool    IsCommandValueInputed();
         void    ProcessInput();
 
         //  Machine States Management.
         bool  IsInitialized();
+        void  ProcessBoot();
         bool  IsServiceLocked();
         int   GetMachineState();
         void  SetMachineState(int machine_state);
         void  FinalizeCycle();
+        void  Idle();
 
         //  Save & Load.
-        void  LoadData();
-        void  SaveData();
+        bool  LoadData();
+        bool  SaveData();
+        void  SaveSetting(byte setting);
 };
 
 
@@ -175,6 +316,18 @@ class GlobalController
 //  *** DISPLAY MANAGEMENT PRIVATE METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+//  Strony wyswietlane w trybie zapetlenia (kolejnosc zgodna z DISPLAY_*_STATE).
+PROGMEM const DisplayPage GlobalController::display_pages[DISPLAY_STATES] = {
+    { &GlobalController::DisplayDate,                 DISPLAY_PAGE_CLOCK },
+    { &GlobalController::DisplayTemperatureInside,    DISPLAY_PAGE_CLOCK },
+    { &GlobalController::DisplayMinMaxInside,         DISPLAY_PAGE_CLOCK },
+    { &GlobalController::DisplaySparklineInside,      DISPLAY_PAGE_FULLSCREEN },
+    { &GlobalController::DisplayTemperatureOutside,   DISPLAY_PAGE_CLOCK },
+    { &GlobalController::DisplayMinMaxOutside,        DISPLAY_PAGE_CLOCK },
+    { &GlobalController::DisplaySparklineOutside,     DISPLAY_PAGE_FULLSCREEN }
+};
+
+//  ----------------------------------------------------------------------------
 //  Wyswietlanie ikonki alarmu kiedy jest ustawiony.
 void GlobalController::DisplayAlarmIsSet()
 {
@@ -204,7 +357,7 @@ void GlobalController::DisplayClock()
     DisplayString * dsp_str = this->display_strings[TEXT_ALIGN_RIGHT];
     bool            blink   = this->clock_ctrl->GetBlink();
     
-    dsp_str->text   = this->clock_ctrl->GetTime("HM", ':', blink);
+    this->clock_ctrl->GetTime(dsp_str->text, "HM", ':', blink);
     dsp_str->offset = 1;
     this->display_ctrl->PrintDS(dsp_str, true);
 }
@@ -215,21 +368,96 @@ void GlobalController::DisplayDate()
 {
     DisplayString * dsp_str = this->display_strings[TEXT_ALIGN_LEFT];
 
-    dsp_str->text   = this->clock_ctrl->GetDate("DMy", '-');
+    this->clock_ctrl->GetDate(dsp_str->text, "DMy", '-');
     dsp_str->offset = 1;
     dsp_str->_xpos  = 0;
 
     this->display_ctrl->PrintDS(dsp_str, true);
 }
 
+//  ----------------------------------------------------------------------------
+/*  Wyswietlenie minimalnej i maksymalnej temperatury dnia oraz strzalki trendu
+ *  na lewej stronie wyswietlacza (za ikonka).
+ *  @param trend: Statystyki czujnika.
+ */
+void GlobalController::DisplayMinMax(TemperatureTrend & trend)
+{
+    DisplayString * dsp_str = this->display_strings[TEXT_ALIGN_LEFT];
+
+    dsp_str->text.Clear();
+
+    if (trend.GetDayMin() == TREND_NULL)
+        dsp_str->text.Append('-');
+    else
+    {
+        dsp_str->text.AppendNumber(trend.GetDayMinDegrees());
+        dsp_str->text.Append('/');
+        dsp_str->text.AppendNumber(trend.GetDayMaxDegrees());
+    }
+
+    //  Strzalka za tekstem (odstep i 3 kolumny) - wliczona do szerokosci, aby zostala wyczyszczona
+    //  przy zmianie strony.
+    dsp_str->offset =   9;
+    dsp_str->suffix_width = 4;
+    this->display_ctrl->PrintDS(dsp_str, true);
+    this->display_ctrl->DrawSprite(SPRITE_TREND, dsp_str->_xpos + dsp_str->_width - 3, trend.GetTrend());
+    dsp_str->suffix_width = 0;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyswietlenie minimalnej i maksymalnej temperatury wewnetrznej.
+void GlobalController::DisplayMinMaxInside()
+{
+    this->display_ctrl->DrawSprite(SPRITE_HOME, 0, 0);
+    this->DisplayMinMax(this->temp_logger->trend_in);
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyswietlenie minimalnej i maksymalnej temperatury zewnetrznej.
+void GlobalController::DisplayMinMaxOutside()
+{
+    int weather_icon = this->weather->GetWeather(this->clock_ctrl->Now());
+    this->display_ctrl->DrawSprite(SPRITE_WEATHER, 0, weather_icon);
+    this->DisplayMinMax(this->temp_logger->trend_out);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyswietlenie wykresu temperatury z ostatniej doby na calym wyswietlaczu.
+ *  @param trend: Statystyki czujnika.
+ */
+void GlobalController::DisplaySparkline(TemperatureTrend & trend)
+{
+    byte  columns[TREND_BUCKETS];
+    int   width = min(this->display_ctrl->GetWidth(), TREND_BUCKETS);
+
+    trend.GetSparkline(columns, width);
+
+    for (int i = 0; i < width; i++)
+        this->display_ctrl->DrawColumn(i, columns[i]);
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyswietlenie wykresu temperatury wewnetrznej.
+void GlobalController::DisplaySparklineInside()
+{
+    this->DisplaySparkline(this->temp_logger->trend_in);
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyswietlenie wykresu temperatury zewnetrznej.
+void GlobalController::DisplaySparklineOutside()
+{
+    this->DisplaySparkline(this->temp_logger->trend_out);
+}
+
 //  ----------------------------------------------------------------------------
 //  Wyswietlenie temperatury wewnetrznej na lewej stronie wyswietlacza.
 void GlobalController::DisplayTemperatureInside()
 {
     DisplayString * dsp_str = this->display_strings[TEXT_ALIGN_LEFT];
-    int             temp    = this->temp_sensor_ctrl_in->GetTemperature();
+    int             temp    = this->sensor_sampler->GetValue(SAMPLER_TEMP_IN);
 
-    dsp_str->text   =   temp <= TEMPERATURE_SENSOR_NULL ? "-`C" : String(temp) + "`C";
+    this->FormatTemperature(dsp_str->text, temp);
     dsp_str->offset =   10;
     dsp_str->_xpos  =   8;
     dsp_str->_width +=  2;
@@ -243,9 +471,9 @@ void GlobalController::DisplayTemperatureInside()
 void GlobalController::DisplayTemperatureOutside()
 {
     DisplayString * dsp_str = this->display_strings[TEXT_ALIGN_LEFT];
-    int             temp    = this->temp_sensor_ctrl_out->GetTemperature();
+    int             temp    = this->sensor_sampler->GetValue(SAMPLER_TEMP_OUT);
 
-    dsp_str->text   =   temp <= TEMPERATURE_SENSOR_NULL ? "-`C" : String(temp) + "`C";
+    this->FormatTemperature(dsp_str->text, temp);
     dsp_str->offset =   10;
     dsp_str->_xpos  =   8;
     dsp_str->_width +=  2;
@@ -255,6 +483,23 @@ void GlobalController::DisplayTemperatureOutside()
     this->display_ctrl->PrintDS(dsp_str, true);
 }
 
+//  ----------------------------------------------------------------------------
+/*  Formatowanie temperatury do wyswietlenia (bez alokacji pamieci).
+ *  @param text: Tekst wynikowy (nadpisywany).
+ *  @param temp: Temperatura w dziesiatych czesciach stopnia lub SAMPLER_NULL gdy brak odczytu.
+ */
+void GlobalController::FormatTemperature(FixedStringBase & text, int temp)
+{
+    text.Clear();
+
+    if (temp == SAMPLER_NULL)
+        text.Append("--");
+    else
+        TemperatureLogger::AppendTenths(text, temp);
+
+    text.Append("`C");
+}
+
 //  ----------------------------------------------------------------------------
 //  Wyswietlenie nastepnych informacji na ekranie w trybie zapetlenia.
 void GlobalController::SetNextDisplayingState()
@@ -266,182 +511,478 @@ void GlobalController::SetNextDisplayingState()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//  *** INITIALIZATION PRIVATE METHOD BODIES ***
+//  *** JOURNAL PRIVATE METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-//  Inicjalizacja, konfiguracja i test modulu kontrolera zegara czasu rzeczywistego.
-void GlobalController::InitializeClock()
+/*  Zastosowanie jednego ustawienia z zapisanego stanu.
+ *  @param setting: Ustawienie JOURNAL_SETTING_*.
+ *  @param state: Ustawienia.
+ *  @param save_to_file: Zapisanie zmiany w dzienniku.
+ */
+void GlobalController::ApplyJournalSetting(byte setting, JournalState & state, bool save_to_file)
 {
-    this->clock_ctrl = new ClockController();
-    this->serial_ctrl->WriteRawData("DS3231 CLOCK Date: " + this->clock_ctrl->GetDate("WDMY", '.'), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("DS3231 CLOCK Time: " + this->clock_ctrl->GetTime("HMS", ':'), SERIAL_COM);
-    this->update_timer = new ClockTimer(this->clock_ctrl->Now(), DISPLAY_MODE_INTERVAL);
+    switch (setting)
+    {
+        case JOURNAL_SETTING_ALARM:
+            this->SetAlarm(state.alarm_hour, state.alarm_minute,
+                state.flags & JOURNAL_STATE_ALARM_ON, state.flags & JOURNAL_STATE_ALARM_LED, false);
+            break;
+
+        case JOURNAL_SETTING_BEEP:
+            this->SetBuzzerHourNotifierInterval(state.beep_interval, false);
+            break;
+
+        case JOURNAL_SETTING_BRIGHTNESS:
+            this->SetBrightness(state.brightness, false);
+
+            if (state.flags & JOURNAL_STATE_AUTO_BRIGHT)
+                this->SetAutoBrightness(true, false);
+            break;
+
+        case JOURNAL_SETTING_NIGHT:
+            this->night_mode->SetLevel(state.night_level);
+
+            if (!(state.flags & JOURNAL_STATE_NIGHT_HOURS) || !this->night_mode->SetSchedule(state.night_start, state.night_end))
+                this->night_mode->SetLightTrigger();
+            break;
+    }
+
+    if (save_to_file)
+        this->RecordSetting(setting);
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test modulu kontrolera brzeczyka.
-void GlobalController::InitializeBuzzer()
+/*  Zastosowanie ustawien odtworzonych z dziennika (bez ponownego zapisu).
+ *  @param state: Ustawienia.
+ */
+void GlobalController::ApplyJournalState(JournalState & state)
 {
-    this->buzzer_ctrl = new BuzzerController();
-    this->buzzer_ctrl->PlayTone(NOTE_C8, 2);
+    for (byte setting = JOURNAL_SETTING_ALARM; setting <= JOURNAL_SETTING_NIGHT; setting++)
+        this->ApplyJournalSetting(setting, state, false);
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test modulu kontrolera wyswietlacza.
-void GlobalController::InitializeDisplay()
+/*  Ponowne zastosowanie i zapis ustawien zmienionych przed wczytaniem konfiguracji (wczytywanie
+ *  conf.ini je pomija, a odtworzenie dziennika nadpisuje caly stan).
+ *  @param state: Ustawienia sprzed odtworzenia dziennika.
+ */
+void GlobalController::ApplyPendingSettings(JournalState & state)
 {
-    //  Konfiguracja modulu wyswietlacza.
-    this->display_ctrl = new DisplayController(DISPLAY_MAX_BRIGHTNESS, 8);
+    if (this->pending_settings == 0)
+        return;
 
-    //  Inicjalizacja i konfiguracja kontenerow tekstowych wyswietlacza.
-    for (int dsp_index = 0; dsp_index < DISPLAY_STRINGS; dsp_index++)
-        this->display_strings[dsp_index] = new DisplayString(0, dsp_index, "");
-        
-    this->display_strings[TEXT_ALIGN_LEFT]->_xpos = 0;
-    this->display_strings[TEXT_ALIGN_CENTER]->_xpos = this->display_ctrl->GetWidth()/2;
-    this->display_strings[TEXT_ALIGN_RIGHT]->_xpos = this->display_ctrl->GetWidth()-1;
+    for (byte setting = JOURNAL_SETTING_ALARM; setting <= JOURNAL_SETTING_NIGHT; setting++)
+        if (this->pending_settings & (1 << setting))
+            this->ApplyJournalSetting(setting, state, true);
 
-    //  Inicjalizacja kontenera wiadomosci.
-    this->msg_ctrl = new MessageController(this->display_ctrl);
+    if (this->pending_settings & (PENDING_SETTING_BAUD_PC | PENDING_SETTING_BAUD_BT
+        | PENDING_SETTING_SENSOR_IN | PENDING_SETTING_SENSOR_OUT))
+        this->SaveData();
 
-    //  Wyswietlenie logo.
-    DisplayString * _display_string_center = this->display_strings[TEXT_ALIGN_CENTER];
-    _display_string_center->offset = 0;
-    _display_string_center->text = "AOS 3.0";
-    this->display_ctrl->PrintDS(_display_string_center, false);
+    this->pending_settings = 0;
+    this->serial_ctrl->WriteRawData_P(PSTR("Pending settings applied."), SERIAL_COM);
+}
 
-    //  Testowanie jasnosci wyswietlacza.
-    for (int b = 0; b <= DISPLAY_MAX_BRIGHTNESS; b++)
+//  ----------------------------------------------------------------------------
+/*  Pobranie bitu ustawienia zapisanego w linii conf.ini.
+ *  @param line: Linia pliku konfiguracji.
+ *  @return: Bit ustawienia (pending_settings) lub 0 dla nieznanej linii.
+ */
+byte GlobalController::GetPendingSetting(String & line)
+{
+    if (line.startsWith("alarm="))
+        return 1 << JOURNAL_SETTING_ALARM;
+    if (line.startsWith("beep_hours="))
+        return 1 << JOURNAL_SETTING_BEEP;
+    if (line.startsWith("brightness="))
+        return 1 << JOURNAL_SETTING_BRIGHTNESS;
+    if (line.startsWith("night="))
+        return 1 << JOURNAL_SETTING_NIGHT;
+    if (line.startsWith("baud_pc="))
+        return PENDING_SETTING_BAUD_PC;
+    if (line.startsWith("baud_bt="))
+        return PENDING_SETTING_BAUD_BT;
+    if (line.startsWith("sensor_in="))
+        return PENDING_SETTING_SENSOR_IN;
+    if (line.startsWith("sensor_out="))
+        return PENDING_SETTING_SENSOR_OUT;
+
+    return 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie aktualnych ustawien zapisywanych w dzienniku.
+ *  @param state: Wynikowe ustawienia.
+ */
+void GlobalController::GetJournalState(JournalState & state)
+{
+    state.alarm_hour = this->alarm->hour;
+    state.alarm_minute = this->alarm->minute;
+    state.beep_interval = this->buzzer_hour_change_interval;
+    state.brightness = this->brightness;
+    state.night_level = this->night_mode->GetLevel();
+    state.night_start = this->night_mode->GetStartHour();
+    state.night_end = this->night_mode->GetEndHour();
+    state.flags = (this->alarm->IsEnabled() ? JOURNAL_STATE_ALARM_ON : 0)
+        | (this->alarm->IsLed() ? JOURNAL_STATE_ALARM_LED : 0)
+        | (this->brightness_auto ? JOURNAL_STATE_AUTO_BRIGHT : 0)
+        | (this->night_mode->GetTrigger() == NIGHT_TRIGGER_SCHEDULE ? JOURNAL_STATE_NIGHT_HOURS : 0);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis zmiany ustawienia - dopisanie rekordu do dziennika (conf.ini jest przepisywany przy
+ *  punkcie kontrolnym), a gdy dziennik jest niedostepny przepisanie conf.ini od razu.
+ *  @param setting: Zmienione ustawienie JOURNAL_SETTING_*.
+ */
+void GlobalController::RecordSetting(byte setting)
+{
+    //  Przed wczytaniem konfiguracji zmiana czeka na zakonczenie uruchamiania (ApplyPendingSettings).
+    if (!this->initialized)
+    {
+        this->pending_settings |= (1 << setting);
+        return;
+    }
+
+    JournalState state;
+    this->GetJournalState(state);
+
+    if (!this->journal->AppendSetting(setting, state))
+        this->SaveData();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** NIGHT MODE PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Ustawienie wyswietlacza i czestotliwosci pracy zgodnie ze stanem trybu nocnego.
+ *  @param changed: True - tryb nocny zostal wlaczony lub wylaczony.
+ */
+void GlobalController::ApplyNightMode(bool changed = false)
+{
+    bool active = this->night_mode->IsActive();
+    bool blank  = this->night_mode->IsBlank();
+
+    //  Wyswietlacz jest usypiany tylko w trybie podstawowym - pozostale tryby wymagaja ekranu.
+    this->display_ctrl->SetShutdown(blank && this->global_state == GLOBAL_STATE_NORMAL);
+    this->power_mgr->SetTickInterval(!active ? POWER_TICK_INTERVAL : (blank ? NIGHT_TICK_BLANK : NIGHT_TICK_DIM));
+
+    if (!changed)
+        return;
+
+    //  Rzadsze odczyty czujnikow w nocy.
+    this->sensor_sampler->SetLightInterval(active ? NIGHT_LIGHT_INTERVAL : SAMPLER_LIGHT_INTERVAL);
+    this->onewire_bus_in->SetInterval(active ? NIGHT_BUS_INTERVAL : ONEWIRE_BUS_INTERVAL);
+    this->onewire_bus_out->SetInterval(active ? NIGHT_BUS_INTERVAL : ONEWIRE_BUS_INTERVAL);
+
+    if (active)
+        this->display_ctrl->SetBrightness(DISPLAY_MIN_BRIGHTNESS);
+    else if (this->brightness_auto)
+        this->ProcessAutoBrightness();
+    else
+        this->display_ctrl->SetBrightness(this->brightness);
+
+    //  W nocy wyswietlany jest tylko zegar, po zakonczeniu nocy strona z data.
+    if (this->global_state == GLOBAL_STATE_NORMAL)
     {
-        this->display_ctrl->SetBrightness(b);
-        delay(200);
+        this->display_ctrl->Clear();
+        this->SetDisplayingState(DISPLAY_DATETIME_STATE);
     }
+}
 
-    //  Testowanie wyswietlacza.
-    for (int x = 0; x < this->display_ctrl->GetWidth(); x++)
+////////////////////////////////////////////////////////////////////////////////
+//  *** POWER MANAGEMENT PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Sprawdzenie czy procesor moze zostac uspiony pomiedzy przebiegami petli. Stany z animacja
+ *  lub dzwiekiem (alarm, wiadomosc, odtwarzanie) wymagaja ciaglej pracy petli.
+ *  @return: Informacja o mozliwosci uspienia.
+ */
+bool GlobalController::IsIdleAllowed()
+{
+    switch (this->global_state)
     {
-        this->display_ctrl->DrawPoint(x, 7, 1);
-        delay(10);
+        case GLOBAL_STATE_NORMAL:
+        case GLOBAL_STATE_MENU:
+        case GLOBAL_STATE_SETTER:
+        case GLOBAL_STATE_SERVICE_LOCK:
+        case GLOBAL_STATE_LEDS:
+            return this->serial_ctrl->IsIdle();
+
+        default:
+            return false;
     }
+}
 
-    //  Wyczyszczenie wyswietlacza i wyswietlenie tekstu powitalnego.
-    _display_string_center->text = "Welcome";
-    
-    this->display_ctrl->Clear();
-    this->display_ctrl->PrintDS(_display_string_center, false);
-    delay(2000);
-    this->display_ctrl->ClearDS(_display_string_center);
+////////////////////////////////////////////////////////////////////////////////
+//  *** INITIALIZATION PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Inicjalizacja, konfiguracja i test modulu kontrolera zegara czasu rzeczywistego.
+ *  @return: BOOT_STATUS_FAIL gdy odczytana data jest niepoprawna (brak odpowiedzi DS3231).
+ */
+byte GlobalController::InitializeClock()
+{
+    this->clock_ctrl = clock_ctrl_instance.Create();
+    FixedString<CLOCK_TEXT_SIZE> text;
+
+    this->clock_ctrl->GetDate(text, "WDMY", '.');
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("DS3231 CLOCK Date: %s"), text.c_str());
+    this->clock_ctrl->GetTime(text, "HMS", ':');
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("DS3231 CLOCK Time: %s"), text.c_str());
+
+    Time now = this->clock_ctrl->Now();
+    this->update_timer = update_timer_instance.Create(now, DISPLAY_MODE_INTERVAL);
+
+    if (now.mon < 1 || now.mon > 12 || now.date < 1 || now.date > 31 || now.hour > 23 || now.min > 59)
+        return BOOT_STATUS_FAIL;
+
+    return BOOT_STATUS_OK;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Inicjalizacja, konfiguracja i test modulu kontrolera brzeczyka.
+ *  @return: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+byte GlobalController::InitializeBuzzer()
+{
+    this->buzzer_ctrl = buzzer_ctrl_instance.Create();
+    this->buzzer_ctrl->PlayToneAsync(NOTE_C8, 2);
+    return BOOT_STATUS_OK;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Inicjalizacja, konfiguracja i test modulu kontrolera wyswietlacza.
+ *  @return: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+byte GlobalController::InitializeDisplay()
+{
+    //  Konfiguracja modulu wyswietlacza - jasnosc jest zwiekszana stopniowo w ProcessBoot().
+    this->display_ctrl = display_ctrl_instance.Create(DISPLAY_MIN_BRIGHTNESS, Board::DISPLAY_SEGMENTS);
+
+    //  Inicjalizacja i konfiguracja kontenerow tekstowych wyswietlacza.
+    for (int dsp_index = 0; dsp_index < DISPLAY_STRINGS; dsp_index++)
+        this->display_strings[dsp_index] = display_string_instances[dsp_index].Create(0, dsp_index, "");
+        
+    this->display_strings[TEXT_ALIGN_LEFT]->_xpos = 0;
+    this->display_strings[TEXT_ALIGN_CENTER]->_xpos = this->display_ctrl->GetWidth()/2;
+    this->display_strings[TEXT_ALIGN_RIGHT]->_xpos = this->display_ctrl->GetWidth()-1;
+
+    //  Inicjalizacja kontenera wiadomosci.
+    this->msg_ctrl = msg_ctrl_instance.Create(this->display_ctrl);
     this->display_ctrl->Clear();
+    return BOOT_STATUS_OK;
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test kontrolera modulow IR i Led.
-void GlobalController::InitializeIRLed()
+/*  Inicjalizacja, konfiguracja i test kontrolera modulow IR i Led.
+ *  @return: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+byte GlobalController::InitializeIRLed()
 {
-    this->ir_controller = new IRController();
-    this->led_controller = new LedController(this->ir_controller);
+    this->ir_controller = ir_controller_instance.Create();
+    this->led_controller = led_controller_instance.Create(this->ir_controller);
+    return BOOT_STATUS_OK;
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test modulu kontrolera fotorezystorow.
-void GlobalController::InitializePhotoresistors()
+/*  Otwarcie dziennika zdarzen i odtworzenie zmian ustawien zapisanych po ostatnim punkcie
+ *  kontrolnym (w tle, po wczytaniu conf.ini). Bez conf.ini ustawienia pochodza z punktu kontrolnego.
+ *  @return: BOOT_STATUS_FAIL gdy dziennik jest niedostepny (zmiany sa zapisywane w conf.ini).
+ */
+byte GlobalController::InitializeJournal()
 {
-    this->photoresistor_ctrl_left = new PhotoresistorController(A10);
-    this->photoresistor_ctrl_right = new PhotoresistorController(A11);
-    this->serial_ctrl->WriteRawData("GL5528 Light Left:  " + String(this->photoresistor_ctrl_left->GetBrightness()), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("GL5528 Light Right: " + String(this->photoresistor_ctrl_right->GetBrightness()), SERIAL_COM);
+    if (!this->journal->Open())
+        return BOOT_STATUS_FAIL;
+
+    JournalState state;
+    this->GetJournalState(state);
+
+    int restored = this->journal->Restore(state, this->boot_report->GetStatus(BOOT_DEVICE_CONFIG) != BOOT_STATUS_OK);
+
+    if (restored > 0)
+        this->ApplyJournalState(state);
+
+    this->journal->AppendEvent(JOURNAL_BOOT, this->boot_report->GetCount(BOOT_STATUS_FAIL));
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("Journal: %d records restored"), restored);
+
+    return BOOT_STATUS_OK;
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test modulu kontrolera czytnika kart sd.
-void GlobalController::InitializeSdCard()
+/*  Inicjalizacja, konfiguracja i test modulu kontrolera fotorezystorow.
+ *  @return: Wynik inicjalizacji BOOT_STATUS_*.
+ */
+byte GlobalController::InitializePhotoresistors()
+{
+    this->photoresistor_ctrl_left = photoresistor_ctrl_left_instance.Create(LIGHT_SENSOR_PIN_L);
+    this->photoresistor_ctrl_right = photoresistor_ctrl_right_instance.Create(LIGHT_SENSOR_PIN_R);
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("GL5528 Light Left:  %d"), this->photoresistor_ctrl_left->GetBrightness());
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("GL5528 Light Right: %d"), this->photoresistor_ctrl_right->GetBrightness());
+    return BOOT_STATUS_OK;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Inicjalizacja i montowanie karty sd (w tle, po wyswietleniu zegara).
+ *  @return: BOOT_STATUS_FAIL gdy brak karty lub nie udalo sie jej zamontowac.
+ */
+byte GlobalController::InitializeSdCard()
 {
-    this->sdcard_ctrl = new SdCardController();
+    this->sdcard_ctrl->Initialize();
+    this->sdcard_ctrl->Mount();
     
+    //  Brak karty sygnalizowany jest trzema dzwiekami odtwarzanymi w ProcessBoot().
     if (!this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
     {
-        this->buzzer_ctrl->PlayTone(NOTE_C7, 8);
-        delay(100);
-        this->buzzer_ctrl->PlayTone(NOTE_C7, 8);
-        delay(100);
-        this->buzzer_ctrl->PlayTone(NOTE_C7, 8);
-        delay(100);
-        return;
+        this->boot_beeps = BOOT_ERROR_BEEPS;
+        return BOOT_STATUS_FAIL;
     }
 
-    this->serial_ctrl->WriteRawData("SD-CARD HW-125 Type:     " + this->sdcard_ctrl->GetCardType(), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("SD-CARD HW-125 Format:   " + this->sdcard_ctrl->GetPartitionFormat(), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("SD-CARD HW-125 Blocks:   " + String(this->sdcard_ctrl->GetPartitionBlocks()), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("SD-CARD HW-125 Clusters: " + String(this->sdcard_ctrl->GetPartitionClusters()), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("SD-CARD HW-125 Size:     " + String(this->sdcard_ctrl->GetPartitionSizeInMB()) + "MB", SERIAL_COM);
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("SD-CARD HW-125 Type:     %s"), this->sdcard_ctrl->GetCardType().c_str());
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("SD-CARD HW-125 Format:   %s"), this->sdcard_ctrl->GetPartitionFormat().c_str());
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("SD-CARD HW-125 Blocks:   %lu"), (unsigned long) this->sdcard_ctrl->GetPartitionBlocks());
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("SD-CARD HW-125 Clusters: %lu"), (unsigned long) this->sdcard_ctrl->GetPartitionClusters());
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("SD-CARD HW-125 Size:     %luMB"), (unsigned long) this->sdcard_ctrl->GetPartitionSizeInMB());
+    return BOOT_STATUS_OK;
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test kontrolera modulu sensorow temperatury.
+//  Inicjalizacja kontrolera modulu sensorow temperatury (wyszukanie czujnikow odbywa sie w tle).
 void GlobalController::InitializeTemperatureSensors()
 {
-    this->temp_sensor_ctrl_in = new TemperatureSensorController(A9);
-    this->temp_sensor_ctrl_out = new TemperatureSensorController(A8);
-    this->serial_ctrl->WriteRawData("DALLAS DS18B20 Thermometer IN:  " + String(this->temp_sensor_ctrl_in->GetTemperature()), SERIAL_COM);
-    this->serial_ctrl->WriteRawData("DALLAS DS18B20 Thermometer OUT: " + String(this->temp_sensor_ctrl_out->GetTemperature()), SERIAL_COM);
+    //  Czujniki na wspolnym pinie dziela magistrale - zewnetrzny jest drugim wykrytym czujnikiem.
+    this->onewire_bus_in = onewire_bus_in_instance.Create(TEMPERATURE_SENSOR_PIN_IN);
+
+    if (TEMPERATURE_SENSOR_PIN_OUT == TEMPERATURE_SENSOR_PIN_IN)
+    {
+        this->onewire_bus_out = this->onewire_bus_in;
+        this->temp_sensor_ctrl_out = temp_sensor_ctrl_out_instance.Create(this->onewire_bus_out, 1);
+    }
+    else
+    {
+        this->onewire_bus_out = onewire_bus_out_instance.Create(TEMPERATURE_SENSOR_PIN_OUT);
+        this->temp_sensor_ctrl_out = temp_sensor_ctrl_out_instance.Create(this->onewire_bus_out, 0);
+    }
+
+    this->temp_sensor_ctrl_in = temp_sensor_ctrl_in_instance.Create(this->onewire_bus_in, 0);
+
+    //  Usluga probkowania - odczyty temperatur pojawiaja sie po pierwszym cyklu magistrali.
+    this->sensor_sampler = sensor_sampler_instance.Create(this->photoresistor_ctrl_left,
+        this->photoresistor_ctrl_right, this->temp_sensor_ctrl_in, this->temp_sensor_ctrl_out);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyszukanie czujnikow temperatury na magistralach (w tle, pierwsza konwersja bez oczekiwania).
+ *  @return: BOOT_STATUS_FAIL gdy brak czujnikow, BOOT_STATUS_WARN gdy brak jednego z nich.
+ */
+byte GlobalController::DiscoverTemperatureSensors()
+{
+    this->onewire_bus_in->Discover();
+
+    if (this->onewire_bus_out != this->onewire_bus_in)
+        this->onewire_bus_out->Discover();
+
+    this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE,
+        PSTR("DALLAS DS18B20 Sensors:         %d"),
+        this->onewire_bus_in->GetDeviceCount()
+            + (this->onewire_bus_out != this->onewire_bus_in ? this->onewire_bus_out->GetDeviceCount() : 0));
+
+    bool connected_in = this->temp_sensor_ctrl_in->IsConnected();
+    bool connected_out = this->temp_sensor_ctrl_out->IsConnected();
+
+    if (!connected_in && !connected_out)
+        return BOOT_STATUS_FAIL;
+
+    return connected_in && connected_out ? BOOT_STATUS_OK : BOOT_STATUS_WARN;
 }
 
 //  ----------------------------------------------------------------------------
 //  Inicjalizacja komponentu alarmu.
 void GlobalController::InitializeAlarm()
 {
-    this->alarm = new Alarm();
+    this->alarm = alarm_instance.Create();
 }
 
 //  ----------------------------------------------------------------------------
 //  Inicjalizacja komponentu prognozy pogody.
 void GlobalController::InitializeWeather()
 {
-    this->weather = new Weather(this->sdcard_ctrl, this->serial_ctrl);
+    this->weather = weather_instance.Create(this->sdcard_ctrl, this->serial_ctrl);
 }
 
 //  ----------------------------------------------------------------------------
-//  Inicjalizacja, konfiguracja i test urzadzen peryferyjnych.
+/*  Inicjalizacja urzadzen peryferyjnych potrzebnych do wyswietlenia zegara. Obiekty wszystkich
+ *  kontrolerow sa tworzone od razu, a wolne operacje (karta SD, wyszukanie czujnikow,
+ *  konfiguracja) wykonuje ProcessBoot() w kolejnych przebiegach petli. Wynik i czas
+ *  inicjalizacji kazdego urzadzenia trafia do raportu uruchomienia (/boot).
+ */
 void GlobalController::Initialize()
 {
     //  Inicjalizacja i konfiguracja diody kontrolnej.
     pinMode(LED_BUILTIN, OUTPUT);
+    this->boot_report = boot_report_instance.Create();
 
     //  Inicjalizacja, konfiguracja i test modulu kontrolera brzeczyka.
-    this->InitializeBuzzer();
-
-    //  Wstepny czas oczekiwania na zainicjalizowanie sie pozostalych urzadzen.
-    delay(2000);
+    this->boot_report->Begin(BOOT_DEVICE_BUZZER);
+    this->boot_report->End(this->InitializeBuzzer());
 
     //  Inicjalizacja, konfiguracja i test polaczenia szeregowego i modulow kontrolnych.
-    this->keypad_ctrl = new KeypadController();
-    this->serial_ctrl = new SerialController();
+    this->boot_report->Begin(BOOT_DEVICE_KEYPAD);
+    this->keypad_ctrl = keypad_ctrl_instance.Create();
+    this->boot_report->End(BOOT_STATUS_OK);
+
+    this->boot_report->Begin(BOOT_DEVICE_SERIAL);
+    this->serial_ctrl = serial_ctrl_instance.Create();
+    this->boot_report->End(BOOT_STATUS_OK);
+    this->memory_monitor = memory_monitor_instance.Create(this->serial_ctrl);
 
-    //  Inicjalizacja, konfiguracja i test modulu kontrolera czytnika kart sd.
-    this->InitializeSdCard();
+    //  Kontroler czytnika kart sd - montowanie karty w tle.
+    this->sdcard_ctrl = sdcard_ctrl_instance.Create(false);
+    this->command_recorder = command_recorder_instance.Create(this->sdcard_ctrl);
 
     //  Inicjalizacja, konfiguracja i test modulu kontrolera zegara czasu rzeczywistego.
-    this->InitializeClock();
+    this->boot_report->Begin(BOOT_DEVICE_CLOCK);
+    this->boot_report->End(this->InitializeClock());
 
     //  Inicjalizacja, konfiguracja i test modulu kontrolera fotorezystorow.
-    this->InitializePhotoresistors();
+    this->boot_report->Begin(BOOT_DEVICE_LIGHT);
+    this->boot_report->End(this->InitializePhotoresistors());
 
     //  Inicjalizacja, konfiguracja i test kontrolera modulu sensorow temperatury.
     this->InitializeTemperatureSensors();
 
     //  Inicjalizacja, konfiguracja i test kontrolera modulow IR i Led.
-    this->InitializeIRLed();
+    this->boot_report->Begin(BOOT_DEVICE_IRLED);
+    this->boot_report->End(this->InitializeIRLed());
 
     //  Inicjalizacja, konfiguracja i test modulu kontrolera wyswietlacza.
-    this->InitializeDisplay();
+    this->boot_report->Begin(BOOT_DEVICE_DISPLAY);
+    this->boot_report->End(this->InitializeDisplay());
 
     //  Inicjalizacja dodatkowych zaleznych komponentow.
     this->InitializeAlarm();
     this->InitializeWeather();
-    this->song_controller = new SongController(this->display_ctrl, this->buzzer_ctrl);
-
-    //  Zaladowanie danych z pliku.
-    this->LoadData();
+    this->temp_logger = temp_logger_instance.Create(
+        this->clock_ctrl, this->sdcard_ctrl, this->sensor_sampler);
+    this->journal = journal_instance.Create(this->clock_ctrl, this->sdcard_ctrl);
+    this->song_controller = song_controller_instance.Create(this->display_ctrl, this->buzzer_ctrl);
+    this->vplayer_ctrl = vplayer_ctrl_instance.Create(this->display_ctrl, this->serial_ctrl);
+
+    //  Usypianie procesora pomiedzy przebiegami petli i wylaczenie nieuzywanych peryferiow.
+    this->power_mgr = power_mgr_instance.Create(this->keypad_ctrl, this->serial_ctrl);
+    this->power_mgr->Begin();
+    this->night_mode = night_mode_instance.Create();
+
+    if (POWER_PIN_SQW >= 0)
+        this->clock_ctrl->EnableSquareWave();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -452,8 +993,6 @@ void GlobalController::Initialize()
 GlobalController::GlobalController()
 {
     this->Initialize();
-
-    this->initialized = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -466,7 +1005,7 @@ void GlobalController::DisableAlarm(bool save_to_file = true)
     this->alarm->DisableAlarm();
 
     if (save_to_file)
-        this->SaveData();
+        this->RecordSetting(JOURNAL_SETTING_ALARM);
 }
 
 //  ----------------------------------------------------------------------------
@@ -479,13 +1018,22 @@ void GlobalController::SetAlarm(int hour, int minute, bool enabled = true, bool
     this->alarm->SetAlarm(hour, minute, enabled, is_led);
 
     if (save_to_file)
-        this->SaveData();
+        this->RecordSetting(JOURNAL_SETTING_ALARM);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** BRIGHTNESS PUBLIC METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+/*  Pobranie jasnosci ustawionej recznie (w nocy wyswietlacz pracuje z jasnoscia minimalna).
+ *  @return: Jasnosc wyswietlacza.
+ */
+int GlobalController::GetBrightness()
+{
+    return this->brightness;
+}
+
+//  ----------------------------------------------------------------------------
 /*  Sprawdzenie czy ustawiona jest jasnosc automatyczna.
  *  @return: True - Jasnosc ustawiona automatycznie; False - w innym przypadku.
  */
@@ -503,7 +1051,7 @@ void GlobalController::SetAutoBrightness(bool enabled, bool save_to_file = true)
     this->brightness_auto = enabled;
 
     if (save_to_file)
-        this->SaveData();
+        this->RecordSetting(JOURNAL_SETTING_BRIGHTNESS);
 }
 
 //  ----------------------------------------------------------------------------
@@ -513,10 +1061,11 @@ void GlobalController::SetAutoBrightness(bool enabled, bool save_to_file = true)
 void GlobalController::SetBrightness(int brightness, bool save_to_file = true)
 {
     this->brightness_auto = false;
-    this->display_ctrl->SetBrightness(brightness);
+    this->brightness = max(DISPLAY_MIN_BRIGHTNESS, min(brightness, DISPLAY_MAX_BRIGHTNESS));
+    this->display_ctrl->SetBrightness(min(this->brightness, this->boot_fade));
 
     if (save_to_file)
-        this->SaveData();
+        this->RecordSetting(JOURNAL_SETTING_BRIGHTNESS);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -541,7 +1090,7 @@ void GlobalController::SetBuzzerHourNotifierInterval(int interval = 0, bool save
         this->buzzer_hour_change_interval = 0;
     
     if (save_to_file)
-        this->SaveData();
+        this->RecordSetting(JOURNAL_SETTING_BEEP);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -556,7 +1105,10 @@ void GlobalController::ProcessAlarm()
         Time datetime_now = this->clock_ctrl->Now();
         
         if (this->alarm->CheckTrigger(datetime_now))
+        {
             this->SetMachineState(GLOBAL_STATE_ALARM);
+            this->journal->AppendEvent(JOURNAL_ALARM_FIRE);
+        }
     }
 }
 
@@ -564,12 +1116,25 @@ void GlobalController::ProcessAlarm()
 //  Ustawienie jasnosci poprzez opcje jasnosci automatycznej.
 void GlobalController::ProcessAutoBrightness(bool override = false)
 {
+    //  W nocy wyswietlacz pracuje z jasnoscia minimalna.
+    if (this->night_mode->IsActive())
+        return;
+
     if (this->brightness_auto || override)
     {
-        int brightness  = (this->photoresistor_ctrl_left->GetMappedBrightness(DISPLAY_MAX_BRIGHTNESS)
-            + this->photoresistor_ctrl_right->GetMappedBrightness(DISPLAY_MAX_BRIGHTNESS)) / 2;
+        int left    = this->sensor_sampler->GetMappedValue(
+            SAMPLER_LIGHT_LEFT, LIGHT_SENSOR_MIN_VALUE, LIGHT_SENSOR_MAX_VALUE, DISPLAY_MAX_BRIGHTNESS);
+        int right   = this->sensor_sampler->GetMappedValue(
+            SAMPLER_LIGHT_RIGHT, LIGHT_SENSOR_MIN_VALUE, LIGHT_SENSOR_MAX_VALUE, DISPLAY_MAX_BRIGHTNESS);
+
+        //  Brak aktualnych odczytow - jasnosc pozostaje bez zmian, jeden czujnik wystarcza.
+        if (left < 0 && right < 0)
+            return;
+
+        int brightness  = left < 0 ? right : (right < 0 ? left : (left + right) / 2);
         
-        this->display_ctrl->SetBrightness(brightness);
+        //  Po uruchomieniu jasnosc jest ograniczona przez rozjasnianie ekranu (ProcessBoot).
+        this->display_ctrl->SetBrightness(min(brightness, this->boot_fade));
     }
 }
 
@@ -593,6 +1158,56 @@ void GlobalController::ProcessBeepHour()
     }
 }
 
+//  ----------------------------------------------------------------------------
+/*  Zapis oczekujacych rekordow dziennika i punkt kontrolny (przepisanie conf.ini po zmianach ustawien).
+ *  @param checkpoint: Wymuszenie punktu kontrolnego (conf.ini jest zapisywany zawsze).
+ *  @return: False - punkt kontrolny nie zostal zapisany.
+ */
+bool GlobalController::ProcessJournal(bool checkpoint = false)
+{
+    bool result = true;
+
+    if (checkpoint || this->journal->IsCheckpointDue())
+    {
+        JournalState state;
+
+        //  Punkt kontrolny zastepuje zmiany zapisane w conf.ini - gdy conf.ini nie zostal zapisany,
+        //  zmiany pozostaja w dzienniku, a punkt kontrolny jest ponawiany pozniej.
+        if ((checkpoint || this->journal->HasChanges()) && !this->SaveData())
+        {
+            this->journal->PostponeCheckpoint();
+            result = false;
+        }
+        else
+        {
+            this->GetJournalState(state);
+            result = this->journal->AppendCheckpoint(state);
+        }
+    }
+
+    this->journal->Process();
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+//  Sprawdzenie warunkow trybu nocnego i ustawienie wyswietlacza.
+void GlobalController::ProcessNightMode()
+{
+    bool changed = false;
+
+    if (this->night_mode->IsCheckDue())
+    {
+        //  Zegar jest odczytywany tylko dla harmonogramu; noc konczy juz jeden oswietlony czujnik.
+        int hour  = this->night_mode->GetTrigger() == NIGHT_TRIGGER_SCHEDULE ? this->clock_ctrl->Now().hour : 0;
+        int light = max(this->sensor_sampler->GetValue(SAMPLER_LIGHT_LEFT),
+            this->sensor_sampler->GetValue(SAMPLER_LIGHT_RIGHT));
+
+        changed = this->night_mode->Update(hour, light < 0 ? -1 : light);
+    }
+
+    this->ApplyNightMode(changed);
+}
+
 //  ----------------------------------------------------------------------------
 //  Miganie wbudowana dioda led podczas zmianiy sekundy.
 void GlobalController::ProcessSecondLedBlinking()
@@ -605,6 +1220,23 @@ void GlobalController::ProcessSecondLedBlinking()
 //  Przetwarzanie funkcjonalnosci.
 void GlobalController::ProcessFunctionalities()
 {
+    //  Kontrola wykorzystania pamieci RAM.
+    this->memory_monitor->Update();
+
+    //  Dokonczenie uruchamiania w tle.
+    this->ProcessBoot();
+
+    //  Zapis dziennika zdarzen.
+    this->ProcessJournal();
+
+    //  Odczyty czujnikow przed trybem nocnym - przy wygaszonym wyswietlaczu odstep przebiegow petli
+    //  rowna sie dopuszczalnemu wiekowi odczytu swiatla, wiec noc konczy odczyt z tego przebiegu.
+    //  Temperatury z magistrali trafiaja do probkowania w kolejnym przebiegu.
+    this->sensor_sampler->Process();
+
+    //  Tryb nocny (rowniez w trakcie odtwarzania - wybudzenie wyswietlacza).
+    this->ProcessNightMode();
+
     //  Pominiecie niepotrzebnych wykonan dla okreslonego stanu.
     if (this->global_state == GLOBAL_STATE_SONG_PLAY)
         return;
@@ -613,6 +1245,15 @@ void GlobalController::ProcessFunctionalities()
     this->ProcessAutoBrightness();
     this->ProcessBeepHour();
     this->ProcessAlarm();
+
+    //  Cykl pomiarowy czujnikow temperatury (jedna konwersja na magistrale).
+    this->onewire_bus_in->Process();
+
+    if (this->onewire_bus_out != this->onewire_bus_in)
+        this->onewire_bus_out->Process();
+
+    //  Rejestracja historii temperatur.
+    this->temp_logger->Process();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -713,29 +1354,46 @@ void GlobalController::ProcessDisplay(bool force_refresh = false)
         force_update = auto_switch || day_changed;
     }
 
+    //  W nocy wyswietlany jest tylko zegar, a wygaszony wyswietlacz nie jest odswiezany.
+    if (this->night_mode->IsActive())
+    {
+        if (this->night_mode->IsBlank())
+            return;
+
+        if (force_update)
+        {
+            this->display_ctrl->Clear();
+            this->display_page_flags = DISPLAY_PAGE_CLOCK;
+        }
+
+        this->DisplayClock();
+        return;
+    }
+
     //  Wyswietlenie danych na ekranie.
     if (force_update)
     {
-        switch (this->display_state)
+        DisplayPage page;
+        memcpy_P(&page, &display_pages[this->display_state], sizeof(DisplayPage));
+
+        //  Przejscie pomiedzy strona pelnoekranowa i strona z zegarem wymaga wyczyszczenia ekranu.
+        if (page.flags != this->display_page_flags)
         {
-            case DISPLAY_DATETIME_STATE:
-                this->DisplayDate();
-                break;
-            
-            case DISPLAY_TEMPERATURE_IN_STATE:
-                this->DisplayTemperatureInside();
-                break;
-            
-            case DISPLAY_TEMPERATURE_OUT_STATE:
-                this->DisplayTemperatureOutside();
-                break;
+            this->display_ctrl->Clear();
+            this->display_page_flags = page.flags;
         }
 
-        if (this->alarm->IsEnabled())
+        (this->*page.draw)();
+
+        if ((page.flags & DISPLAY_PAGE_CLOCK) && this->alarm->IsEnabled())
             this->DisplayAlarmIsSet();
     }
 
-    this->DisplayClock();
+    if (this->display_page_flags & DISPLAY_PAGE_CLOCK)
+        this->DisplayClock();
+
+    //  Pomiar czasu od uruchomienia do pierwszej klatki z zegarem.
+    this->boot_report->MarkClock();
 }
 
 //  ----------------------------------------------------------------------------
@@ -755,6 +1413,69 @@ void GlobalController::SetDisplayingState(int displaying_state, bool reset_timer
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** NIGHT MODE MANAGEMENT PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Ustawienie trybu nocnego.
+ *  @param config: Konfiguracja w postaci "<off|dim|blank> [light|hh-hh]".
+ *  @param save_to_file: Zapisanie konfiguracji do pliku.
+ *  @return: True - konfiguracja poprawna.
+ */
+bool GlobalController::SetNightMode(const char * config, bool save_to_file = true)
+{
+    if (!this->night_mode->ParseConfig(config))
+        return false;
+
+    if (save_to_file)
+        this->RecordSetting(JOURNAL_SETTING_NIGHT);
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie poziomu trybu nocnego (bez zmiany sposobu wlaczania).
+ *  @param level: NIGHT_MODE_OFF, NIGHT_MODE_DIM lub NIGHT_MODE_BLANK.
+ *  @param save_to_file: Zapisanie konfiguracji do pliku.
+ */
+void GlobalController::SetNightModeLevel(byte level, bool save_to_file = true)
+{
+    this->night_mode->SetLevel(level);
+
+    if (save_to_file)
+        this->RecordSetting(JOURNAL_SETTING_NIGHT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** TEMPERATURE SENSORS MANAGEMENT PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Przypisanie czujnika temperatury po adresie ROM (kolejnosc wyszukiwania na wspolnej magistrali
+ *  zalezy od adresow, wiec po wymianie czujnika mogla by zamienic wewnetrzny z zewnetrznym).
+ *  @param outside: True - czujnik zewnetrzny; False - czujnik wewnetrzny.
+ *  @param address: Adres szesnastkowy (16 znakow) lub "auto" - kolejnosc wyszukiwania.
+ *  @param save_to_file: Zapisanie konfiguracji do pliku.
+ *  @return: True - adres poprawny.
+ */
+bool GlobalController::SetTemperatureSensor(bool outside, const char * address, bool save_to_file = true)
+{
+    TemperatureSensorController * sensor = outside ? this->temp_sensor_ctrl_out : this->temp_sensor_ctrl_in;
+    DeviceAddress rom;
+
+    if (strcmp_P(address, PSTR("auto")) == 0)
+        sensor->SetAddress(NULL);
+    else if (OneWireBus::ParseAddress(address, rom))
+        sensor->SetAddress(rom);
+    else
+        return false;
+
+    //  Przypisanie zmienia sie rzadko (wymiana czujnika) - zapis bezposrednio do conf.ini.
+    if (save_to_file)
+        this->SaveSetting(outside ? PENDING_SETTING_SENSOR_OUT : PENDING_SETTING_SENSOR_IN);
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** INPUT PUBLIC METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
@@ -776,6 +1497,15 @@ char GlobalController::GetInputKey()
     return this->input_key;
 }
 
+//  ----------------------------------------------------------------------------
+/*  Pobranie ostatniego zdarzenia klawiatury (wcisniecie, powtorzenie, przytrzymanie lub zwolnienie).
+ *  @return: Zdarzenie klawiatury (typ KEYPAD_EVENT_NONE gdy brak zdarzenia).
+ */
+KeypadEvent GlobalController::GetInputKeyEvent()
+{
+    return this->input_key_event;
+}
+
 //  ----------------------------------------------------------------------------
 /*  Sprawdzenie czy zostala wprowadzona komenda z portu szeregowego.
  *  @return: True - komenda została wprowadzona; False - w innym wypadku.
@@ -792,8 +1522,30 @@ bool GlobalController::IsCommandValueInputed()
 void GlobalController::ProcessInput()
 {
     //  Odczytanie danych przychodzacych z urzadzen wejscia/wyjscia.
-    this->input_command_value = this->serial_ctrl->ReadInputData();
-    this->input_key = this->keypad_ctrl->GetPressedKey();
+    //  W trybie odtwarzacza obrazu dane binarne odbiera bezposrednio VPlayerController.
+    if (this->serial_ctrl->ProcessNegotiation() == SERIAL_BAUD_COMMITTED)
+        this->SaveSetting(PENDING_SETTING_BAUD_BT);
+
+    //  Bez oczekujacych danych nie sa tworzone zadne obiekty String (brak alokacji w petli).
+    if (this->global_state == GLOBAL_STATE_VPLAYER || !this->serial_ctrl->HasInputData())
+        this->input_command_value = "";
+    else
+        this->input_command_value = this->serial_ctrl->ReadInputData();
+
+    //  Zdarzenia klawiatury sa zbierane w przerwaniu - w jednym cyklu pobierane jest jedno
+    //  zdarzenie, pozostale czekaja w kolejce.
+    this->input_key_event = KeypadEvent();
+    this->keypad_ctrl->ReadEvent(this->input_key_event);
+
+    this->input_key = this->input_key_event.type == KEYPAD_EVENT_PRESS
+        ? this->input_key_event.key : KEYPAD_NO_KEY;
+
+    //  Klawisz przy wygaszonym wyswietlaczu tylko go wybudza.
+    if (this->input_key != KEYPAD_NO_KEY && this->global_state == GLOBAL_STATE_NORMAL && this->night_mode->IsBlank())
+    {
+        this->night_mode->Wake();
+        this->input_key = KEYPAD_NO_KEY;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -817,6 +1569,78 @@ bool GlobalController::IsServiceLocked()
     return this->global_state == GLOBAL_STATE_SERVICE_LOCK;
 }
 
+//  ----------------------------------------------------------------------------
+/*  Uruchamianie w tle - jeden etap na przebieg petli, rozpoczynane po wyswietleniu zegara.
+ *  Rownolegle rozjasniany jest ekran i odtwarzane sa sygnaly bledu karty SD.
+ */
+void GlobalController::ProcessBoot()
+{
+    unsigned long now = millis();
+
+    //  Rozjasnianie ekranu (zamiast blokujacego testu jasnosci), w nocy jasnosc jest minimalna.
+    if (this->boot_fade < DISPLAY_MAX_BRIGHTNESS && now - this->boot_fade_time >= BOOT_FADE_INTERVAL)
+    {
+        this->boot_fade_time = now;
+        this->boot_fade = this->night_mode->IsActive() ? DISPLAY_MAX_BRIGHTNESS : this->boot_fade + 1;
+
+        if (this->brightness_auto)
+            this->ProcessAutoBrightness();
+        else if (!this->night_mode->IsActive())
+            this->display_ctrl->SetBrightness(min(this->brightness, this->boot_fade));
+    }
+
+    //  Sygnaly bledu karty SD.
+    if (this->boot_beeps > 0 && !this->buzzer_ctrl->UpdateToneAsync()
+        && now - this->boot_beep_time >= BOOT_ERROR_BEEP_INTERVAL)
+    {
+        this->boot_beep_time = now;
+        this->boot_beeps--;
+        this->buzzer_ctrl->PlayToneAsync(NOTE_C7, 8);
+    }
+
+    if (this->boot_stage == BOOT_STAGE_READY || this->boot_report->GetClockTime() == 0)
+        return;
+
+    switch (this->boot_stage)
+    {
+        case BOOT_STAGE_SDCARD:
+            this->boot_report->Begin(BOOT_DEVICE_SDCARD);
+            this->boot_report->End(this->InitializeSdCard());
+            break;
+
+        case BOOT_STAGE_SENSORS:
+            this->boot_report->Begin(BOOT_DEVICE_SENSORS);
+            this->boot_report->End(this->DiscoverTemperatureSensors());
+            break;
+
+        case BOOT_STAGE_CONFIG:
+            //  Brak karty lub pliku konfiguracji - praca z ustawieniami domyslnymi.
+            this->boot_report->Begin(BOOT_DEVICE_CONFIG);
+            this->boot_report->End(this->LoadData() ? BOOT_STATUS_OK : BOOT_STATUS_WARN);
+            break;
+
+        case BOOT_STAGE_JOURNAL:
+        {
+            //  Ustawienia zmienione w trakcie uruchamiania - odtworzenie dziennika je nadpisze.
+            JournalState pending;
+            this->GetJournalState(pending);
+
+            this->boot_report->Begin(BOOT_DEVICE_JOURNAL);
+            this->boot_report->End(this->InitializeJournal());
+            this->boot_report->MarkReady();
+            this->initialized = true;
+            this->ApplyPendingSettings(pending);
+
+            FixedString<96> summary;
+            this->boot_report->GetSummary(summary);
+            this->serial_ctrl->WriteRawData(summary.c_str(), SERIAL_COM);
+            break;
+        }
+    }
+
+    this->boot_stage++;
+}
+
 //  ----------------------------------------------------------------------------
 /*  Pobranie indeksu aktualnego trybu pracy uzadzenia.
  *  @result: Indeks aktualnego trybu pracy uzadzenia.
@@ -834,7 +1658,12 @@ void GlobalController::SetMachineState(int machine_state)
 {
     this->force_display_refresh = true;
     this->global_state = machine_state % GLOBAL_STATES;
-    this->serial_ctrl->WriteRawData("Entering mode: " + String(machine_state % GLOBAL_STATES), this->serial_ctrl->GetLastInputDevice());
+
+    //  Wygaszenie nocne dotyczy tylko trybu podstawowego.
+    if (this->global_state != GLOBAL_STATE_NORMAL)
+        this->display_ctrl->SetShutdown(false);
+    this->serial_ctrl->WriteFormat_P(
+        this->serial_ctrl->GetLastInputDevice(), SERIAL_PRIORITY_DEBUG, PSTR("Entering mode: %d"), this->global_state);
 }
 
 //  ----------------------------------------------------------------------------
@@ -844,28 +1673,44 @@ void GlobalController::FinalizeCycle()
     this->force_display_refresh = false;
     this->input_command_value = "";
     this->input_key = 0;
+    this->input_key_event = KeypadEvent();
+
+    //  Wyslanie oczekujacych danych wyjsciowych.
+    this->serial_ctrl->Tick();
+}
+
+//  ----------------------------------------------------------------------------
+//  Uspienie procesora do kolejnego przebiegu petli (czas mierzony jako sekcja "idle").
+void GlobalController::Idle()
+{
+    PROFILE_SCOPE(PROFILE_SECTION_IDLE);
+
+    this->power_mgr->Idle(this->IsIdleAllowed());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** MACHINE STATES MANAGEMENT PUBLIC METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-//  Zaladowanie konfiguracji z pliku.
-void GlobalController::LoadData()
+/*  Zaladowanie konfiguracji z pliku.
+ *  @return: True - konfiguracja wczytana, false - brak karty sd lub pliku konfiguracji.
+ */
+bool GlobalController::LoadData()
 {
+    PROFILE_SCOPE(PROFILE_SECTION_CONFIG_LOAD);
     char character = ' ';
     String line = "";
 
     if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
     {
-        if (!this->sdcard_ctrl->FileExists(CONFIG_FILE_NAME))
-            return;
-        
         File file = this->sdcard_ctrl->OpenFileToRead(CONFIG_FILE_NAME);
 
-        this->serial_ctrl->WriteRawData("", SERIAL_COM);
-        this->serial_ctrl->WriteRawData("Loading data from file...", SERIAL_COM);
-        this->serial_ctrl->WriteRawData("", SERIAL_COM);
+        if (!file)
+            return false;
+
+        this->serial_ctrl->WriteRawData_P(PSTR(""), SERIAL_COM);
+        this->serial_ctrl->WriteRawData_P(PSTR("Loading data from file..."), SERIAL_COM);
+        this->serial_ctrl->WriteRawData_P(PSTR(""), SERIAL_COM);
 
         while (file.available()) {
             while (file.available() && character != '\n')
@@ -882,7 +1727,11 @@ void GlobalController::LoadData()
             }
             
             line.toLowerCase();
-            Serial.println(line);
+            this->serial_ctrl->WriteRawData(line, SERIAL_COM, SERIAL_PRIORITY_DEBUG);
+
+            //  Ustawienia zmienione w trakcie uruchamiania maja pierwszenstwo przed zapisanymi.
+            if (this->pending_settings & this->GetPendingSetting(line))
+                line = "";
 
             //  Load alarm configuration.
             if (line.startsWith("alarm="))
@@ -926,36 +1775,100 @@ void GlobalController::LoadData()
                     this->SetBrightness(max(0, min(8, line.toInt())), false);
             }
 
+            //  Load night mode configuration.
+            else if (line.startsWith("night="))
+                this->SetNightMode(line.c_str() + 6, false);
+
+            //  Load serial baudrate configuration.
+            else if (line.startsWith("baud_pc="))
+                this->serial_ctrl->SetBaudrate(line.substring(8).toInt(), SERIAL_COM);
+
+            else if (line.startsWith("baud_bt="))
+                this->serial_ctrl->SetBaudrate(line.substring(8).toInt(), SERIAL_BLUETOOTH);
+
+            //  Load temperature sensors ROM addresses.
+            else if (line.startsWith("sensor_in="))
+                this->SetTemperatureSensor(false, line.c_str() + 10, false);
+
+            else if (line.startsWith("sensor_out="))
+                this->SetTemperatureSensor(true, line.c_str() + 11, false);
+
             character = ' ';
             line = "";
         }
 
         file.close();
 
-        this->serial_ctrl->WriteRawData("", SERIAL_COM);
-        this->serial_ctrl->WriteRawData("Configuration loaded!", SERIAL_COM);
-        this->serial_ctrl->WriteRawData("", SERIAL_COM);
+        this->serial_ctrl->WriteRawData_P(PSTR(""), SERIAL_COM);
+        this->serial_ctrl->WriteRawData_P(PSTR("Configuration loaded!"), SERIAL_COM);
+        this->serial_ctrl->WriteRawData_P(PSTR(""), SERIAL_COM);
+        return true;
     }
+
+    return false;
 }
 
 //  ----------------------------------------------------------------------------
-//  Zapis konfiguracji do pliku.
-void GlobalController::SaveData()
+/*  Zapis konfiguracji do pliku.
+ *  @return: True - conf.ini zapisany; False - konfiguracja niewczytana, brak karty lub blad zapisu.
+ */
+bool GlobalController::SaveData()
 {
-    if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
+    PROFILE_SCOPE(PROFILE_SECTION_SAVE_DATA);
+    bool result = false;
+
+    //  Konfiguracja nie jest zapisywana przed jej wczytaniem (uruchamianie w tle).
+    if (this->initialized && this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
     {
         File file = this->sdcard_ctrl->OpenFileToWrite(CONFIG_FILE_NAME);
 
         String alarm_data = String(this->alarm->hour) + ":" + String(this->alarm->minute) + " " + (this->alarm->IsEnabled() ? "on" : "off") + " " + (this->alarm->IsLed() ? "led" : "off");
         String beep_data = String(this->buzzer_hour_change_interval);
-        String brightness_data = this->brightness_auto ? "auto" : String(this->display_ctrl->GetBrightness());
+        String brightness_data = this->brightness_auto ? "auto" : String(this->brightness);
+        FixedString<16> night_data;
+        this->night_mode->WriteConfig(night_data);
 
         file.println("[configuration]");
         file.println("alarm=" + alarm_data);
         file.println("beep_hours=" + beep_data);
         file.println("brightness=" + brightness_data);
+        file.print(F("night="));
+        file.println(night_data.c_str());
+        file.println("baud_pc=" + String(this->serial_ctrl->GetBaudrate(SERIAL_COM)));
+        file.println("baud_bt=" + String(this->serial_ctrl->GetBaudrate(SERIAL_BLUETOOTH)));
+
+        TemperatureSensorController * sensors[2] = { this->temp_sensor_ctrl_in, this->temp_sensor_ctrl_out };
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (sensors[i]->GetAssignedAddress() == NULL)
+                continue;
+
+            FixedString<16> address;
+            OneWireBus::AppendAddress(address, sensors[i]->GetAssignedAddress());
+            file.print(i == 0 ? F("sensor_in=") : F("sensor_out="));
+            file.println(address.c_str());
+        }
+
+        //  Zapis do pustego obiektu File (plik nie zostal otwarty) jest pomijany.
+        result = file && !file.getWriteError();
         file.close();
     }
+
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis ustawienia przechowywanego tylko w conf.ini (przed wczytaniem konfiguracji zapis
+ *  czeka na zakonczenie uruchamiania).
+ *  @param setting: Bit ustawienia PENDING_SETTING_*.
+ */
+void GlobalController::SaveSetting(byte setting)
+{
+    if (!this->initialized)
+        this->pending_settings |= setting;
+    else
+        this->SaveData();
 }
 
 #endif
\ No newline at end of file
@@ -10,13 +10,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <IRremote.h>
+#include "board_profile.h"
+#include "profiler.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#define IR_PIN_SENDER   9
+#define IR_PIN_SENDER   Board::IR_PIN_SENDER
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,6 +52,8 @@ IRController::IRController()
  */
 void IRController::Send(uint32_t data, int delay_time = 250, int repeat = 2)
 {
+    PROFILE_SCOPE(PROFILE_SECTION_IR_SEND);
+
     IrSender.sendNECRaw(data, repeat);
     delay(delay_time);
 }
@@ -0,0 +1,714 @@
+////////////////////////////////////////////////////////////////////////////////
+//  JOURNAL
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "clock_controller.h"
+#include "fixed_string.h"
+#include "sd_card_controller.h"
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define JOURNAL_FILE_NAME           F("journal.bin")
+#define JOURNAL_BLOCKS              2048UL      //  Bufor cykliczny 1MB (ok. 30 tys. rekordow).
+#define JOURNAL_MAGIC               0x4C4E524AUL    //  "JRNL"
+
+#define JOURNAL_RECORD_SIZE         32
+#define JOURNAL_SLOTS               (SDCARD_BLOCK_SIZE / JOURNAL_RECORD_SIZE)
+#define JOURNAL_RECORDS             (JOURNAL_SLOTS - 1)     //  Miejsce 0 sektora zajmuje naglowek.
+#define JOURNAL_DATA_SIZE           (JOURNAL_RECORD_SIZE - 6)
+
+#define JOURNAL_FLUSH_INTERVAL      5000        //  Maksymalny czas rekordow w buforze sektora [ms].
+#define JOURNAL_CHECKPOINT_CHANGES  16          //  Zmiany ustawien wymuszajace punkt kontrolny.
+#define JOURNAL_CHECKPOINT_INTERVAL 600000UL    //  Maksymalny czas zmian bez punktu kontrolnego [ms].
+#define JOURNAL_CHECKPOINT_BLOCKS   8           //  Ograniczenie przegladania dziennika przy odtwarzaniu.
+#define JOURNAL_CHECKPOINT_RETRY    60000UL     //  Ponowienie punktu kontrolnego po bledzie zapisu conf.ini [ms].
+
+//  Typy rekordow.
+#define JOURNAL_NONE                0           //  Puste miejsce w sektorze.
+#define JOURNAL_BOOT                1           //  Uruchomienie (source: ilosc urzadzen z bledem).
+#define JOURNAL_SETTING             2           //  Zmiana ustawienia (source: JOURNAL_SETTING_*).
+#define JOURNAL_CHECKPOINT          3           //  Stan wszystkich ustawien (zapisany rowniez w conf.ini).
+#define JOURNAL_ALARM_FIRE          4
+#define JOURNAL_ALARM_SNOOZE        5
+#define JOURNAL_ALARM_DISMISS       6
+#define JOURNAL_COMMAND             7           //  Polecenie (source: urzadzenie wejsciowe SERIAL_*).
+#define JOURNAL_TYPES               8
+
+#define JOURNAL_SETTING_ALARM       0
+#define JOURNAL_SETTING_BEEP        1
+#define JOURNAL_SETTING_BRIGHTNESS  2
+#define JOURNAL_SETTING_NIGHT       3
+
+#define JOURNAL_STATE_ALARM_ON      0x01
+#define JOURNAL_STATE_ALARM_LED     0x02
+#define JOURNAL_STATE_AUTO_BRIGHT   0x04
+#define JOURNAL_STATE_NIGHT_HOURS   0x08        //  Tryb nocny wedlug harmonogramu (inaczej fotorezystory).
+
+//  Wiersz miesci najdluzsza nazwe ("alarm snooze") z terminatorem.
+const char journal_type_names[JOURNAL_TYPES][13] PROGMEM = {
+    "-", "boot", "set", "checkpoint", "alarm fire", "alarm snooze", "alarm stop", "command"
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Ustawienia odtwarzane z dziennika.
+struct JournalState
+{
+    byte        alarm_hour;
+    byte        alarm_minute;
+    byte        beep_interval;
+    byte        brightness;
+    byte        night_level;
+    byte        night_start;
+    byte        night_end;
+    byte        flags;          //  JOURNAL_STATE_*.
+};
+
+//  Rekord dziennika. Rekordy ustawien i punktow kontrolnych zawieraja JournalState, polecenia
+//  ich poczatek (bez terminatora gdy zajmuje cale pole).
+struct JournalRecord
+{
+    uint32_t    time;           //  Czas unix.
+    byte        type;
+    byte        source;
+    byte        data[JOURNAL_DATA_SIZE];
+};
+
+//  Naglowek sektora (miejsce 0). Numer kolejny rosnie o 1 w kazdym nastepnym sektorze.
+struct JournalHeader
+{
+    uint32_t    magic;
+    uint32_t    sequence;
+    uint32_t    check;          //  ~sequence
+    byte        reserved[JOURNAL_RECORD_SIZE - 12];
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Dziennik zdarzen zapisywany w pliku ciaglym na karcie SD jako bufor cykliczny sektorow.
+//  Rekordy sa dopisywane do bufora sektora kontrolera karty i zapisywane calym sektorem (po
+//  zapelnieniu lub po JOURNAL_FLUSH_INTERVAL, zmiany ustawien od razu). Zmiana ustawienia to
+//  dopisanie jednego rekordu i zapis jednego sektora - conf.ini jest przepisywany tylko przy
+//  punkcie kontrolnym, a po uruchomieniu odtwarzane sa zmiany zapisane po ostatnim punkcie
+//  kontrolnym.
+class Journal
+{
+    private:
+        ClockController   * clock_ctrl;
+        SdCardController  * sdcard_ctrl;
+
+        uint32_t        first_block         =   0;
+        uint32_t        head                =   0;      //  Indeks biezacego sektora.
+        uint32_t        sequence            =   0;      //  Numer kolejny biezacego sektora.
+        byte            position            =   0;      //  Pierwsze wolne miejsce biezacego sektora.
+        bool            ready               =   false;
+
+        bool            dirty               =   false;
+        unsigned long   dirty_time          =   0;
+        unsigned long   appended            =   0;
+        int             changes             =   0;      //  Zmiany ustawien od punktu kontrolnego.
+        unsigned long   changes_time        =   0;
+        uint32_t        checkpoint_blocks   =   JOURNAL_CHECKPOINT_BLOCKS;
+        bool            postponed           =   false;
+        unsigned long   postponed_time      =   0;
+
+        bool  Append(byte type, byte source, const void * data, int size);
+        bool  FindHead();
+        void  NextBlock();
+        bool  ReadHeader(uint32_t index, uint32_t & sequence);
+        void  StartBlock(uint32_t index, uint32_t sequence);
+
+    public:
+        Journal(ClockController * clock_ctrl, SdCardController * sdcard_ctrl);
+
+        bool  AppendCheckpoint(JournalState & state);
+        bool  AppendCommand(const char * command, int device);
+        bool  AppendEvent(byte type, byte source = 0);
+        bool  AppendSetting(byte setting, JournalState & state);
+        void  Flush();
+        bool  GetRecord(unsigned long back, JournalRecord & record);
+        void  GetStatus(FixedStringBase & result);
+        bool  HasChanges();
+        bool  IsCheckpointDue();
+        bool  IsReady();
+        bool  Open();
+        void  PostponeCheckpoint();
+        void  Process();
+        int   Restore(JournalState & state, bool from_checkpoint);
+
+        static void ApplySetting(JournalState & state, JournalRecord & record);
+        static void AppendRecord(FixedStringBase & result, JournalRecord & record);
+        static void AppendTime(FixedStringBase & result, uint32_t time);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Dopisanie rekordu do biezacego sektora.
+ *  @param type: Typ rekordu JOURNAL_*.
+ *  @param source: Zrodlo lub rodzaj zdarzenia (zalezne od typu).
+ *  @param data: Dane rekordu lub NULL.
+ *  @param size: Rozmiar danych (nadmiar jest obcinany do JOURNAL_DATA_SIZE).
+ *  @return: True - rekord dopisany.
+ */
+bool Journal::Append(byte type, byte source, const void * data, int size)
+{
+    if (!this->ready)
+        return false;
+
+    if (this->position >= JOURNAL_SLOTS)
+        this->NextBlock();
+
+    uint8_t * block = this->sdcard_ctrl->GetBlock(this->first_block + this->head, SDCARD_CACHE_WRITE);
+
+    if (block == NULL)
+    {
+        this->ready = false;
+        return false;
+    }
+
+    JournalRecord record;
+    memset(&record, 0, sizeof(record));
+
+    record.time = this->clock_ctrl->GetUnixTime(this->clock_ctrl->Now());
+    record.type = type;
+    record.source = source;
+
+    if (data != NULL)
+        memcpy(record.data, data, min(size, JOURNAL_DATA_SIZE));
+
+    memcpy(block + this->position * JOURNAL_RECORD_SIZE, &record, JOURNAL_RECORD_SIZE);
+    this->position++;
+    this->appended++;
+
+    if (!this->dirty)
+    {
+        this->dirty = true;
+        this->dirty_time = millis();
+    }
+
+    //  Pelny sektor jest zapisywany od razu.
+    if (this->position >= JOURNAL_SLOTS)
+        this->Flush();
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyszukanie biezacego sektora - ostatniego sektora, ktorego numer kolejny rosnie o 1 od
+ *  sektora 0 (wyszukiwanie binarne). Pusty dziennik zaczyna sie od numeru rownego czasowi unix,
+ *  aby pozostalosci poprzedniego pliku nie zostaly uznane za kontynuacje.
+ *  @return: True - dziennik gotowy do zapisu.
+ */
+bool Journal::FindHead()
+{
+    uint32_t base;
+
+    if (!this->ReadHeader(0, base))
+    {
+        this->ready = true;
+        this->StartBlock(0, this->clock_ctrl->GetUnixTime(this->clock_ctrl->Now()));
+        return true;
+    }
+
+    uint32_t low = 0;
+    uint32_t high = JOURNAL_BLOCKS - 1;
+
+    while (low < high)
+    {
+        uint32_t middle = (low + high + 1) / 2;
+        uint32_t value;
+
+        if (this->ReadHeader(middle, value) && value == base + middle)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    uint8_t * block = this->sdcard_ctrl->GetBlock(this->first_block + low, SDCARD_CACHE_READ);
+
+    if (block == NULL)
+        return false;
+
+    this->head = low;
+    this->sequence = base + low;
+    this->position = 1;
+
+    //  Sektor jest zapisywany calymi rekordami - pierwsze puste miejsce konczy zapisane dane.
+    while (this->position < JOURNAL_SLOTS
+        && ((JournalRecord *) (block + this->position * JOURNAL_RECORD_SIZE))->type != JOURNAL_NONE)
+        this->position++;
+
+    this->ready = true;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Przejscie do kolejnego sektora (po ostatnim sektorze pliku nadpisywany jest pierwszy).
+void Journal::NextBlock()
+{
+    this->Flush();
+    this->StartBlock((this->head + 1) % JOURNAL_BLOCKS, this->sequence + 1);
+    this->checkpoint_blocks++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odczyt naglowka sektora.
+ *  @param index: Indeks sektora w dzienniku.
+ *  @param sequence: Wynikowy numer kolejny sektora.
+ *  @return: True - naglowek poprawny.
+ */
+bool Journal::ReadHeader(uint32_t index, uint32_t & sequence)
+{
+    uint8_t * block = this->sdcard_ctrl->GetBlock(this->first_block + index, SDCARD_CACHE_READ);
+    JournalHeader header;
+
+    if (block == NULL)
+        return false;
+
+    memcpy(&header, block, sizeof(header));
+    sequence = header.sequence;
+
+    return header.magic == JOURNAL_MAGIC && header.check == ~header.sequence;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rozpoczecie nowego sektora - bufor jest zerowany bez odczytu z karty.
+ *  @param index: Indeks sektora w dzienniku.
+ *  @param sequence: Numer kolejny sektora.
+ */
+void Journal::StartBlock(uint32_t index, uint32_t sequence)
+{
+    uint8_t * block = this->sdcard_ctrl->GetBlock(this->first_block + index, SDCARD_CACHE_ZERO);
+
+    if (block == NULL)
+    {
+        this->ready = false;
+        return;
+    }
+
+    JournalHeader header;
+    memset(&header, 0, sizeof(header));
+
+    header.magic = JOURNAL_MAGIC;
+    header.sequence = sequence;
+    header.check = ~sequence;
+    memcpy(block, &header, sizeof(header));
+
+    this->head = index;
+    this->sequence = sequence;
+    this->position = 1;
+    this->dirty = true;
+    this->dirty_time = millis();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy dziennika zdarzen.
+ *  @param clock_ctrl: Kontroler zegara (czas rekordow).
+ *  @param sdcard_ctrl: Kontroler karty SD.
+ */
+Journal::Journal(ClockController * clock_ctrl, SdCardController * sdcard_ctrl)
+{
+    this->clock_ctrl = clock_ctrl;
+    this->sdcard_ctrl = sdcard_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie punktu kontrolnego (po zapisaniu conf.ini) i zapis sektora.
+ *  @param state: Aktualne ustawienia.
+ *  @return: True - punkt kontrolny zapisany.
+ */
+bool Journal::AppendCheckpoint(JournalState & state)
+{
+    if (!this->Append(JOURNAL_CHECKPOINT, 0, &state, sizeof(state)))
+        return false;
+
+    this->Flush();
+    this->changes = 0;
+    this->checkpoint_blocks = 0;
+    this->postponed = false;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie polecenia tekstowego.
+ *  @param command: Polecenie.
+ *  @param device: Urzadzenie wejsciowe SERIAL_*.
+ *  @return: True - rekord dopisany.
+ */
+bool Journal::AppendCommand(const char * command, int device)
+{
+    return this->Append(JOURNAL_COMMAND, device, command, strlen(command));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie zdarzenia bez danych.
+ *  @param type: Typ rekordu JOURNAL_*.
+ *  @param source: Zrodlo zdarzenia.
+ *  @return: True - rekord dopisany.
+ */
+bool Journal::AppendEvent(byte type, byte source = 0)
+{
+    return this->Append(type, source, NULL, 0);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie zmiany ustawienia (zamiast przepisania conf.ini) i zapis sektora - zmiana nie moze
+ *  zostac utracona przy zaniku zasilania w ciagu JOURNAL_FLUSH_INTERVAL.
+ *  @param setting: Zmienione ustawienie JOURNAL_SETTING_*.
+ *  @param state: Aktualne ustawienia (odtwarzane jest tylko zmienione).
+ *  @return: True - rekord zapisany; False - dziennik niedostepny lub blad zapisu.
+ */
+bool Journal::AppendSetting(byte setting, JournalState & state)
+{
+    if (!this->Append(JOURNAL_SETTING, setting, &state, sizeof(state)))
+        return false;
+
+    this->Flush();
+
+    if (!this->ready)
+        return false;
+
+    if (this->changes++ == 0)
+        this->changes_time = millis();
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis biezacego sektora na karte.
+void Journal::Flush()
+{
+    if (!this->dirty)
+        return;
+
+    this->dirty = false;
+
+    if (!this->sdcard_ctrl->FlushBlock())
+        this->ready = false;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie rekordu liczac od najnowszego.
+ *  @param back: Ilosc nowszych rekordow (0 - najnowszy rekord).
+ *  @param record: Wynikowy rekord.
+ *  @return: True - rekord istnieje.
+ */
+bool Journal::GetRecord(unsigned long back, JournalRecord & record)
+{
+    if (!this->ready)
+        return false;
+
+    //  Wszystkie sektory poza biezacym sa pelne.
+    unsigned long in_head = this->position - 1;
+    uint32_t blocks_back = 0;
+    int slot = 0;
+
+    if (back < in_head)
+        slot = in_head - back;
+    else
+    {
+        back -= in_head;
+        blocks_back = 1 + back / JOURNAL_RECORDS;
+        slot = JOURNAL_RECORDS - back % JOURNAL_RECORDS;
+    }
+
+    if (blocks_back >= JOURNAL_BLOCKS)
+        return false;
+
+    uint32_t index = (this->head + JOURNAL_BLOCKS - blocks_back) % JOURNAL_BLOCKS;
+    uint32_t value;
+
+    if (blocks_back > 0 && (!this->ReadHeader(index, value) || value != this->sequence - blocks_back))
+        return false;
+
+    uint8_t * block = this->sdcard_ctrl->GetBlock(this->first_block + index, SDCARD_CACHE_READ);
+
+    if (block == NULL)
+        return false;
+
+    memcpy(&record, block + slot * JOURNAL_RECORD_SIZE, JOURNAL_RECORD_SIZE);
+    return record.type != JOURNAL_NONE;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie opisu stanu dziennika.
+ *  @param result: Tekst wynikowy.
+ */
+void Journal::GetStatus(FixedStringBase & result)
+{
+    result.Append_P(PSTR("journal: "));
+
+    if (!this->ready)
+    {
+        result.Append_P(PSTR("off"));
+        return;
+    }
+
+    result.Append_P(PSTR("sector ")).AppendNumber(this->head).Append('/').AppendNumber(JOURNAL_BLOCKS);
+    result.Append_P(PSTR(", seq ")).AppendNumber(this->sequence);
+    result.Append_P(PSTR(", appended ")).AppendNumber(this->appended);
+    result.Append_P(PSTR(", changes ")).AppendNumber(this->changes);
+    result.Append_P(PSTR(", sectors since checkpoint ")).AppendNumber(this->checkpoint_blocks);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy po ostatnim punkcie kontrolnym zmieniono ustawienia.
+ *  @return: True - ustawienia zmienione (conf.ini jest nieaktualny).
+ */
+bool Journal::HasChanges()
+{
+    return this->changes > 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy nalezy zapisac punkt kontrolny.
+ *  @return: True - duzo lub dawno zapisanych zmian albo dziennik przesunal sie o JOURNAL_CHECKPOINT_BLOCKS.
+ */
+bool Journal::IsCheckpointDue()
+{
+    if (!this->ready)
+        return false;
+
+    if (this->postponed && millis() - this->postponed_time < JOURNAL_CHECKPOINT_RETRY)
+        return false;
+
+    if (this->changes > 0 && (this->changes >= JOURNAL_CHECKPOINT_CHANGES
+        || millis() - this->changes_time >= JOURNAL_CHECKPOINT_INTERVAL))
+        return true;
+
+    return this->checkpoint_blocks >= JOURNAL_CHECKPOINT_BLOCKS;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy dziennik jest dostepny.
+ *  @return: True - dziennik otwarty.
+ */
+bool Journal::IsReady()
+{
+    return this->ready;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Otwarcie dziennika (utworzenie pliku ciaglego przy pierwszym uruchomieniu).
+ *  @return: True - dziennik gotowy do zapisu.
+ */
+bool Journal::Open()
+{
+    uint32_t last_block;
+
+    this->ready = false;
+
+    if (!this->sdcard_ctrl->IsMounted()
+        || !this->sdcard_ctrl->OpenContiguousFile(JOURNAL_FILE_NAME, JOURNAL_BLOCKS, this->first_block, last_block))
+        return false;
+
+    return this->FindHead();
+}
+
+//  ----------------------------------------------------------------------------
+//  Odlozenie punktu kontrolnego o JOURNAL_CHECKPOINT_RETRY (conf.ini nie zostal zapisany).
+void Journal::PostponeCheckpoint()
+{
+    this->postponed = true;
+    this->postponed_time = millis();
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis sektora z rekordami oczekujacymi dluzej niz JOURNAL_FLUSH_INTERVAL.
+void Journal::Process()
+{
+    if (this->dirty && millis() - this->dirty_time >= JOURNAL_FLUSH_INTERVAL)
+        this->Flush();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odtworzenie ustawien - wczytanie ostatniego punktu kontrolnego i zmian zapisanych po nim.
+ *  @param state: Ustawienia wczytane z conf.ini (wynik - ustawienia po odtworzeniu).
+ *  @param from_checkpoint: True - ustawienia z punktu kontrolnego (brak conf.ini).
+ *  @return: Ilosc odtworzonych rekordow.
+ */
+int Journal::Restore(JournalState & state, bool from_checkpoint)
+{
+    JournalRecord record;
+    unsigned long limit = (JOURNAL_CHECKPOINT_BLOCKS + 2) * JOURNAL_RECORDS;
+    unsigned long back = 0;
+    bool found = false;
+    int restored = 0;
+
+    for (; back < limit && this->GetRecord(back, record); back++)
+        if (record.type == JOURNAL_CHECKPOINT)
+        {
+            found = true;
+            break;
+        }
+
+    if (found && from_checkpoint)
+    {
+        memcpy(&state, record.data, sizeof(state));
+        restored++;
+    }
+
+    this->checkpoint_blocks = found ? (back + JOURNAL_RECORDS - this->position + 1) / JOURNAL_RECORDS
+        : JOURNAL_CHECKPOINT_BLOCKS;
+
+    while (back-- > 0)
+        if (this->GetRecord(back, record) && record.type == JOURNAL_SETTING)
+        {
+            ApplySetting(state, record);
+            restored++;
+        }
+
+    //  Odtworzone zmiany nie sa jeszcze zapisane w conf.ini.
+    if (restored > 0)
+    {
+        this->changes += restored;
+        this->changes_time = millis();
+    }
+
+    return restored;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zastosowanie rekordu zmiany ustawienia.
+ *  @param state: Ustawienia.
+ *  @param record: Rekord JOURNAL_SETTING.
+ */
+void Journal::ApplySetting(JournalState & state, JournalRecord & record)
+{
+    JournalState changed;
+    memcpy(&changed, record.data, sizeof(changed));
+
+    switch (record.source)
+    {
+        case JOURNAL_SETTING_ALARM:
+            state.alarm_hour = changed.alarm_hour;
+            state.alarm_minute = changed.alarm_minute;
+            state.flags = (state.flags & ~(JOURNAL_STATE_ALARM_ON | JOURNAL_STATE_ALARM_LED))
+                | (changed.flags & (JOURNAL_STATE_ALARM_ON | JOURNAL_STATE_ALARM_LED));
+            break;
+
+        case JOURNAL_SETTING_BEEP:
+            state.beep_interval = changed.beep_interval;
+            break;
+
+        case JOURNAL_SETTING_BRIGHTNESS:
+            state.brightness = changed.brightness;
+            state.flags = (state.flags & ~JOURNAL_STATE_AUTO_BRIGHT) | (changed.flags & JOURNAL_STATE_AUTO_BRIGHT);
+            break;
+
+        case JOURNAL_SETTING_NIGHT:
+            state.night_level = changed.night_level;
+            state.night_start = changed.night_start;
+            state.night_end = changed.night_end;
+            state.flags = (state.flags & ~JOURNAL_STATE_NIGHT_HOURS) | (changed.flags & JOURNAL_STATE_NIGHT_HOURS);
+            break;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Opis rekordu, np. "2026-10-19 06:30:00 command pc /alarm set 06:30 on".
+ *  @param result: Tekst wynikowy.
+ *  @param record: Rekord dziennika.
+ */
+void Journal::AppendRecord(FixedStringBase & result, JournalRecord & record)
+{
+    AppendTime(result, record.time);
+    result.Append(' ').Append_P(record.type < JOURNAL_TYPES ? journal_type_names[record.type] : PSTR("?"));
+
+    JournalState state;
+    memcpy(&state, record.data, sizeof(state));
+
+    switch (record.type)
+    {
+        case JOURNAL_BOOT:
+            result.Append_P(PSTR(", failed ")).AppendNumber(record.source);
+            break;
+
+        case JOURNAL_SETTING:
+            switch (record.source)
+            {
+                case JOURNAL_SETTING_ALARM:
+                    result.Append_P(PSTR(" alarm ")).AppendNumber(state.alarm_hour, 2).Append(':');
+                    result.AppendNumber(state.alarm_minute, 2);
+                    result.Append_P(state.flags & JOURNAL_STATE_ALARM_ON ? PSTR(" on") : PSTR(" off"));
+                    break;
+
+                case JOURNAL_SETTING_BEEP:
+                    result.Append_P(PSTR(" beep ")).AppendNumber(state.beep_interval);
+                    break;
+
+                case JOURNAL_SETTING_BRIGHTNESS:
+                    result.Append_P(PSTR(" brightness "));
+
+                    if (state.flags & JOURNAL_STATE_AUTO_BRIGHT)
+                        result.Append_P(PSTR("auto"));
+                    else
+                        result.AppendNumber(state.brightness);
+                    break;
+
+                case JOURNAL_SETTING_NIGHT:
+                    result.Append_P(PSTR(" night ")).AppendNumber(state.night_level);
+
+                    if (state.flags & JOURNAL_STATE_NIGHT_HOURS)
+                        result.Append(' ').AppendNumber(state.night_start).Append('-').AppendNumber(state.night_end);
+                    break;
+            }
+            break;
+
+        case JOURNAL_COMMAND:
+            result.Append_P(record.source == SERIAL_BLUETOOTH ? PSTR(" bt ") : PSTR(" pc "));
+            result.Append((const char *) record.data, strnlen((const char *) record.data, JOURNAL_DATA_SIZE));
+            break;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis czasu unix w postaci "yyyy-MM-dd HH:mm:ss".
+ *  @param result: Tekst wynikowy.
+ *  @param time: Czas unix.
+ */
+void Journal::AppendTime(FixedStringBase & result, uint32_t time)
+{
+    //  Konwersja ilosci dni na date kalendarza gregorianskiego (ery 400-letnie od 0000-03-01).
+    long days = time / 86400UL + 719468L;
+    long era = days / 146097L;
+    long day_of_era = days - era * 146097L;
+    long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    long month_index = (5 * day_of_year + 2) / 153;
+    long day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    long month = month_index < 10 ? month_index + 3 : month_index - 9;
+    long year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+    unsigned long seconds = time % 86400UL;
+
+    result.AppendNumber(year).Append('-').AppendNumber(month, 2).Append('-').AppendNumber(day, 2).Append(' ');
+    result.AppendNumber(seconds / 3600, 2).Append(':').AppendNumber((seconds / 60) % 60, 2).Append(':');
+    result.AppendNumber(seconds % 60, 2);
+}
+
+#endif
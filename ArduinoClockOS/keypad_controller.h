@@ -9,7 +9,8 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <Keypad.h>
+#include <Arduino.h>
+#include "board_profile.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,6 +19,7 @@
 
 #define KEYPAD_COLS     4
 #define KEYPAD_ROWS     4
+#define KEYPAD_KEYS     (KEYPAD_COLS * KEYPAD_ROWS)
 
 #define KEYPAD_NO_KEY       0     //  NULL
 #define KEYPAD_NEXT_KEY     35    //  #
@@ -37,8 +39,28 @@
 #define KEYPAD_OPTION_KEY   67    //  c
 #define KEYPAD_MENU_KEY     68    //  d
 
-const byte  KEYPAD_PIN_COLS[KEYPAD_COLS] = {30, 32, 34, 36};
-const byte  KEYPAD_PIN_ROWS[KEYPAD_COLS] = {22, 24, 26, 28};
+#define KEYPAD_EVENT_NONE       0
+#define KEYPAD_EVENT_PRESS      1     //  Wcisniecie przycisku (po eliminacji drgan).
+#define KEYPAD_EVENT_REPEAT     2     //  Automatyczne powtorzenie przytrzymanego przycisku.
+#define KEYPAD_EVENT_LONG       3     //  Dlugie przytrzymanie przycisku (jednorazowo).
+#define KEYPAD_EVENT_RELEASE    4     //  Zwolnienie przycisku.
+
+#define KEYPAD_SCAN_PERIOD      4     //  ms - okres skanowania matrycy w przerwaniu Timer5.
+#define KEYPAD_DEBOUNCE_SCANS   3     //  Ilosc identycznych odczytow wymagana do zmiany stanu.
+#define KEYPAD_LONG_SCANS       250   //  1000 ms
+#define KEYPAD_REPEAT_SCANS     125   //  500 ms - opoznienie pierwszego powtorzenia.
+#define KEYPAD_REPEAT_PERIOD    25    //  100 ms - okres kolejnych powtorzen.
+
+#define KEYPAD_QUEUE_SIZE       16    //  Potega liczby 2.
+#define KEYPAD_QUEUE_RESERVE    4     //  Miejsca zarezerwowane dla wcisniec (powtorzenia sa pomijane).
+
+//  Bez Timer5 (plytka inna niz Mega) skanowanie jest wykonywane przy odczycie zdarzen.
+#if defined(TIMSK5)
+#define KEYPAD_SCAN_IN_ISR      1
+#else
+#define KEYPAD_SCAN_IN_ISR      0
+#endif
+
 const char  KEYPAD_MAP[KEYPAD_ROWS][KEYPAD_COLS] = {
     { '1', '2', '3', 'A' },
     { '4', '5', '6', 'B' },
@@ -47,37 +69,338 @@ const char  KEYPAD_MAP[KEYPAD_ROWS][KEYPAD_COLS] = {
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+struct KeypadEvent
+{
+    char  key       =   KEYPAD_NO_KEY;
+    byte  type      =   KEYPAD_EVENT_NONE;
+    byte  repeats   =   0;    //  Numer powtorzenia (KEYPAD_EVENT_REPEAT), nasycany na 255.
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
 ////////////////////////////////////////////////////////////////////////////////
 
+//  Klawiatura skanowana w przerwaniu Timer5 co KEYPAD_SCAN_PERIOD ms, niezaleznie od petli
+//  glownej. Zdarzenia trafiaja do kolejki cyklicznej (jeden producent - przerwanie, jeden
+//  konsument - petla glowna), z ktorej odczytuje je GlobalController::ProcessInput().
 class KeypadController
 {
     private:
-        Keypad *controller;
+        static KeypadController *active;
+
+        volatile uint8_t  *col_mode[KEYPAD_COLS];
+        volatile uint8_t  *col_output[KEYPAD_COLS];
+        uint8_t           col_mask[KEYPAD_COLS];
+        volatile uint8_t  *row_input[KEYPAD_ROWS];
+        uint8_t           row_mask[KEYPAD_ROWS];
+
+        uint16_t  last_raw          =   0;
+        uint16_t  pressed           =   0;
+        byte      stable_scans      =   0;
+        char      held_key          =   KEYPAD_NO_KEY;
+        uint16_t  held_scans        =   0;
+        byte      held_repeats      =   0;
+
+        volatile char  queue_keys[KEYPAD_QUEUE_SIZE];
+        volatile byte  queue_types[KEYPAD_QUEUE_SIZE];
+        volatile byte  queue_repeats[KEYPAD_QUEUE_SIZE];
+        volatile byte  queue_head   =   0;    //  Zapisywany tylko w przerwaniu.
+        volatile byte  queue_tail   =   0;    //  Zapisywany tylko w petli glownej.
+        volatile byte  overflows    =   0;
+
+#if !KEYPAD_SCAN_IN_ISR
+        unsigned long  last_scan    =   0;
+#endif
+
+        bool      PushEvent(char key, byte type, byte repeats = 0);
+        uint16_t  ReadMatrix();
+        void      StartTimer();
 
     public:
         KeypadController();
 
-        int GetPressedKey();
+        int   GetPressedKey();
+        byte  GetOverflows();
+        bool  HasEvents();
+        bool  ReadEvent(KeypadEvent &event);
+        void  Scan();
+
+        static void ScanActive();
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** STATIC FIELDS ***
+////////////////////////////////////////////////////////////////////////////////
+
+KeypadController * KeypadController::active = NULL;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Dodanie zdarzenia do kolejki (wywolywane w przerwaniu).
+ *  @param key: Znak przycisku.
+ *  @param type: Typ zdarzenia.
+ *  @param repeats: Numer powtorzenia.
+ *  @return: Informacja o dodaniu zdarzenia do kolejki.
+ */
+bool KeypadController::PushEvent(char key, byte type, byte repeats = 0)
+{
+    byte head = this->queue_head;
+    byte used = (head - this->queue_tail) & (KEYPAD_QUEUE_SIZE - 1);
+    byte free_slots = KEYPAD_QUEUE_SIZE - 1 - used;
+
+    //  Powtorzenia nie moga zajac miejsca potrzebnego na wcisniecia i zwolnienia.
+    if (free_slots == 0 || (type == KEYPAD_EVENT_REPEAT && free_slots <= KEYPAD_QUEUE_RESERVE))
+    {
+        if (this->overflows < 255)
+            this->overflows++;
+        return false;
+    }
+
+    this->queue_keys[head] = key;
+    this->queue_types[head] = type;
+    this->queue_repeats[head] = repeats;
+
+    //  Przesuniecie glowy dopiero po zapisaniu danych - konsument widzi kompletne zdarzenie.
+    this->queue_head = (head + 1) & (KEYPAD_QUEUE_SIZE - 1);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odczytanie stanu matrycy. Kolumny sa kolejno ustawiane jako wyjscie w stanie niskim,
+ *  wiersze sa wejsciami z rezystorem podciagajacym.
+ *  @return: Mapa bitowa wcisnietych przyciskow (bit = wiersz * KEYPAD_COLS + kolumna).
+ */
+uint16_t KeypadController::ReadMatrix()
+{
+    uint16_t raw = 0;
+
+    for (byte col = 0; col < KEYPAD_COLS; col++)
+    {
+        *this->col_output[col] &= ~this->col_mask[col];
+        *this->col_mode[col] |= this->col_mask[col];
+        delayMicroseconds(2);
+
+        for (byte row = 0; row < KEYPAD_ROWS; row++)
+            if (!(*this->row_input[row] & this->row_mask[row]))
+                raw |= (uint16_t) 1 << (row * KEYPAD_COLS + col);
+
+        *this->col_mode[col] &= ~this->col_mask[col];
+        *this->col_output[col] |= this->col_mask[col];
+    }
+
+    return raw;
+}
+
+//  ----------------------------------------------------------------------------
+//  Uruchomienie Timer5 w trybie CTC z przerwaniem co KEYPAD_SCAN_PERIOD ms.
+void KeypadController::StartTimer()
+{
+#if KEYPAD_SCAN_IN_ISR
+    uint8_t sreg = SREG;
+    cli();
+
+    TCCR5A = 0;
+    TCCR5B = (1 << WGM52) | (1 << CS51) | (1 << CS50);    //  CTC, preskaler 64.
+    TCNT5 = 0;
+    OCR5A = (F_CPU / 64 / 1000) * KEYPAD_SCAN_PERIOD - 1;
+    TIMSK5 |= (1 << OCIE5A);
+
+    SREG = sreg;
+#endif
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** PUBLIC METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
 KeypadController::KeypadController()
 {
-    //  Inicjalizacja podrzednego sprzetowego kontrolera klawiatury.
-    this->controller = new Keypad(
-        makeKeymap(KEYPAD_MAP), KEYPAD_PIN_ROWS, KEYPAD_PIN_COLS, KEYPAD_ROWS, KEYPAD_COLS);
+    //  Przygotowanie rejestrow portow - przerwanie nie korzysta z digitalRead/digitalWrite.
+    for (byte col = 0; col < KEYPAD_COLS; col++)
+    {
+        byte pin = Board::KEYPAD_PIN_COLS[col];
+
+        this->col_mode[col] = portModeRegister(digitalPinToPort(pin));
+        this->col_output[col] = portOutputRegister(digitalPinToPort(pin));
+        this->col_mask[col] = digitalPinToBitMask(pin);
+        pinMode(pin, INPUT_PULLUP);
+    }
+
+    for (byte row = 0; row < KEYPAD_ROWS; row++)
+    {
+        byte pin = Board::KEYPAD_PIN_ROWS[row];
+
+        this->row_input[row] = portInputRegister(digitalPinToPort(pin));
+        this->row_mask[row] = digitalPinToBitMask(pin);
+        pinMode(pin, INPUT_PULLUP);
+    }
+
+    KeypadController::active = this;
+    this->StartTimer();
 }
 
 //  ----------------------------------------------------------------------------
+/*  Pobranie znaku wcisnietego przycisku z kolejki zdarzen (pomija pozostale zdarzenia).
+ *  @return: Znak wcisnietego przycisku lub KEYPAD_NO_KEY.
+ */
 int KeypadController::GetPressedKey()
 {
-    return this->controller->getKey();
+    KeypadEvent event;
+
+    while (this->ReadEvent(event))
+        if (event.type == KEYPAD_EVENT_PRESS)
+            return event.key;
+
+    return KEYPAD_NO_KEY;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci zdarzen odrzuconych z powodu przepelnienia kolejki.
+ *  @return: Ilosc odrzuconych zdarzen (nasycana na 255).
+ */
+byte KeypadController::GetOverflows()
+{
+    return this->overflows;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy kolejka zawiera nieodczytane zdarzenia (bez ich pobierania).
+ *  @return: Informacja o oczekujacych zdarzeniach.
+ */
+bool KeypadController::HasEvents()
+{
+    return this->queue_head != this->queue_tail;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie najstarszego zdarzenia z kolejki.
+ *  @param event: Struktura wypelniana danymi zdarzenia.
+ *  @return: Informacja o pobraniu zdarzenia.
+ */
+bool KeypadController::ReadEvent(KeypadEvent &event)
+{
+#if !KEYPAD_SCAN_IN_ISR
+    if (millis() - this->last_scan >= KEYPAD_SCAN_PERIOD)
+    {
+        this->last_scan = millis();
+        this->Scan();
+    }
+#endif
+
+    byte tail = this->queue_tail;
+
+    if (tail == this->queue_head)
+        return false;
+
+    event.key = this->queue_keys[tail];
+    event.type = this->queue_types[tail];
+    event.repeats = this->queue_repeats[tail];
+
+    this->queue_tail = (tail + 1) & (KEYPAD_QUEUE_SIZE - 1);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Pojedynczy cykl skanowania: eliminacja drgan, wykrycie wcisniec, zwolnien, dlugiego
+//  przytrzymania i powtorzen. Wywolywany w przerwaniu Timer5.
+void KeypadController::Scan()
+{
+    uint16_t raw = this->ReadMatrix();
+
+    if (raw != this->last_raw)
+    {
+        this->last_raw = raw;
+        this->stable_scans = 0;
+    }
+    else if (this->stable_scans < KEYPAD_DEBOUNCE_SCANS)
+    {
+        this->stable_scans++;
+    }
+
+    if (this->stable_scans >= KEYPAD_DEBOUNCE_SCANS && raw != this->pressed)
+    {
+        uint16_t changed = raw ^ this->pressed;
+
+        for (byte key = 0; key < KEYPAD_KEYS; key++)
+        {
+            uint16_t mask = (uint16_t) 1 << key;
+
+            if (!(changed & mask))
+                continue;
+
+            char key_char = KEYPAD_MAP[key / KEYPAD_COLS][key % KEYPAD_COLS];
+
+            if (raw & mask)
+            {
+                this->PushEvent(key_char, KEYPAD_EVENT_PRESS);
+
+                //  Powtorzenia i dlugie przytrzymanie dotycza ostatnio wcisnietego przycisku.
+                this->held_key = key_char;
+                this->held_scans = 0;
+                this->held_repeats = 0;
+            }
+            else
+            {
+                this->PushEvent(key_char, KEYPAD_EVENT_RELEASE);
+
+                if (this->held_key == key_char)
+                    this->held_key = KEYPAD_NO_KEY;
+            }
+        }
+
+        this->pressed = raw;
+    }
+
+    if (this->held_key == KEYPAD_NO_KEY)
+        return;
+
+    this->held_scans++;
+
+    if (this->held_scans == KEYPAD_LONG_SCANS)
+        this->PushEvent(this->held_key, KEYPAD_EVENT_LONG);
+
+    if (this->held_scans >= KEYPAD_REPEAT_SCANS
+        && (this->held_scans - KEYPAD_REPEAT_SCANS) % KEYPAD_REPEAT_PERIOD == 0)
+    {
+        if (this->held_repeats < 255)
+            this->held_repeats++;
+
+        this->PushEvent(this->held_key, KEYPAD_EVENT_REPEAT, this->held_repeats);
+    }
+
+    //  Ograniczenie licznika (wielokrotnosc okresu powtorzen - zachowana faza, bez ponownego LONG).
+    if (this->held_scans >= 0xF000)
+        this->held_scans -= KEYPAD_REPEAT_PERIOD * 1000;
+}
+
+//  ----------------------------------------------------------------------------
+//  Skanowanie aktywnej klawiatury (procedura przerwania).
+void KeypadController::ScanActive()
+{
+    if (KeypadController::active != NULL)
+        KeypadController::active->Scan();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INTERRUPT SERVICE ROUTINES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#if KEYPAD_SCAN_IN_ISR
+ISR(TIMER5_COMPA_vect)
+{
+    KeypadController::ScanActive();
 }
+#endif
 
-#endif
\ No newline at end of file
+#endif
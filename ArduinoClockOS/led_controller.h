@@ -9,6 +9,7 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "fixed_string.h"
 #include "ir_controller.h"
 
 
@@ -19,6 +20,8 @@
 #define LED_COMMAND_OK    0
 #define LED_COMMAND_BAD   1
 
+#define LED_COLOR_NAME_SIZE 12
+
 #define IR_LDS_ON       0xF807FF00
 #define IR_LDS_OFF      0xF906FF00
 
@@ -56,7 +59,7 @@ class LedController
     private:
         IRController * ir_controller;
 
-        String  color_name;
+        FixedString<LED_COLOR_NAME_SIZE> color_name;
         bool    on_off_state  = false;
         bool    has_changed   = true;
 
@@ -64,7 +67,7 @@ class LedController
         void SendIRCommand(uint32_t data);
 
     public:
-        LedController(IRController * ir_controller, String color_name = "White");
+        LedController(IRController * ir_controller);
 
         int   ProcessCommand(String command);
         int   On();
@@ -81,8 +84,8 @@ class LedController
         int   Brighter();
         int   Darker();
 
-        String  GetName();
-        void    SetName(String color_name);
+        const char * GetName();
+        void    SetName(const __FlashStringHelper * color_name);
         bool    HasChanged();
 };
 
@@ -117,10 +120,10 @@ void LedController::SendIRCommand(uint32_t data)
 ////////////////////////////////////////////////////////////////////////////////
 
 //  Konstruktor klasy modulu kontrolera tasm led.
-LedController::LedController(IRController * ir_controller, String color_name = "White")
+LedController::LedController(IRController * ir_controller)
 {
     this->ir_controller = ir_controller;
-    this->color_name = color_name;
+    this->color_name = F("White");
 }
 
 //  ----------------------------------------------------------------------------
@@ -202,7 +205,7 @@ int LedController::OnOff()
 int LedController::White()
 {
     this->SendIRCommand(IR_LDS_WHITE);
-    this->SetName("White");
+    this->SetName(F("White"));
     return LED_COMMAND_OK;
 }
 
@@ -213,27 +216,27 @@ int LedController::Red(int hue)
     {
         case 0:
             this->SendIRCommand(IR_LDS_RED_0);
-            this->SetName("Red");
+            this->SetName(F("Red"));
             break;
 
         case 1:
             this->SendIRCommand(IR_LDS_RED_1);
-            this->SetName("Tomato");
+            this->SetName(F("Tomato"));
             break;
 
         case 2:
             this->SendIRCommand(IR_LDS_RED_2);
-            this->SetName("Orange");
+            this->SetName(F("Orange"));
             break;
 
         case 3:
             this->SendIRCommand(IR_LDS_RED_3);
-            this->SetName("Gold");
+            this->SetName(F("Gold"));
             break;
 
         case 4:
             this->SendIRCommand(IR_LDS_RED_4);
-            this->SetName("Yellow");
+            this->SetName(F("Yellow"));
             break;
         
         default:
@@ -250,27 +253,27 @@ int LedController::Green(int hue)
     {
         case 0:
             this->SendIRCommand(IR_LDS_GREEN_0);
-            this->SetName("Green");
+            this->SetName(F("Green"));
             break;
 
         case 1:
             this->SendIRCommand(IR_LDS_GREEN_1);
-            this->SetName("Mint");
+            this->SetName(F("Mint"));
             break;
 
         case 2:
             this->SendIRCommand(IR_LDS_GREEN_2);
-            this->SetName("Sea");
+            this->SetName(F("Sea"));
             break;
 
         case 3:
             this->SendIRCommand(IR_LDS_GREEN_3);
-            this->SetName("Teal");
+            this->SetName(F("Teal"));
             break;
 
         case 4:
             this->SendIRCommand(IR_LDS_GREEN_4);
-            this->SetName("Aqua");
+            this->SetName(F("Aqua"));
             break;
         
         default:
@@ -287,27 +290,27 @@ int LedController::Blue(int hue)
     {
         case 0:
             this->SendIRCommand(IR_LDS_BLUE_0);
-            this->SetName("Blue");
+            this->SetName(F("Blue"));
             break;
 
         case 1:
             this->SendIRCommand(IR_LDS_BLUE_1);
-            this->SetName("Purple");
+            this->SetName(F("Purple"));
             break;
 
         case 2:
             this->SendIRCommand(IR_LDS_BLUE_2);
-            this->SetName("Violet");
+            this->SetName(F("Violet"));
             break;
 
         case 3:
             this->SendIRCommand(IR_LDS_BLUE_3);
-            this->SetName("Fuchsia");
+            this->SetName(F("Fuchsia"));
             break;
 
         case 4:
             this->SendIRCommand(IR_LDS_BLUE_4);
-            this->SetName("Pink");
+            this->SetName(F("Pink"));
             break;
         
         default:
@@ -360,17 +363,21 @@ int LedController::Smooth()
 }
 
 //  ----------------------------------------------------------------------------
-String LedController::GetName()
+const char * LedController::GetName()
 {
     if (!this->on_off_state)
         return "Off";
-    return this->color_name;
+    return this->color_name.c_str();
 }
 
 //  ----------------------------------------------------------------------------
-void LedController::SetName(String color_name)
+void LedController::SetName(const __FlashStringHelper * color_name)
 {
-    this->color_name = color_name == "Off" ? "White" : color_name;
+    this->color_name = color_name;
+
+    if (strcmp_P(this->color_name.c_str(), PSTR("Off")) == 0)
+        this->color_name = F("White");
+
     this->has_changed = true;
 }
 
@@ -0,0 +1,331 @@
+////////////////////////////////////////////////////////////////////////////////
+//  MEMORY MONITOR
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define MEMORY_STACK_CANARY             0xC5
+#define MEMORY_CHECK_INTERVAL           1000
+#define MEMORY_WARNING_FREE_RAM         512     //  Minimalna wolna przestrzen miedzy stosem a sterta.
+#define MEMORY_WARNING_STACK_FREE       256     //  Minimalny nigdy nieuzyty obszar stosu.
+#define MEMORY_WARNING_FRAGMENTATION    50      //  Maksymalna fragmentacja wolnej pamieci w procentach.
+#define MEMORY_REPORT_SIZE              208     //  Najdluzszy raport: 137 znakow stalych, 10 x %d (6 znakow), %u (5 znakow).
+
+#define MEMORY_STATE_OK                 0
+#define MEMORY_STATE_WARNING            1
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** AVR-LIBC MEMORY SYMBOLS ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Symbole alokatora i linkera istnieja tylko w avr-libc. W innych kompilacjach
+//  (np. poza mikrokontrolerem) monitor zwraca zera i nie generuje ostrzezen.
+#if defined(__AVR__)
+
+//  Element listy wolnych blokow alokatora malloc (avr-libc).
+struct __freelist
+{
+    size_t              sz;
+    struct __freelist * nx;
+};
+
+extern char                 __data_start;
+extern char                 __data_end;
+extern char                 __bss_start;
+extern char                 __bss_end;
+extern char                 __heap_start;
+extern char               * __brkval;
+extern struct __freelist  * __flp;
+extern uint8_t              _end;
+extern uint8_t              __stack;
+
+//  Wypelnienie calej wolnej pamieci wartoscia kontrolna przed uruchomieniem konstruktorow.
+//  Sekcja .init3 jest wykonywana po ustawieniu wskaznika stosu, a przed main().
+void MemoryMonitorPaintStack(void) __attribute__ ((naked)) __attribute__ ((used)) __attribute__ ((section (".init3")));
+
+void MemoryMonitorPaintStack(void)
+{
+    uint8_t * p = &_end;
+
+    while (p <= &__stack)
+        *p++ = MEMORY_STACK_CANARY;
+}
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class MemoryMonitor
+{
+    private:
+        SerialController * serial_ctrl;
+
+        unsigned long   last_check_time     =   0;
+        int             state               =   MEMORY_STATE_OK;
+        unsigned int    warnings            =   0;
+
+        char *          GetHeapEnd();
+
+    public:
+        MemoryMonitor(SerialController * serial_ctrl);
+
+        int     GetFragmentation();
+        int     GetFreeListSize(int &blocks, int &largest_block);
+        int     GetFreeRam();
+        int     GetHeapSize();
+        int     GetHeapUsed();
+        bool    GetReport(char * buffer, int buffer_size);
+        int     GetStackFree();
+        int     GetStaticSize(int &data_size, int &bss_size);
+        void    Update();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Pobranie adresu konca sterty.
+ *  @return: Wskaznik na pierwszy bajt za sterta.
+ */
+char * MemoryMonitor::GetHeapEnd()
+{
+#if defined(__AVR__)
+    return __brkval != 0 ? __brkval : &__heap_start;
+#else
+    return NULL;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy monitorujacej wykorzystanie pamieci RAM.
+ *  @param serial_ctrl: Kontroler polaczenia szeregowego (powiadomienia o ostrzezeniach).
+ */
+MemoryMonitor::MemoryMonitor(SerialController * serial_ctrl)
+{
+    this->serial_ctrl = serial_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Obliczenie fragmentacji wolnej pamieci (udzial wolnej pamieci poza najwiekszym blokiem).
+ *  @return: Fragmentacja w procentach.
+ */
+int MemoryMonitor::GetFragmentation()
+{
+    int blocks = 0;
+    int largest_block = 0;
+    long free_total = (long) this->GetFreeListSize(blocks, largest_block) + this->GetFreeRam();
+    long largest = max((long) largest_block, (long) this->GetFreeRam());
+
+    if (free_total <= 0)
+        return 0;
+
+    return (int) (100 - (largest * 100) / free_total);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przejscie po liscie wolnych blokow alokatora (pamiec zwolniona wewnatrz sterty).
+ *  @param blocks: Ilosc wolnych blokow (wynik).
+ *  @param largest_block: Rozmiar najwiekszego wolnego bloku (wynik).
+ *  @return: Suma rozmiarow wolnych blokow w bajtach.
+ */
+int MemoryMonitor::GetFreeListSize(int &blocks, int &largest_block)
+{
+    int total = 0;
+
+    blocks = 0;
+    largest_block = 0;
+
+#if defined(__AVR__)
+    for (struct __freelist * current = __flp; current != NULL; current = current->nx)
+    {
+        int block_size = current->sz + sizeof(size_t);
+
+        total += block_size;
+        largest_block = max(largest_block, block_size);
+        blocks++;
+    }
+#elif defined(ARDUINO_ARCH_HOST)
+    //  Symulator: zwolniona pamiec ponizej najwyzszego poziomu sterty jako jeden blok.
+    total = hostHeapSize() - hostHeapUsed();
+    blocks = total > 0 ? 1 : 0;
+    largest_block = total;
+#endif
+
+    return total;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie wolnej przestrzeni pomiedzy koncem sterty a wierzcholkiem stosu.
+ *  @return: Ilosc wolnej pamieci w bajtach.
+ */
+int MemoryMonitor::GetFreeRam()
+{
+#if defined(__AVR__)
+    char top;
+    return &top - this->GetHeapEnd();
+#else
+    return 0;
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie rozmiaru sterty.
+ *  @return: Rozmiar sterty w bajtach.
+ */
+int MemoryMonitor::GetHeapSize()
+{
+#if defined(__AVR__)
+    return this->GetHeapEnd() - &__heap_start;
+#elif defined(ARDUINO_ARCH_HOST)
+    return hostHeapSize();
+#else
+    return 0;
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci zajetej pamieci sterty (rozmiar sterty bez wolnych blokow).
+ *  @return: Ilosc zaalokowanej pamieci w bajtach.
+ */
+int MemoryMonitor::GetHeapUsed()
+{
+    int blocks = 0;
+    int largest_block = 0;
+
+    return this->GetHeapSize() - this->GetFreeListSize(blocks, largest_block);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przygotowanie raportu wykorzystania pamieci w postaci tekstu.
+ *  @param buffer: Bufor wynikowy.
+ *  @param buffer_size: Rozmiar bufora wynikowego.
+ *  @return: Informacja czy pamiec jest w stanie ostrzegawczym.
+ */
+bool MemoryMonitor::GetReport(char * buffer, int buffer_size)
+{
+    int blocks = 0;
+    int largest_block = 0;
+    int free_list = this->GetFreeListSize(blocks, largest_block);
+    int data_size = 0;
+    int bss_size = 0;
+    int static_size = this->GetStaticSize(data_size, bss_size);
+
+    snprintf_P(buffer, buffer_size,
+        PSTR("static: %d B (data %d B, bss %d B), free: %d B, heap: %d B, free list: %d B in %d blocks (largest %d B), stack min free: %d B, fragmentation: %d%%, warnings: %u"),
+        static_size,
+        data_size,
+        bss_size,
+        this->GetFreeRam(),
+        this->GetHeapSize(),
+        free_list,
+        blocks,
+        largest_block,
+        this->GetStackFree(),
+        this->GetFragmentation(),
+        this->warnings);
+
+    return this->state == MEMORY_STATE_WARNING;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyznaczenie najmniejszej wolnej przestrzeni stosu od uruchomienia (obszar z wartoscia kontrolna).
+ *  @return: Ilosc nigdy nieuzytych bajtow pomiedzy sterta a stosem.
+ */
+int MemoryMonitor::GetStackFree()
+{
+    int count = 0;
+
+#if defined(__AVR__)
+    uint8_t * p = (uint8_t *) this->GetHeapEnd();
+
+    while (p <= &__stack && *p == MEMORY_STACK_CANARY)
+    {
+        p++;
+        count++;
+    }
+#endif
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie rozmiaru pamieci statycznej (zmienne globalne) wyznaczonego przez linker.
+ *  @param data_size: Rozmiar sekcji .data - zmienne inicjalizowane, w tym teksty spoza PROGMEM (wynik).
+ *  @param bss_size: Rozmiar sekcji .bss - zmienne zerowane (wynik).
+ *  @return: Laczny rozmiar pamieci statycznej w bajtach.
+ */
+int MemoryMonitor::GetStaticSize(int &data_size, int &bss_size)
+{
+#if defined(__AVR__)
+    data_size = &__data_end - &__data_start;
+    bss_size = &__bss_end - &__bss_start;
+#else
+    data_size = 0;
+    bss_size = 0;
+#endif
+
+    return data_size + bss_size;
+}
+
+//  ----------------------------------------------------------------------------
+//  Okresowe sprawdzenie progow i wyslanie zdarzenia przy ich przekroczeniu.
+void MemoryMonitor::Update()
+{
+    unsigned long now = millis();
+
+    if (now - this->last_check_time < MEMORY_CHECK_INTERVAL)
+        return;
+
+    this->last_check_time = now;
+
+    //  Poza AVR wolna pamiec i stos nie sa mierzone - brak wartosci do porownania z progami.
+#if defined(__AVR__)
+    int free_ram = this->GetFreeRam();
+    int stack_free = this->GetStackFree();
+    int fragmentation = this->GetFragmentation();
+
+    bool warning = free_ram < MEMORY_WARNING_FREE_RAM
+        || stack_free < MEMORY_WARNING_STACK_FREE
+        || fragmentation > MEMORY_WARNING_FRAGMENTATION;
+
+    if (warning && this->state == MEMORY_STATE_OK)
+    {
+        this->state = MEMORY_STATE_WARNING;
+        this->warnings++;
+
+        this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_EVENT,
+            PSTR("Memory warning: free %d B, stack min free %d B, fragmentation %d%%"),
+            free_ram, stack_free, fragmentation);
+    }
+    else if (!warning && this->state == MEMORY_STATE_WARNING)
+    {
+        this->state = MEMORY_STATE_OK;
+
+        this->serial_ctrl->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_EVENT,
+            PSTR("Memory recovered: free %d B"), free_ram);
+    }
+#endif
+}
+
+#endif
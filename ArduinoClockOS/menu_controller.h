@@ -26,12 +26,13 @@
 #define MENU_ITEM_EXIT            100
 
 #define LEVEL_SETTINGS            200
-#define LEVEL_SETTINGS_ITEMS      6
+#define LEVEL_SETTINGS_ITEMS      7
 #define SETTINGS_ITEM_TIME        201
 #define SETTINGS_ITEM_DATE        202
 #define SETTINGS_ITEM_BRIGHTNESS  203
 #define SETTINGS_ITEM_BEEP        204
 #define SETTINGS_ITEM_ALARM       205
+#define SETTINGS_ITEM_NIGHT       206
 #define SETTINGS_ITEM_EXIT        200
 
 
@@ -85,47 +86,52 @@ void MenuController::DisplayMenu(bool clear = false)
         {
             case MENU_ITEM_SETTINGS:
                 _ds->DrawSprite(SPRITE_SETTINGS, 0, 1);
-                _ds->PrintText(0, _text_offset, "Settings");
+                _ds->PrintText_P(0, _text_offset, PSTR("Settings"));
                 break;
             
             case MENU_ITEM_LEDS:
                 _ds->DrawSprite(SPRITE_LEDS, 0, 0);
-                _ds->PrintText(0, _text_offset, "Leds");
+                _ds->PrintText_P(0, _text_offset, PSTR("Leds"));
                 break;
             
             case MENU_ITEM_EXIT:
                 _ds->DrawSprite(SPRITE_EXIT, 0, 0);
-                _ds->PrintText(0, _text_offset, "Exit");
+                _ds->PrintText_P(0, _text_offset, PSTR("Exit"));
                 break;
             
             case SETTINGS_ITEM_TIME:
                 _ds->DrawSprite(SPRITE_CLOCK, 0, 0);
-                _ds->PrintText(0, _text_offset, "Time");
+                _ds->PrintText_P(0, _text_offset, PSTR("Time"));
                 break;
             
             case SETTINGS_ITEM_DATE:
                 _ds->DrawSprite(SPRITE_CALENDAR, 0, 0);
-                _ds->PrintText(0, _text_offset, "Date");
+                _ds->PrintText_P(0, _text_offset, PSTR("Date"));
                 break;
             
             case SETTINGS_ITEM_BRIGHTNESS:
                 _ds->DrawSprite(SPRITE_BRIGHTNESS, 0, 0);
-                _ds->PrintText(0, _text_offset, "Brightness");
+                _ds->PrintText_P(0, _text_offset, PSTR("Brightness"));
                 break;
             
             case SETTINGS_ITEM_BEEP:
                 _ds->DrawSprite(SPRITE_MUSIC, 0, 0);
-                _ds->PrintText(0, _text_offset, "Beep");
+                _ds->PrintText_P(0, _text_offset, PSTR("Beep"));
                 break;
             
             case SETTINGS_ITEM_ALARM:
                 _ds->DrawSprite(SPRITE_ALARM, 0, 0);
-                _ds->PrintText(0, _text_offset, "Alarm");
+                _ds->PrintText_P(0, _text_offset, PSTR("Alarm"));
+                break;
+            
+            case SETTINGS_ITEM_NIGHT:
+                _ds->DrawSprite(SPRITE_NIGHT, 0, 0);
+                _ds->PrintText_P(0, _text_offset, PSTR("Night"));
                 break;
             
             case SETTINGS_ITEM_EXIT:
                 _ds->DrawSprite(SPRITE_EXIT, 0, 0);
-                _ds->PrintText(0, _text_offset, "Back");
+                _ds->PrintText_P(0, _text_offset, PSTR("Back"));
                 break;
         }
     }
@@ -144,6 +150,8 @@ int MenuController::GetMaxItem()
         case LEVEL_SETTINGS:
             return LEVEL_SETTINGS + LEVEL_SETTINGS_ITEMS - 1;
     }
+
+    return this->menu_level;
 }
 
 //  ----------------------------------------------------------------------------
@@ -182,6 +190,7 @@ int MenuController::NavigateForward()
         case SETTINGS_ITEM_BRIGHTNESS:
         case SETTINGS_ITEM_BEEP:
         case SETTINGS_ITEM_ALARM:
+        case SETTINGS_ITEM_NIGHT:
             this->DisplayMenu(true);
             return this->menu_selection;
         
@@ -0,0 +1,362 @@
+////////////////////////////////////////////////////////////////////////////////
+//  NIGHT MODE
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NIGHT_MODE_H
+#define NIGHT_MODE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "fixed_string.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define NIGHT_MODE_OFF              0
+#define NIGHT_MODE_DIM              1           //  Tylko zegar przy najnizszej jasnosci.
+#define NIGHT_MODE_BLANK            2           //  Wyswietlacz uspiony, klawisz wybudza go na chwile.
+#define NIGHT_MODES                 3
+
+#define NIGHT_TRIGGER_LIGHT         0
+#define NIGHT_TRIGGER_SCHEDULE      1
+
+#define NIGHT_LIGHT_ENTER           16          //  Odczyt fotorezystorow ponizej ktorego zapada noc.
+#define NIGHT_LIGHT_EXIT            48          //  Odczyt powyzej ktorego noc sie konczy (histereza).
+#define NIGHT_LIGHT_DELAY           30000       //  Czas ciemnosci wymagany do wlaczenia [ms].
+#define NIGHT_CHECK_INTERVAL        1000        //  Odstep sprawdzania warunkow [ms].
+#define NIGHT_WAKE_TIME             10000       //  Czas wybudzenia wyswietlacza klawiszem [ms].
+
+#define NIGHT_DEFAULT_START         22
+#define NIGHT_DEFAULT_END           6
+
+//  Zmniejszone czestotliwosci pracy w nocy.
+#define NIGHT_TICK_DIM              200         //  Odstep przebiegow petli - miganie dwukropka [ms].
+#define NIGHT_TICK_BLANK            1000        //  Odstep przebiegow petli przy wygaszonym ekranie [ms].
+#define NIGHT_LIGHT_INTERVAL        500         //  Odstep odczytow fotorezystorow [ms].
+#define NIGHT_BUS_INTERVAL          5000        //  Odstep pomiarow temperatury [ms].
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Tryb nocny. Wlaczany wedlug harmonogramu godzinowego lub przy ciemnosci odczytanej przez
+//  fotorezystory. Klasa wyznacza tylko stan - wyswietlacz i czestotliwosci pracy ustawia
+//  GlobalController po zmianie stanu.
+class NightMode
+{
+    private:
+        byte            level               =   NIGHT_MODE_OFF;
+        byte            trigger             =   NIGHT_TRIGGER_LIGHT;
+        byte            start_hour          =   NIGHT_DEFAULT_START;
+        byte            end_hour            =   NIGHT_DEFAULT_END;
+
+        bool            active              =   false;
+        bool            dark                =   false;
+        unsigned long   dark_since          =   0;
+        unsigned long   last_check          =   0;
+        bool            woken               =   false;
+        unsigned long   wake_start          =   0;
+
+        bool  IsScheduledHour(int hour);
+
+    public:
+        NightMode();
+
+        byte  GetEndHour();
+        byte  GetLevel();
+        byte  GetStartHour();
+        void  GetStatus(FixedStringBase & result);
+        byte  GetTrigger();
+        bool  IsActive();
+        bool  IsBlank();
+        bool  IsCheckDue();
+        bool  ParseConfig(const char * config);
+        void  SetLevel(byte level);
+        void  SetLightTrigger();
+        bool  SetSchedule(int start_hour, int end_hour);
+        bool  Update(int hour, int light);
+        void  Wake();
+        void  WriteConfig(FixedStringBase & result);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Sprawdzenie czy godzina nalezy do przedzialu nocnego (przedzial moze przechodzic przez polnoc).
+ *  @param hour: Godzina od 0 do 23.
+ *  @return: True - godzina nocna.
+ */
+bool NightMode::IsScheduledHour(int hour)
+{
+    if (this->start_hour == this->end_hour)
+        return false;
+
+    if (this->start_hour < this->end_hour)
+        return hour >= this->start_hour && hour < this->end_hour;
+
+    return hour >= this->start_hour || hour < this->end_hour;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Konstruktor klasy trybu nocnego.
+NightMode::NightMode()
+{
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie godziny zakonczenia harmonogramu.
+ *  @return: Godzina od 0 do 23.
+ */
+byte NightMode::GetEndHour()
+{
+    return this->end_hour;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie poziomu trybu nocnego.
+ *  @return: NIGHT_MODE_OFF, NIGHT_MODE_DIM lub NIGHT_MODE_BLANK.
+ */
+byte NightMode::GetLevel()
+{
+    return this->level;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie godziny rozpoczecia harmonogramu.
+ *  @return: Godzina od 0 do 23.
+ */
+byte NightMode::GetStartHour()
+{
+    return this->start_hour;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie opisu konfiguracji i stanu trybu nocnego.
+ *  @param result: Tekst wynikowy.
+ */
+void NightMode::GetStatus(FixedStringBase & result)
+{
+    result.Append_P(PSTR("night: "));
+    this->WriteConfig(result);
+    result.Append_P(this->active ? PSTR(", active") : PSTR(", inactive"));
+
+    if (this->IsActive() && this->level == NIGHT_MODE_BLANK && !this->IsBlank())
+        result.Append_P(PSTR(" (woken)"));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie sposobu wlaczania trybu nocnego.
+ *  @return: NIGHT_TRIGGER_LIGHT lub NIGHT_TRIGGER_SCHEDULE.
+ */
+byte NightMode::GetTrigger()
+{
+    return this->trigger;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy tryb nocny jest aktywny.
+ *  @return: True - tryb nocny aktywny.
+ */
+bool NightMode::IsActive()
+{
+    return this->active;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy wyswietlacz ma byc wygaszony (tryb BLANK bez wybudzenia klawiszem).
+ *  @return: True - wyswietlacz wygaszony.
+ */
+bool NightMode::IsBlank()
+{
+    if (!this->active || this->level != NIGHT_MODE_BLANK)
+        return false;
+
+    if (this->woken && millis() - this->wake_start >= NIGHT_WAKE_TIME)
+        this->woken = false;
+
+    return !this->woken;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy minal odstep sprawdzania warunkow (pozwala pominac odczyt zegara).
+ *  @return: True - nalezy wywolac Update().
+ */
+bool NightMode::IsCheckDue()
+{
+    return millis() - this->last_check >= NIGHT_CHECK_INTERVAL;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wczytanie konfiguracji w postaci "<off|dim|blank> <light|hh-hh>".
+ *  @param config: Tekst konfiguracji (male litery).
+ *  @return: True - konfiguracja poprawna.
+ */
+bool NightMode::ParseConfig(const char * config)
+{
+    byte new_level;
+
+    if (strncmp_P(config, PSTR("off"), 3) == 0)
+        new_level = NIGHT_MODE_OFF;
+    else if (strncmp_P(config, PSTR("dim"), 3) == 0)
+        new_level = NIGHT_MODE_DIM;
+    else if (strncmp_P(config, PSTR("blank"), 5) == 0)
+        new_level = NIGHT_MODE_BLANK;
+    else
+        return false;
+
+    const char * trigger_text = strchr(config, ' ');
+
+    if (trigger_text != NULL)
+    {
+        trigger_text++;
+
+        if (strncmp_P(trigger_text, PSTR("light"), 5) == 0)
+            this->SetLightTrigger();
+
+        else
+        {
+            const char * separator = strchr(trigger_text, '-');
+
+            if (separator == NULL || !this->SetSchedule(atoi(trigger_text), atoi(separator + 1)))
+                return false;
+        }
+    }
+
+    this->SetLevel(new_level);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie poziomu trybu nocnego.
+ *  @param level: NIGHT_MODE_OFF, NIGHT_MODE_DIM lub NIGHT_MODE_BLANK.
+ */
+void NightMode::SetLevel(byte level)
+{
+    this->level = min(level, (byte) (NIGHT_MODES - 1));
+    this->last_check = millis() - NIGHT_CHECK_INTERVAL;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wlaczanie trybu nocnego przy ciemnosci odczytanej przez fotorezystory.
+void NightMode::SetLightTrigger()
+{
+    this->trigger = NIGHT_TRIGGER_LIGHT;
+    this->dark = false;
+    this->last_check = millis() - NIGHT_CHECK_INTERVAL;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wlaczanie trybu nocnego wedlug harmonogramu godzinowego.
+ *  @param start_hour: Godzina rozpoczecia od 0 do 23.
+ *  @param end_hour: Godzina zakonczenia od 0 do 23.
+ *  @return: True - harmonogram poprawny.
+ */
+bool NightMode::SetSchedule(int start_hour, int end_hour)
+{
+    if (start_hour < 0 || start_hour > 23 || end_hour < 0 || end_hour > 23 || start_hour == end_hour)
+        return false;
+
+    this->trigger = NIGHT_TRIGGER_SCHEDULE;
+    this->start_hour = start_hour;
+    this->end_hour = end_hour;
+    this->last_check = millis() - NIGHT_CHECK_INTERVAL;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie warunkow wlaczenia trybu nocnego (wywolywane gdy IsCheckDue()).
+ *  @param hour: Aktualna godzina.
+ *  @param light: Przefiltrowany odczyt fotorezystorow lub -1 gdy brak odczytu.
+ *  @return: True - stan trybu nocnego zmienil sie.
+ */
+bool NightMode::Update(int hour, int light)
+{
+    unsigned long now = millis();
+
+    this->last_check = now;
+    bool night = this->active;
+
+    if (this->level == NIGHT_MODE_OFF)
+        night = false;
+
+    else if (this->trigger == NIGHT_TRIGGER_SCHEDULE)
+        night = this->IsScheduledHour(hour);
+
+    //  Brak odczytu nie zmienia stanu; wlaczenie wymaga ciaglej ciemnosci, wylaczenie nastepuje od razu.
+    else if (light >= 0)
+    {
+        if (light >= NIGHT_LIGHT_EXIT)
+        {
+            this->dark = false;
+            night = false;
+        }
+        else if (light < NIGHT_LIGHT_ENTER)
+        {
+            if (!this->dark)
+            {
+                this->dark = true;
+                this->dark_since = now;
+            }
+
+            if (now - this->dark_since >= NIGHT_LIGHT_DELAY)
+                night = true;
+        }
+        else
+            this->dark = false;
+    }
+
+    if (night == this->active)
+        return false;
+
+    this->active = night;
+    this->woken = false;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wybudzenie wygaszonego wyswietlacza na NIGHT_WAKE_TIME.
+void NightMode::Wake()
+{
+    this->woken = true;
+    this->wake_start = millis();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis konfiguracji w postaci "<off|dim|blank> <light|hh-hh>".
+ *  @param result: Tekst wynikowy.
+ */
+void NightMode::WriteConfig(FixedStringBase & result)
+{
+    switch (this->level)
+    {
+        case NIGHT_MODE_DIM:
+            result.Append_P(PSTR("dim "));
+            break;
+
+        case NIGHT_MODE_BLANK:
+            result.Append_P(PSTR("blank "));
+            break;
+
+        default:
+            result.Append_P(PSTR("off "));
+    }
+
+    if (this->trigger == NIGHT_TRIGGER_LIGHT)
+        result.Append_P(PSTR("light"));
+    else
+        result.AppendNumber(this->start_hour).Append('-').AppendNumber(this->end_hour);
+}
+
+#endif
@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////
+//  ONEWIRE BUS - DALLAS DS18B20
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ONEWIRE_BUS_H
+#define ONEWIRE_BUS_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include "fixed_string.h"
+#include "profiler.h"
+#include "static_instance.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define ONEWIRE_BUS_MAX_DEVICES     4
+#define ONEWIRE_BUS_RESOLUTION      12          //  Rozdzielczosc 12 bitow - konwersja 750ms.
+#define ONEWIRE_BUS_INTERVAL        2000        //  Odstep pomiedzy poczatkami konwersji [ms].
+#define ONEWIRE_BUS_RAW_NULL        DEVICE_DISCONNECTED_RAW
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Magistrala OneWire z wieloma czujnikami DS18B20. Adresy ROM sa wyszukiwane raz
+//  po uruchomieniu, konwersja jest zlecana jednym poleceniem dla wszystkich czujnikow
+//  (bez oczekiwania), a po jej zakonczeniu czujniki sa odczytywane po adresach.
+//  Odczyty temperatur zwracaja ostatnie zapamietane wartosci i nie blokuja petli.
+class OneWireBus
+{
+    private:
+        OneWire           * connection;
+        DallasTemperature * sensor;
+
+        StaticInstance<OneWire>           connection_instance;
+        StaticInstance<DallasTemperature> sensor_instance;
+
+        DeviceAddress   addresses[ONEWIRE_BUS_MAX_DEVICES];
+        int16_t         raw_values[ONEWIRE_BUS_MAX_DEVICES];
+        byte            device_count        =   0;
+        unsigned int    read_count          =   0;
+
+        bool            converting          =   false;
+        unsigned long   convert_start       =   0;
+        unsigned int    convert_time        =   0;
+        unsigned int    interval            =   ONEWIRE_BUS_INTERVAL;
+
+        void  ReadAll();
+        void  RequestConversion();
+
+    public:
+        OneWireBus(int pin_input);
+
+        void            Discover();
+        int             FindAddress(const uint8_t * address);
+        const uint8_t * GetAddress(int index);
+        int             GetDeviceCount();
+        unsigned int    GetReadCount();
+        int16_t         GetRawValue(int index);
+        int             GetTemperature(int index);
+        void            Process();
+        void            SetInterval(unsigned int interval);
+
+        static void     AppendAddress(FixedStringBase & text, const uint8_t * address);
+        static bool     ParseAddress(const char * text, uint8_t * address);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odczytanie wynikow konwersji ze wszystkich czujnikow (po adresach ROM).
+void OneWireBus::ReadAll()
+{
+    PROFILE_SCOPE(PROFILE_SECTION_TEMPERATURE);
+
+    for (int i = 0; i < this->device_count; i++)
+        this->raw_values[i] = this->sensor->getTemp(this->addresses[i]);
+
+    this->converting = false;
+    this->read_count++;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zlecenie konwersji temperatury wszystkim czujnikom jednoczesnie (Skip ROM + Convert T).
+void OneWireBus::RequestConversion()
+{
+    this->sensor->requestTemperatures();
+    this->convert_start = millis();
+    this->converting = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy magistrali OneWire czujnikow DALLAS DS18B20.
+ *  @param pin_input: Pin danych magistrali.
+ */
+OneWireBus::OneWireBus(int pin_input)
+{
+    this->connection = this->connection_instance.Create(pin_input);
+    this->sensor = this->sensor_instance.Create(this->connection);
+
+    for (int i = 0; i < ONEWIRE_BUS_MAX_DEVICES; i++)
+        this->raw_values[i] = ONEWIRE_BUS_RAW_NULL;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyszukanie czujnikow na magistrali, zapamietanie ich adresow i zlecenie pierwszej konwersji.
+void OneWireBus::Discover()
+{
+    this->sensor->begin();
+    this->device_count = 0;
+
+    int found = this->sensor->getDeviceCount();
+
+    for (int i = 0; i < found && this->device_count < ONEWIRE_BUS_MAX_DEVICES; i++)
+    {
+        uint8_t * address = this->addresses[this->device_count];
+
+        if (!this->sensor->getAddress(address, i) || !this->sensor->validAddress(address))
+            continue;
+
+        this->sensor->setResolution(address, ONEWIRE_BUS_RESOLUTION);
+        this->device_count++;
+    }
+
+    this->sensor->setWaitForConversion(false);
+    this->convert_time = this->sensor->millisToWaitForConversion(ONEWIRE_BUS_RESOLUTION);
+
+    //  Wynik pierwszej konwersji odczytuje Process() - bez oczekiwania ~750ms.
+    if (this->device_count > 0)
+        this->RequestConversion();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyszukanie czujnika o podanym adresie ROM wsrod wykrytych na magistrali.
+ *  @param address: Adres czujnika (8 bajtow).
+ *  @return: Indeks czujnika lub -1 gdy czujnik nie zostal wykryty.
+ */
+int OneWireBus::FindAddress(const uint8_t * address)
+{
+    for (int i = 0; i < this->device_count; i++)
+        if (memcmp(this->addresses[i], address, sizeof(DeviceAddress)) == 0)
+            return i;
+
+    return -1;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie adresu ROM czujnika.
+ *  @param index: Indeks czujnika w kolejnosci wyszukiwania.
+ *  @return: Adres czujnika (8 bajtow) lub NULL gdy czujnik nie istnieje.
+ */
+const uint8_t * OneWireBus::GetAddress(int index)
+{
+    if (index < 0 || index >= this->device_count)
+        return NULL;
+
+    return this->addresses[index];
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci czujnikow wykrytych na magistrali.
+ *  @return: Ilosc czujnikow.
+ */
+int OneWireBus::GetDeviceCount()
+{
+    return this->device_count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci zakonczonych cykli pomiarowych (zmiana oznacza nowe odczyty).
+ *  @return: Licznik cykli pomiarowych.
+ */
+unsigned int OneWireBus::GetReadCount()
+{
+    return this->read_count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ostatniego odczytu czujnika w jednostkach 1/128 stopnia.
+ *  @param index: Indeks czujnika w kolejnosci wyszukiwania.
+ *  @return: Odczyt lub ONEWIRE_BUS_RAW_NULL gdy brak odczytu.
+ */
+int16_t OneWireBus::GetRawValue(int index)
+{
+    if (index < 0 || index >= this->device_count)
+        return ONEWIRE_BUS_RAW_NULL;
+
+    return this->raw_values[index];
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ostatniej temperatury czujnika.
+ *  @param index: Indeks czujnika w kolejnosci wyszukiwania.
+ *  @return: Temperatura w stopniach lub DEVICE_DISCONNECTED_C gdy brak odczytu.
+ */
+int OneWireBus::GetTemperature(int index)
+{
+    int16_t raw_value = this->GetRawValue(index);
+
+    if (raw_value <= ONEWIRE_BUS_RAW_NULL)
+        return DEVICE_DISCONNECTED_C;
+
+    return raw_value / 128;
+}
+
+//  ----------------------------------------------------------------------------
+//  Obsluga cyklu pomiarowego - odczyt po zakonczeniu konwersji i zlecenie kolejnej.
+void OneWireBus::Process()
+{
+    if (this->device_count == 0)
+        return;
+
+    unsigned long elapsed = millis() - this->convert_start;
+
+    if (this->converting)
+    {
+        if (elapsed >= this->convert_time)
+            this->ReadAll();
+    }
+    else if (elapsed >= this->interval)
+        this->RequestConversion();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie odstepu pomiedzy poczatkami konwersji (nie krotszego niz czas konwersji).
+ *  @param interval: Odstep [ms].
+ */
+void OneWireBus::SetInterval(unsigned int interval)
+{
+    this->interval = max(interval, this->convert_time);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie adresu ROM w postaci szesnastkowej.
+ *  @param text: Tekst wynikowy.
+ *  @param address: Adres czujnika (8 bajtow).
+ */
+void OneWireBus::AppendAddress(FixedStringBase & text, const uint8_t * address)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        text.Append("0123456789ABCDEF"[address[i] >> 4]);
+        text.Append("0123456789ABCDEF"[address[i] & 0x0F]);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odczytanie adresu ROM zapisanego szesnastkowo (16 znakow, wielkosc liter dowolna).
+ *  @param text: Tekst adresu.
+ *  @param address: Adres wynikowy (8 bajtow).
+ *  @return: True - adres poprawny (zgodna suma kontrolna CRC8).
+ */
+bool OneWireBus::ParseAddress(const char * text, uint8_t * address)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        char c = text[i];
+        byte value;
+
+        if (c >= '0' && c <= '9')
+            value = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value = c - 'A' + 10;
+        else
+            return false;
+
+        address[i / 2] = (i % 2 == 0) ? value << 4 : address[i / 2] | value;
+    }
+
+    return (text[16] == '\0' || text[16] == ' ') && OneWire::crc8(address, 7) == address[7];
+}
+
+#endif
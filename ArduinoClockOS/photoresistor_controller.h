@@ -5,14 +5,21 @@
 #ifndef PHOTORESISTOR_CONTROLLER_H
 #define PHOTORESISTOR_CONTROLLER_H
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "board_profile.h"
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
 #define LIGHT_SENSOR_MIN_VALUE        0
 #define LIGHT_SENSOR_MAX_VALUE        1023
-#define LIGHT_SENSOR_PIN_L            A10
-#define LIGHT_SENSOR_PIN_R            A11
+#define LIGHT_SENSOR_PIN_L            Board::LIGHT_SENSOR_PIN_L
+#define LIGHT_SENSOR_PIN_R            Board::LIGHT_SENSOR_PIN_R
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////
+//  POWER MANAGER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "board_profile.h"
+#include "fixed_string.h"
+#include "keypad_controller.h"
+#include "serial_controller.h"
+
+#if defined(__AVR__) || defined(ARDUINO_ARCH_HOST)
+#include <avr/sleep.h>
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define POWER_TICK_INTERVAL         50          //  Minimalny odstep pomiedzy przebiegami petli w bezczynnosci [ms].
+#define POWER_REPORT_WINDOW         10000       //  Okno pomiaru wypelnienia [ms].
+
+//  Szacunkowy pobor pradu samego ATmega2560 (5V, 16MHz) wg noty katalogowej [uA].
+#define POWER_ACTIVE_CURRENT_UA     20000UL
+#define POWER_IDLE_CURRENT_UA       6000UL
+
+//  Peryferia nieuzywane przez zegar: Timer1, Timer3, Timer4 (brak PWM), USART2, USART3.
+#if defined(PRR0)
+#define POWER_PRR0_UNUSED           (_BV(PRTIM1))
+#define POWER_PRR1_UNUSED           (_BV(PRTIM3) | _BV(PRTIM4) | _BV(PRUSART2) | _BV(PRUSART3))
+#endif
+
+#define POWER_PIN_SQW               Board::CLOCK_PIN_SQW
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Zarzadzanie poborem energii. Pomiedzy przebiegami petli procesor przechodzi w tryb
+//  SLEEP_MODE_IDLE (zegary i przerwania dzialaja) do czasu kolejnego przebiegu lub zdarzenia:
+//  klawisza z kolejki Timer5, danych UART lub przerwania SQW zegara DS3231. Przerwanie Timer0
+//  (millis) budzi procesor co ~1ms, wiec petla oczekiwania usypia go ponownie.
+class PowerManager
+{
+    private:
+        static volatile bool square_wave;
+
+        KeypadController  * keypad_ctrl;
+        SerialController  * serial_ctrl;
+
+        bool            enabled             =   true;
+        unsigned long   deadline            =   0;
+        unsigned int    tick_interval       =   POWER_TICK_INTERVAL;
+        unsigned long   wake_time           =   0;
+
+        unsigned long   window_start        =   0;
+        unsigned long   awake_us            =   0;
+        unsigned long   sleep_us            =   0;
+        unsigned long   wakeups             =   0;
+        unsigned int    duty_permille       =   1000;
+        unsigned long   last_wakeups        =   0;
+
+        bool  HasWakeEvent();
+        void  UpdateStatistics();
+
+        static void OnSquareWave();
+
+    public:
+        PowerManager(KeypadController * keypad_ctrl, SerialController * serial_ctrl);
+
+        void            Begin();
+        unsigned long   GetCurrentEstimate();
+        unsigned int    GetDutyCycle();
+        void            GetStatus(FixedStringBase & result);
+        void            Idle(bool allowed);
+        bool            IsEnabled();
+        void            SetEnabled(bool enabled);
+        void            SetTickInterval(unsigned int interval);
+
+        static void     AdcOff();
+        static void     AdcOn();
+};
+
+volatile bool PowerManager::square_wave = false;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Sprawdzenie czy wystapilo zdarzenie wymagajace przebiegu petli przed czasem.
+ *  @return: True - klawisz, dane wejsciowe lub nowa sekunda zegara.
+ */
+bool PowerManager::HasWakeEvent()
+{
+    return square_wave || this->keypad_ctrl->HasEvents() || this->serial_ctrl->HasInputData();
+}
+
+//  ----------------------------------------------------------------------------
+//  Zamkniecie okna pomiarowego i wyznaczenie wypelnienia.
+void PowerManager::UpdateStatistics()
+{
+    if (millis() - this->window_start < POWER_REPORT_WINDOW)
+        return;
+
+    unsigned long total_us = this->awake_us + this->sleep_us;
+
+    this->duty_permille = total_us > 0 ? (unsigned int) (this->awake_us / (total_us / 1000 + 1)) : 1000;
+    this->duty_permille = min(this->duty_permille, (unsigned int) 1000);
+    this->last_wakeups = this->wakeups;
+
+    this->window_start = millis();
+    this->awake_us = 0;
+    this->sleep_us = 0;
+    this->wakeups = 0;
+}
+
+//  ----------------------------------------------------------------------------
+//  Obsluga przerwania SQW zegara DS3231 (zmiana sekundy).
+void PowerManager::OnSquareWave()
+{
+    square_wave = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy zarzadzania poborem energii.
+ *  @param keypad_ctrl: Kontroler klawiatury (kolejka zdarzen).
+ *  @param serial_ctrl: Kontroler polaczen szeregowych.
+ */
+PowerManager::PowerManager(KeypadController * keypad_ctrl, SerialController * serial_ctrl)
+{
+    this->keypad_ctrl = keypad_ctrl;
+    this->serial_ctrl = serial_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wylaczenie nieuzywanych peryferiow i podlaczenie przerwania SQW (jezeli jest podlaczone).
+void PowerManager::Begin()
+{
+#if defined(PRR0)
+    PRR0 |= POWER_PRR0_UNUSED;
+    PRR1 |= POWER_PRR1_UNUSED;
+#endif
+
+    AdcOff();
+
+    if (POWER_PIN_SQW >= 0 && digitalPinToInterrupt(POWER_PIN_SQW) >= 0)
+    {
+        pinMode(POWER_PIN_SQW, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(POWER_PIN_SQW), PowerManager::OnSquareWave, FALLING);
+    }
+
+    this->window_start = millis();
+    this->wake_time = micros();
+    this->deadline = millis() + POWER_TICK_INTERVAL;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie szacunkowego poboru pradu procesora w ostatnim oknie pomiarowym.
+ *  @return: Prad [uA].
+ */
+unsigned long PowerManager::GetCurrentEstimate()
+{
+    return (POWER_ACTIVE_CURRENT_UA * this->duty_permille
+        + POWER_IDLE_CURRENT_UA * (1000 - this->duty_permille)) / 1000;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie wypelnienia (czas pracy procesora) w ostatnim oknie pomiarowym.
+ *  @return: Wypelnienie w promilach.
+ */
+unsigned int PowerManager::GetDutyCycle()
+{
+    return this->duty_permille;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie opisu stanu zarzadzania energia.
+ *  @param result: Tekst wynikowy.
+ */
+void PowerManager::GetStatus(FixedStringBase & result)
+{
+    unsigned long current = this->GetCurrentEstimate();
+
+    result.Append_P(PSTR("power: idle "));
+    result.Append_P(this->enabled ? PSTR("on") : PSTR("off"));
+    result.Append_P(PSTR(", duty ")).AppendNumber(this->duty_permille / 10).Append('.');
+    result.AppendNumber(this->duty_permille % 10).Append('%');
+    result.Append_P(PSTR(", MCU ~")).AppendNumber(current / 1000).Append('.');
+    result.AppendNumber((current % 1000) / 100).Append_P(PSTR("mA"));
+    result.Append_P(PSTR(", wakeups ")).AppendNumber(this->last_wakeups);
+    result.Append_P(PSTR("/")).AppendNumber(POWER_REPORT_WINDOW / 1000).Append('s');
+}
+
+//  ----------------------------------------------------------------------------
+/*  Oczekiwanie w trybie uspienia do kolejnego przebiegu petli lub zdarzenia.
+ *  @param allowed: Brak pracy wymagajacej ciaglego dzialania petli (animacje, dzwieki, transmisja).
+ */
+void PowerManager::Idle(bool allowed)
+{
+    unsigned long sleep_start = micros();
+    this->awake_us += sleep_start - this->wake_time;
+
+#if defined(SLEEP_MODE_IDLE)
+    if (allowed && this->enabled)
+    {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+
+        while ((long) (millis() - this->deadline) < 0)
+        {
+            //  Sprawdzenie zdarzen przy wylaczonych przerwaniach - sei() przed sleep_cpu() wykonuje
+            //  jeszcze jedna instrukcje, wiec przerwanie nie zostanie utracone.
+            cli();
+
+            if (this->HasWakeEvent())
+            {
+                sei();
+                break;
+            }
+
+            sleep_enable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+
+            this->wakeups++;
+        }
+    }
+#endif
+
+    square_wave = false;
+
+    this->wake_time = micros();
+    this->sleep_us += this->wake_time - sleep_start;
+    this->deadline = millis() + this->tick_interval;
+    this->UpdateStatistics();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy usypianie procesora jest wlaczone.
+ *  @return: True - usypianie wlaczone.
+ */
+bool PowerManager::IsEnabled()
+{
+    return this->enabled;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wlaczenie lub wylaczenie usypiania procesora.
+ *  @param enabled: True - usypianie wlaczone.
+ */
+void PowerManager::SetEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie minimalnego odstepu pomiedzy przebiegami petli w bezczynnosci.
+ *  @param interval: Odstep [ms].
+ */
+void PowerManager::SetTickInterval(unsigned int interval)
+{
+    this->tick_interval = max(interval, (unsigned int) POWER_TICK_INTERVAL);
+}
+
+//  ----------------------------------------------------------------------------
+//  Wylaczenie przetwornika ADC (najpierw ADEN, nastepnie zasilanie przez PRR).
+void PowerManager::AdcOff()
+{
+#if defined(PRR0)
+    ADCSRA &= ~_BV(ADEN);
+    PRR0 |= _BV(PRADC);
+#endif
+}
+
+//  ----------------------------------------------------------------------------
+//  Wlaczenie przetwornika ADC przed odczytem (pierwsza konwersja trwa 25 cykli ADC).
+void PowerManager::AdcOn()
+{
+#if defined(PRR0)
+    PRR0 &= ~_BV(PRADC);
+    ADCSRA |= _BV(ADEN);
+#endif
+}
+
+#endif
@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+//  PROFILER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Domyslnie wylaczony - pomiary zajmuja 492B RAM (sekcje z histogramami). Ustawienie na 1
+//  (lub -DPROFILER_ENABLED=1) wlacza /stats i /bench; przy 0 makra PROFILE_* sa puste.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED              0
+#endif
+
+#define PROFILE_SECTION_LOOP              0
+#define PROFILE_SECTION_INPUT             1
+#define PROFILE_SECTION_FUNCTIONALITIES   2
+#define PROFILE_SECTION_DISPLAY           3
+#define PROFILE_SECTION_SAVE_DATA         4
+#define PROFILE_SECTION_TEMPERATURE       5
+#define PROFILE_SECTION_IR_SEND           6
+#define PROFILE_SECTION_CONFIG_LOAD       7
+#define PROFILE_SECTION_WEATHER_LOAD      8
+#define PROFILE_SECTION_IDLE              9           //  Uspienie pomiedzy przebiegami (poza "loop").
+#define PROFILE_SECTIONS                  10
+
+//  Przedzial i: [2^i, 2^(i+1)) us, ostatni przedzial zbiera wszystkie dluzsze pomiary.
+#define PROFILER_BUCKETS                  16
+#define PROFILER_REPORT_SIZE              96
+
+
+//  Przy wylaczonym profilerze klasy i instancja globalna nie sa kompilowane (brak kosztu w RAM).
+#if PROFILER_ENABLED
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+struct ProfileSection
+{
+    unsigned long   count;
+    unsigned long   total;
+    unsigned long   min;
+    unsigned long   max;
+    unsigned int    buckets[PROFILER_BUCKETS];
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class Profiler
+{
+    private:
+        ProfileSection  sections[PROFILE_SECTIONS];
+
+        unsigned long   loop_counter        =   0;
+        unsigned long   loop_window_start   =   0;
+        unsigned long   loops_per_second    =   0;
+
+        int             GetBucket(unsigned long duration);
+        unsigned long   GetPercentile(int section, int percent);
+
+    public:
+        Profiler();
+
+        void            CountLoop();
+        unsigned long   GetLoopsPerSecond();
+        const char    * GetSectionName(int section);
+        bool            GetSectionReport(int section, char * buffer, int buffer_size);
+        void            Record(int section, unsigned long duration);
+        void            Reset();
+};
+
+//  ----------------------------------------------------------------------------
+//  Pomiar czasu wykonania bloku kodu (od utworzenia do wyjscia z zakresu).
+class ProfileScope
+{
+    private:
+        int             section;
+        unsigned long   start_time;
+
+    public:
+        ProfileScope(int section);
+        ~ProfileScope();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** GLOBAL INSTANCE & MACROS ***
+////////////////////////////////////////////////////////////////////////////////
+
+Profiler profiler;
+
+#define PROFILE_CONCAT_(a, b)   a##b
+#define PROFILE_CONCAT(a, b)    PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(section)  ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(section)
+#define PROFILE_LOOP()          profiler.CountLoop()
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Wyznaczenie przedzialu histogramu dla czasu wykonania.
+ *  @param duration: Czas wykonania w mikrosekundach.
+ *  @return: Indeks przedzialu histogramu.
+ */
+int Profiler::GetBucket(unsigned long duration)
+{
+    int bucket = 0;
+
+    while (duration > 1 && bucket < PROFILER_BUCKETS - 1)
+    {
+        duration >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Oszacowanie percentyla czasu wykonania na podstawie histogramu.
+ *  @param section: Indeks mierzonej sekcji.
+ *  @param percent: Percentyl (np. 99).
+ *  @return: Gorna granica przedzialu zawierajacego percentyl (w mikrosekundach).
+ */
+unsigned long Profiler::GetPercentile(int section, int percent)
+{
+    ProfileSection * data = &this->sections[section];
+    unsigned long threshold = (data->count * (100 - percent) + 99) / 100;
+    unsigned long above = 0;
+
+    for (int bucket = PROFILER_BUCKETS - 1; bucket > 0; bucket--)
+    {
+        above += data->buckets[bucket];
+
+        if (above >= threshold)
+            return min(data->max, (1UL << (bucket + 1)) - 1);
+    }
+
+    return min(data->max, 1UL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Konstruktor klasy zbierajacej pomiary czasu wykonania.
+Profiler::Profiler()
+{
+    this->Reset();
+}
+
+//  ----------------------------------------------------------------------------
+//  Zliczenie przebiegu petli glownej (wywolywane raz na cykl).
+void Profiler::CountLoop()
+{
+    unsigned long now = millis();
+
+    this->loop_counter++;
+
+    if (now - this->loop_window_start >= 1000)
+    {
+        this->loops_per_second = (this->loop_counter * 1000UL) / (now - this->loop_window_start);
+        this->loop_counter = 0;
+        this->loop_window_start = now;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci przebiegow petli glownej w ostatniej sekundzie.
+ *  @return: Ilosc przebiegow petli na sekunde.
+ */
+unsigned long Profiler::GetLoopsPerSecond()
+{
+    return this->loops_per_second;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie nazwy mierzonej sekcji.
+ *  @param section: Indeks mierzonej sekcji.
+ *  @return: Nazwa sekcji (w pamieci programu).
+ */
+const char * Profiler::GetSectionName(int section)
+{
+    switch (section)
+    {
+        case PROFILE_SECTION_LOOP:              return PSTR("loop");
+        case PROFILE_SECTION_INPUT:             return PSTR("input");
+        case PROFILE_SECTION_FUNCTIONALITIES:   return PSTR("functionalities");
+        case PROFILE_SECTION_DISPLAY:           return PSTR("display");
+        case PROFILE_SECTION_SAVE_DATA:         return PSTR("save_data");
+        case PROFILE_SECTION_TEMPERATURE:       return PSTR("temperature");
+        case PROFILE_SECTION_IR_SEND:           return PSTR("ir_send");
+        case PROFILE_SECTION_CONFIG_LOAD:       return PSTR("config_load");
+        case PROFILE_SECTION_WEATHER_LOAD:      return PSTR("weather_load");
+        case PROFILE_SECTION_IDLE:              return PSTR("idle");
+        default:                                return PSTR("?");
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przygotowanie raportu pomiarow sekcji w postaci tekstu.
+ *  @param section: Indeks mierzonej sekcji.
+ *  @param buffer: Bufor wynikowy.
+ *  @param buffer_size: Rozmiar bufora wynikowego.
+ *  @return: Informacja czy sekcja posiada pomiary.
+ */
+bool Profiler::GetSectionReport(int section, char * buffer, int buffer_size)
+{
+    ProfileSection * data = &this->sections[section];
+
+    if (data->count == 0)
+        return false;
+
+    char name[20];
+    strncpy_P(name, this->GetSectionName(section), sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    snprintf_P(buffer, buffer_size,
+        PSTR("%s: n=%lu min=%lu avg=%lu max=%lu p99<=%lu us"),
+        name,
+        data->count,
+        data->min,
+        data->total / data->count,
+        data->max,
+        this->GetPercentile(section, 99));
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapisanie pomiaru czasu wykonania sekcji.
+ *  @param section: Indeks mierzonej sekcji.
+ *  @param duration: Czas wykonania w mikrosekundach.
+ */
+void Profiler::Record(int section, unsigned long duration)
+{
+    if (section < 0 || section >= PROFILE_SECTIONS)
+        return;
+
+    ProfileSection * data = &this->sections[section];
+    int bucket = this->GetBucket(duration);
+
+    data->count++;
+    data->total += duration;
+    data->min = min(data->min, duration);
+    data->max = max(data->max, duration);
+
+    //  Pelny przedzial - wszystkie przedzialy, licznik i suma sa zmniejszane o polowe, aby
+    //  proporcje (percentyle i srednia) pozostaly poprawne przy dlugim czasie pracy.
+    if (data->buckets[bucket] == 0xFFFF)
+    {
+        for (int i = 0; i < PROFILER_BUCKETS; i++)
+            data->buckets[i] /= 2;
+
+        data->count /= 2;
+        data->total /= 2;
+    }
+
+    data->buckets[bucket]++;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyczyszczenie wszystkich pomiarow.
+void Profiler::Reset()
+{
+    memset(this->sections, 0, sizeof(this->sections));
+
+    for (int section = 0; section < PROFILE_SECTIONS; section++)
+        this->sections[section].min = 0xFFFFFFFFUL;
+
+    this->loop_counter = 0;
+    this->loop_window_start = millis();
+    this->loops_per_second = 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rozpoczecie pomiaru czasu wykonania sekcji.
+ *  @param section: Indeks mierzonej sekcji.
+ */
+ProfileScope::ProfileScope(int section)
+{
+    this->section = section;
+    this->start_time = micros();
+}
+
+//  ----------------------------------------------------------------------------
+//  Zakonczenie pomiaru czasu wykonania sekcji.
+ProfileScope::~ProfileScope()
+{
+    profiler.Record(this->section, micros() - this->start_time);
+}
+
+#else
+
+#define PROFILE_SCOPE(section)
+#define PROFILE_LOOP()
+
+#endif
+
+#endif
@@ -11,34 +11,72 @@
 
 #include  <SPI.h>
 #include  <SD.h>
+#include  "board_profile.h"
+#include  "spi_bus.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#define SDCARD_PIN_MISO   50
-#define SDCARD_PIN_MOSI   51
-#define SDCARD_PIN_SCK    52
-#define SDCARD_PIN_CS     53
+#define SDCARD_PIN_MISO   Board::SDCARD_PIN_MISO
+#define SDCARD_PIN_MOSI   Board::SDCARD_PIN_MOSI
+#define SDCARD_PIN_SCK    Board::SDCARD_PIN_SCK
+#define SDCARD_PIN_CS     Board::SDCARD_PIN_CS
+
+#define SDCARD_BLOCK_SIZE   512
+#define SDCARD_BLOCK_NONE   0xFFFFFFFFUL
+#define SDCARD_NAME_SIZE    13          //  Nazwa 8.3 z terminatorem.
+
+#define SDCARD_CACHE_READ   0           //  Odczyt sektora.
+#define SDCARD_CACHE_WRITE  1           //  Odczyt i modyfikacja sektora (zapis przy zmianie lub FlushBlock).
+#define SDCARD_CACHE_ZERO   2           //  Nadpisanie calego sektora - bez odczytu, bufor wyzerowany.
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Bufor jednego sektora karty z opoznionym zapisem.
+struct SdBlockCache
+{
+    uint32_t    block;
+    bool        dirty;
+    uint8_t     data[SDCARD_BLOCK_SIZE];
+};
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
 ////////////////////////////////////////////////////////////////////////////////
 
+//  Kontroler karty SD. Karta jest montowana raz (bez SD.begin), katalog glowny i ostatnio uzyty
+//  podkatalog pozostaja otwarte, a pliki sa otwierane bezposrednio przez SdFile. Transmisja SPI
+//  odbywa sie z pelna predkoscia (F_CPU/2). Magistrala jest przejmowana (SpiBus) tylko w metodach
+//  kontrolera - operacje na zwroconych obiektach File jej nie przejmuja.
 class SdCardController
 {
     private:
         Sd2Card   _device;
         SdVolume  _partition;
+        SdFile    _root;
+        SdFile    _directory;
+        char      directory_name[SDCARD_NAME_SIZE];
+
+        SdBlockCache  cache;
+        int8_t        spi_device;
 
         bool  initialized = false;
         bool  mounted = false;
-        bool  rw_ready = false;
+
+        unsigned long block_write_count = 0;
+        unsigned long write_open_count = 0;
+
+        File      OpenFile(String file_path, uint8_t flags);
+        SdFile  * OpenParentDirectory(const char * path, const char *& name);
     
     public:
-        SdCardController();
+        SdCardController(bool mount);
 
         //  Initialization.
         void      Initialize();
@@ -55,24 +93,119 @@ class SdCardController
         float     GetPartitionSizeInGB();
         uint32_t  GetPartitionSizeInMB();
 
+        //  Block Cache.
+        bool      FlushBlock();
+        uint8_t * GetBlock(uint32_t block, byte mode = SDCARD_CACHE_READ);
+        bool      OpenContiguousFile(String file_path, uint32_t blocks, uint32_t & first_block, uint32_t & last_block);
+
         //  Files Management.
         void  CreateDirectory(String directory_path);
         bool  FileExists(String file_path);
         File  OpenFileToAppend(String file_path);
         File  OpenFileToRead(String file_path);
+        File  OpenFileToUpdate(String file_path);
         File  OpenFileToWrite(String file_path);
         void  RemoveDirectory(String directory_path);
         void  RemoveFile(String file_path);
+
+        //  Statistics.
+        unsigned long GetBlockWriteCount();
+        unsigned long GetWriteOpenCount();
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Otwarcie pliku bez sprawdzania jego istnienia (jak SD.open - tryby zapisu ustawiaja pozycje na koncu).
+ *  @param file_path: Sciezka pliku.
+ *  @param flags: Flagi otwarcia O_*.
+ *  @return: Otwarty plik lub pusty obiekt File w przypadku bledu.
+ */
+File SdCardController::OpenFile(String file_path, uint8_t flags)
+{
+    if (!this->mounted)
+        return File();
+
+    const char * name;
+    SdFile file;
+
+    SpiBus::Acquire(this->spi_device);
+
+    SdFile * directory = this->OpenParentDirectory(file_path.c_str(), name);
+    bool opened = directory != NULL && file.open(directory, name, flags);
+
+    if (opened && (flags & (O_APPEND | O_WRITE)))
+        file.seekSet(file.fileSize());
+
+    SpiBus::Release(this->spi_device);
+    return opened ? File(file, name) : File();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie katalogu nadrzednego pliku. Katalog glowny i ostatnio uzyty podkatalog pozostaja
+ *  otwarte - obslugiwany jest jeden poziom podkatalogow (np. "frames/name.frm").
+ *  @param path: Sciezka pliku.
+ *  @param name: Wynikowa nazwa pliku w katalogu nadrzednym (wskaznik do path).
+ *  @return: Otwarty katalog nadrzedny lub NULL w przypadku bledu.
+ */
+SdFile * SdCardController::OpenParentDirectory(const char * path, const char *& name)
+{
+    while (*path == '/')
+        path++;
+
+    const char * separator = strchr(path, '/');
+    name = path;
+
+    if (separator == NULL)
+        return &this->_root;
+
+    int length = separator - path;
+    name = separator + 1;
+
+    if (length >= SDCARD_NAME_SIZE || strchr(name, '/') != NULL)
+        return NULL;
+
+    if (this->_directory.isOpen() && strncmp(this->directory_name, path, length) == 0
+        && this->directory_name[length] == '\0')
+        return &this->_directory;
+
+    if (this->_directory.isOpen())
+        this->_directory.close();
+
+    memcpy(this->directory_name, path, length);
+    this->directory_name[length] = '\0';
+
+    if (!this->_directory.open(&this->_root, this->directory_name, O_READ) || !this->_directory.isDir())
+    {
+        this->_directory.close();
+        return NULL;
+    }
+
+    return &this->_directory;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** PUBLIC METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-//  Konstruktor kontrolera czytnika kart SD HW-125.
-SdCardController::SdCardController()
+/*  Konstruktor kontrolera czytnika kart SD HW-125.
+ *  @param mount: True - inicjalizacja i montowanie karty; False - wykonywane pozniej (Initialize, Mount).
+ */
+SdCardController::SdCardController(bool mount = true)
 {
+    this->directory_name[0] = '\0';
+    this->cache.block = SDCARD_BLOCK_NONE;
+    this->cache.dirty = false;
+
+    //  Pin CS karty w stanie wysokim od uruchomienia (pin SS musi byc wyjsciem w trybie master).
+    this->spi_device = SpiBus::Register(SDCARD_PIN_CS);
+
+    if (!mount)
+        return;
+
     this->Initialize();
     this->Mount();
 }
@@ -81,24 +214,24 @@ SdCardController::SdCardController()
 //  *** PUBLIC INITIALIZATION METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-//  Inicjalizacja kontrolera czytnika kart SD.
+//  Inicjalizacja kontrolera czytnika kart SD (inicjalizacja karty odbywa sie przy 250kHz, dalsza praca z pelna predkoscia).
 void SdCardController::Initialize()
 {
-    this->initialized = this->_device.init(SPI_HALF_SPEED, SDCARD_PIN_CS);
-
-    if (this->initialized)
-        this->mounted = this->_partition.init(this->_device);
+    SpiBus::Acquire(this->spi_device);
+    this->initialized = this->_device.init(SPI_FULL_SPEED, SDCARD_PIN_CS);
+    SpiBus::Release(this->spi_device);
 }
 
 //  ----------------------------------------------------------------------------
-//  Montowanie karty SD.
+//  Montowanie karty SD - jednokrotne wczytanie partycji i otwarcie katalogu glownego.
 void SdCardController::Mount()
 {
-    if (this->initialized)
-    {
-        this->mounted = this->_partition.init(this->_device);
-        this->rw_ready = SD.begin(SDCARD_PIN_CS);
-    }
+    if (!this->initialized || this->mounted)
+        return;
+
+    SpiBus::Acquire(this->spi_device);
+    this->mounted = this->_partition.init(this->_device) && this->_root.openRoot(&this->_partition);
+    SpiBus::Release(this->spi_device);
 }
 
 //  ----------------------------------------------------------------------------
@@ -116,7 +249,7 @@ bool SdCardController::IsInitialized()
  */
 bool SdCardController::IsMounted()
 {
-    return this->mounted && this->rw_ready;
+    return this->mounted;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -226,56 +359,245 @@ uint32_t SdCardController::GetPartitionSizeInMB()
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC BLOCK CACHE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Zapis zmodyfikowanego sektora z bufora na karte.
+ *  @return: True - bufor zapisany lub niezmodyfikowany; False - blad zapisu.
+ */
+bool SdCardController::FlushBlock()
+{
+    if (!this->cache.dirty)
+        return true;
+
+    SpiBus::Acquire(this->spi_device);
+    bool written = this->_device.writeBlock(this->cache.block, this->cache.data);
+    SpiBus::Release(this->spi_device);
+
+    if (!written)
+        return false;
+
+    this->cache.dirty = false;
+    this->block_write_count++;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie sektora karty przez bufor (tylko dla plikow ciaglych, z pominieciem systemu plikow -
+ *  te same sektory nie moga byc jednoczesnie uzywane przez obiekty File).
+ *  @param block: Numer sektora karty.
+ *  @param mode: SDCARD_CACHE_READ, SDCARD_CACHE_WRITE lub SDCARD_CACHE_ZERO.
+ *  @return: Dane sektora (SDCARD_BLOCK_SIZE bajtow) lub NULL w przypadku bledu.
+ */
+uint8_t * SdCardController::GetBlock(uint32_t block, byte mode = SDCARD_CACHE_READ)
+{
+    if (!this->mounted)
+        return NULL;
+
+    if (this->cache.block != block)
+    {
+        if (!this->FlushBlock())
+            return NULL;
+
+        this->cache.block = SDCARD_BLOCK_NONE;
+
+        if (mode == SDCARD_CACHE_ZERO)
+            memset(this->cache.data, 0, SDCARD_BLOCK_SIZE);
+        else
+        {
+            SpiBus::Acquire(this->spi_device);
+            bool read = this->_device.readBlock(block, this->cache.data);
+            SpiBus::Release(this->spi_device);
+
+            if (!read)
+                return NULL;
+        }
+
+        this->cache.block = block;
+    }
+    else if (mode == SDCARD_CACHE_ZERO)
+        memset(this->cache.data, 0, SDCARD_BLOCK_SIZE);
+
+    if (mode != SDCARD_CACHE_READ)
+        this->cache.dirty = true;
+
+    return this->cache.data;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Otwarcie lub utworzenie pliku zajmujacego ciagly obszar karty (do zapisu przez GetBlock).
+ *  Nowy plik nie jest zerowany.
+ *  @param file_path: Sciezka pliku.
+ *  @param blocks: Wymagana ilosc sektorow.
+ *  @param first_block: Wynikowy numer pierwszego sektora.
+ *  @param last_block: Wynikowy numer ostatniego sektora.
+ *  @return: True - plik jest ciagly i ma co najmniej blocks sektorow.
+ */
+bool SdCardController::OpenContiguousFile(String file_path, uint32_t blocks, uint32_t & first_block, uint32_t & last_block)
+{
+    if (!this->mounted || blocks == 0)
+        return false;
+
+    const char * name;
+    SdFile file;
+
+    SpiBus::Acquire(this->spi_device);
+
+    SdFile * directory = this->OpenParentDirectory(file_path.c_str(), name);
+    bool opened = directory != NULL && file.open(directory, name, O_READ);
+    bool created = !opened && directory != NULL
+        && file.createContiguous(directory, name, blocks * SDCARD_BLOCK_SIZE);
+    bool result = (opened || created) && file.contiguousRange(&first_block, &last_block)
+        && last_block - first_block + 1 >= blocks;
+
+    if (opened || created)
+        file.close();
+
+    SpiBus::Release(this->spi_device);
+
+    if (created)
+        this->write_open_count++;
+
+    return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** PUBLIC FILES MANAGEMENT METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
 void SdCardController::CreateDirectory(String directory_path)
 {
-    SD.mkdir(directory_path);
+    if (!this->mounted)
+        return;
+
+    const char * name;
+    SdFile directory;
+
+    SpiBus::Acquire(this->spi_device);
+
+    SdFile * parent = this->OpenParentDirectory(directory_path.c_str(), name);
+
+    if (parent != NULL && directory.makeDir(parent, name))
+        directory.close();
+
+    SpiBus::Release(this->spi_device);
 }
 
 //  ----------------------------------------------------------------------------
 bool SdCardController::FileExists(String file_path)
 {
-    return SD.exists(file_path);
+    if (!this->mounted)
+        return false;
+
+    const char * name;
+    SdFile file;
+
+    SpiBus::Acquire(this->spi_device);
+
+    SdFile * directory = this->OpenParentDirectory(file_path.c_str(), name);
+    bool exists = directory != NULL && file.open(directory, name, O_READ);
+
+    if (exists)
+        file.close();
+
+    SpiBus::Release(this->spi_device);
+    return exists;
 }
 
 //  ----------------------------------------------------------------------------
 File SdCardController::OpenFileToAppend(String file_path)
 {
-    File file = SD.open(file_path, FILE_WRITE);
-    file.seek(EOF);
+    this->write_open_count++;
 
-    return file;
+    return this->OpenFile(file_path, FILE_WRITE);
 }
 
 //  ----------------------------------------------------------------------------
 File SdCardController::OpenFileToRead(String file_path)
 {
-    return SD.open(file_path, FILE_READ);
+    return this->OpenFile(file_path, FILE_READ);
+}
+
+//  ----------------------------------------------------------------------------
+//  Otwarcie pliku do zapisu w dowolnym miejscu (bez O_APPEND i bez usuwania zawartosci).
+File SdCardController::OpenFileToUpdate(String file_path)
+{
+    this->write_open_count++;
+
+    return this->OpenFile(file_path, O_READ | O_WRITE | O_CREAT);
 }
 
 //  ----------------------------------------------------------------------------
+//  Otwarcie pliku do zapisu od poczatku (zawartosc jest obcinana przy otwarciu, bez usuwania pliku).
 File SdCardController::OpenFileToWrite(String file_path)
 {
-    if (this->FileExists(file_path))
-        this->RemoveFile(file_path);
-    
-    return SD.open(file_path, FILE_WRITE);
+    this->write_open_count++;
+
+    return this->OpenFile(file_path, FILE_WRITE | O_TRUNC);
 }
 
 //  ----------------------------------------------------------------------------
 void SdCardController::RemoveFile(String file_path)
 {
-    if (this->FileExists(file_path))
-        SD.remove(file_path);
+    if (!this->mounted)
+        return;
+
+    const char * name;
+
+    SpiBus::Acquire(this->spi_device);
+
+    SdFile * directory = this->OpenParentDirectory(file_path.c_str(), name);
+
+    if (directory != NULL)
+        SdFile::remove(directory, name);
+
+    SpiBus::Release(this->spi_device);
 }
 
 //  ----------------------------------------------------------------------------
 void SdCardController::RemoveDirectory(String directory_path)
 {
-    SD.rmdir(directory_path);
+    if (!this->mounted)
+        return;
+
+    const char * name;
+    SdFile directory;
+
+    SpiBus::Acquire(this->spi_device);
+
+    //  Usuwany katalog nie moze pozostac otwarty jako podkatalog ostatnio uzyty.
+    if (this->_directory.isOpen())
+        this->_directory.close();
+
+    SdFile * parent = this->OpenParentDirectory(directory_path.c_str(), name);
+
+    if (parent != NULL && directory.open(parent, name, O_READ))
+        directory.rmDir();
+
+    SpiBus::Release(this->spi_device);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC STATISTICS METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Pobranie ilosci sektorow zapisanych z bufora GetBlock (od uruchomienia).
+ *  Zapisy przez obiekty File przechodza przez bufor biblioteki SD i nie sa tu liczone.
+ *  @return: Ilosc zapisanych sektorow plikow ciaglych.
+ */
+unsigned long SdCardController::GetBlockWriteCount()
+{
+    return this->block_write_count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci otwarc plikow do zapisu (od uruchomienia).
+ *  @return: Ilosc otwarc plikow do zapisu, dopisywania oraz utworzen plikow ciaglych.
+ */
+unsigned long SdCardController::GetWriteOpenCount()
+{
+    return this->write_open_count;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+//  SENSOR SAMPLER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SENSOR_SAMPLER_H
+#define SENSOR_SAMPLER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "photoresistor_controller.h"
+#include "power_manager.h"
+#include "temperature_sensor_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define SAMPLER_LIGHT_LEFT          0
+#define SAMPLER_LIGHT_RIGHT         1
+#define SAMPLER_TEMP_IN             2           //  Temperatura w dziesiatych czesciach stopnia.
+#define SAMPLER_TEMP_OUT            3           //  Temperatura w dziesiatych czesciach stopnia.
+#define SAMPLER_CHANNELS            4
+
+#define SAMPLER_WINDOW              5           //  Mediana z 5 ostatnich odczytow (odrzucenie szpilek).
+#define SAMPLER_FIXED_SHIFT         4           //  Srednia w formacie stalopozycyjnym Q4.
+#define SAMPLER_SMOOTHING           2           //  Srednia wykladnicza: alfa = 1/4.
+
+#define SAMPLER_LIGHT_INTERVAL      100         //  Odstep odczytow ADC [ms].
+#define SAMPLER_LIGHT_MAX_AGE       1000        //  Wiek odczytu, po ktorym jest on nieaktualny [ms].
+#define SAMPLER_TEMP_MAX_AGE        10000       //  5 cykli pomiarowych magistrali OneWire [ms].
+
+#define SAMPLER_FLAG_VALID          0x01        //  Kanal otrzymal co najmniej jeden odczyt.
+#define SAMPLER_FLAG_STALE          0x02        //  Ostatni odczyt jest starszy niz dopuszczalny wiek.
+
+#define SAMPLER_NULL                -1270       //  Brak waznego odczytu (jak TEMP_LOG_NULL).
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Kanal pomiarowy - okno mediany, wygladzona wartosc i czas ostatniego odczytu.
+struct SensorChannel
+{
+    int16_t         window[SAMPLER_WINDOW];
+    byte            position;
+    byte            count;
+    long            filtered;
+    unsigned long   last_update;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Usluga probkowania czujnikow. Odczyty sa wykonywane wedlug harmonogramu w Process(),
+//  filtrowane mediana i srednia wykladnicza, a odbiorcy pobieraja gotowe wartosci w czasie
+//  stalym bez dostepu do ADC ani magistrali OneWire.
+class SensorSampler
+{
+    private:
+        PhotoresistorController     * light_left;
+        PhotoresistorController     * light_right;
+        TemperatureSensorController * temp_in;
+        TemperatureSensorController * temp_out;
+
+        SensorChannel   channels[SAMPLER_CHANNELS];
+        unsigned long   last_light_read     =   0;
+        unsigned int    light_interval      =   SAMPLER_LIGHT_INTERVAL;
+        unsigned int    bus_reads_in        =   0;
+        unsigned int    bus_reads_out       =   0;
+
+        int16_t GetMedian(SensorChannel & channel);
+        unsigned long GetMaxAge(int channel);
+        void    PushTemperature(int channel, TemperatureSensorController * sensor, unsigned int & bus_reads);
+
+    public:
+        SensorSampler(PhotoresistorController * light_left, PhotoresistorController * light_right,
+            TemperatureSensorController * temp_in, TemperatureSensorController * temp_out);
+
+        byte    GetFlags(int channel);
+        int     GetMappedValue(int channel, int min_value, int max_value, int map_stages);
+        int     GetValue(int channel);
+        bool    IsValid(int channel);
+        void    Process();
+        void    Push(int channel, int16_t value);
+        void    SetLightInterval(unsigned int interval);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Wyznaczenie mediany z okna odczytow kanalu (sortowanie przez wstawianie kopii).
+ *  @param channel: Kanal pomiarowy.
+ *  @return: Mediana odczytow.
+ */
+int16_t SensorSampler::GetMedian(SensorChannel & channel)
+{
+    int16_t sorted[SAMPLER_WINDOW];
+
+    for (int i = 0; i < channel.count; i++)
+    {
+        int16_t value = channel.window[i];
+        int j = i;
+
+        for (; j > 0 && sorted[j - 1] > value; j--)
+            sorted[j] = sorted[j - 1];
+
+        sorted[j] = value;
+    }
+
+    return sorted[channel.count / 2];
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie dopuszczalnego wieku odczytu kanalu.
+ *  @param channel: Indeks kanalu.
+ *  @return: Wiek w milisekundach.
+ */
+unsigned long SensorSampler::GetMaxAge(int channel)
+{
+    return channel <= SAMPLER_LIGHT_RIGHT ? SAMPLER_LIGHT_MAX_AGE : SAMPLER_TEMP_MAX_AGE;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przekazanie nowego pomiaru temperatury po zakonczonym cyklu magistrali (bez dodatkowych
+ *  odczytow). Nieudane odczyty sa pomijane - kanal staje sie nieaktualny po SAMPLER_TEMP_MAX_AGE.
+ *  @param channel: Indeks kanalu.
+ *  @param sensor: Czujnik temperatury.
+ *  @param bus_reads: Licznik cykli magistrali przy ostatnim odczycie.
+ */
+void SensorSampler::PushTemperature(int channel, TemperatureSensorController * sensor, unsigned int & bus_reads)
+{
+    OneWireBus * bus = sensor->GetBus();
+
+    if (bus->GetReadCount() == bus_reads)
+        return;
+
+    bus_reads = bus->GetReadCount();
+    int16_t raw_value = bus->GetRawValue(sensor->GetIndex());
+
+    if (raw_value <= ONEWIRE_BUS_RAW_NULL)
+        return;
+
+    //  Jednostki 1/128 stopnia na dziesiate czesci stopnia z zaokragleniem.
+    long tenths = (long) raw_value * 10;
+    this->Push(channel, (tenths + (tenths >= 0 ? 64 : -64)) / 128);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy uslugi probkowania czujnikow.
+ *  @param light_left: Lewy fotorezystor.
+ *  @param light_right: Prawy fotorezystor.
+ *  @param temp_in: Czujnik temperatury wewnetrznej.
+ *  @param temp_out: Czujnik temperatury zewnetrznej.
+ */
+SensorSampler::SensorSampler(PhotoresistorController * light_left, PhotoresistorController * light_right,
+    TemperatureSensorController * temp_in, TemperatureSensorController * temp_out)
+{
+    this->light_left = light_left;
+    this->light_right = light_right;
+    this->temp_in = temp_in;
+    this->temp_out = temp_out;
+
+    memset(this->channels, 0, sizeof(this->channels));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie flag stanu kanalu.
+ *  @param channel: Indeks kanalu.
+ *  @return: Flagi SAMPLER_FLAG_*.
+ */
+byte SensorSampler::GetFlags(int channel)
+{
+    if (channel < 0 || channel >= SAMPLER_CHANNELS || this->channels[channel].count == 0)
+        return 0;
+
+    if (millis() - this->channels[channel].last_update > this->GetMaxAge(channel))
+        return SAMPLER_FLAG_VALID | SAMPLER_FLAG_STALE;
+
+    return SAMPLER_FLAG_VALID;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie zmapowanej wartosci kanalu.
+ *  @param channel: Indeks kanalu.
+ *  @param min_value: Minimalna wartosc kanalu.
+ *  @param max_value: Maksymalna wartosc kanalu.
+ *  @param map_stages: Maksymalna wartosc ktora zostanie zmapowana.
+ *  @return: Zmapowana wartosc lub -1 gdy brak aktualnego odczytu.
+ */
+int SensorSampler::GetMappedValue(int channel, int min_value, int max_value, int map_stages)
+{
+    if (!this->IsValid(channel))
+        return -1;
+
+    int value = max(min_value, min(this->GetValue(channel), max_value));
+    return map(value, min_value, max_value, 0, map_stages);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie przefiltrowanej wartosci kanalu.
+ *  @param channel: Indeks kanalu.
+ *  @return: Wartosc lub SAMPLER_NULL gdy brak aktualnego odczytu.
+ */
+int SensorSampler::GetValue(int channel)
+{
+    if (!this->IsValid(channel))
+        return SAMPLER_NULL;
+
+    long filtered = this->channels[channel].filtered;
+    long half = 1L << (SAMPLER_FIXED_SHIFT - 1);
+
+    return (filtered + (filtered >= 0 ? half : -half)) / (1L << SAMPLER_FIXED_SHIFT);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie czy kanal posiada aktualny odczyt.
+ *  @param channel: Indeks kanalu.
+ *  @return: True - odczyt wazny i aktualny.
+ */
+bool SensorSampler::IsValid(int channel)
+{
+    return this->GetFlags(channel) == SAMPLER_FLAG_VALID;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wykonanie zaplanowanych odczytow czujnikow.
+void SensorSampler::Process()
+{
+    unsigned long now = millis();
+
+    if (now - this->last_light_read >= this->light_interval)
+    {
+        this->last_light_read = now;
+
+        //  Przetwornik ADC jest zasilany tylko na czas odczytow.
+        PowerManager::AdcOn();
+        this->Push(SAMPLER_LIGHT_LEFT, this->light_left->GetBrightness());
+        this->Push(SAMPLER_LIGHT_RIGHT, this->light_right->GetBrightness());
+        PowerManager::AdcOff();
+    }
+
+    this->PushTemperature(SAMPLER_TEMP_IN, this->temp_in, this->bus_reads_in);
+    this->PushTemperature(SAMPLER_TEMP_OUT, this->temp_out, this->bus_reads_out);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dodanie odczytu do kanalu - mediana okna jest wygladzana srednia wykladnicza.
+ *  @param channel: Indeks kanalu.
+ *  @param value: Surowy odczyt.
+ */
+void SensorSampler::Push(int channel, int16_t value)
+{
+    if (channel < 0 || channel >= SAMPLER_CHANNELS)
+        return;
+
+    SensorChannel & data = this->channels[channel];
+    bool first = data.count == 0;
+
+    data.window[data.position] = value;
+    data.position = (data.position + 1) % SAMPLER_WINDOW;
+    data.count = min(data.count + 1, SAMPLER_WINDOW);
+    data.last_update = millis();
+
+    long median = (long) this->GetMedian(data) << SAMPLER_FIXED_SHIFT;
+
+    if (first)
+        data.filtered = median;
+    else
+        data.filtered += (median - data.filtered) / (1 << SAMPLER_SMOOTHING);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie odstepu odczytow fotorezystorow (nie wiekszego niz SAMPLER_LIGHT_MAX_AGE).
+ *  @param interval: Odstep odczytow [ms].
+ */
+void SensorSampler::SetLightInterval(unsigned int interval)
+{
+    this->light_interval = min(interval, (unsigned int) (SAMPLER_LIGHT_MAX_AGE / 2));
+}
+
+#endif
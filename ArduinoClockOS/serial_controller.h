@@ -13,6 +13,27 @@
 #define SERIAL_COM          0
 #define SERIAL_BLUETOOTH    1
 
+#define SERIAL_DEFAULT_BAUDRATE       9600
+#define SERIAL_MAX_BAUDRATE_PC        250000
+#define SERIAL_MAX_BAUDRATE_BT        115200
+#define SERIAL_NEGOTIATION_TIMEOUT    3000
+#define SERIAL_AT_RESPONSE_SIZE       12
+
+#define SERIAL_BAUD_NONE              0
+#define SERIAL_BAUD_PENDING           1
+#define SERIAL_BAUD_COMMITTED         2
+#define SERIAL_BAUD_REVERTED          3
+
+#define SERIAL_PRIORITY_RESPONSE      0   //  Odpowiedzi na polecenia - nigdy nie sa odrzucane.
+#define SERIAL_PRIORITY_EVENT         1   //  Zdarzenia - odrzucane przy pelnej kolejce.
+#define SERIAL_PRIORITY_DEBUG         2   //  Diagnostyka - odrzucana gdy kolejka jest zapelniona w polowie.
+#define SERIAL_PRIORITIES             3
+
+#define SERIAL_TX_QUEUE_SIZE          256 //  Musi byc potega liczby 2.
+#define SERIAL_TX_QUEUE_MASK          (SERIAL_TX_QUEUE_SIZE - 1)
+#define SERIAL_TX_DEBUG_RESERVE       (SERIAL_TX_QUEUE_SIZE / 2)
+#define SERIAL_FORMAT_BUFFER_SIZE     96
+
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
 ////////////////////////////////////////////////////////////////////////////////
@@ -23,16 +44,62 @@ class SerialController
         const int input_types[2] = { SERIAL_COM, SERIAL_BLUETOOTH };
         int   last_device = 0;
 
-        void  InitSerialComBT(int baudrate);
-        void  InitSerialComPC(int baudrate);
+        //  Predkosci obslugiwane przez modul HC-06 (indeks + 1 = numer w poleceniu AT+BAUDn).
+        const long bt_baudrates[8] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+        const long pc_baudrates[7] = { 9600, 19200, 38400, 57600, 115200, 230400, 250000 };
+        long  baudrates[2] = { SERIAL_DEFAULT_BAUDRATE, SERIAL_DEFAULT_BAUDRATE };
+
+        int             pending_device      =   -1;
+        long            pending_baudrate    =   0;
+        unsigned long   pending_deadline    =   0;
+        char            at_response[SERIAL_AT_RESPONSE_SIZE + 1];
+        int             at_response_length  =   0;
+
+        //  Kolejki danych wyjsciowych oprozniane bez blokowania w Tick().
+        byte            tx_queue[2][SERIAL_TX_QUEUE_SIZE];
+        unsigned int    tx_head[2]          =   { 0, 0 };
+        unsigned int    tx_tail[2]          =   { 0, 0 };
+        unsigned int    tx_max_used[2]      =   { 0, 0 };
+        unsigned long   tx_dropped[2][SERIAL_PRIORITIES];
+
+        void            DrainQueue(int device);
+        bool            Enqueue(const char * data, bool progmem, int output_device, int priority);
+        void            Flush(int device);
+        int             GetBluetoothBaudrateIndex(long baudrate);
+        HardwareSerial *GetPort(int device);
+        unsigned int    GetQueueUsed(int device);
+        void            InitSerialComBT(long baudrate);
+        void            InitSerialComPC(long baudrate);
+        int             ProcessBluetoothNegotiation();
+        void            PushByte(int device, byte data);
 
     public:
-        SerialController(int baudrate);
+        SerialController(long baudrate);
 
         int     GetLastInputDevice();
+        bool    HasInputData();
         String  ReadInputData();
         String  ReadRawData(int input_device);
-        void    WriteRawData(String raw_data, int output_device);
+        void    WriteRawData(const char * raw_data, int output_device, int priority = SERIAL_PRIORITY_RESPONSE);
+        void    WriteRawData(String raw_data, int output_device, int priority = SERIAL_PRIORITY_RESPONSE);
+        void    WriteRawData_P(const char * raw_data, int output_device, int priority = SERIAL_PRIORITY_RESPONSE);
+        void    WriteFormat_P(int output_device, int priority, const char * format, ...);
+
+        String  GetOutputStatistics();
+        void    Tick();
+
+        int     GetAvailableBytes(int input_device);
+        int     ReadByte(int input_device);
+        void    WriteByte(byte data, int output_device);
+
+        bool    BeginBaudrateNegotiation(long baudrate, int device);
+        bool    ConfirmBaudrate(int device);
+        long    GetBaudrate(int device);
+        bool    IsBaudrateSupported(long baudrate, int device);
+        bool    IsIdle();
+        bool    IsNegotiationPending();
+        int     ProcessNegotiation();
+        void    SetBaudrate(long baudrate, int device);
 };
 
 
@@ -40,30 +107,191 @@ class SerialController
 //  *** PRIVATE METHOD BODIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+/* Wyslanie oczekujacych danych z kolejki w ilosci miesczacej sie w buforze sprzetowym (bez blokowania).
+ * @param device: Typ urzadzenia.
+ */
+void SerialController::DrainQueue(int device)
+{
+    HardwareSerial * port = this->GetPort(device);
+    int room = port->availableForWrite();
+
+    while (room-- > 0 && this->tx_tail[device] != this->tx_head[device])
+    {
+        port->write(this->tx_queue[device][this->tx_tail[device]]);
+        this->tx_tail[device] = (this->tx_tail[device] + 1) & SERIAL_TX_QUEUE_MASK;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Dodanie linii tekstu do kolejki danych wyjsciowych.
+ * @param data: Tekst do wyslania (w pamieci RAM lub PROGMEM).
+ * @param progmem: Informacja czy tekst znajduje sie w pamieci programu.
+ * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ * @param priority: Priorytet wiadomosci.
+ * @return: Informacja czy wiadomosc zostala dodana do kolejki (false - odrzucona).
+ */
+bool SerialController::Enqueue(const char * data, bool progmem, int output_device, int priority)
+{
+    int device = output_device == SERIAL_BLUETOOTH ? SERIAL_BLUETOOTH : SERIAL_COM;
+    unsigned int length = progmem ? strlen_P(data) : strlen(data);
+
+    //  Odpowiedzi nie sa odrzucane - przy pelnej kolejce PushByte czeka na zwolnienie miejsca.
+    if (priority != SERIAL_PRIORITY_RESPONSE)
+    {
+        unsigned int reserve = priority == SERIAL_PRIORITY_DEBUG ? SERIAL_TX_DEBUG_RESERVE : 0;
+        unsigned int free = SERIAL_TX_QUEUE_MASK - this->GetQueueUsed(device);
+
+        if (free < length + 2 + reserve)
+        {
+            this->tx_dropped[device][priority % SERIAL_PRIORITIES]++;
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < length; i++)
+        this->PushByte(device, progmem ? pgm_read_byte(data + i) : data[i]);
+
+    this->PushByte(device, '\r');
+    this->PushByte(device, '\n');
+
+    this->tx_max_used[device] = max(this->tx_max_used[device], this->GetQueueUsed(device));
+    this->DrainQueue(device);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie wszystkich oczekujacych danych z kolejki (z blokowaniem, np. przed zmiana predkosci).
+ * @param device: Typ urzadzenia.
+ */
+void SerialController::Flush(int device)
+{
+    HardwareSerial * port = this->GetPort(device);
+
+    while (this->tx_tail[device] != this->tx_head[device])
+    {
+        port->write(this->tx_queue[device][this->tx_tail[device]]);
+        this->tx_tail[device] = (this->tx_tail[device] + 1) & SERIAL_TX_QUEUE_MASK;
+    }
+
+    port->flush();
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie numeru predkosci transmisji modulu HC-06 uzywanego w poleceniu AT+BAUDn.
+ * @param baudrate: Szybkosc transmisji w bitach na sekunde.
+ * @return: Numer predkosci transmisji (1..8) lub 0 jezeli nie jest obslugiwana.
+ */
+int SerialController::GetBluetoothBaudrateIndex(long baudrate)
+{
+    for (int i = 0; i < 8; i++)
+        if (this->bt_baudrates[i] == baudrate)
+            return i + 1;
+    
+    return 0;
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie portu sprzetowego urzadzenia.
+ * @param device: Typ urzadzenia.
+ * @return: Port szeregowy urzadzenia.
+ */
+HardwareSerial * SerialController::GetPort(int device)
+{
+    return device == SERIAL_BLUETOOTH ? &Serial1 : &Serial;
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie ilosci bajtow oczekujacych w kolejce danych wyjsciowych.
+ * @param device: Typ urzadzenia.
+ * @return: Ilosc bajtow w kolejce.
+ */
+unsigned int SerialController::GetQueueUsed(int device)
+{
+    return (this->tx_head[device] - this->tx_tail[device]) & SERIAL_TX_QUEUE_MASK;
+}
+
+//  ----------------------------------------------------------------------------
 /* Inicjalizacja polaczenia szeregowego z urzadzeniami zewnetrznymi poprzez modul bluetooth.
  * @param baudrate: Szybkosc transmisji w bitach na sekunde.
  */
-void SerialController::InitSerialComBT(int baudrate)
+void SerialController::InitSerialComBT(long baudrate)
 {
+    this->baudrates[SERIAL_BLUETOOTH] = baudrate;
     Serial1.begin(baudrate);
-    this->WriteRawData("Arduino Clock OS 2.0\nCopyright (c) Kamil Karpiński 2021", SERIAL_BLUETOOTH);
-    this->WriteRawData("Bluetooth communication established in " + String(baudrate) + " bps.", SERIAL_BLUETOOTH);
-    this->WriteRawData("", SERIAL_BLUETOOTH);
+    this->WriteRawData_P(PSTR("Arduino Clock OS 2.0\nCopyright (c) Kamil Karpiński 2021"), SERIAL_BLUETOOTH);
+    this->WriteFormat_P(SERIAL_BLUETOOTH, SERIAL_PRIORITY_RESPONSE, PSTR("Bluetooth communication established in %ld bps."), baudrate);
+    this->WriteRawData_P(PSTR(""), SERIAL_BLUETOOTH);
 
-    this->WriteRawData("Bluetooth module: HC-06", SERIAL_COM);
-    this->WriteRawData("Bluetooth passwd: 1234.", SERIAL_COM);
+    this->WriteRawData_P(PSTR("Bluetooth module: HC-06"), SERIAL_COM);
+    this->WriteRawData_P(PSTR("Bluetooth passwd: 1234."), SERIAL_COM);
 }
 
 //  ----------------------------------------------------------------------------
 /* Inicjalizacja polaczenia szeregowego z urzadzeniami zewnetrznymi poprzez kabel USB.
  * @param baudrate: Szybkosc transmisji w bitach na sekunde.
  */
-void SerialController::InitSerialComPC(int baudrate)
+void SerialController::InitSerialComPC(long baudrate)
 {
+    this->baudrates[SERIAL_COM] = baudrate;
     Serial.begin(baudrate);
-    this->WriteRawData("Arduino Clock OS 2.0\nCopyright (c) Kamil Karpiński 2021", SERIAL_COM);
-    this->WriteRawData("PC communication established in " + String(baudrate) + " bps.", SERIAL_COM);
-    this->WriteRawData("", SERIAL_COM);
+    this->WriteRawData_P(PSTR("Arduino Clock OS 2.0\nCopyright (c) Kamil Karpiński 2021"), SERIAL_COM);
+    this->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("PC communication established in %ld bps."), baudrate);
+    this->WriteRawData_P(PSTR(""), SERIAL_COM);
+}
+
+//  ----------------------------------------------------------------------------
+/* Oczekiwanie na odpowiedz modulu HC-06 na polecenie zmiany predkosci transmisji.
+ * Modul odpowiada "OKnnnn" i od razu przechodzi na nowa predkosc.
+ * @return: Stan negocjacji predkosci transmisji.
+ */
+int SerialController::ProcessBluetoothNegotiation()
+{
+    while (Serial1.available() > 0 && this->at_response_length < SERIAL_AT_RESPONSE_SIZE)
+    {
+        this->at_response[this->at_response_length++] = (char) Serial1.read();
+        this->at_response[this->at_response_length] = '\0';
+    }
+
+    if (strstr(this->at_response, "OK") != NULL)
+    {
+        this->pending_device = -1;
+        this->Flush(SERIAL_BLUETOOTH);
+        Serial1.end();
+        Serial1.begin(this->pending_baudrate);
+        this->baudrates[SERIAL_BLUETOOTH] = this->pending_baudrate;
+
+        this->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("Bluetooth baudrate changed to %ld bps."), this->pending_baudrate);
+        return SERIAL_BAUD_COMMITTED;
+    }
+
+    if ((long) (millis() - this->pending_deadline) >= 0)
+    {
+        this->pending_device = -1;
+        this->WriteRawData_P(PSTR("Bluetooth module did not respond, baudrate unchanged."), SERIAL_COM);
+        return SERIAL_BAUD_REVERTED;
+    }
+
+    return SERIAL_BAUD_PENDING;
+}
+
+//  ----------------------------------------------------------------------------
+/* Dodanie bajtu do kolejki danych wyjsciowych.
+ * Przy pelnej kolejce najstarszy bajt wysylany jest z blokowaniem.
+ * @param device: Typ urzadzenia.
+ * @param data: Bajt do wyslania.
+ */
+void SerialController::PushByte(int device, byte data)
+{
+    unsigned int next_head = (this->tx_head[device] + 1) & SERIAL_TX_QUEUE_MASK;
+
+    if (next_head == this->tx_tail[device])
+    {
+        this->GetPort(device)->write(this->tx_queue[device][this->tx_tail[device]]);
+        this->tx_tail[device] = (this->tx_tail[device] + 1) & SERIAL_TX_QUEUE_MASK;
+    }
+
+    this->tx_queue[device][this->tx_head[device]] = data;
+    this->tx_head[device] = next_head;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,8 +301,11 @@ void SerialController::InitSerialComPC(int baudrate)
 /* Konstruktor kontrolera polaczenia szeregowego z urzadzeniami zewnetrznymi.
  * @param baudrate: Szybkosc transmisji w bitach na sekunde (domyslnie 9600).
  */
-SerialController::SerialController(int baudrate = 9600)
+SerialController::SerialController(long baudrate = SERIAL_DEFAULT_BAUDRATE)
 {
+    this->at_response[0] = '\0';
+    memset(this->tx_dropped, 0, sizeof(this->tx_dropped));
+
     this->InitSerialComPC(baudrate);
     this->InitSerialComBT(baudrate);
 }
@@ -88,6 +319,24 @@ int SerialController::GetLastInputDevice()
     return this->last_device;
 }
 
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy w buforach odbiorczych oczekuja dane (bez tworzenia obiektow String).
+ * @return: Informacja czy ktorekolwiek urzadzenie przyslalo dane.
+ */
+bool SerialController::HasInputData()
+{
+    for (int it_index = 0; it_index < 2; it_index++)
+    {
+        if (this->pending_device == input_types[it_index] && input_types[it_index] == SERIAL_BLUETOOTH)
+            continue;
+
+        if (this->GetAvailableBytes(input_types[it_index]) > 0)
+            return true;
+    }
+
+    return false;
+}
+
 //  ----------------------------------------------------------------------------
 /* Iteracyjne odczytanie danych z kolejnych urzadzen do ktorego zostaly wyslane.
  * @return: Dane odczytane z urzadzenia.
@@ -100,6 +349,10 @@ String SerialController::ReadInputData()
     //  Odczytanie danych.
     for (int it_index = 0; it_index < 2; it_index++)
     {
+        //  Odpowiedz modulu HC-06 odczytywana jest w trakcie negocjacji predkosci.
+        if (this->pending_device == input_types[it_index] && input_types[it_index] == SERIAL_BLUETOOTH)
+            continue;
+
         data = ReadRawData(input_types[it_index]);
         if (data.length() > 0)
         {
@@ -130,7 +383,7 @@ String SerialController::ReadRawData(int input_device)
             while(Serial.available() > 0)
             {
                 readed_data = Serial.readString();
-                Serial.println(readed_data);
+                this->WriteRawData(readed_data, SERIAL_COM, SERIAL_PRIORITY_DEBUG);
                 result_data = result_data + readed_data;
                 readed_data = "";
             }
@@ -140,7 +393,7 @@ String SerialController::ReadRawData(int input_device)
             while (Serial1.available() > 0)
             {
                 readed_data = Serial1.readString();
-                Serial1.println(readed_data);
+                this->WriteRawData(readed_data, SERIAL_BLUETOOTH, SERIAL_PRIORITY_DEBUG);
                 result_data = result_data + readed_data;
                 readed_data = "";
             }
@@ -152,24 +405,299 @@ String SerialController::ReadRawData(int input_device)
     return result_data.length() > 0 ? result_data : "";
 }
 
+//  ----------------------------------------------------------------------------
+/* Wyslanie danych do urzadzenia zewnetrznego za pomoca okreslonego portu komunikacyjnego.
+ * Dane trafiaja do kolejki i sa wysylane bez blokowania petli glownej.
+ * @param data: Dane ktore maja zostac wyslane.
+ * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ * @param priority: Priorytet wiadomosci (domyslnie odpowiedz - nigdy nie jest odrzucana).
+ */
+void SerialController::WriteRawData(const char * data, int output_device, int priority = SERIAL_PRIORITY_RESPONSE)
+{
+    this->Enqueue(data, false, output_device, priority);
+}
+
 //  ----------------------------------------------------------------------------
 /* Wyslanie danych do urzadzenia zewnetrznego za pomoca okreslonego portu komunikacyjnego.
  * @param data: Dane ktore maja zostac wyslane.
  * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ * @param priority: Priorytet wiadomosci (domyslnie odpowiedz - nigdy nie jest odrzucana).
+ */
+void SerialController::WriteRawData(String data, int output_device, int priority = SERIAL_PRIORITY_RESPONSE)
+{
+    this->WriteRawData(data.c_str(), output_device, priority);
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie tekstu zapisanego w pamieci programu (PSTR) bez tworzenia obiektu String.
+ * @param data: Tekst w pamieci programu.
+ * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ * @param priority: Priorytet wiadomosci.
+ */
+void SerialController::WriteRawData_P(const char * data, int output_device, int priority)
+{
+    this->Enqueue(data, true, output_device, priority);
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie sformatowanego tekstu (printf) z formatem zapisanym w pamieci programu.
+ * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ * @param priority: Priorytet wiadomosci.
+ * @param format: Format w pamieci programu (PSTR).
  */
-void SerialController::WriteRawData(String data, int output_device)
+void SerialController::WriteFormat_P(int output_device, int priority, const char * format, ...)
 {
-    switch (output_device)
+    char buffer[SERIAL_FORMAT_BUFFER_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf_P(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    this->Enqueue(buffer, false, output_device, priority);
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie ilosci bajtow oczekujacych w buforze odbiorczym urzadzenia (bez blokowania).
+ * @param input_device: Typ urzadzenia z ktorego dane beda odczytywane.
+ * @return: Ilosc bajtow gotowych do odczytania.
+ */
+int SerialController::GetAvailableBytes(int input_device)
+{
+    switch (input_device)
     {
         default:
         case SERIAL_COM:
-            Serial.println(data);
+            return Serial.available();
+        
+        case SERIAL_BLUETOOTH:
+            return Serial1.available();
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Odczytanie pojedynczego bajtu danych binarnych z urzadzenia zewnetrznego.
+ * @param input_device: Typ urzadzenia z ktorego dane zostana odczytane.
+ * @return: Odczytany bajt lub -1 jezeli bufor odbiorczy jest pusty.
+ */
+int SerialController::ReadByte(int input_device)
+{
+    switch (input_device)
+    {
+        default:
+        case SERIAL_COM:
+            return Serial.read();
+        
+        case SERIAL_BLUETOOTH:
+            return Serial1.read();
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Wyslanie pojedynczego bajtu danych binarnych do urzadzenia zewnetrznego.
+ * @param data: Bajt ktory ma zostac wyslany.
+ * @param output_device: Typ urzadzenia do ktorego dane zostana wyslane.
+ */
+void SerialController::WriteByte(byte data, int output_device)
+{
+    int device = output_device == SERIAL_BLUETOOTH ? SERIAL_BLUETOOTH : SERIAL_COM;
+
+    //  Bajt przechodzi przez kolejke, aby nie wyprzedzic oczekujacych wiadomosci tekstowych.
+    this->PushByte(device, data);
+    this->DrainQueue(device);
+}
+
+//  ----------------------------------------------------------------------------
+/* Rozpoczecie zmiany predkosci transmisji.
+ * Dla SERIAL_COM urzadzenie wysyla "BAUD n" w starej predkosci i przechodzi na nowa predkosc.
+ * Jezeli w czasie SERIAL_NEGOTIATION_TIMEOUT nie zostanie potwierdzona, wraca do poprzedniej.
+ * Dla SERIAL_BLUETOOTH wysylane jest polecenie AT+BAUDn (modul nie moze byc sparowany).
+ * @param baudrate: Nowa szybkosc transmisji w bitach na sekunde.
+ * @param device: Typ urzadzenia dla ktorego zmieniana jest predkosc.
+ * @return: Informacja czy negocjacja zostala rozpoczeta.
+ */
+bool SerialController::BeginBaudrateNegotiation(long baudrate, int device)
+{
+    if (this->pending_device >= 0 || !this->IsBaudrateSupported(baudrate, device))
+        return false;
+    
+    this->pending_device = device;
+    this->pending_baudrate = baudrate;
+    this->pending_deadline = millis() + SERIAL_NEGOTIATION_TIMEOUT;
+
+    switch (device)
+    {
+        default:
+        case SERIAL_COM:
+            this->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("BAUD %ld"), baudrate);
+            this->Flush(SERIAL_COM);
+            Serial.end();
+            Serial.begin(baudrate);
             break;
         
         case SERIAL_BLUETOOTH:
-            Serial1.println(data);
+            this->at_response_length = 0;
+            this->at_response[0] = '\0';
+            this->Flush(SERIAL_BLUETOOTH);
+
+            //  Modul HC-06 nie akceptuje znakow konca linii w poleceniach AT.
+            Serial1.print("AT+BAUD" + String(this->GetBluetoothBaudrateIndex(baudrate)));
+            Serial1.flush();
             break;
     }
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/* Potwierdzenie zmiany predkosci transmisji przez urzadzenie zewnetrzne.
+ * @param device: Typ urzadzenia ktore potwierdza nowa predkosc.
+ * @return: Informacja czy nowa predkosc zostala zatwierdzona.
+ */
+bool SerialController::ConfirmBaudrate(int device)
+{
+    if (this->pending_device != device || device != SERIAL_COM)
+        return false;
+    
+    this->pending_device = -1;
+    this->baudrates[SERIAL_COM] = this->pending_baudrate;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie aktualnej predkosci transmisji urzadzenia.
+ * @param device: Typ urzadzenia.
+ * @return: Szybkosc transmisji w bitach na sekunde.
+ */
+long SerialController::GetBaudrate(int device)
+{
+    return this->baudrates[device == SERIAL_BLUETOOTH ? SERIAL_BLUETOOTH : SERIAL_COM];
+}
+
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy predkosc transmisji jest obslugiwana przez urzadzenie.
+ * @param baudrate: Szybkosc transmisji w bitach na sekunde.
+ * @param device: Typ urzadzenia.
+ * @return: Informacja czy predkosc jest obslugiwana.
+ */
+bool SerialController::IsBaudrateSupported(long baudrate, int device)
+{
+    if (device == SERIAL_BLUETOOTH)
+        return baudrate >= SERIAL_DEFAULT_BAUDRATE && this->GetBluetoothBaudrateIndex(baudrate) > 0;
+    
+    for (int i = 0; i < 7; i++)
+        if (this->pc_baudrates[i] == baudrate)
+            return true;
+    
+    return false;
+}
+
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy trwa negocjacja predkosci transmisji.
+ * @return: Informacja czy trwa negocjacja predkosci transmisji.
+ */
+bool SerialController::IsNegotiationPending()
+{
+    return this->pending_device >= 0;
+}
+
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy kontroler nie ma pracy do wykonania (puste kolejki, brak negocjacji).
+ * @return: Informacja o bezczynnosci.
+ */
+bool SerialController::IsIdle()
+{
+    return this->GetQueueUsed(SERIAL_COM) == 0 && this->GetQueueUsed(SERIAL_BLUETOOTH) == 0
+        && !this->IsNegotiationPending();
+}
+
+//  ----------------------------------------------------------------------------
+/* Obsluga trwajacej negocjacji predkosci transmisji (bez blokowania, wywolywana co cykl).
+ * @return: Stan negocjacji predkosci transmisji.
+ */
+int SerialController::ProcessNegotiation()
+{
+    if (this->pending_device < 0)
+        return SERIAL_BAUD_NONE;
+    
+    if (this->pending_device == SERIAL_BLUETOOTH)
+        return this->ProcessBluetoothNegotiation();
+
+    if ((long) (millis() - this->pending_deadline) < 0)
+        return SERIAL_BAUD_PENDING;
+
+    //  Brak potwierdzenia - powrot do poprzedniej predkosci transmisji.
+    this->pending_device = -1;
+    this->Flush(SERIAL_COM);
+    Serial.end();
+    Serial.begin(this->baudrates[SERIAL_COM]);
+    this->WriteFormat_P(SERIAL_COM, SERIAL_PRIORITY_RESPONSE, PSTR("Baudrate not confirmed, restored %ld bps."), this->baudrates[SERIAL_COM]);
+
+    return SERIAL_BAUD_REVERTED;
+}
+
+//  ----------------------------------------------------------------------------
+/* Ustawienie predkosci transmisji bez negocjacji (np. po wczytaniu konfiguracji).
+ * @param baudrate: Szybkosc transmisji w bitach na sekunde.
+ * @param device: Typ urzadzenia.
+ */
+void SerialController::SetBaudrate(long baudrate, int device)
+{
+    if (!this->IsBaudrateSupported(baudrate, device) || this->GetBaudrate(device) == baudrate)
+        return;
+    
+    switch (device)
+    {
+        default:
+        case SERIAL_COM:
+            this->Flush(SERIAL_COM);
+            Serial.end();
+            Serial.begin(baudrate);
+            this->baudrates[SERIAL_COM] = baudrate;
+            break;
+        
+        case SERIAL_BLUETOOTH:
+            this->Flush(SERIAL_BLUETOOTH);
+            Serial1.end();
+            Serial1.begin(baudrate);
+            this->baudrates[SERIAL_BLUETOOTH] = baudrate;
+            break;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie statystyk kolejek danych wyjsciowych.
+ * @return: Statystyki kolejek (zajetosc, maksymalna zajetosc, odrzucone wiadomosci).
+ */
+String SerialController::GetOutputStatistics()
+{
+    char buffer[SERIAL_FORMAT_BUFFER_SIZE];
+    String result = "";
+
+    for (int device = SERIAL_COM; device <= SERIAL_BLUETOOTH; device++)
+    {
+        snprintf_P(buffer, sizeof(buffer),
+            PSTR("%s queue: %u/%u (max %u), dropped events: %lu, debug: %lu"),
+            device == SERIAL_COM ? "PC" : "BT",
+            this->GetQueueUsed(device), SERIAL_TX_QUEUE_SIZE - 1, this->tx_max_used[device],
+            this->tx_dropped[device][SERIAL_PRIORITY_EVENT],
+            this->tx_dropped[device][SERIAL_PRIORITY_DEBUG]);
+        
+        if (device != SERIAL_COM)
+            result += "\n";
+
+        result += buffer;
+    }
+
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyslanie oczekujacych danych z kolejek bez blokowania (wywolywane co cykl petli glownej).
+void SerialController::Tick()
+{
+    this->DrainQueue(SERIAL_COM);
+    this->DrainQueue(SERIAL_BLUETOOTH);
 }
 
 #endif
\ No newline at end of file
@@ -109,7 +109,7 @@ int SongController::SetupSong(String song)
 
         this->display_ctrl->Clear();
         this->display_ctrl->DrawSprite(SPRITE_MUSIC, 0, 0);
-        this->display_ctrl->PrintText(0, 9, "Playing...");
+        this->display_ctrl->PrintText_P(0, 9, PSTR("Playing..."));
         
         return SONG_PLAYING;
     }
@@ -150,8 +150,6 @@ int SongController::ProcessInput(int input)
 //  Odtwarzania piosenki.
 void SongController::ProcessPlaying()
 {
-    unsigned long milis = millis();
-
     if (this->position < this->song_length)
     {
         char    c               = ' ';
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+//  SPI BUS
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <SPI.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define SPI_BUS_DEVICES             4
+#define SPI_BUS_NONE                -1
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Arbiter sprzetowej magistrali SPI. Kazde urzadzenie rejestruje swoj pin CS (utrzymywany
+//  w stanie wysokim), a przed transmisja przejmuje magistrale - pozostale urzadzenia sa wtedy
+//  odlaczane. Urzadzenia obslugiwane przez biblioteki sterujace CS samodzielnie (karta SD)
+//  uzywaja Acquire()/Release(), pozostale Begin()/End() z wlasnymi ustawieniami SPI.
+//  Karta SD przejmuje magistrale tylko na operacje kontrolera (otwarcie, katalogi, sektory) -
+//  odczyt i zapis przez obiekty File omija arbiter. Jest to bezpieczne, dopoki karta jest jedynym
+//  urzadzeniem na sprzetowym SPI (wyswietlacz MAX7219 jest sterowany programowo na innych pinach);
+//  kolejne urzadzenie SPI wymaga przejecia magistrali rowniez wokol operacji na plikach.
+class SpiBus
+{
+    private:
+        static int8_t           cs_pins[SPI_BUS_DEVICES];
+        static byte             device_count;
+        static int8_t           owner;
+        static unsigned long    conflicts;
+
+    public:
+        static void             Acquire(int8_t device);
+        static void             Begin(int8_t device, SPISettings settings);
+        static void             End(int8_t device);
+        static unsigned long    GetConflicts();
+        static int8_t           GetOwner();
+        static int8_t           Register(int cs_pin);
+        static void             Release(int8_t device);
+};
+
+int8_t          SpiBus::cs_pins[SPI_BUS_DEVICES];
+byte            SpiBus::device_count    =   0;
+int8_t          SpiBus::owner           =   SPI_BUS_NONE;
+unsigned long   SpiBus::conflicts       =   0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Przejecie magistrali przez urzadzenie (piny CS pozostalych urzadzen w stanie wysokim).
+ *  @param device: Identyfikator urzadzenia z Register().
+ */
+void SpiBus::Acquire(int8_t device)
+{
+    if (device < 0 || device >= device_count)
+        return;
+
+    //  Magistrala nie zostala zwolniona przez poprzednie urzadzenie.
+    if (owner != SPI_BUS_NONE && owner != device)
+        conflicts++;
+
+    for (int i = 0; i < device_count; i++)
+        if (i != device)
+            digitalWrite(cs_pins[i], HIGH);
+
+    owner = device;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rozpoczecie transmisji urzadzenia bez wlasnej obslugi CS.
+ *  @param device: Identyfikator urzadzenia z Register().
+ *  @param settings: Predkosc, kolejnosc bitow i tryb SPI urzadzenia.
+ */
+void SpiBus::Begin(int8_t device, SPISettings settings)
+{
+    if (device < 0 || device >= device_count)
+        return;
+
+    Acquire(device);
+    SPI.beginTransaction(settings);
+    digitalWrite(cs_pins[device], LOW);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zakonczenie transmisji rozpoczetej przez Begin().
+ *  @param device: Identyfikator urzadzenia z Register().
+ */
+void SpiBus::End(int8_t device)
+{
+    if (device < 0 || device >= device_count)
+        return;
+
+    digitalWrite(cs_pins[device], HIGH);
+    SPI.endTransaction();
+    Release(device);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ilosci przejec magistrali zajetej przez inne urzadzenie.
+ *  @return: Ilosc konfliktow od uruchomienia.
+ */
+unsigned long SpiBus::GetConflicts()
+{
+    return conflicts;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie urzadzenia aktualnie korzystajacego z magistrali.
+ *  @return: Identyfikator urzadzenia lub SPI_BUS_NONE.
+ */
+int8_t SpiBus::GetOwner()
+{
+    return owner;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Rejestracja urzadzenia na magistrali - pin CS jest od razu ustawiany w stan wysoki,
+ *  aby niezainicjalizowane urzadzenie nie zaklocalo transmisji pozostalych.
+ *  @param cs_pin: Pin CS urzadzenia.
+ *  @return: Identyfikator urzadzenia lub SPI_BUS_NONE gdy brak miejsca.
+ */
+int8_t SpiBus::Register(int cs_pin)
+{
+    for (int i = 0; i < device_count; i++)
+        if (cs_pins[i] == cs_pin)
+            return i;
+
+    if (device_count >= SPI_BUS_DEVICES)
+        return SPI_BUS_NONE;
+
+    digitalWrite(cs_pin, HIGH);
+    pinMode(cs_pin, OUTPUT);
+
+    cs_pins[device_count] = cs_pin;
+    return device_count++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zwolnienie magistrali przez urzadzenie.
+ *  @param device: Identyfikator urzadzenia z Register().
+ */
+void SpiBus::Release(int8_t device)
+{
+    if (owner == device)
+        owner = SPI_BUS_NONE;
+}
+
+#endif
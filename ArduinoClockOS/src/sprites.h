@@ -48,8 +48,12 @@
 //  00003c3c3c3c0000  SPRITE_MUSIC stop
 //  384440e44e044438  SPRITE_MUSIC repeat
 //  44ee442810284444  SPRITE_MUSIC shuffle
+//  0602018181c37e3c  SPRITE_NIGHT
 //  187e66c3c3667e18  SPRITE_SETTINGS 0
 //  03070e7cd8881830  SPRITE_SETTINGS 1
+//  0000000000083e08  SPRITE_TREND falling
+//  0000000000080808  SPRITE_TREND steady
+//  0000000000203e20  SPRITE_TREND rising
 //  00187e4224181800  SPRITE_VOLUME
 //  1028345462a2c17f  SPRITE_VPLAYER
 //  44200e1fdf1f0e20  SPRITE_WEATHER 0 sunny
@@ -133,11 +137,21 @@ PROGMEM const byte SPRITE_MUSIC[] = {
     8, 8, B00100010, B00100010, B00010100, B00001000, B00010100, B00100010, B01110111, B00100010
 };
 
+PROGMEM const byte SPRITE_NIGHT[] = {
+    8, 8, B00111100, B01111110, B11000011, B10000001, B10000001, B10000000, B01000000, B01100000
+};
+
 PROGMEM const byte SPRITE_SETTINGS[] = {
     8, 8, B00011000, B01111110, B01100110, B11000011, B11000011, B01100110, B01111110, B00011000,
     8, 8, B00001100, B00011000, B00010001, B00011011, B00111110, B01110000, B11100000, B11000000
 };
 
+PROGMEM const byte SPRITE_TREND[] = {
+    3, 8, B00010000, B00111110, B00010000, B00000000, B00000000, B00000000, B00000000, B00000000,
+    3, 8, B00010000, B00010000, B00010000, B00000000, B00000000, B00000000, B00000000, B00000000,
+    3, 8, B00000100, B00111110, B00000100, B00000000, B00000000, B00000000, B00000000, B00000000
+};
+
 PROGMEM const byte SPRITE_VOLUME[] = {
     8, 8, B00000000, B00011000, B00011000, B00100100, B01000010, B01111110, B00011000, B00000000
 };
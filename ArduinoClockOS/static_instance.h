@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+//  STATIC INSTANCE
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STATIC_INSTANCE_H
+#define STATIC_INSTANCE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <new.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Statycznie przydzielona pamiec na jeden obiekt typu T (sekcja .bss gdy zmienna jest
+//  globalna), konstruowany w wybranym momencie przez Create() zamiast operatora new.
+//  Rozmiar wszystkich kontrolerow jest dzieki temu znany po linkowaniu, a sterta pozostaje
+//  wolna. Obiekt nie jest nigdy niszczony - kontrolery zyja przez caly czas pracy urzadzenia.
+template <typename T>
+class StaticInstance
+{
+    private:
+        alignas(T) byte storage[sizeof(T)];
+
+    public:
+        /*  Utworzenie obiektu w pamieci statycznej (placement new).
+         *  @param args: Argumenty konstruktora obiektu.
+         *  @return: Wskaznik do utworzonego obiektu.
+         */
+        template <typename... Args>
+        T * Create(Args... args)
+        {
+            return new (this->storage) T(args...);
+        }
+
+        /*  Pobranie wskaznika do obiektu (utworzonego wczesniej przez Create).
+         *  @return: Wskaznik do obiektu.
+         */
+        T * Get()
+        {
+            return reinterpret_cast<T *>(this->storage);
+        }
+};
+
+#endif
@@ -0,0 +1,613 @@
+////////////////////////////////////////////////////////////////////////////////
+//  TEMPERATURE LOGGER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEMPERATURE_LOGGER_H
+#define TEMPERATURE_LOGGER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "clock_controller.h"
+#include "fixed_string.h"
+#include "sd_card_controller.h"
+#include "sensor_sampler.h"
+#include "temperature_trend.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Plik danych: strony po 512 bajtow (wyrownane do blokow karty SD). Kazda strona zaczyna
+//  sie naglowkiem TempLogPageHeader z czasem i pelnymi wartosciami pierwszej probki, dalej
+//  kolejne probki (IN, OUT) zapisane jako roznice do poprzedniej probki w kodzie zigzag:
+//      0                   - roznica 0             (1 bit)
+//      10   + 4 bity       - zigzag < 16           (6 bitow)
+//      110  + 8 bitow      - zigzag < 256          (11 bitow)
+//      111  + 16 bitow     - pozostale wartosci    (19 bitow)
+//  Probki w stronie sa rowno odlegle o interwal; przerwa w pomiarach otwiera nowa strone.
+#define TEMP_LOG_DATA_FILE        F("templog.dat")
+
+//  Plik podsumowan: rekordy TempLogHourRecord (16 bajtow) - jeden na kazda godzine.
+#define TEMP_LOG_SUMMARY_FILE     F("templog.sum")
+
+#define TEMP_LOG_INTERVAL         5       //  min - okres probkowania (dzielnik 60).
+#define TEMP_LOG_RAM_SAMPLES      16      //  Bufor probek oczekujacych na zapis.
+#define TEMP_LOG_CHECK_INTERVAL   1000    //  ms - okres sprawdzania zegara.
+
+#define TEMP_LOG_PAGE_SIZE        512
+#define TEMP_LOG_PAGE_BITS        ((int) (TEMP_LOG_PAGE_SIZE - sizeof(TempLogPageHeader)) * 8)
+#define TEMP_LOG_SAMPLE_MAX_BITS  38      //  Dwie roznice w najdluzszym kodzie.
+#define TEMP_LOG_VERSION          1
+#define TEMP_LOG_NULL             (TEMPERATURE_SENSOR_NULL * 10)
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Pojedyncza probka (temperatury w dziesiatych czesciach stopnia).
+struct TempLogSample
+{
+    unsigned long   time    =   0;      //  Czas unix.
+    int             in      =   TEMP_LOG_NULL;
+    int             out     =   TEMP_LOG_NULL;
+};
+
+//  ----------------------------------------------------------------------------
+//  Naglowek strony pliku danych (16 bajtow).
+struct TempLogPageHeader
+{
+    char      magic[2]    =   { 'T', 'L' };
+    uint8_t   version     =   TEMP_LOG_VERSION;
+    uint8_t   interval    =   TEMP_LOG_INTERVAL;
+    uint32_t  start_time  =   0;        //  Czas unix pierwszej probki.
+    uint16_t  count       =   0;        //  Ilosc probek w stronie.
+    uint16_t  bits        =   0;        //  Ilosc zajetych bitow danych.
+    int16_t   first_in    =   0;
+    int16_t   first_out   =   0;
+};
+
+//  ----------------------------------------------------------------------------
+//  Podsumowanie godziny (16 bajtow).
+struct TempLogHourRecord
+{
+    uint16_t  day       =   0;          //  Dzien od 1970-01-01.
+    uint8_t   hour      =   0;
+    uint8_t   count     =   0;          //  Ilosc probek.
+    int16_t   in_min    =   TEMP_LOG_NULL;
+    int16_t   in_max    =   TEMP_LOG_NULL;
+    int16_t   in_avg    =   TEMP_LOG_NULL;
+    int16_t   out_min   =   TEMP_LOG_NULL;
+    int16_t   out_max   =   TEMP_LOG_NULL;
+    int16_t   out_avg   =   TEMP_LOG_NULL;
+};
+
+//  ----------------------------------------------------------------------------
+//  Statystyki jednego czujnika (akumulator godziny lub dnia).
+struct TempLogStats
+{
+    int   min_value   =   TEMP_LOG_NULL;
+    int   max_value   =   TEMP_LOG_NULL;
+    long  sum         =   0;
+    int   count       =   0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class TemperatureLogger
+{
+    private:
+        ClockController             * clock_ctrl;
+        SdCardController            * sdcard_ctrl;
+        SensorSampler               * sampler;
+
+        TempLogSample   samples[TEMP_LOG_RAM_SAMPLES];
+        int             pending           =   0;
+        unsigned int    dropped           =   0;
+
+        unsigned long   last_check        =   0;
+        unsigned long   last_minute       =   0;
+
+        unsigned long   current_hour      =   0;
+        TempLogStats    hour_in;
+        TempLogStats    hour_out;
+        int             hour_count        =   0;
+
+        bool              page_open       =   false;
+        unsigned long     page_index      =   0;
+        TempLogPageHeader page_header;
+        int               prev_in         =   0;
+        int               prev_out        =   0;
+        byte              partial         =   0;
+
+        void  AddToStats(TempLogStats & stats, int value);
+        void  AppendSample(File & file, TempLogSample & sample);
+        void  ClosePage(File & file);
+        void  MergeRecord(TempLogStats & stats, int min_value, int max_value, int avg_value, int count);
+        void  StartPage(File & file, TempLogSample & sample);
+        void  WriteBits(File & file, uint16_t value, byte count);
+        void  WriteDelta(File & file, int delta);
+        void  WriteHourSummary();
+        void  WritePageHeader(File & file);
+
+    public:
+        TemperatureTrend  trend_in;
+        TemperatureTrend  trend_out;
+
+        TemperatureLogger(ClockController * clock_ctrl, SdCardController * sdcard_ctrl, SensorSampler * sampler);
+
+        bool  Flush();
+        bool  GetDaySummary(unsigned int day, TempLogStats & in, TempLogStats & out, int & hours);
+        void  GetStatus(FixedStringBase & result);
+        void  Process();
+        void  Sample(unsigned long time);
+
+        static void AppendTenths(FixedStringBase & text, int value);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Dodanie wartosci do statystyk czujnika (pomijane sa odczyty odlaczonego czujnika).
+ *  @param stats: Statystyki czujnika.
+ *  @param value: Temperatura w dziesiatych czesciach stopnia.
+ */
+void TemperatureLogger::AddToStats(TempLogStats & stats, int value)
+{
+    if (value == TEMP_LOG_NULL)
+        return;
+
+    stats.min_value = stats.count == 0 ? value : min(stats.min_value, value);
+    stats.max_value = stats.count == 0 ? value : max(stats.max_value, value);
+    stats.sum += value;
+    stats.count++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie probki do biezacej strony lub otwarcie nowej strony.
+ *  @param file: Plik danych.
+ *  @param sample: Probka.
+ */
+void TemperatureLogger::AppendSample(File & file, TempLogSample & sample)
+{
+    unsigned long expected_time = this->page_header.start_time
+        + (unsigned long) this->page_header.count * TEMP_LOG_INTERVAL * 60;
+
+    if (!this->page_open
+        || sample.time != expected_time
+        || this->page_header.bits + TEMP_LOG_SAMPLE_MAX_BITS > TEMP_LOG_PAGE_BITS)
+    {
+        if (this->page_open)
+        {
+            this->ClosePage(file);
+            this->page_index++;
+        }
+
+        this->StartPage(file, sample);
+        return;
+    }
+
+    this->WriteDelta(file, sample.in - this->prev_in);
+    this->WriteDelta(file, sample.out - this->prev_out);
+
+    this->prev_in = sample.in;
+    this->prev_out = sample.out;
+    this->page_header.count++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zamkniecie strony - zapis naglowka i dopelnienie strony zerami do granicy bloku.
+ *  @param file: Plik danych.
+ */
+void TemperatureLogger::ClosePage(File & file)
+{
+    byte zeros[16];
+    memset(zeros, 0, sizeof(zeros));
+
+    this->WritePageHeader(file);
+
+    unsigned long position = this->page_index * TEMP_LOG_PAGE_SIZE
+        + sizeof(TempLogPageHeader) + (this->page_header.bits + 7) / 8;
+    unsigned long page_end = (this->page_index + 1) * TEMP_LOG_PAGE_SIZE;
+
+    file.seek(position);
+
+    while (position < page_end)
+    {
+        int count = min((unsigned long) sizeof(zeros), page_end - position);
+        file.write(zeros, count);
+        position += count;
+    }
+
+    this->page_open = false;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dodanie rekordu godzinowego do statystyk dnia.
+ *  @param stats: Statystyki czujnika.
+ *  @param min_value: Minimum godziny.
+ *  @param max_value: Maksimum godziny.
+ *  @param avg_value: Srednia godziny.
+ *  @param count: Ilosc probek godziny.
+ */
+void TemperatureLogger::MergeRecord(TempLogStats & stats, int min_value, int max_value, int avg_value, int count)
+{
+    if (avg_value == TEMP_LOG_NULL || count <= 0)
+        return;
+
+    stats.min_value = stats.count == 0 ? min_value : min(stats.min_value, min_value);
+    stats.max_value = stats.count == 0 ? max_value : max(stats.max_value, max_value);
+    stats.sum += (long) avg_value * count;
+    stats.count += count;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Otwarcie nowej strony z pelnymi wartosciami pierwszej probki.
+ *  @param file: Plik danych.
+ *  @param sample: Pierwsza probka strony.
+ */
+void TemperatureLogger::StartPage(File & file, TempLogSample & sample)
+{
+    this->page_header = TempLogPageHeader();
+    this->page_header.start_time = sample.time;
+    this->page_header.count = 1;
+    this->page_header.first_in = sample.in;
+    this->page_header.first_out = sample.out;
+
+    this->prev_in = sample.in;
+    this->prev_out = sample.out;
+    this->partial = 0;
+    this->page_open = true;
+
+    //  Po zapisie naglowka pozycja pliku wskazuje poczatek danych strony.
+    this->WritePageHeader(file);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis bitow do strony (od najstarszego bitu). Pelne bajty trafiaja do pliku,
+ *  niepelny bajt jest przechowywany w pamieci i zapisywany przy zapisie naglowka.
+ *  @param file: Plik danych (pozycja na biezacym bajcie strony).
+ *  @param value: Wartosc.
+ *  @param count: Ilosc bitow (do 16).
+ */
+void TemperatureLogger::WriteBits(File & file, uint16_t value, byte count)
+{
+    while (count > 0)
+    {
+        count--;
+        this->partial = (this->partial << 1) | ((value >> count) & 1);
+        this->page_header.bits++;
+
+        if ((this->page_header.bits & 7) == 0)
+        {
+            file.write(this->partial);
+            this->partial = 0;
+        }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis roznicy temperatur w kodzie zmiennej dlugosci.
+ *  @param file: Plik danych.
+ *  @param delta: Roznica do poprzedniej probki.
+ */
+void TemperatureLogger::WriteDelta(File & file, int delta)
+{
+    uint16_t zigzag = ((uint16_t) delta << 1) ^ (uint16_t) (delta >> 15);
+
+    if (zigzag == 0)
+        this->WriteBits(file, 0, 1);
+
+    else if (zigzag < 16)
+    {
+        this->WriteBits(file, 0x2, 2);
+        this->WriteBits(file, zigzag, 4);
+    }
+    else if (zigzag < 256)
+    {
+        this->WriteBits(file, 0x6, 3);
+        this->WriteBits(file, zigzag, 8);
+    }
+    else
+    {
+        this->WriteBits(file, 0x7, 3);
+        this->WriteBits(file, zigzag, 16);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis podsumowania zakonczonej godziny i wyzerowanie akumulatorow.
+void TemperatureLogger::WriteHourSummary()
+{
+    if (this->hour_count == 0)
+        return;
+
+    TempLogHourRecord record;
+    record.day = this->current_hour / 24;
+    record.hour = this->current_hour % 24;
+    record.count = this->hour_count;
+
+    if (this->hour_in.count > 0)
+    {
+        record.in_min = this->hour_in.min_value;
+        record.in_max = this->hour_in.max_value;
+        record.in_avg = this->hour_in.sum / this->hour_in.count;
+    }
+
+    if (this->hour_out.count > 0)
+    {
+        record.out_min = this->hour_out.min_value;
+        record.out_max = this->hour_out.max_value;
+        record.out_avg = this->hour_out.sum / this->hour_out.count;
+    }
+
+    if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
+    {
+        File file = this->sdcard_ctrl->OpenFileToAppend(TEMP_LOG_SUMMARY_FILE);
+
+        if (file)
+        {
+            file.write((const uint8_t *) &record, sizeof(record));
+            file.close();
+        }
+    }
+
+    this->hour_in = TempLogStats();
+    this->hour_out = TempLogStats();
+    this->hour_count = 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis naglowka biezacej strony wraz z niepelnym bajtem danych.
+ *  @param file: Plik danych.
+ */
+void TemperatureLogger::WritePageHeader(File & file)
+{
+    unsigned long page_start = this->page_index * TEMP_LOG_PAGE_SIZE;
+    byte used_bits = this->page_header.bits & 7;
+
+    if (used_bits > 0)
+    {
+        file.seek(page_start + sizeof(TempLogPageHeader) + this->page_header.bits / 8);
+        file.write((byte) (this->partial << (8 - used_bits)));
+    }
+
+    file.seek(page_start);
+    file.write((const uint8_t *) &this->page_header, sizeof(TempLogPageHeader));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy rejestratora temperatur.
+ *  @param clock_ctrl: Kontroler zegara.
+ *  @param sdcard_ctrl: Kontroler karty SD.
+ *  @param sampler: Usluga probkowania czujnikow (temperatury w dziesiatych czesciach stopnia).
+ */
+TemperatureLogger::TemperatureLogger(ClockController * clock_ctrl, SdCardController * sdcard_ctrl, SensorSampler * sampler)
+{
+    this->clock_ctrl = clock_ctrl;
+    this->sdcard_ctrl = sdcard_ctrl;
+    this->sampler = sampler;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Zapis oczekujacych probek do pliku danych. Zapis odbywa sie w obrebie jednej strony
+ *  (biblioteka SD buforuje blok), naglowek strony jest aktualizowany na koncu.
+ *  @return: Informacja o zapisaniu probek.
+ */
+bool TemperatureLogger::Flush()
+{
+    if (this->pending == 0)
+        return true;
+
+    if (!this->sdcard_ctrl->IsInitialized() || !this->sdcard_ctrl->IsMounted())
+        return false;
+
+    File file = this->sdcard_ctrl->OpenFileToUpdate(TEMP_LOG_DATA_FILE);
+
+    if (!file)
+        return false;
+
+    if (this->page_open)
+    {
+        file.seek(this->page_index * TEMP_LOG_PAGE_SIZE
+            + sizeof(TempLogPageHeader) + this->page_header.bits / 8);
+    }
+    else
+    {
+        //  Po uruchomieniu zapis zaczyna sie od nowej strony - niepelna strona jest dopelniana.
+        unsigned long size = file.size();
+        this->page_index = (size + TEMP_LOG_PAGE_SIZE - 1) / TEMP_LOG_PAGE_SIZE;
+
+        if (size % TEMP_LOG_PAGE_SIZE != 0)
+        {
+            file.seek(size);
+
+            while (size++ < this->page_index * TEMP_LOG_PAGE_SIZE)
+                file.write((byte) 0);
+        }
+    }
+
+    for (int i = 0; i < this->pending; i++)
+        this->AppendSample(file, this->samples[i]);
+
+    this->WritePageHeader(file);
+    file.close();
+
+    this->pending = 0;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie statystyk dnia z pliku podsumowan godzinowych (bez odczytu stron z probkami).
+ *  Rekordy sa zapisywane chronologicznie - poczatek dnia jest wyszukiwany binarnie.
+ *  @param day: Dzien od 1970-01-01.
+ *  @param in: Statystyki czujnika wewnetrznego (wynik).
+ *  @param out: Statystyki czujnika zewnetrznego (wynik).
+ *  @param hours: Ilosc godzin z pomiarami (wynik).
+ *  @return: Informacja o znalezieniu pomiarow z danego dnia.
+ */
+bool TemperatureLogger::GetDaySummary(unsigned int day, TempLogStats & in, TempLogStats & out, int & hours)
+{
+    in = TempLogStats();
+    out = TempLogStats();
+    hours = 0;
+
+    File file;
+
+    if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
+        file = this->sdcard_ctrl->OpenFileToRead(TEMP_LOG_SUMMARY_FILE);
+
+    if (file)
+    {
+        TempLogHourRecord record;
+
+        unsigned long low = 0;
+        unsigned long high = file.size() / sizeof(TempLogHourRecord);
+
+        while (low < high)
+        {
+            unsigned long middle = (low + high) / 2;
+
+            file.seek(middle * sizeof(TempLogHourRecord));
+            file.read(&record, sizeof(record));
+
+            if (record.day < day)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        file.seek(low * sizeof(TempLogHourRecord));
+
+        while (file.read(&record, sizeof(record)) == sizeof(record) && record.day == day)
+        {
+            this->MergeRecord(in, record.in_min, record.in_max, record.in_avg, record.count);
+            this->MergeRecord(out, record.out_min, record.out_max, record.out_avg, record.count);
+            hours++;
+        }
+
+        file.close();
+    }
+
+    //  Biezaca godzina nie jest jeszcze zapisana w pliku.
+    if (this->hour_count > 0 && this->current_hour / 24 == day)
+    {
+        if (this->hour_in.count > 0)
+            this->MergeRecord(in, this->hour_in.min_value, this->hour_in.max_value,
+                this->hour_in.sum / this->hour_in.count, this->hour_in.count);
+
+        if (this->hour_out.count > 0)
+            this->MergeRecord(out, this->hour_out.min_value, this->hour_out.max_value,
+                this->hour_out.sum / this->hour_out.count, this->hour_out.count);
+
+        hours++;
+    }
+
+    return hours > 0;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie opisu stanu rejestratora.
+ *  @param result: Opis stanu (nadpisywany).
+ */
+void TemperatureLogger::GetStatus(FixedStringBase & result)
+{
+    result.Clear();
+    result.Append_P(PSTR("templog: interval ")).AppendNumber(TEMP_LOG_INTERVAL)
+        .Append_P(PSTR("min, pending ")).AppendNumber(this->pending)
+        .Append_P(PSTR(", page ")).AppendNumber(this->page_index)
+        .Append_P(PSTR(" (")).AppendNumber(this->page_open ? this->page_header.count : 0)
+        .Append_P(PSTR(" samples, ")).AppendNumber(this->page_open ? this->page_header.bits : 0)
+        .Append('/').AppendNumber(TEMP_LOG_PAGE_BITS)
+        .Append_P(PSTR(" bits), dropped ")).AppendNumber(this->dropped);
+}
+
+//  ----------------------------------------------------------------------------
+//  Sprawdzenie czasu probkowania (raz na TEMP_LOG_CHECK_INTERVAL ms).
+void TemperatureLogger::Process()
+{
+    if (millis() - this->last_check < TEMP_LOG_CHECK_INTERVAL)
+        return;
+
+    this->last_check = millis();
+
+    unsigned long minute = this->clock_ctrl->GetUnixTime(this->clock_ctrl->Now()) / 60;
+
+    if (minute == this->last_minute || minute % TEMP_LOG_INTERVAL != 0)
+        return;
+
+    this->last_minute = minute;
+    this->Sample(minute * 60);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pomiar temperatur i dodanie probki do bufora. Po zmianie godziny zapisywane sa
+ *  oczekujace probki i podsumowanie zakonczonej godziny.
+ *  @param time: Czas probki (unix).
+ */
+void TemperatureLogger::Sample(unsigned long time)
+{
+    TempLogSample sample;
+
+    //  Nieaktualny odczyt (brak czujnika lub bledy magistrali) zapisywany jest jako brak pomiaru.
+    sample.time = time;
+    sample.in = this->sampler->IsValid(SAMPLER_TEMP_IN) ? this->sampler->GetValue(SAMPLER_TEMP_IN) : TEMP_LOG_NULL;
+    sample.out = this->sampler->IsValid(SAMPLER_TEMP_OUT) ? this->sampler->GetValue(SAMPLER_TEMP_OUT) : TEMP_LOG_NULL;
+
+    unsigned long hour = time / 3600;
+
+    if (this->hour_count > 0 && hour != this->current_hour)
+    {
+        this->Flush();
+        this->WriteHourSummary();
+    }
+
+    //  Brak karty SD - najstarsza probka jest usuwana z bufora.
+    if (this->pending >= TEMP_LOG_RAM_SAMPLES && !this->Flush())
+    {
+        memmove(this->samples, this->samples + 1, sizeof(TempLogSample) * (TEMP_LOG_RAM_SAMPLES - 1));
+        this->pending--;
+        this->dropped++;
+    }
+
+    this->samples[this->pending++] = sample;
+
+    //  Statystyki wyswietlane na ekranie (aktualizacja w czasie stalym).
+    this->trend_in.Update(time, sample.in);
+    this->trend_out.Update(time, sample.out);
+
+    this->current_hour = hour;
+    this->AddToStats(this->hour_in, sample.in);
+    this->AddToStats(this->hour_out, sample.out);
+    this->hour_count++;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dopisanie temperatury w dziesiatych czesciach stopnia w postaci "-12.5".
+ *  @param text: Tekst wynikowy.
+ *  @param value: Temperatura w dziesiatych czesciach stopnia.
+ */
+void TemperatureLogger::AppendTenths(FixedStringBase & text, int value)
+{
+    if (value < 0)
+    {
+        text.Append('-');
+        value = -value;
+    }
+
+    text.AppendNumber(value / 10).Append('.').AppendNumber(value % 10);
+}
+
+#endif
@@ -9,8 +9,8 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "board_profile.h"
+#include "onewire_bus.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,24 +18,33 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define TEMPERATURE_SENSOR_NULL       -127
-#define TEMPERATURE_SENSOR_PIN_IN     A9
-#define TEMPERATURE_SENSOR_PIN_OUT    A8
+#define TEMPERATURE_SENSOR_PIN_IN     Board::TEMPERATURE_SENSOR_PIN_IN
+#define TEMPERATURE_SENSOR_PIN_OUT    Board::TEMPERATURE_SENSOR_PIN_OUT
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //  *** CLASS DEFINITION ***
 ////////////////////////////////////////////////////////////////////////////////
 
+//  Czujnik temperatury na wspoldzielonej magistrali OneWire. Czujnik jest wskazany adresem ROM
+//  zapisanym w konfiguracji, a bez niego indeksem w kolejnosci wyszukiwania na magistrali.
 class TemperatureSensorController
 {
     private:
-        OneWire           *connection;
-        DallasTemperature *sensor;
+        OneWireBus    * bus;
+        int             index;
+        DeviceAddress   address;
+        bool            assigned    =   false;
 
     public:
-        TemperatureSensorController(int pin_input);
-
-        int GetTemperature();
+        TemperatureSensorController(OneWireBus * bus, int index);
+
+        const uint8_t * GetAssignedAddress();
+        OneWireBus    * GetBus();
+        int             GetIndex();
+        int             GetTemperature();
+        bool            IsConnected();
+        void            SetAddress(const uint8_t * address);
 };
 
 
@@ -44,23 +53,71 @@ class TemperatureSensorController
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Konstruktor klasy modulu miernika temperatury DALLAS DS18B20.
- * @param pin_input: Pin danych.
+ * @param bus: Magistrala OneWire z wyszukanymi czujnikami.
+ * @param index: Indeks czujnika na magistrali.
+ */
+TemperatureSensorController::TemperatureSensorController(OneWireBus * bus, int index)
+{
+    this->bus = bus;
+    this->index = index;
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie adresu ROM przypisanego w konfiguracji.
+ * @return: Adres czujnika (8 bajtow) lub NULL gdy czujnik jest wskazany kolejnoscia wyszukiwania.
+ */
+const uint8_t * TemperatureSensorController::GetAssignedAddress()
+{
+    return this->assigned ? this->address : NULL;
+}
+
+//  ----------------------------------------------------------------------------
+/* Pobranie magistrali czujnika.
+ * @return: Magistrala OneWire.
  */
-TemperatureSensorController::TemperatureSensorController(int pin_input)
+OneWireBus * TemperatureSensorController::GetBus()
 {
-    this->connection = new OneWire(pin_input);
-    this->sensor = new DallasTemperature(connection);
-    this->sensor->begin();
+    return this->bus;
 }
 
 //  ----------------------------------------------------------------------------
-/* Odczytanie wartosci temperatury z merinika.
+/* Pobranie indeksu czujnika na magistrali.
+ * @return: Indeks czujnika lub -1 gdy przypisany czujnik nie zostal wykryty.
+ */
+int TemperatureSensorController::GetIndex()
+{
+    return this->assigned ? this->bus->FindAddress(this->address) : this->index;
+}
+
+//  ----------------------------------------------------------------------------
+/* Odczytanie wartosci temperatury z merinika (ostatni pomiar magistrali, bez oczekiwania).
  * @return: Wartosc odczytanej temperatury.
  */
 int TemperatureSensorController::GetTemperature()
 {
-    this->sensor->requestTemperatures();
-    return this->sensor->getTempCByIndex(0);
+    return this->bus->GetTemperature(this->GetIndex());
+}
+
+//  ----------------------------------------------------------------------------
+/* Sprawdzenie czy czujnik zostal wykryty na magistrali.
+ * @return: True - czujnik wykryty.
+ */
+bool TemperatureSensorController::IsConnected()
+{
+    int index = this->GetIndex();
+    return index >= 0 && index < this->bus->GetDeviceCount();
+}
+
+//  ----------------------------------------------------------------------------
+/* Przypisanie czujnika po adresie ROM (niezaleznie od kolejnosci wyszukiwania).
+ * @param address: Adres czujnika (8 bajtow) lub NULL - powrot do indeksu na magistrali.
+ */
+void TemperatureSensorController::SetAddress(const uint8_t * address)
+{
+    this->assigned = address != NULL;
+
+    if (this->assigned)
+        memcpy(this->address, address, sizeof(DeviceAddress));
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+//  TEMPERATURE TREND
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEMPERATURE_TREND_H
+#define TEMPERATURE_TREND_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define TREND_BUCKETS           64                              //  Jedna kolumna wyswietlacza na przedzial.
+#define TREND_BUCKET_SECONDS    (86400UL / TREND_BUCKETS)       //  22.5 min
+#define TREND_EMPTY             -128                            //  Przedzial bez pomiarow.
+#define TREND_LOOKBACK          3                               //  Przedzialy wstecz (~1h) do wyznaczenia trendu.
+#define TREND_THRESHOLD         5                               //  0.5 stopnia - mniejsza zmiana to trend staly.
+#define TREND_NULL              -1270                           //  Brak pomiaru (jak TEMP_LOG_NULL).
+
+#define TREND_FALLING           0
+#define TREND_STEADY            1
+#define TREND_RISING            2
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Biezace statystyki jednego czujnika aktualizowane w czasie stalym przy kazdej probce:
+//  minimum i maksimum dnia, trend oraz srednie z 64 przedzialow ostatniej doby (wykres).
+//  Temperatury w dziesiatych czesciach stopnia; przedzialy przechowuja polowki stopnia (int8).
+class TemperatureTrend
+{
+    private:
+        int8_t          buckets[TREND_BUCKETS];
+        unsigned long   slot            =   0;
+        long            slot_sum        =   0;
+        int             slot_count      =   0;
+
+        unsigned int    day             =   0;
+        int             day_min         =   TREND_NULL;
+        int             day_max         =   TREND_NULL;
+        int             last_value      =   TREND_NULL;
+
+        int8_t  GetBucket(unsigned long bucket_slot);
+
+    public:
+        TemperatureTrend();
+
+        int   GetDayMax();
+        int   GetDayMaxDegrees();
+        int   GetDayMin();
+        int   GetDayMinDegrees();
+        int   GetLastValue();
+        void  GetSparkline(byte * columns, int width);
+        int   GetTrend();
+        void  Update(unsigned long time, int value);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Pobranie wartosci przedzialu (pusty gdy przedzial jest starszy niz doba).
+ *  @param bucket_slot: Numer przedzialu od 1970-01-01.
+ *  @return: Temperatura w polowkach stopnia lub TREND_EMPTY.
+ */
+int8_t TemperatureTrend::GetBucket(unsigned long bucket_slot)
+{
+    if (bucket_slot > this->slot || this->slot - bucket_slot >= TREND_BUCKETS)
+        return TREND_EMPTY;
+
+    return this->buckets[bucket_slot % TREND_BUCKETS];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Konstruktor klasy statystyk temperatury.
+TemperatureTrend::TemperatureTrend()
+{
+    memset(this->buckets, TREND_EMPTY, sizeof(this->buckets));
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie maksymalnej temperatury dnia.
+ *  @return: Temperatura w dziesiatych czesciach stopnia lub TREND_NULL.
+ */
+int TemperatureTrend::GetDayMax()
+{
+    return this->day_max;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie maksymalnej temperatury dnia zaokraglonej w gore do pelnych stopni.
+ *  @return: Temperatura w stopniach (wynik nieokreslony gdy brak pomiaru).
+ */
+int TemperatureTrend::GetDayMaxDegrees()
+{
+    return this->day_max >= 0 ? (this->day_max + 9) / 10 : -(-this->day_max / 10);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie minimalnej temperatury dnia.
+ *  @return: Temperatura w dziesiatych czesciach stopnia lub TREND_NULL.
+ */
+int TemperatureTrend::GetDayMin()
+{
+    return this->day_min;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie minimalnej temperatury dnia zaokraglonej w dol do pelnych stopni (-0.7 to -1).
+ *  @return: Temperatura w stopniach (wynik nieokreslony gdy brak pomiaru).
+ */
+int TemperatureTrend::GetDayMinDegrees()
+{
+    return this->day_min >= 0 ? this->day_min / 10 : -((9 - this->day_min) / 10);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie ostatniego pomiaru.
+ *  @return: Temperatura w dziesiatych czesciach stopnia lub TREND_NULL.
+ */
+int TemperatureTrend::GetLastValue()
+{
+    return this->last_value;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wygenerowanie wykresu ostatniej doby - jeden punkt na kolumne, skala od minimum do
+ *  maksimum widocznych przedzialow (bit 0 - gorny wiersz, najnowszy przedzial po prawej).
+ *  @param columns: Kolumny wynikowe.
+ *  @param width: Ilosc kolumn (do TREND_BUCKETS).
+ */
+void TemperatureTrend::GetSparkline(byte * columns, int width)
+{
+    width = min(width, TREND_BUCKETS);
+
+    int low = 127;
+    int high = -127;
+
+    for (int i = 0; i < width; i++)
+    {
+        int8_t value = this->GetBucket(this->slot - (width - 1 - i));
+
+        if (value == TREND_EMPTY)
+            continue;
+
+        low = min(low, (int) value);
+        high = max(high, (int) value);
+    }
+
+    for (int i = 0; i < width; i++)
+    {
+        int8_t value = this->GetBucket(this->slot - (width - 1 - i));
+
+        if (value == TREND_EMPTY)
+        {
+            columns[i] = 0;
+            continue;
+        }
+
+        int level = high > low ? (value - low) * 7 / (high - low) : 3;
+        columns[i] = 1 << (7 - level);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie kierunku zmian temperatury (ostatni pomiar wzgledem sredniej sprzed ~1h).
+ *  @return: TREND_FALLING, TREND_STEADY lub TREND_RISING.
+ */
+int TemperatureTrend::GetTrend()
+{
+    int8_t past = this->GetBucket(this->slot - TREND_LOOKBACK);
+
+    if (past == TREND_EMPTY || this->last_value == TREND_NULL)
+        return TREND_STEADY;
+
+    int difference = this->last_value - past * 5;
+
+    if (difference >= TREND_THRESHOLD)
+        return TREND_RISING;
+
+    if (difference <= -TREND_THRESHOLD)
+        return TREND_FALLING;
+
+    return TREND_STEADY;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Aktualizacja statystyk nowym pomiarem.
+ *  @param time: Czas pomiaru (unix).
+ *  @param value: Temperatura w dziesiatych czesciach stopnia lub TREND_NULL.
+ */
+void TemperatureTrend::Update(unsigned long time, int value)
+{
+    if (value == TREND_NULL)
+        return;
+
+    //  Minimum i maksimum dnia (zerowane po polnocy).
+    unsigned int current_day = time / 86400UL;
+
+    if (current_day != this->day || this->day_min == TREND_NULL)
+    {
+        this->day = current_day;
+        this->day_min = value;
+        this->day_max = value;
+    }
+    else
+    {
+        this->day_min = min(this->day_min, value);
+        this->day_max = max(this->day_max, value);
+    }
+
+    //  Przejscie do nowego przedzialu - czyszczone sa przedzialy pominiete (najwyzej 64).
+    unsigned long current_slot = time / TREND_BUCKET_SECONDS;
+
+    if (current_slot != this->slot)
+    {
+        unsigned long skipped = current_slot > this->slot ? current_slot - this->slot : TREND_BUCKETS;
+
+        for (unsigned long i = 1; i <= min(skipped, (unsigned long) TREND_BUCKETS); i++)
+            this->buckets[(this->slot + i) % TREND_BUCKETS] = TREND_EMPTY;
+
+        this->slot = current_slot;
+        this->slot_sum = 0;
+        this->slot_count = 0;
+    }
+
+    this->slot_sum += value;
+    this->slot_count++;
+    this->buckets[this->slot % TREND_BUCKETS] = constrain(this->slot_sum / this->slot_count / 5, -127, 127);
+    this->last_value = value;
+}
+
+#endif
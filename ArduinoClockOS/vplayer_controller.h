@@ -0,0 +1,419 @@
+////////////////////////////////////////////////////////////////////////////////
+//  VISUAL PLAYER CONTROLLER
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef VPLAYER_CONTROLLER_H
+#define VPLAYER_CONTROLLER_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "display_controller.h"
+#include "keypad_controller.h"
+#include "serial_controller.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define VPLAYER_NOTHING           -1
+#define VPLAYER_FINISHED          0
+#define VPLAYER_PLAYING           1
+
+//  Pakiet: [SYNC] [TYPE] [LENGTH] [PAYLOAD x LENGTH] [CHECKSUM = TYPE ^ LENGTH ^ PAYLOAD...]
+#define VPLAYER_SYNC_BYTE         0xA5
+#define VPLAYER_FRAME_RAW         0x01    //  64 bajty - jeden bajt na kolumne.
+#define VPLAYER_FRAME_RLE         0x02    //  Pary (ilosc, wartosc) wypelniajace kolejne kolumny.
+#define VPLAYER_FRAME_DELTA       0x03    //  Pary (kolumna, wartosc) nakladane na poprzednia klatke.
+#define VPLAYER_STOP              0x04    //  Zakonczenie transmisji (LENGTH = 0).
+
+#define VPLAYER_ACK               0x06    //  Klatka wyswietlona - mozna wyslac kolejna.
+#define VPLAYER_NAK               0x15    //  Klatka odrzucona - mozna wyslac kolejna.
+
+#define VPLAYER_PACKET_SYNC       0
+#define VPLAYER_PACKET_TYPE       1
+#define VPLAYER_PACKET_LENGTH     2
+#define VPLAYER_PACKET_PAYLOAD    3
+#define VPLAYER_PACKET_CHECKSUM   4
+
+#define VPLAYER_READ_LIMIT        80
+#define VPLAYER_FRAME_TIMEOUT     250
+#define VPLAYER_IDLE_TIMEOUT      10000
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class VPlayerController
+{
+    private:
+        DisplayController * display_ctrl;
+        SerialController  * serial_ctrl;
+
+        bool    active            = false;
+        int     device            = SERIAL_COM;
+        bool    frame_ready       = false;
+
+        byte    packet_checksum   = 0;
+        bool    packet_error      = false;
+        byte    packet_length     = 0;
+        byte    packet_state      = VPLAYER_PACKET_SYNC;
+        byte    packet_type       = 0;
+        byte    payload_index     = 0;
+        byte    frame_position    = 0;
+        byte    pair_value        = 0;
+
+        unsigned long   last_data_time    = 0;
+        unsigned long   packet_start_time = 0;
+        unsigned long   start_time        = 0;
+
+        unsigned long   frames_received   = 0;
+        unsigned long   frames_displayed  = 0;
+        unsigned long   frames_dropped    = 0;
+        unsigned long   checksum_errors   = 0;
+        unsigned long   format_errors     = 0;
+        unsigned long   sync_errors       = 0;
+        unsigned long   timeouts          = 0;
+
+        void  BeginPacket();
+        void  DecodePayloadByte(byte value);
+        void  DropPacket();
+        void  FinishPacket();
+        void  ProcessByte(byte value);
+        void  ReceiveData();
+
+    public:
+        VPlayerController(DisplayController * display_ctrl, SerialController * serial_ctrl);
+
+        int     CheckState();
+        String  GetStatistics();
+        int     ProcessInput(int input);
+        int     Start(int device);
+        void    Stop();
+        void    UpdateDisplay();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRIVATE METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Przygotowanie bufora ramki do odbioru danych nowego pakietu.
+void VPlayerController::BeginPacket()
+{
+    this->frame_position = 0;
+    this->packet_error = false;
+    this->payload_index = 0;
+
+    //  Klatka roznicowa nakladana jest na aktualnie wyswietlana klatke.
+    if (this->packet_type == VPLAYER_FRAME_DELTA)
+        memcpy(this->display_ctrl->GetBackFrame(), this->display_ctrl->GetFrontFrame(), this->display_ctrl->GetFrameSize());
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dekodowanie pojedynczego bajtu danych pakietu bezposrednio do bufora ramki.
+ *  @param value: Odebrany bajt danych pakietu.
+ */
+void VPlayerController::DecodePayloadByte(byte value)
+{
+    byte  * frame       = this->display_ctrl->GetBackFrame();
+    int     frame_size  = this->display_ctrl->GetFrameSize();
+    bool    pair_second = this->payload_index % 2 == 1;
+
+    switch (this->packet_type)
+    {
+        case VPLAYER_FRAME_RAW:
+            //  Dane dluzsze niz ramka - pakiet odrzucany (jak przepelnienie RLE).
+            if (this->frame_position >= frame_size)
+            {
+                this->packet_error = true;
+                break;
+            }
+
+            frame[this->frame_position++] = value;
+            break;
+
+        case VPLAYER_FRAME_RLE:
+            if (!pair_second)
+            {
+                this->pair_value = value;
+                break;
+            }
+
+            if (this->frame_position + this->pair_value > frame_size)
+            {
+                this->packet_error = true;
+                break;
+            }
+
+            memset(frame + this->frame_position, value, this->pair_value);
+            this->frame_position += this->pair_value;
+            break;
+
+        case VPLAYER_FRAME_DELTA:
+            if (!pair_second)
+            {
+                this->pair_value = value;
+                break;
+            }
+
+            if (this->pair_value >= frame_size)
+                this->packet_error = true;
+            else
+                frame[this->pair_value] = value;
+            break;
+    }
+
+    this->payload_index++;
+}
+
+//  ----------------------------------------------------------------------------
+//  Odrzucenie aktualnie odbieranego pakietu i powiadomienie nadawcy.
+void VPlayerController::DropPacket()
+{
+    this->frames_dropped++;
+    this->packet_state = VPLAYER_PACKET_SYNC;
+    this->serial_ctrl->WriteByte(VPLAYER_NAK, this->device);
+}
+
+//  ----------------------------------------------------------------------------
+//  Weryfikacja odebranego pakietu i oznaczenie klatki jako gotowej do wyswietlenia.
+void VPlayerController::FinishPacket()
+{
+    int frame_size = this->display_ctrl->GetFrameSize();
+
+    this->packet_state = VPLAYER_PACKET_SYNC;
+
+    if (this->packet_checksum != 0)
+    {
+        this->checksum_errors++;
+        this->DropPacket();
+        return;
+    }
+
+    switch (this->packet_type)
+    {
+        case VPLAYER_STOP:
+            this->Stop();
+            return;
+
+        case VPLAYER_FRAME_RAW:
+        case VPLAYER_FRAME_RLE:
+            if (this->frame_position != frame_size)
+                this->packet_error = true;
+            break;
+    }
+
+    if (this->packet_error)
+    {
+        this->format_errors++;
+        this->DropPacket();
+        return;
+    }
+
+    this->frames_received++;
+    this->frame_ready = true;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przetworzenie pojedynczego bajtu strumienia przez automat stanow pakietu.
+ *  @param value: Odebrany bajt.
+ */
+void VPlayerController::ProcessByte(byte value)
+{
+    switch (this->packet_state)
+    {
+        case VPLAYER_PACKET_SYNC:
+            if (value == VPLAYER_SYNC_BYTE)
+            {
+                this->packet_state = VPLAYER_PACKET_TYPE;
+                this->packet_start_time = millis();
+            }
+            else
+                this->sync_errors++;
+            break;
+
+        case VPLAYER_PACKET_TYPE:
+            this->packet_type = value;
+            this->packet_checksum = value;
+
+            if (value < VPLAYER_FRAME_RAW || value > VPLAYER_STOP)
+            {
+                this->format_errors++;
+                this->DropPacket();
+                break;
+            }
+
+            this->packet_state = VPLAYER_PACKET_LENGTH;
+            break;
+
+        case VPLAYER_PACKET_LENGTH:
+            this->packet_length = value;
+            this->packet_checksum ^= value;
+            this->BeginPacket();
+            this->packet_state = value > 0 ? VPLAYER_PACKET_PAYLOAD : VPLAYER_PACKET_CHECKSUM;
+            break;
+
+        case VPLAYER_PACKET_PAYLOAD:
+            this->packet_checksum ^= value;
+            this->DecodePayloadByte(value);
+
+            if (this->payload_index >= this->packet_length)
+                this->packet_state = VPLAYER_PACKET_CHECKSUM;
+            break;
+
+        case VPLAYER_PACKET_CHECKSUM:
+            this->packet_checksum ^= value;
+            this->FinishPacket();
+            break;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+//  Odczytanie dostepnych danych bez blokowania petli glownej.
+void VPlayerController::ReceiveData()
+{
+    unsigned long now = millis();
+    int read_count = 0;
+
+    //  Kontrola przeplywu - kolejna klatka jest odbierana dopiero po wyswietleniu poprzedniej.
+    while (!this->frame_ready && this->active && read_count < VPLAYER_READ_LIMIT)
+    {
+        int value = this->serial_ctrl->ReadByte(this->device);
+
+        if (value < 0)
+            break;
+
+        this->ProcessByte((byte) value);
+        this->last_data_time = now;
+        read_count++;
+    }
+
+    //  Odrzucenie niekompletnej klatki.
+    if (this->packet_state != VPLAYER_PACKET_SYNC && now - this->packet_start_time > VPLAYER_FRAME_TIMEOUT)
+    {
+        this->timeouts++;
+        this->DropPacket();
+    }
+
+    //  Zakonczenie trybu przy braku transmisji.
+    if (this->active && now - this->last_data_time > VPLAYER_IDLE_TIMEOUT)
+        this->Stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PUBLIC METHOD BODIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Konstruktor klasy odtwarzacza obrazu przesylanego przez port szeregowy.
+ *  @param display_ctrl: Kontroler wyswietlacza.
+ *  @param serial_ctrl: Kontroler polaczenia szeregowego.
+ */
+VPlayerController::VPlayerController(DisplayController * display_ctrl, SerialController * serial_ctrl)
+{
+    this->display_ctrl = display_ctrl;
+    this->serial_ctrl = serial_ctrl;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Sprawdzenie stanu odtwarzania.
+ *  @return: Indeks stanu odtwarzania.
+ */
+int VPlayerController::CheckState()
+{
+    return this->active ? VPLAYER_PLAYING : VPLAYER_FINISHED;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Pobranie statystyk ostatniej (lub trwajacej) transmisji.
+ *  @return: Statystyki transmisji jako tekst.
+ */
+String VPlayerController::GetStatistics()
+{
+    unsigned long elapsed = max(1UL, this->last_data_time - this->start_time);
+    unsigned long fps_x10 = (this->frames_displayed * 10000UL) / elapsed;
+
+    return "Frames: " + String(this->frames_received) + " received, "
+        + String(this->frames_displayed) + " displayed, "
+        + String(this->frames_dropped) + " dropped (checksum " + String(this->checksum_errors)
+        + ", format " + String(this->format_errors)
+        + ", timeout " + String(this->timeouts) + "); sync errors: " + String(this->sync_errors)
+        + "; fps: " + String(fps_x10 / 10) + "." + String(fps_x10 % 10);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Przetworzenie danych wejsciowych z klawiatury i odbior danych obrazu.
+ *  @param input: Dane wejsciowe z klawiatury (wcisniety klawisz).
+ *  @return: Indeks stanu odtwarzania.
+ */
+int VPlayerController::ProcessInput(int input)
+{
+    if (input > KEYPAD_NO_KEY)
+    {
+        this->Stop();
+        return VPLAYER_FINISHED;
+    }
+
+    this->ReceiveData();
+    return this->CheckState();
+}
+
+//  ----------------------------------------------------------------------------
+/*  Uruchomienie odbioru klatek obrazu.
+ *  @param device: Typ urzadzenia z ktorego odbierane beda dane.
+ *  @return: Indeks stanu odtwarzania.
+ */
+int VPlayerController::Start(int device)
+{
+    unsigned long now = millis();
+
+    this->active = true;
+    this->device = device;
+    this->frame_ready = false;
+    this->packet_state = VPLAYER_PACKET_SYNC;
+
+    this->frames_received = 0;
+    this->frames_displayed = 0;
+    this->frames_dropped = 0;
+    this->checksum_errors = 0;
+    this->format_errors = 0;
+    this->sync_errors = 0;
+    this->timeouts = 0;
+
+    this->last_data_time = now;
+    this->start_time = now;
+
+    memset(this->display_ctrl->GetBackFrame(), 0, this->display_ctrl->GetFrameSize());
+    memset(this->display_ctrl->GetFrontFrame(), 0, this->display_ctrl->GetFrameSize());
+    this->display_ctrl->Clear();
+
+    return VPLAYER_PLAYING;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zakonczenie odbioru klatek obrazu.
+void VPlayerController::Stop()
+{
+    this->active = false;
+    this->frame_ready = false;
+    this->packet_state = VPLAYER_PACKET_SYNC;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyswietlenie odebranej klatki obrazu na granicy ramki i potwierdzenie jej odbioru.
+void VPlayerController::UpdateDisplay()
+{
+    if (!this->frame_ready)
+        return;
+
+    this->display_ctrl->SwapFrames();
+    this->frame_ready = false;
+    this->frames_displayed++;
+
+    this->serial_ctrl->WriteByte(VPLAYER_ACK, this->device);
+}
+
+#endif
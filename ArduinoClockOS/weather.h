@@ -9,6 +9,7 @@
 //  *** INCLUDED LIBRARIES ***
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "profiler.h"
 #include "sd_card_controller.h"
 
 
@@ -16,7 +17,7 @@
 //  *** CONFIGURATION ***
 ////////////////////////////////////////////////////////////////////////////////
 
-const String WEATHER_FILE_NAME = "weat.ini";
+#define WEATHER_FILE_NAME   F("weat.ini")
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,7 +30,7 @@ class Weather
         SdCardController  * sdcard_ctrl;
         SerialController  * serial_ctrl;
 
-        byte  * weather       = new byte[25] { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        byte    weather[25]   = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
         int     year          = 2000;
         int     month         = 1;
         int     day           = 1;
@@ -61,8 +62,6 @@ class Weather
  */
 int Weather::CheckDateValidity(int *date_array)
 {
-    bool old = false;
-
     if (date_array[0] < this->year || date_array[1] < this->month || date_array[2] < this->day)
         return -1;
     
@@ -90,11 +89,17 @@ bool Weather::IsCharacterADigit(char c)
  */
 bool Weather::LoadFromFile()
 {
+    PROFILE_SCOPE(PROFILE_SECTION_WEATHER_LOAD);
     bool result = false;
 
-    if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted() && this->sdcard_ctrl->FileExists(WEATHER_FILE_NAME))
+    File weather_file;
+
+    if (this->sdcard_ctrl->IsInitialized() && this->sdcard_ctrl->IsMounted())
+        weather_file = this->sdcard_ctrl->OpenFileToRead(WEATHER_FILE_NAME);
+
+    //  Brak pliku - pusty obiekt File (bez osobnego przeszukania katalogu).
+    if (weather_file)
     {
-        File weather_file = this->sdcard_ctrl->OpenFileToRead(WEATHER_FILE_NAME);
         bool stop_reading = false;
 
         while (weather_file.available())
@@ -120,14 +125,14 @@ bool Weather::LoadFromFile()
 
             line.toLowerCase();
 
-            int *date_array = new int[3] {0, 0, 0};
+            int date_array[3] = {0, 0, 0};
             int last_step = this->ParseData(line, date_array, 3);
 
             if (last_step == 3)
             {
                 if (CheckDateValidity(date_array) == 0)
                 {
-                    int *weather_array = new int[25] { 0 };
+                    int weather_array[25] = { 0 };
                     last_step = this->ParseData(line, weather_array, 25, this->data_idx_pos);
 
                     if (last_step > 0 && last_step <= 25)
@@ -279,7 +284,7 @@ int Weather::GetWeather(Time date_time)
         if (!this->LoadFromFile())
         {
             this->weather[0] = 0;
-            this->serial_ctrl->WriteRawData("/get weather", SERIAL_COM);
+            this->serial_ctrl->WriteRawData_P(PSTR("/get weather"), SERIAL_COM);
             this->request_send = true;
         }
     }
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO CORE (ARDUINO MEGA 2560)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avr/pgmspace.h"
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "binary.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Kompilacja na komputerze (bez __AVR__) - kod oprogramowania wybiera sciezki bez rejestrow AVR.
+#define ARDUINO_ARCH_HOST           1
+#define ARDUINO                     10813
+
+#ifndef F_CPU
+#define F_CPU                       16000000UL
+#endif
+
+#define HIGH                        0x1
+#define LOW                         0x0
+
+#define INPUT                       0x0
+#define OUTPUT                      0x1
+#define INPUT_PULLUP                0x2
+
+#define LSBFIRST                    0
+#define MSBFIRST                    1
+
+#define CHANGE                      1
+#define FALLING                     2
+#define RISING                      3
+
+#define DEC                         10
+#define HEX                         16
+#define OCT                         8
+#define BIN                         2
+
+#define NOT_A_PIN                   0
+#define NOT_A_PORT                  0
+#define NOT_AN_INTERRUPT            -1
+
+#define LED_BUILTIN                 13
+#define SDA                         20
+#define SCL                         21
+#define SS                          53
+#define MOSI                        51
+#define MISO                        50
+#define SCK                         52
+
+#define A0                          54
+#define A1                          55
+#define A2                          56
+#define A3                          57
+#define A4                          58
+#define A5                          59
+#define A6                          60
+#define A7                          61
+#define A8                          62
+#define A9                          63
+#define A10                         64
+#define A11                         65
+#define A12                         66
+#define A13                         67
+#define A14                         68
+#define A15                         69
+
+#define NUM_DIGITAL_PINS            70
+
+//  Numery portow jak w pins_arduino.h (PA = 1 ... PL = 12, brak portu I).
+#define PA                          1
+#define PB                          2
+#define PC                          3
+#define PD                          4
+#define PE                          5
+#define PF                          6
+#define PG                          7
+#define PH                          8
+#define PJ                          10
+#define PK                          11
+#define PL                          12
+#define PORTS_COUNT                 13
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** TYPES & MACROS ***
+////////////////////////////////////////////////////////////////////////////////
+
+typedef uint8_t     byte;
+typedef bool        boolean;
+typedef uint16_t    word;
+
+#ifdef abs
+#undef abs
+#endif
+
+#define min(a, b)                   ((a) < (b) ? (a) : (b))
+#define max(a, b)                   ((a) > (b) ? (a) : (b))
+#define abs(x)                      ((x) > 0 ? (x) : -(x))
+#define constrain(x, low, high)     ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+#define sq(x)                       ((x) * (x))
+
+#define lowByte(w)                  ((uint8_t) ((w) & 0xff))
+#define highByte(w)                 ((uint8_t) ((w) >> 8))
+
+#define bit(b)                      (1UL << (b))
+#define bitRead(value, b)           (((value) >> (b)) & 0x01)
+#define bitSet(value, b)            ((value) |= (1UL << (b)))
+#define bitClear(value, b)          ((value) &= ~(1UL << (b)))
+#define bitWrite(value, b, v)       ((v) ? bitSet(value, b) : bitClear(value, b))
+
+#define digitalPinToInterrupt(p)    ((p) == 2 ? 0 : ((p) == 3 ? 1 : ((p) >= 18 && (p) <= 21 ? 23 - (p) : NOT_AN_INTERRUPT)))
+
+inline bool isDigit(int c)          { return isdigit(c) != 0; }
+inline bool isAlpha(int c)          { return isalpha(c) != 0; }
+inline bool isSpace(int c)          { return isspace(c) != 0; }
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CORE FUNCTIONS ***
+////////////////////////////////////////////////////////////////////////////////
+
+void            pinMode(uint8_t pin, uint8_t mode);
+void            digitalWrite(uint8_t pin, uint8_t value);
+int             digitalRead(uint8_t pin);
+int             analogRead(uint8_t pin);
+void            analogWrite(uint8_t pin, int value);
+
+unsigned long   millis();
+unsigned long   micros();
+void            delay(unsigned long ms);
+void            delayMicroseconds(unsigned int us);
+
+void            shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t bit_order, uint8_t value);
+void            tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void            noTone(uint8_t pin);
+
+void            attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void            detachInterrupt(uint8_t interrupt);
+
+long            map(long x, long in_min, long in_max, long out_min, long out_max);
+long            random(long max_value);
+long            random(long min_value, long max_value);
+void            randomSeed(unsigned long seed);
+
+uint8_t             digitalPinToPort(uint8_t pin);
+uint8_t             digitalPinToBitMask(uint8_t pin);
+volatile uint8_t  * portOutputRegister(uint8_t port);
+volatile uint8_t  * portInputRegister(uint8_t port);
+volatile uint8_t  * portModeRegister(uint8_t port);
+
+//  Wywolywane przez program symulatora.
+void            setup(void);
+void            loop(void);
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** HOST EXTENSIONS ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Sterta emulowana (bufory String i obiekty File) - odpowiednik __brkval i __flp avr-libc.
+size_t          hostHeapSize();     //  Najwieksza zajetosc sterty od uruchomienia (koniec sterty).
+size_t          hostHeapUsed();     //  Aktualnie zaalokowane bloki wraz z naglowkami.
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CORE CLASSES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+
+#endif
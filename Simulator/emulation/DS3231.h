@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - DS3231 LIBRARY (RINKYDINK ELECTRONICS)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DS3231_H
+#define DS3231_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define MONDAY          1
+#define TUESDAY         2
+#define WEDNESDAY       3
+#define THURSDAY        4
+#define FRIDAY          5
+#define SATURDAY        6
+#define SUNDAY          7
+
+#define OUTPUT_SQW      0
+#define OUTPUT_INT      1
+
+#define SQW_RATE_1      0
+#define SQW_RATE_1K     1
+#define SQW_RATE_4K     2
+#define SQW_RATE_8K     3
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class Time
+{
+    public:
+        uint8_t     hour;
+        uint8_t     min;
+        uint8_t     sec;
+        uint8_t     date;
+        uint8_t     mon;
+        uint16_t    year;
+        uint8_t     dow;
+
+        Time();
+};
+
+//  ----------------------------------------------------------------------------
+//  Zegar czasu rzeczywistego. Czas plynie razem z czasem wirtualnym emulatora od chwili
+//  ustawionej parametrem --rtc lub poleceniem skryptu "rtc".
+class DS3231
+{
+    public:
+        DS3231(uint8_t data_pin, uint8_t sclk_pin);
+
+        void    begin();
+        Time    getTime();
+        void    setTime(uint8_t hour, uint8_t min, uint8_t sec);
+        void    setDate(uint8_t date, uint8_t mon, uint16_t year);
+        void    setDOW();
+        void    setDOW(uint8_t dow);
+        long    getUnixTime(Time time);
+        float   getTemp();
+
+        void    enable32KHz(bool enable);
+        void    setOutput(byte enable);
+        void    setSQWRate(int rate);
+};
+
+#endif
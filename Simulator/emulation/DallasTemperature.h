@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - DALLAS TEMPERATURE LIBRARY (DS18B20)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DALLASTEMPERATURE_H
+#define DALLASTEMPERATURE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "OneWire.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define DEVICE_DISCONNECTED_C       -127
+#define DEVICE_DISCONNECTED_F       -196.6
+#define DEVICE_DISCONNECTED_RAW     -7040
+
+typedef uint8_t DeviceAddress[8];
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Czujniki DS18B20 emulowane na pinie magistrali. Konwersja trwa jak w ukladzie (94 - 750 ms
+//  zaleznie od rozdzielczosci); przed jej zakonczeniem odczyt zwraca poprzedni wynik.
+class DallasTemperature
+{
+    private:
+        OneWire   * bus;
+        bool        wait_for_conversion     =   true;
+
+    public:
+        DallasTemperature();
+        DallasTemperature(OneWire * bus);
+
+        void        setOneWire(OneWire * bus);
+        void        begin();
+
+        uint8_t     getDeviceCount();
+        bool        getAddress(uint8_t * address, uint8_t index);
+        bool        validAddress(const uint8_t * address);
+        bool        isConnected(const uint8_t * address);
+
+        uint8_t     getResolution();
+        void        setResolution(uint8_t resolution);
+        bool        setResolution(const uint8_t * address, uint8_t resolution, bool skip_global_calculation = false);
+
+        bool        getWaitForConversion()              { return this->wait_for_conversion; }
+        void        setWaitForConversion(bool wait)     { this->wait_for_conversion = wait; }
+        int16_t     millisToWaitForConversion(uint8_t resolution);
+        bool        isConversionComplete();
+
+        void        requestTemperatures();
+        bool        requestTemperaturesByAddress(const uint8_t * address);
+        int16_t     getTemp(const uint8_t * address);
+        float       getTempC(const uint8_t * address);
+        float       getTempCByIndex(uint8_t index);
+};
+
+#endif
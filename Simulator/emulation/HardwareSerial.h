@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO HARDWARE SERIAL
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HARDWARESERIAL_H
+#define HARDWARESERIAL_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Stream.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define SERIAL_RX_BUFFER_SIZE   64
+#define SERIAL_TX_BUFFER_SIZE   64
+
+#define SERIAL_8N1              0x06
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Port UART z buforami jak w rdzeniu Arduino (64 B). Bajty odbierane i wysylane sa w tempie
+//  wynikajacym z predkosci transmisji (10 bitow na bajt) wzgledem czasu wirtualnego - strona
+//  zewnetrzna portu (skrypt, konsola, emulowany modul HC-06) jest obslugiwana przez emulator.
+class HardwareSerial : public Stream
+{
+    private:
+        uint8_t     index;
+
+    public:
+        HardwareSerial(uint8_t index);
+
+        void    begin(unsigned long baudrate, uint8_t config = SERIAL_8N1);
+        void    end();
+
+        virtual int     available();
+        virtual int     availableForWrite();
+        virtual void    flush();
+        virtual int     peek();
+        virtual int     read();
+        virtual size_t  write(uint8_t value);
+        using Print::write;
+
+        operator bool()     { return true; }
+};
+
+extern HardwareSerial   Serial;
+extern HardwareSerial   Serial1;
+
+#endif
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - IRREMOTE LIBRARY (SENDER)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRREMOTE_H
+#define IRREMOTE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define DISABLE_LED_FEEDBACK            false
+#define ENABLE_LED_FEEDBACK             true
+#define USE_DEFAULT_FEEDBACK_LED_PIN    0
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Nadajnik IR - wyslane ramki NEC sa zapisywane w dzienniku emulatora (ramka 32 bity ~68 ms).
+class IRsend
+{
+    private:
+        uint8_t     pin     =   0;
+
+    public:
+        void    begin(uint8_t pin, bool enable_led_feedback, uint8_t feedback_led_pin);
+        void    sendNECRaw(uint32_t data, int_fast8_t repeats = 0);
+};
+
+extern IRsend IrSender;
+
+#endif
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - MAXMATRIX LIBRARY (MAX7219 CHAIN)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAXMATRIX_H
+#define MAXMATRIX_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define max7219_reg_noop            0x00
+#define max7219_reg_digit0          0x01
+#define max7219_reg_decodeMode      0x09
+#define max7219_reg_intensity       0x0a
+#define max7219_reg_scanLimit       0x0b
+#define max7219_reg_shutdown        0x0c
+#define max7219_reg_displayTest     0x0f
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Biblioteka MaxMatrix w wersji oryginalnej - komunikacja przez digitalWrite i shiftOut.
+//  Uklady MAX7219 sa emulowane na poziomie pinow (DIN, CLK, LOAD), wiec obraz i liczniki
+//  zapisow nie zaleza od tego, czy oprogramowanie uzywa biblioteki, czy wlasnej transmisji.
+class MaxMatrix
+{
+    private:
+        byte    data;
+        byte    load;
+        byte    clock;
+        byte    num;
+        byte    buffer[80];
+
+        void    reload();
+
+    public:
+        MaxMatrix(byte data, byte load, byte clock, byte num);
+
+        void    init();
+        void    clear();
+        void    setCommand(byte command, byte value);
+        void    setIntensity(byte intensity);
+        void    setColumn(byte col, byte value);
+        void    setColumnAll(byte col, byte value);
+        void    setDot(byte col, byte row, byte value);
+        void    writeSprite(int x, int y, const byte * sprite);
+
+        void    shiftLeft(bool rotate = false, bool fill_zero = true);
+        void    shiftRight(bool rotate = false, bool fill_zero = true);
+};
+
+#endif
@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ONEWIRE LIBRARY
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ONEWIRE_H
+#define ONEWIRE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Magistrala 1-Wire - emulowane sa tylko operacje uzywane przez DallasTemperature
+//  (czujniki sa przypisane do pinu magistrali w emulatorze).
+class OneWire
+{
+    private:
+        uint8_t     pin;
+
+    public:
+        OneWire(uint8_t pin);
+
+        uint8_t     getPin()    { return this->pin; }
+
+        static uint8_t  crc8(const uint8_t * address, uint8_t length);
+};
+
+#endif
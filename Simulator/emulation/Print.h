@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO PRINT
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PRINT_H
+#define PRINT_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odpowiednik klasy Print rdzenia Arduino - formatowanie liczb i tekstow na strumien bajtow.
+class Print
+{
+    private:
+        int     write_error = 0;
+
+        size_t  PrintNumber(unsigned long value, uint8_t base);
+        size_t  PrintFloat(double value, uint8_t digits);
+
+    protected:
+        void    setWriteError(int error = 1)    { this->write_error = error; }
+
+    public:
+        virtual ~Print() {}
+
+        int     getWriteError()                 { return this->write_error; }
+        void    clearWriteError()               { this->setWriteError(0); }
+
+        virtual size_t  write(uint8_t value) = 0;
+        virtual size_t  write(const uint8_t * buffer, size_t size);
+        virtual int     availableForWrite()     { return 0; }
+        virtual void    flush()                 {}
+
+        size_t  write(const char * text)                        { return text != NULL ? this->write((const uint8_t *) text, strlen(text)) : 0; }
+        size_t  write(const char * buffer, size_t size)         { return this->write((const uint8_t *) buffer, size); }
+
+        size_t  print(const __FlashStringHelper * text);
+        size_t  print(const String & text);
+        size_t  print(const char * text);
+        size_t  print(char c);
+        size_t  print(unsigned char value, int base = DEC);
+        size_t  print(int value, int base = DEC);
+        size_t  print(unsigned int value, int base = DEC);
+        size_t  print(long value, int base = DEC);
+        size_t  print(unsigned long value, int base = DEC);
+        size_t  print(double value, int digits = 2);
+
+        size_t  println(const __FlashStringHelper * text);
+        size_t  println(const String & text);
+        size_t  println(const char * text);
+        size_t  println(char c);
+        size_t  println(unsigned char value, int base = DEC);
+        size_t  println(int value, int base = DEC);
+        size_t  println(unsigned int value, int base = DEC);
+        size_t  println(long value, int base = DEC);
+        size_t  println(unsigned long value, int base = DEC);
+        size_t  println(double value, int digits = 2);
+        size_t  println();
+};
+
+#endif
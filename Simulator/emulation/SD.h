@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - SD LIBRARY
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SD_H
+#define SD_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "utility/SdFat.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define FILE_READ   O_READ
+#define FILE_WRITE  (O_READ | O_WRITE | O_CREAT | O_APPEND)
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Plik biblioteki SD. Jak w oryginale przechowuje wskaznik na kopie SdFile alokowana na
+//  stercie (malloc) - kopie obiektu File wspoldziela ten sam plik, a close() zwalnia pamiec.
+//  Klasa SDClass nie jest emulowana - oprogramowanie montuje karte przez SdVolume i SdFile.
+class File : public Stream
+{
+    private:
+        char        file_name[13];
+        SdFile    * file;
+
+    public:
+        File(SdFile file, const char * name);
+        File();
+
+        virtual size_t  write(uint8_t value);
+        virtual size_t  write(const uint8_t * buffer, size_t size);
+        virtual int     availableForWrite();
+        virtual int     read();
+        virtual int     peek();
+        virtual int     available();
+        virtual void    flush();
+
+        int         read(void * buffer, uint16_t size);
+        bool        seek(uint32_t position);
+        uint32_t    position();
+        uint32_t    size();
+        void        close();
+        operator    bool();
+        char      * name()          { return this->file_name; }
+        bool        isDirectory()   { return this->file != NULL && this->file->isDir(); }
+        using Print::write;
+};
+
+#endif
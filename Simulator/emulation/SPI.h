@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - SPI LIBRARY
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPI_H
+#define SPI_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define SPI_MODE0   0x00
+#define SPI_MODE1   0x04
+#define SPI_MODE2   0x08
+#define SPI_MODE3   0x0C
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class SPISettings
+{
+    public:
+        uint32_t    clock;
+        uint8_t     bit_order;
+        uint8_t     data_mode;
+
+        SPISettings() : clock(4000000), bit_order(MSBFIRST), data_mode(SPI_MODE0) {}
+        SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode) : clock(clock), bit_order(bit_order), data_mode(data_mode) {}
+};
+
+//  ----------------------------------------------------------------------------
+//  Magistrala SPI - transakcje sa zliczane, transfer trwa 8 taktow zegara SPI.
+class SPIClass
+{
+    public:
+        static void     begin();
+        static void     end();
+        static void     beginTransaction(SPISettings settings);
+        static void     endTransaction();
+        static uint8_t  transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO STREAM
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STREAM_H
+#define STREAM_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Print.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odpowiednik klasy Stream rdzenia Arduino. Oczekiwanie na dane (timedRead) przesuwa czas
+//  wirtualny do kolejnego zdarzenia emulatora zamiast aktywnego czekania.
+class Stream : public Print
+{
+    protected:
+        unsigned long   timeout     =   1000;
+
+        int     timedRead();
+
+    public:
+        virtual int     available() = 0;
+        virtual int     read() = 0;
+        virtual int     peek() = 0;
+
+        void            setTimeout(unsigned long timeout)   { this->timeout = timeout; }
+        unsigned long   getTimeout()                        { return this->timeout; }
+
+        size_t  readBytes(char * buffer, size_t length);
+        size_t  readBytes(uint8_t * buffer, size_t length)  { return this->readBytes((char *) buffer, length); }
+        size_t  readBytesUntil(char terminator, char * buffer, size_t length);
+        String  readString();
+        String  readStringUntil(char terminator);
+};
+
+#endif
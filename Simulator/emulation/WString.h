@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO STRING
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WSTRING_H
+#define WSTRING_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include "avr/pgmspace.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+class __FlashStringHelper;
+#define F(text)     (reinterpret_cast<const __FlashStringHelper *>(PSTR(text)))
+
+class StringSumHelper;
+
+//  Odpowiednik klasy String rdzenia Arduino (WString.cpp) - bufor na stercie emulowanej,
+//  dzieki czemu alokacje tekstow sa widoczne w statystykach pamieci.
+class String
+{
+    private:
+        char          * buffer      =   NULL;
+        unsigned int    capacity    =   0;
+        unsigned int    len         =   0;
+
+        bool            ChangeBuffer(unsigned int size);
+        String        & Copy(const char * text, unsigned int length);
+        void            Invalidate();
+        void            Move(String & other);
+
+    public:
+        String(const char * text = "");
+        String(const char * text, unsigned int length);
+        String(const String & other);
+        String(String && other);
+        String(const __FlashStringHelper * text);
+        explicit String(char c);
+        explicit String(unsigned char value, unsigned char base = 10);
+        explicit String(int value, unsigned char base = 10);
+        explicit String(unsigned int value, unsigned char base = 10);
+        explicit String(long value, unsigned char base = 10);
+        explicit String(unsigned long value, unsigned char base = 10);
+        explicit String(float value, unsigned char decimals = 2);
+        explicit String(double value, unsigned char decimals = 2);
+        ~String();
+
+        String & operator = (const String & other);
+        String & operator = (String && other);
+        String & operator = (const char * text);
+        String & operator = (const __FlashStringHelper * text);
+
+        bool            reserve(unsigned int size);
+        unsigned int    length() const                  { return this->len; }
+        const char    * c_str() const                   { return this->buffer != NULL ? this->buffer : ""; }
+        bool            isEmpty() const                 { return this->len == 0; }
+
+        bool    concat(const String & other);
+        bool    concat(const char * text);
+        bool    concat(const char * text, unsigned int length);
+        bool    concat(const __FlashStringHelper * text);
+        bool    concat(char c);
+        bool    concat(unsigned char value);
+        bool    concat(int value);
+        bool    concat(unsigned int value);
+        bool    concat(long value);
+        bool    concat(unsigned long value);
+        bool    concat(float value);
+        bool    concat(double value);
+
+        String & operator += (const String & other)               { this->concat(other); return *this; }
+        String & operator += (const char * text)                  { this->concat(text); return *this; }
+        String & operator += (const __FlashStringHelper * text)   { this->concat(text); return *this; }
+        String & operator += (char c)                             { this->concat(c); return *this; }
+        String & operator += (unsigned char value)                { this->concat(value); return *this; }
+        String & operator += (int value)                          { this->concat(value); return *this; }
+        String & operator += (unsigned int value)                 { this->concat(value); return *this; }
+        String & operator += (long value)                         { this->concat(value); return *this; }
+        String & operator += (unsigned long value)                { this->concat(value); return *this; }
+        String & operator += (float value)                        { this->concat(value); return *this; }
+        String & operator += (double value)                       { this->concat(value); return *this; }
+
+        friend StringSumHelper & operator + (const StringSumHelper & left, const String & right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, const char * right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, const __FlashStringHelper * right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, char right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, unsigned char right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, int right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, unsigned int right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, long right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, unsigned long right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, float right);
+        friend StringSumHelper & operator + (const StringSumHelper & left, double right);
+
+        int     compareTo(const String & other) const;
+        bool    equals(const String & other) const;
+        bool    equals(const char * text) const;
+        bool    equalsIgnoreCase(const String & other) const;
+        bool    operator == (const String & other) const    { return this->equals(other); }
+        bool    operator == (const char * text) const       { return this->equals(text); }
+        bool    operator != (const String & other) const    { return !this->equals(other); }
+        bool    operator != (const char * text) const       { return !this->equals(text); }
+        bool    operator < (const String & other) const     { return this->compareTo(other) < 0; }
+        bool    operator > (const String & other) const     { return this->compareTo(other) > 0; }
+        bool    startsWith(const String & prefix) const;
+        bool    startsWith(const String & prefix, unsigned int offset) const;
+        bool    endsWith(const String & suffix) const;
+
+        char    charAt(unsigned int index) const;
+        void    setCharAt(unsigned int index, char c);
+        char    operator [] (unsigned int index) const;
+        char  & operator [] (unsigned int index);
+        void    getBytes(unsigned char * destination, unsigned int size, unsigned int index = 0) const;
+        void    toCharArray(char * destination, unsigned int size, unsigned int index = 0) const;
+
+        int     indexOf(char c) const;
+        int     indexOf(char c, unsigned int from) const;
+        int     indexOf(const String & text) const;
+        int     indexOf(const String & text, unsigned int from) const;
+        int     lastIndexOf(char c) const;
+        int     lastIndexOf(char c, unsigned int from) const;
+        int     lastIndexOf(const String & text) const;
+        int     lastIndexOf(const String & text, unsigned int from) const;
+        String  substring(unsigned int begin) const;
+        String  substring(unsigned int begin, unsigned int end) const;
+
+        void    replace(char find, char replacement);
+        void    replace(const String & find, const String & replacement);
+        void    remove(unsigned int index);
+        void    remove(unsigned int index, unsigned int count);
+        void    toLowerCase();
+        void    toUpperCase();
+        void    trim();
+
+        long    toInt() const;
+        float   toFloat() const;
+        double  toDouble() const;
+};
+
+//  ----------------------------------------------------------------------------
+//  Wynik tymczasowy operatora + (lancuch "a" + b + c modyfikuje jeden obiekt).
+class StringSumHelper : public String
+{
+    public:
+        StringSumHelper(const String & text) : String(text) {}
+        StringSumHelper(const char * text) : String(text) {}
+        StringSumHelper(char c) : String(c) {}
+        StringSumHelper(unsigned char value) : String(value) {}
+        StringSumHelper(int value) : String(value) {}
+        StringSumHelper(unsigned int value) : String(value) {}
+        StringSumHelper(long value) : String(value) {}
+        StringSumHelper(unsigned long value) : String(value) {}
+        StringSumHelper(float value) : String(value) {}
+        StringSumHelper(double value) : String(value) {}
+};
+
+inline bool operator == (const char * left, const String & right)  { return right.equals(left); }
+inline bool operator != (const char * left, const String & right)  { return !right.equals(left); }
+
+#endif
@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - AVR INTERRUPTS
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+#include "io.h"
+
+//  Emulator wykonuje program w jednym watku - przerwania sa wywolywane w funkcjach emulatora
+//  (uplyw czasu wirtualnego), o ile flaga I rejestru SREG jest ustawiona.
+void    cli();
+void    sei();
+
+#define noInterrupts()  cli()
+#define interrupts()    sei()
+
+#endif
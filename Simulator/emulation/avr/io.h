@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - AVR REGISTERS (ATMEGA2560 SUBSET)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** REGISTERS ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Emulowane sa tylko rejestry uzywane przez oprogramowanie: SREG (flaga przerwan) oraz Timer5
+//  (skanowanie klawiatury). Przerwanie porownania Timer5 jest wywolywane przez emulator wraz
+//  z uplywem czasu wirtualnego, gdy flaga I rejestru SREG jest ustawiona.
+extern volatile uint8_t     emulated_sreg;
+extern volatile uint8_t     emulated_tccr5a;
+extern volatile uint8_t     emulated_tccr5b;
+extern volatile uint16_t    emulated_tcnt5;
+extern volatile uint16_t    emulated_ocr5a;
+extern volatile uint8_t     emulated_timsk5;
+
+#define SREG                emulated_sreg
+#define SREG_I              7
+
+#define TCCR5A              emulated_tccr5a
+#define TCCR5B              emulated_tccr5b
+#define TCNT5               emulated_tcnt5
+#define OCR5A               emulated_ocr5a
+#define TIMSK5              emulated_timsk5
+
+#define CS50                0
+#define CS51                1
+#define CS52                2
+#define WGM52               3
+#define OCIE5A              1
+
+#ifndef _BV
+#define _BV(bit)            (1 << (bit))
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INTERRUPT VECTORS ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define ISR(vector)         extern "C" void vector(void)
+
+extern "C" void TIMER5_COMPA_vect(void) __attribute__((weak));
+
+#endif
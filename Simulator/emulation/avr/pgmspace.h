@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - AVR PROGRAM MEMORY
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVR_PGMSPACE_H
+#define AVR_PGMSPACE_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Na komputerze pamiec programu i RAM to ta sama przestrzen adresowa.
+#define PROGMEM
+#define PGM_P                   const char *
+#define PSTR(s)                 (s)
+
+#define pgm_read_byte(address)  (*(const uint8_t *) (address))
+#define pgm_read_word(address)  (*(const uint16_t *) (address))
+#define pgm_read_dword(address) (*(const uint32_t *) (address))
+#define pgm_read_float(address) (*(const float *) (address))
+#define pgm_read_ptr(address)   (*(const void * const *) (address))
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** FUNCTIONS ***
+////////////////////////////////////////////////////////////////////////////////
+
+inline void * memcpy_P(void * destination, const void * source, size_t size)           { return memcpy(destination, source, size); }
+inline size_t strlen_P(const char * text)                                              { return strlen(text); }
+inline size_t strnlen_P(const char * text, size_t size)                                { return strnlen(text, size); }
+inline char * strcpy_P(char * destination, const char * source)                        { return strcpy(destination, source); }
+inline char * strncpy_P(char * destination, const char * source, size_t size)          { return strncpy(destination, source, size); }
+inline char * strcat_P(char * destination, const char * source)                        { return strcat(destination, source); }
+inline int    strcmp_P(const char * a, const char * b)                                 { return strcmp(a, b); }
+inline int    strncmp_P(const char * a, const char * b, size_t size)                   { return strncmp(a, b, size); }
+inline int    strcasecmp_P(const char * a, const char * b)                             { return strcasecmp(a, b); }
+inline int    strncasecmp_P(const char * a, const char * b, size_t size)               { return strncasecmp(a, b, size); }
+inline const char * strstr_P(const char * text, const char * pattern)                  { return strstr(text, pattern); }
+
+__attribute__((format(printf, 3, 0)))
+inline int vsnprintf_P(char * buffer, size_t size, const char * format, va_list args)  { return vsnprintf(buffer, size, format, args); }
+
+__attribute__((format(printf, 3, 4)))
+inline int snprintf_P(char * buffer, size_t size, const char * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int result = vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
+
+__attribute__((format(printf, 2, 3)))
+inline int sprintf_P(char * buffer, const char * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int result = vsprintf(buffer, format, args);
+    va_end(args);
+    return result;
+}
+
+#endif
@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - AVR SLEEP MODES
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE         0
+#define SLEEP_MODE_PWR_DOWN     2
+
+//  Uspienie przesuwa czas emulacji do najblizszego przerwania (Timer0 co 1 ms lub dane UART).
+void    set_sleep_mode(uint8_t mode);
+void    sleep_enable();
+void    sleep_disable();
+void    sleep_cpu();
+
+#endif
@@ -0,0 +1,1223 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - ARDUINO CORE IMPLEMENTATION
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include "emulator.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** REGISTERS ***
+////////////////////////////////////////////////////////////////////////////////
+
+volatile uint8_t    emulated_sreg       =   _BV(SREG_I);    //  init() rdzenia wlacza przerwania.
+volatile uint8_t    emulated_tccr5a     =   0;
+volatile uint8_t    emulated_tccr5b     =   0;
+volatile uint16_t   emulated_tcnt5      =   0;
+volatile uint16_t   emulated_ocr5a      =   0;
+volatile uint8_t    emulated_timsk5     =   0;
+
+//  Rejestry portow (indeks = numer portu z pins_arduino.h).
+volatile uint8_t    port_output[PORTS_COUNT];
+volatile uint8_t    port_input[PORTS_COUNT];
+volatile uint8_t    port_mode[PORTS_COUNT];
+
+//  Port i bit kazdego pinu Arduino Mega 2560 (pins_arduino.h, wariant "mega").
+static const uint8_t PIN_PORT[NUM_DIGITAL_PINS] = {
+    PE, PE, PE, PE, PG, PE, PH, PH, PH, PH, PB, PB, PB, PB, PJ, PJ,     //  0 - 15
+    PH, PH, PD, PD, PD, PD, PA, PA, PA, PA, PA, PA, PA, PA, PC, PC,     //  16 - 31
+    PC, PC, PC, PC, PC, PC, PD, PG, PG, PG, PL, PL, PL, PL, PL, PL,     //  32 - 47
+    PL, PL, PB, PB, PB, PB, PF, PF, PF, PF, PF, PF, PF, PF, PK, PK,     //  48 - 63
+    PK, PK, PK, PK, PK, PK                                              //  64 - 69
+};
+
+static const uint8_t PIN_BIT[NUM_DIGITAL_PINS] = {
+    0, 1, 4, 5, 5, 3, 3, 4, 5, 6, 4, 5, 6, 7, 1, 0,     //  0 - 15
+    1, 0, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 7, 6,     //  16 - 31
+    5, 4, 3, 2, 1, 0, 7, 2, 1, 0, 7, 6, 5, 4, 3, 2,     //  32 - 47
+    1, 0, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1,     //  48 - 63
+    2, 3, 4, 5, 6, 7                                    //  64 - 69
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** DIGITAL & ANALOG I/O ***
+////////////////////////////////////////////////////////////////////////////////
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+    return pin < NUM_DIGITAL_PINS ? PIN_PORT[pin] : NOT_A_PORT;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+    return pin < NUM_DIGITAL_PINS ? (uint8_t) (1 << PIN_BIT[pin]) : 0;
+}
+
+//  ----------------------------------------------------------------------------
+volatile uint8_t * portOutputRegister(uint8_t port)
+{
+    return &port_output[port < PORTS_COUNT ? port : 0];
+}
+
+//  ----------------------------------------------------------------------------
+volatile uint8_t * portInputRegister(uint8_t port)
+{
+    return &port_input[port < PORTS_COUNT ? port : 0];
+}
+
+//  ----------------------------------------------------------------------------
+volatile uint8_t * portModeRegister(uint8_t port)
+{
+    return &port_mode[port < PORTS_COUNT ? port : 0];
+}
+
+//  ----------------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+        return;
+
+    uint8_t port = PIN_PORT[pin];
+    uint8_t mask = digitalPinToBitMask(pin);
+
+    if (mode == OUTPUT)
+        port_mode[port] |= mask;
+    else
+    {
+        port_mode[port] &= ~mask;
+
+        if (mode == INPUT_PULLUP)
+            port_output[port] |= mask;
+        else
+            port_output[port] &= ~mask;
+    }
+
+    Emulator::Charge(EMULATOR_COST_DIGITAL_IO);
+}
+
+//  ----------------------------------------------------------------------------
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+        return;
+
+    uint8_t port = PIN_PORT[pin];
+    uint8_t mask = digitalPinToBitMask(pin);
+
+    if (value == LOW)
+        port_output[port] &= ~mask;
+    else
+        port_output[port] |= mask;
+
+    Emulator::OnPinWrite(pin);
+    Emulator::Charge(EMULATOR_COST_DIGITAL_IO);
+}
+
+//  ----------------------------------------------------------------------------
+int digitalRead(uint8_t pin)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+        return LOW;
+
+    Emulator::Charge(EMULATOR_COST_DIGITAL_IO);
+    Emulator::UpdateInputs();
+
+    return (port_input[PIN_PORT[pin]] & digitalPinToBitMask(pin)) ? HIGH : LOW;
+}
+
+//  ----------------------------------------------------------------------------
+int analogRead(uint8_t pin)
+{
+    Emulator::Charge(EMULATOR_COST_ANALOG_READ);
+    return Emulator::ReadAnalog(pin < A0 ? pin + A0 : pin);
+}
+
+//  ----------------------------------------------------------------------------
+void analogWrite(uint8_t pin, int value)
+{
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, value >= 128 ? HIGH : LOW);
+}
+
+//  ----------------------------------------------------------------------------
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t bit_order, uint8_t value)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (bit_order == LSBFIRST)
+            digitalWrite(data_pin, (value >> i) & 1);
+        else
+            digitalWrite(data_pin, (value >> (7 - i)) & 1);
+
+        digitalWrite(clock_pin, HIGH);
+        digitalWrite(clock_pin, LOW);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration)
+{
+    Emulator::Charge(EMULATOR_COST_DIGITAL_IO);
+    Emulator::Tone(pin, frequency, duration);
+}
+
+//  ----------------------------------------------------------------------------
+void noTone(uint8_t pin)
+{
+    Emulator::Charge(EMULATOR_COST_DIGITAL_IO);
+    Emulator::Tone(pin, 0, 0);
+}
+
+//  ----------------------------------------------------------------------------
+//  Przerwania zewnetrzne nie sa emulowane (wyjscie SQW zegara nie jest podlaczone).
+void attachInterrupt(uint8_t /* interrupt */, void (* /* handler */)(void), int /* mode */)
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+}
+
+//  ----------------------------------------------------------------------------
+void detachInterrupt(uint8_t /* interrupt */)
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** TIME & INTERRUPTS ***
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned long millis()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return (unsigned long) (Emulator::Now() / 1000);
+}
+
+//  ----------------------------------------------------------------------------
+unsigned long micros()
+{
+    Emulator::Charge(EMULATOR_COST_MICROS);
+    return (unsigned long) Emulator::Now();
+}
+
+//  ----------------------------------------------------------------------------
+void delay(unsigned long ms)
+{
+    Emulator::AdvanceTo(Emulator::Now() + (uint64_t) ms * 1000);
+}
+
+//  ----------------------------------------------------------------------------
+void delayMicroseconds(unsigned int us)
+{
+    Emulator::Charge(us > 0 ? us : EMULATOR_COST_CALL);
+    Emulator::UpdateInputs();
+}
+
+//  ----------------------------------------------------------------------------
+void cli()
+{
+    SREG &= ~_BV(SREG_I);
+}
+
+//  ----------------------------------------------------------------------------
+void sei()
+{
+    SREG |= _BV(SREG_I);
+    Emulator::OnInterruptsEnabled();
+}
+
+//  ----------------------------------------------------------------------------
+void set_sleep_mode(uint8_t /* mode */)
+{
+}
+
+//  ----------------------------------------------------------------------------
+void sleep_enable()
+{
+}
+
+//  ----------------------------------------------------------------------------
+void sleep_disable()
+{
+}
+
+//  ----------------------------------------------------------------------------
+//  Uspienie do najblizszego przerwania (Timer0 co 1 ms, Timer5, dane UART).
+void sleep_cpu()
+{
+    Emulator::Sleep();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** MATH ***
+////////////////////////////////////////////////////////////////////////////////
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+//  ----------------------------------------------------------------------------
+//  Generator liniowy z ustalonym ziarnem - przebiegi symulacji sa powtarzalne.
+static unsigned long random_state = 1;
+
+long random(long max_value)
+{
+    if (max_value <= 0)
+        return 0;
+
+    random_state = random_state * 1103515245UL + 12345UL;
+    return (long) ((random_state >> 16) & 0x7FFFFFFF) % max_value;
+}
+
+//  ----------------------------------------------------------------------------
+long random(long min_value, long max_value)
+{
+    if (min_value >= max_value)
+        return min_value;
+
+    return random(max_value - min_value) + min_value;
+}
+
+//  ----------------------------------------------------------------------------
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0)
+        random_state = seed;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRING ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Zmiana rozmiaru bufora (jak String::changeBuffer - realloc na stercie).
+bool String::ChangeBuffer(unsigned int size)
+{
+    char * buffer = (char *) Emulator::HeapReallocate(this->buffer, size + 1);
+
+    if (buffer == NULL)
+        return false;
+
+    this->buffer = buffer;
+    this->capacity = size;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+String & String::Copy(const char * text, unsigned int length)
+{
+    if (!this->reserve(length))
+    {
+        this->Invalidate();
+        return *this;
+    }
+
+    this->len = length;
+    memcpy(this->buffer, text, length);
+    this->buffer[length] = '\0';
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+void String::Invalidate()
+{
+    if (this->buffer != NULL)
+        Emulator::HeapRelease(this->buffer);
+
+    this->buffer = NULL;
+    this->capacity = 0;
+    this->len = 0;
+}
+
+//  ----------------------------------------------------------------------------
+void String::Move(String & other)
+{
+    if (this == &other)
+        return;
+
+    if (this->buffer != NULL)
+        Emulator::HeapRelease(this->buffer);
+
+    this->buffer = other.buffer;
+    this->capacity = other.capacity;
+    this->len = other.len;
+
+    other.buffer = NULL;
+    other.capacity = 0;
+    other.len = 0;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(const char * text)
+{
+    if (text != NULL)
+        this->Copy(text, strlen(text));
+}
+
+//  ----------------------------------------------------------------------------
+String::String(const char * text, unsigned int length)
+{
+    if (text != NULL)
+        this->Copy(text, length);
+}
+
+//  ----------------------------------------------------------------------------
+String::String(const String & other)
+{
+    *this = other;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(String && other)
+{
+    this->Move(other);
+}
+
+//  ----------------------------------------------------------------------------
+String::String(const __FlashStringHelper * text)
+{
+    if (text != NULL)
+        this->Copy((const char *) text, strlen((const char *) text));
+}
+
+//  ----------------------------------------------------------------------------
+String::String(char c)
+{
+    char text[2] = { c, '\0' };
+    this->Copy(text, c != '\0' ? 1 : 0);
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis liczby w podanym systemie liczbowym (jak ultoa / ltoa).
+static void FormatNumber(char * text, unsigned long value, bool negative, unsigned char base)
+{
+    char digits[34];
+    int count = 0;
+
+    if (base < 2 || base > 36)
+        base = 10;
+
+    do
+    {
+        int digit = value % base;
+        digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    }
+    while (value > 0);
+
+    if (negative)
+        *text++ = '-';
+
+    while (count > 0)
+        *text++ = digits[--count];
+
+    *text = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+String::String(unsigned char value, unsigned char base)
+{
+    char text[34];
+    FormatNumber(text, value, false, base);
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+//  Liczby ze znakiem zapisywane sa w systemie dziesietnym z minusem, w innych jako uzupelnienie.
+String::String(int value, unsigned char base)
+{
+    char text[34];
+
+    if (base == DEC)
+        FormatNumber(text, value < 0 ? -(long) value : value, value < 0, base);
+    else
+        FormatNumber(text, (unsigned int) value, false, base);
+
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(unsigned int value, unsigned char base)
+{
+    char text[34];
+    FormatNumber(text, value, false, base);
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(long value, unsigned char base)
+{
+    char text[34];
+
+    if (base == DEC)
+        FormatNumber(text, value < 0 ? -(unsigned long) value : value, value < 0, base);
+    else
+        FormatNumber(text, (unsigned long) value, false, base);
+
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(unsigned long value, unsigned char base)
+{
+    char text[34];
+    FormatNumber(text, value, false, base);
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(float value, unsigned char decimals)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, (double) value);
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::String(double value, unsigned char decimals)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    *this = text;
+}
+
+//  ----------------------------------------------------------------------------
+String::~String()
+{
+    if (this->buffer != NULL)
+        Emulator::HeapRelease(this->buffer);
+}
+
+//  ----------------------------------------------------------------------------
+String & String::operator = (const String & other)
+{
+    if (this == &other)
+        return *this;
+
+    if (other.buffer != NULL)
+        this->Copy(other.buffer, other.len);
+    else
+        this->Invalidate();
+
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+String & String::operator = (String && other)
+{
+    this->Move(other);
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+String & String::operator = (const char * text)
+{
+    if (text != NULL)
+        this->Copy(text, strlen(text));
+    else
+        this->Invalidate();
+
+    return *this;
+}
+
+//  ----------------------------------------------------------------------------
+String & String::operator = (const __FlashStringHelper * text)
+{
+    return *this = (const char *) text;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::reserve(unsigned int size)
+{
+    if (this->buffer != NULL && this->capacity >= size)
+        return true;
+
+    if (!this->ChangeBuffer(size))
+        return false;
+
+    if (this->len == 0)
+        this->buffer[0] = '\0';
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(const char * text, unsigned int length)
+{
+    unsigned int new_length = this->len + length;
+
+    if (text == NULL)
+        return false;
+
+    if (length == 0)
+        return true;
+
+    if (!this->reserve(new_length))
+        return false;
+
+    memmove(this->buffer + this->len, text, length);
+    this->len = new_length;
+    this->buffer[new_length] = '\0';
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(const String & other)
+{
+    return this->concat(other.c_str(), other.len);
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(const char * text)
+{
+    return text != NULL && this->concat(text, strlen(text));
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(const __FlashStringHelper * text)
+{
+    return this->concat((const char *) text);
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(char c)
+{
+    return this->concat(&c, 1);
+}
+
+//  ----------------------------------------------------------------------------
+bool String::concat(unsigned char value)    { return this->concat(String(value)); }
+bool String::concat(int value)              { return this->concat(String(value)); }
+bool String::concat(unsigned int value)     { return this->concat(String(value)); }
+bool String::concat(long value)             { return this->concat(String(value)); }
+bool String::concat(unsigned long value)    { return this->concat(String(value)); }
+bool String::concat(float value)            { return this->concat(String(value)); }
+bool String::concat(double value)           { return this->concat(String(value)); }
+
+//  ----------------------------------------------------------------------------
+StringSumHelper & operator + (const StringSumHelper & left, const String & right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, const char * right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, const __FlashStringHelper * right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, char right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, unsigned char right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, int right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, unsigned int right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, long right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, unsigned long right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, float right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+StringSumHelper & operator + (const StringSumHelper & left, double right)
+{
+    StringSumHelper & result = const_cast<StringSumHelper &>(left);
+    result.concat(right);
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+int String::compareTo(const String & other) const
+{
+    return strcmp(this->c_str(), other.c_str());
+}
+
+//  ----------------------------------------------------------------------------
+bool String::equals(const String & other) const
+{
+    return this->len == other.len && this->compareTo(other) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::equals(const char * text) const
+{
+    return strcmp(this->c_str(), text != NULL ? text : "") == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::equalsIgnoreCase(const String & other) const
+{
+    return this->len == other.len && strcasecmp(this->c_str(), other.c_str()) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::startsWith(const String & prefix) const
+{
+    return this->len >= prefix.len && strncmp(this->c_str(), prefix.c_str(), prefix.len) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::startsWith(const String & prefix, unsigned int offset) const
+{
+    return offset <= this->len && this->len - offset >= prefix.len
+        && strncmp(this->c_str() + offset, prefix.c_str(), prefix.len) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool String::endsWith(const String & suffix) const
+{
+    return this->len >= suffix.len && strcmp(this->c_str() + this->len - suffix.len, suffix.c_str()) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+char String::charAt(unsigned int index) const
+{
+    return (*this)[index];
+}
+
+//  ----------------------------------------------------------------------------
+void String::setCharAt(unsigned int index, char c)
+{
+    if (index < this->len)
+        this->buffer[index] = c;
+}
+
+//  ----------------------------------------------------------------------------
+char String::operator [] (unsigned int index) const
+{
+    return index < this->len ? this->buffer[index] : '\0';
+}
+
+//  ----------------------------------------------------------------------------
+char & String::operator [] (unsigned int index)
+{
+    static char dummy_writable_char;
+
+    if (index >= this->len)
+    {
+        dummy_writable_char = '\0';
+        return dummy_writable_char;
+    }
+
+    return this->buffer[index];
+}
+
+//  ----------------------------------------------------------------------------
+void String::getBytes(unsigned char * destination, unsigned int size, unsigned int index) const
+{
+    if (size == 0 || destination == NULL)
+        return;
+
+    if (index >= this->len)
+    {
+        destination[0] = '\0';
+        return;
+    }
+
+    unsigned int count = size - 1;
+
+    if (count > this->len - index)
+        count = this->len - index;
+
+    memcpy(destination, this->buffer + index, count);
+    destination[count] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+void String::toCharArray(char * destination, unsigned int size, unsigned int index) const
+{
+    this->getBytes((unsigned char *) destination, size, index);
+}
+
+//  ----------------------------------------------------------------------------
+int String::indexOf(char c) const
+{
+    return this->indexOf(c, 0);
+}
+
+//  ----------------------------------------------------------------------------
+int String::indexOf(char c, unsigned int from) const
+{
+    if (from >= this->len)
+        return -1;
+
+    const char * found = strchr(this->buffer + from, c);
+    return found != NULL ? (int) (found - this->buffer) : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int String::indexOf(const String & text) const
+{
+    return this->indexOf(text, 0);
+}
+
+//  ----------------------------------------------------------------------------
+int String::indexOf(const String & text, unsigned int from) const
+{
+    if (from >= this->len)
+        return -1;
+
+    const char * found = strstr(this->buffer + from, text.c_str());
+    return found != NULL ? (int) (found - this->buffer) : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int String::lastIndexOf(char c) const
+{
+    return this->len > 0 ? this->lastIndexOf(c, this->len - 1) : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int String::lastIndexOf(char c, unsigned int from) const
+{
+    if (from >= this->len)
+        return -1;
+
+    for (int i = from; i >= 0; i--)
+        if (this->buffer[i] == c)
+            return i;
+
+    return -1;
+}
+
+//  ----------------------------------------------------------------------------
+int String::lastIndexOf(const String & text) const
+{
+    return this->len >= text.len ? this->lastIndexOf(text, this->len - text.len) : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int String::lastIndexOf(const String & text, unsigned int from) const
+{
+    if (text.len == 0 || this->len == 0 || text.len > this->len)
+        return -1;
+
+    if (from >= this->len)
+        from = this->len - 1;
+
+    for (int i = from; i >= 0; i--)
+        if (strncmp(this->buffer + i, text.c_str(), text.len) == 0)
+            return i;
+
+    return -1;
+}
+
+//  ----------------------------------------------------------------------------
+String String::substring(unsigned int begin) const
+{
+    return this->substring(begin, this->len);
+}
+
+//  ----------------------------------------------------------------------------
+String String::substring(unsigned int begin, unsigned int end) const
+{
+    if (begin > end)
+    {
+        unsigned int temp = end;
+        end = begin;
+        begin = temp;
+    }
+
+    if (begin >= this->len)
+        return String();
+
+    if (end > this->len)
+        end = this->len;
+
+    return String(this->buffer + begin, end - begin);
+}
+
+//  ----------------------------------------------------------------------------
+void String::replace(char find, char replacement)
+{
+    for (unsigned int i = 0; i < this->len; i++)
+        if (this->buffer[i] == find)
+            this->buffer[i] = replacement;
+}
+
+//  ----------------------------------------------------------------------------
+void String::replace(const String & find, const String & replacement)
+{
+    if (this->len == 0 || find.len == 0)
+        return;
+
+    String result;
+    unsigned int position = 0;
+    int found;
+
+    while ((found = this->indexOf(find, position)) >= 0)
+    {
+        result.concat(this->buffer + position, found - position);
+        result.concat(replacement);
+        position = found + find.len;
+    }
+
+    result.concat(this->buffer + position, this->len - position);
+    *this = result;
+}
+
+//  ----------------------------------------------------------------------------
+void String::remove(unsigned int index)
+{
+    this->remove(index, (unsigned int) -1);
+}
+
+//  ----------------------------------------------------------------------------
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index >= this->len || count == 0)
+        return;
+
+    if (count > this->len - index)
+        count = this->len - index;
+
+    memmove(this->buffer + index, this->buffer + index + count, this->len - index - count + 1);
+    this->len -= count;
+}
+
+//  ----------------------------------------------------------------------------
+void String::toLowerCase()
+{
+    for (unsigned int i = 0; i < this->len; i++)
+        this->buffer[i] = tolower((unsigned char) this->buffer[i]);
+}
+
+//  ----------------------------------------------------------------------------
+void String::toUpperCase()
+{
+    for (unsigned int i = 0; i < this->len; i++)
+        this->buffer[i] = toupper((unsigned char) this->buffer[i]);
+}
+
+//  ----------------------------------------------------------------------------
+void String::trim()
+{
+    if (this->len == 0)
+        return;
+
+    unsigned int begin = 0;
+    unsigned int end = this->len;
+
+    while (begin < end && isspace((unsigned char) this->buffer[begin]))
+        begin++;
+
+    while (end > begin && isspace((unsigned char) this->buffer[end - 1]))
+        end--;
+
+    this->len = end - begin;
+
+    if (begin > 0)
+        memmove(this->buffer, this->buffer + begin, this->len);
+
+    this->buffer[this->len] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+long String::toInt() const
+{
+    return this->buffer != NULL ? atol(this->buffer) : 0;
+}
+
+//  ----------------------------------------------------------------------------
+float String::toFloat() const
+{
+    return (float) this->toDouble();
+}
+
+//  ----------------------------------------------------------------------------
+double String::toDouble() const
+{
+    return this->buffer != NULL ? atof(this->buffer) : 0.0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PRINT ***
+////////////////////////////////////////////////////////////////////////////////
+
+size_t Print::write(const uint8_t * buffer, size_t size)
+{
+    size_t count = 0;
+
+    while (size-- > 0)
+    {
+        if (this->write(*buffer++) == 0)
+            break;
+
+        count++;
+    }
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+size_t Print::PrintNumber(unsigned long value, uint8_t base)
+{
+    char text[34];
+    FormatNumber(text, value, false, base < 2 ? 10 : base);
+
+    for (char * c = text; *c != '\0'; c++)
+        *c = toupper((unsigned char) *c);
+
+    return this->write(text);
+}
+
+//  ----------------------------------------------------------------------------
+size_t Print::PrintFloat(double value, uint8_t digits)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return this->write(text);
+}
+
+//  ----------------------------------------------------------------------------
+size_t Print::print(const __FlashStringHelper * text)   { return this->write((const char *) text); }
+size_t Print::print(const String & text)                { return this->write((const uint8_t *) text.c_str(), text.length()); }
+size_t Print::print(const char * text)                  { return this->write(text); }
+size_t Print::print(char c)                             { return this->write((uint8_t) c); }
+size_t Print::print(unsigned char value, int base)      { return this->print((unsigned long) value, base); }
+size_t Print::print(int value, int base)                { return this->print((long) value, base); }
+size_t Print::print(unsigned int value, int base)       { return this->print((unsigned long) value, base); }
+size_t Print::print(double value, int digits)           { return this->PrintFloat(value, digits); }
+
+//  ----------------------------------------------------------------------------
+size_t Print::print(long value, int base)
+{
+    if (base == 0)
+        return this->write((uint8_t) value);
+
+    if (base == 10 && value < 0)
+        return this->print('-') + this->PrintNumber(-(unsigned long) value, 10);
+
+    return this->PrintNumber((unsigned long) value, base);
+}
+
+//  ----------------------------------------------------------------------------
+size_t Print::print(unsigned long value, int base)
+{
+    if (base == 0)
+        return this->write((uint8_t) value);
+
+    return this->PrintNumber(value, base);
+}
+
+//  ----------------------------------------------------------------------------
+size_t Print::println()                                 { return this->write("\r\n"); }
+size_t Print::println(const __FlashStringHelper * text) { return this->print(text) + this->println(); }
+size_t Print::println(const String & text)              { return this->print(text) + this->println(); }
+size_t Print::println(const char * text)                { return this->print(text) + this->println(); }
+size_t Print::println(char c)                           { return this->print(c) + this->println(); }
+size_t Print::println(unsigned char value, int base)    { return this->print(value, base) + this->println(); }
+size_t Print::println(int value, int base)              { return this->print(value, base) + this->println(); }
+size_t Print::println(unsigned int value, int base)     { return this->print(value, base) + this->println(); }
+size_t Print::println(long value, int base)             { return this->print(value, base) + this->println(); }
+size_t Print::println(unsigned long value, int base)    { return this->print(value, base) + this->println(); }
+size_t Print::println(double value, int digits)         { return this->print(value, digits) + this->println(); }
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STREAM ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odczyt znaku z oczekiwaniem - czas wirtualny jest przesuwany do nadejscia danych lub
+//  uplywu limitu czasu (jak aktywne oczekiwanie w rdzeniu Arduino).
+int Stream::timedRead()
+{
+    uint64_t deadline = Emulator::Now() + (uint64_t) this->timeout * 1000;
+
+    while (true)
+    {
+        int c = this->read();
+
+        if (c >= 0)
+            return c;
+
+        if (Emulator::Now() >= deadline)
+            return -1;
+
+        Emulator::WaitForInput(deadline);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+size_t Stream::readBytes(char * buffer, size_t length)
+{
+    size_t count = 0;
+
+    while (count < length)
+    {
+        int c = this->timedRead();
+
+        if (c < 0)
+            break;
+
+        buffer[count++] = (char) c;
+    }
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+size_t Stream::readBytesUntil(char terminator, char * buffer, size_t length)
+{
+    size_t count = 0;
+
+    while (count < length)
+    {
+        int c = this->timedRead();
+
+        if (c < 0 || c == terminator)
+            break;
+
+        buffer[count++] = (char) c;
+    }
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+String Stream::readString()
+{
+    String result;
+    int c;
+
+    while ((c = this->timedRead()) >= 0)
+        result += (char) c;
+
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+String Stream::readStringUntil(char terminator)
+{
+    String result;
+    int c;
+
+    while ((c = this->timedRead()) >= 0 && c != terminator)
+        result += (char) c;
+
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** HARDWARE SERIAL ***
+////////////////////////////////////////////////////////////////////////////////
+
+HardwareSerial  Serial(EMULATOR_PORT_PC);
+HardwareSerial  Serial1(EMULATOR_PORT_BT);
+
+HardwareSerial::HardwareSerial(uint8_t index)
+{
+    this->index = index;
+}
+
+//  ----------------------------------------------------------------------------
+void HardwareSerial::begin(unsigned long baudrate, uint8_t /* config */)
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    Emulator::SerialBegin(this->index, baudrate);
+}
+
+//  ----------------------------------------------------------------------------
+void HardwareSerial::end()
+{
+    this->flush();
+    Emulator::SerialEnd(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+int HardwareSerial::available()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return Emulator::SerialAvailable(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+int HardwareSerial::availableForWrite()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return Emulator::SerialAvailableForWrite(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+void HardwareSerial::flush()
+{
+    Emulator::SerialFlush(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+int HardwareSerial::peek()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return Emulator::SerialPeek(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+int HardwareSerial::read()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return Emulator::SerialRead(this->index);
+}
+
+//  ----------------------------------------------------------------------------
+size_t HardwareSerial::write(uint8_t value)
+{
+    Emulator::Charge(EMULATOR_COST_SERIAL_WRITE);
+    Emulator::SerialWrite(this->index, value);
+    return 1;
+}
@@ -0,0 +1,1266 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATOR - VIRTUAL BOARD IMPLEMENTATION
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Biblioteka standardowa przed Arduino.h (makra min, max i abs).
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include <OneWire.h>
+#include "emulator.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define EMULATOR_DEFAULT_TIME           10000       //  Czas symulacji bez skryptu [ms].
+#define EMULATOR_SCRIPT_TAIL            2000        //  Czas po ostatnim zdarzeniu skryptu [ms].
+#define EMULATOR_HANG_LIMIT             60000000ULL //  Przekroczenie czasu wewnatrz loop() [us].
+#define EMULATOR_KEY_HOLD               100         //  Domyslny czas wcisniecia przycisku [ms].
+#define EMULATOR_BT_DEFAULT_BAUDRATE    9600
+#define EMULATOR_AT_RESPONSE_DELAY      20          //  Opoznienie odpowiedzi modulu HC-06 [ms].
+#define EMULATOR_MALLOC_HEADER          2           //  Naglowek bloku alokatora avr-libc.
+#define EMULATOR_LIGHT_DEFAULT          600
+#define EMULATOR_TEMP_POWER_ON_RAW      (85 * 128)  //  Wartosc scratchpad DS18B20 po zasileniu.
+
+#define EVENT_PC            0
+#define EVENT_BT            1
+#define EVENT_KEY_PRESS     2
+#define EVENT_KEY_RELEASE   3
+#define EVENT_LIGHT         4
+#define EVENT_TEMP          5
+#define EVENT_RTC           6
+#define EVENT_FRAME         7
+#define EVENT_EXPECT        8
+#define EVENT_QUIT          9
+#define EVENT_SERIAL_BYTES  10      //  Odpowiedz modulu HC-06 (wewnetrzne).
+
+extern volatile uint8_t port_output[PORTS_COUNT];
+extern volatile uint8_t port_input[PORTS_COUNT];
+extern volatile uint8_t port_mode[PORTS_COUNT];
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Zdarzenie skryptu lub emulowanego urzadzenia.
+struct ScriptEvent
+{
+    uint64_t        time;
+    unsigned long   order;
+    int             type;
+    std::string     text;
+    double          values[2];
+    int             line;
+
+    bool operator < (const ScriptEvent & other) const
+    {
+        return this->time != other.time ? this->time < other.time : this->order < other.order;
+    }
+};
+
+//  ----------------------------------------------------------------------------
+//  Port UART wraz z urzadzeniem po drugiej stronie (konsola PC lub modul HC-06).
+struct SerialPortState
+{
+    unsigned long       baudrate        =   0;
+    unsigned long       remote_baudrate =   0;      //  0 - strona zdalna dopasowuje sie do portu.
+    uint8_t             rx[SERIAL_RX_BUFFER_SIZE];
+    int                 rx_head         =   0;
+    int                 rx_count        =   0;
+    std::deque<uint8_t> incoming;
+    uint64_t            next_arrival    =   0;
+    uint64_t            tx_busy_until   =   0;
+    std::string         line;
+    std::string         at_command;
+};
+
+//  ----------------------------------------------------------------------------
+//  Czujnik DS18B20.
+struct SensorState
+{
+    uint8_t     pin;
+    uint8_t     address[8];
+    double      celsius;
+    int16_t     scratchpad;
+    int16_t     pending;
+    uint64_t    ready_time;
+};
+
+//  ----------------------------------------------------------------------------
+//  Lancuch ukladow MAX7219 (indeks 0 - uklad podlaczony do DIN mikrokontrolera).
+struct DisplayState
+{
+    uint16_t    shift[EMULATOR_DISPLAY_MAX_SEGMENTS];
+    uint8_t     digits[EMULATOR_DISPLAY_MAX_SEGMENTS][8];
+    uint8_t     intensity[EMULATOR_DISPLAY_MAX_SEGMENTS];
+    bool        shutdown[EMULATOR_DISPLAY_MAX_SEGMENTS];
+    bool        clk;
+    bool        cs;
+    unsigned long   bits;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** EMULATOR STATE ***
+////////////////////////////////////////////////////////////////////////////////
+
+static EmulatorBoard            board;
+static EmulatorCounters         counters;
+
+static uint64_t                 now_us              =   0;
+static uint64_t                 end_us              =   0;
+static bool                     finished            =   false;
+static bool                     in_interrupt        =   false;
+static bool                     timer5_pending      =   false;
+static uint64_t                 timer5_next         =   0;
+static bool                     quiet               =   false;
+
+static std::vector<ScriptEvent> events;
+static size_t                   next_event          =   0;
+static unsigned long            event_order         =   0;
+static std::string              expect_log;
+static int                      expect_passed       =   0;
+static int                      expect_failed       =   0;
+
+static SerialPortState          ports[EMULATOR_SERIAL_PORTS];
+static const char             * port_names[EMULATOR_SERIAL_PORTS] = { "pc", "bt" };
+
+static bool                     keys[EMULATOR_KEYPAD_SIZE][EMULATOR_KEYPAD_SIZE];
+static std::map<int, int>       analog_values;
+static std::vector<SensorState> sensors;
+static DisplayState             display;
+
+static int64_t                  rtc_epoch           =   0;      //  Sekundy od 1970 w chwili rtc_base_us.
+static uint64_t                 rtc_base_us         =   0;
+
+static std::string              sd_root;
+static bool                     sd_inserted         =   false;
+
+static std::map<void *, size_t> heap_blocks;
+static size_t                   heap_used           =   0;
+static size_t                   heap_peak           =   0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** HELPERS ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Zapis czasu wirtualnego w sekundach.
+ *  @return: Tekst w buforze statycznym.
+ */
+static const char * FormatTime(uint64_t time)
+{
+    static char text[32];
+    snprintf(text, sizeof(text), "%4llu.%03llu", (unsigned long long) (time / 1000000),
+        (unsigned long long) ((time / 1000) % 1000));
+    return text;
+}
+
+//  ----------------------------------------------------------------------------
+//  Ilosc dni od 1970-01-01 (kalendarz gregorianski).
+static int64_t DaysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t year_of_era = year - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+//  ----------------------------------------------------------------------------
+static void CivilFromDays(int64_t days, int & year, int & month, int & day)
+{
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t day_of_era = days - era * 146097;
+    int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int64_t mp = (5 * day_of_year + 2) / 153;
+
+    day = (int) (day_of_year - (153 * mp + 2) / 5 + 1);
+    month = (int) (mp < 10 ? mp + 3 : mp - 9);
+    year = (int) (year_of_era + era * 400 + (month <= 2));
+}
+
+//  ----------------------------------------------------------------------------
+static int64_t RtcNow()
+{
+    return rtc_epoch + (int64_t) ((now_us - rtc_base_us) / 1000000);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Ustawienie zegara z tekstu "YYYY-MM-DD HH:MM:SS".
+ *  @return: Poprawny format.
+ */
+static bool ParseRtc(const char * text)
+{
+    int year, month, day, hour, minute, second;
+
+    if (sscanf(text, "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6)
+        return false;
+
+    rtc_epoch = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    rtc_base_us = now_us;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+static bool IsPin(int pin)
+{
+    return pin >= 0 && pin < NUM_DIGITAL_PINS;
+}
+
+//  ----------------------------------------------------------------------------
+static bool PinOutput(int pin)
+{
+    return IsPin(pin) && (port_output[digitalPinToPort(pin)] & digitalPinToBitMask(pin)) != 0;
+}
+
+//  ----------------------------------------------------------------------------
+static bool PinIsOutput(int pin)
+{
+    return IsPin(pin) && (port_mode[digitalPinToPort(pin)] & digitalPinToBitMask(pin)) != 0;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis znaku na wyjscie konsoli symulatora.
+static void PrintLine(const char * prefix, const std::string & text)
+{
+    if (!quiet)
+        printf("[%s] %s %s\n", FormatTime(now_us), prefix, text.c_str());
+}
+
+//  ----------------------------------------------------------------------------
+//  Wypisanie obrazu wyswietlacza (wiersz 0 = bit 0 kolumny).
+static void PrintFrame()
+{
+    int columns = board.display_segments * 8;
+
+    printf("[%s] frame (%d x 8)%s\n", FormatTime(now_us), columns,
+        display.shutdown[0] ? " - shutdown" : "");
+
+    for (int row = 0; row < 8; row++)
+    {
+        std::string text;
+
+        for (int column = 0; column < columns; column++)
+        {
+            int segment = board.display_segments - 1 - column / 8;
+            bool lit = (display.digits[segment][column % 8] >> row) & 1;
+            text += lit ? '#' : '.';
+        }
+
+        printf("    %s\n", text.c_str());
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SCRIPT ***
+////////////////////////////////////////////////////////////////////////////////
+
+static void AddEvent(uint64_t time, int type, const std::string & text, double a = 0, double b = 0, int line = 0)
+{
+    ScriptEvent event;
+
+    event.time = time;
+    event.order = event_order++;
+    event.type = type;
+    event.text = text;
+    event.values[0] = a;
+    event.values[1] = b;
+    event.line = line;
+
+    //  Zdarzenia dodawane w trakcie symulacji (odpowiedzi urzadzen) sa wstawiane w kolejnosci.
+    std::vector<ScriptEvent>::iterator position = events.begin() + next_event;
+
+    while (position != events.end() && !(event < *position))
+        ++position;
+
+    events.insert(position, event);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wczytanie skryptu. Wiersz: <czas> <polecenie> [argumenty]. Czas w ms od uruchomienia,
+ *  "+ms" wzgledem poprzedniego wiersza, przyrostek "s" oznacza sekundy.
+ *  @return: Skrypt poprawny.
+ */
+static bool LoadScript(const char * path)
+{
+    FILE * file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    char buffer[1024];
+    uint64_t time = 0;
+    int line_number = 0;
+    bool result = true;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "simulator: cannot open script %s\n", path);
+        return false;
+    }
+
+    while (fgets(buffer, sizeof(buffer), file) != NULL)
+    {
+        line_number++;
+
+        std::string line = buffer;
+        size_t end = line.find_last_not_of("\r\n");
+        line = end == std::string::npos ? "" : line.substr(0, end + 1);
+
+        size_t start = line.find_first_not_of(" \t");
+
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        line = line.substr(start);
+
+        //  Czas zdarzenia.
+        size_t space = line.find_first_of(" \t");
+        std::string time_text = line.substr(0, space);
+        std::string rest = space == std::string::npos ? "" : line.substr(line.find_first_not_of(" \t", space));
+        bool relative = time_text[0] == '+';
+        double value = atof(time_text.c_str() + (relative ? 1 : 0));
+
+        if (time_text[time_text.length() - 1] == 's')
+            value *= 1000.0;
+
+        uint64_t offset = (uint64_t) (value * 1000.0);
+        time = relative ? time + offset : offset;
+
+        //  Polecenie i argumenty.
+        space = rest.find_first_of(" \t");
+        std::string command = rest.substr(0, space);
+        std::string args = space == std::string::npos ? "" : rest.substr(rest.find_first_not_of(" \t", space));
+
+        if (command == "pc")
+            AddEvent(time, EVENT_PC, args + "\n", 0, 0, line_number);
+        else if (command == "bt")
+            AddEvent(time, EVENT_BT, args + "\n", 0, 0, line_number);
+        else if (command == "key" && !args.empty())
+        {
+            double hold = args.length() > 1 ? atof(args.c_str() + 1) : 0;
+            uint64_t hold_us = (uint64_t) ((hold > 0 ? hold : EMULATOR_KEY_HOLD) * 1000.0);
+
+            AddEvent(time, EVENT_KEY_PRESS, args.substr(0, 1), 0, 0, line_number);
+            AddEvent(time + hold_us, EVENT_KEY_RELEASE, args.substr(0, 1), 0, 0, line_number);
+        }
+        else if (command == "light")
+        {
+            double left = 0, right = -1;
+            int count = sscanf(args.c_str(), "%lf %lf", &left, &right);
+            AddEvent(time, EVENT_LIGHT, "", left, count == 2 ? right : left, line_number);
+        }
+        else if (command == "temp")
+        {
+            char which[8];
+            double celsius;
+
+            if (sscanf(args.c_str(), "%7s %lf", which, &celsius) != 2
+                || (strcmp(which, "in") != 0 && strcmp(which, "out") != 0))
+            {
+                fprintf(stderr, "%s:%d: usage: temp <in|out> <celsius>\n", path, line_number);
+                result = false;
+                continue;
+            }
+
+            AddEvent(time, EVENT_TEMP, which, celsius, 0, line_number);
+        }
+        else if (command == "rtc")
+            AddEvent(time, EVENT_RTC, args, 0, 0, line_number);
+        else if (command == "frame")
+            AddEvent(time, EVENT_FRAME, "", 0, 0, line_number);
+        else if (command == "expect")
+            AddEvent(time, EVENT_EXPECT, args, 0, 0, line_number);
+        else if (command == "quit")
+            AddEvent(time, EVENT_QUIT, "", 0, 0, line_number);
+        else
+        {
+            fprintf(stderr, "%s:%d: unknown command \"%s\"\n", path, line_number, command.c_str());
+            result = false;
+        }
+    }
+
+    if (file != stdin)
+        fclose(file);
+
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+static void EnqueueSerial(int port, const std::string & text)
+{
+    SerialPortState & state = ports[port];
+
+    //  Strona zdalna z inna predkoscia - bajty odbierane jako bledy ramki (pomijane).
+    if (state.baudrate == 0 || (state.remote_baudrate != 0 && state.remote_baudrate != state.baudrate))
+    {
+        counters.serial_overflows[port] += text.length();
+        return;
+    }
+
+    if (state.incoming.empty())
+        state.next_arrival = max(state.next_arrival, now_us) + 10000000ULL / state.baudrate;
+
+    for (size_t i = 0; i < text.length(); i++)
+        state.incoming.push_back((uint8_t) text[i]);
+}
+
+//  ----------------------------------------------------------------------------
+static void ExecuteEvent(const ScriptEvent & event)
+{
+    switch (event.type)
+    {
+        case EVENT_PC:
+        case EVENT_BT:
+        {
+            int port = event.type == EVENT_PC ? EMULATOR_PORT_PC : EMULATOR_PORT_BT;
+            std::string text = event.text.substr(0, event.text.length() - 1);
+
+            PrintLine(event.type == EVENT_PC ? "pc>" : "bt>", text);
+            EnqueueSerial(port, event.text);
+            break;
+        }
+
+        case EVENT_SERIAL_BYTES:
+            EnqueueSerial((int) event.values[0], event.text);
+            ports[(int) event.values[0]].remote_baudrate = (unsigned long) event.values[1];
+            break;
+
+        case EVENT_KEY_PRESS:
+        case EVENT_KEY_RELEASE:
+            for (int row = 0; row < EMULATOR_KEYPAD_SIZE; row++)
+                for (int col = 0; col < EMULATOR_KEYPAD_SIZE; col++)
+                    if (toupper(board.keypad_map[row][col]) == toupper(event.text[0]))
+                        keys[row][col] = event.type == EVENT_KEY_PRESS;
+
+            if (event.type == EVENT_KEY_PRESS)
+                PrintLine("key", event.text);
+            break;
+
+        case EVENT_LIGHT:
+            analog_values[board.light_pin_left] = (int) event.values[0];
+            analog_values[board.light_pin_right] = (int) event.values[1];
+            break;
+
+        case EVENT_TEMP:
+        {
+            int pin = event.text == "in" ? board.temperature_pin_in : board.temperature_pin_out;
+
+            for (size_t i = 0; i < sensors.size(); i++)
+                if (sensors[i].pin == pin)
+                    sensors[i].celsius = event.values[0];
+            break;
+        }
+
+        case EVENT_RTC:
+            if (!ParseRtc(event.text.c_str()))
+                fprintf(stderr, "script:%d: rtc expects YYYY-MM-DD HH:MM:SS\n", event.line);
+            break;
+
+        case EVENT_FRAME:
+            PrintFrame();
+            break;
+
+        case EVENT_EXPECT:
+            if (expect_log.find(event.text) != std::string::npos)
+                expect_passed++;
+            else
+            {
+                expect_failed++;
+                fprintf(stderr, "[%s] expect failed (script line %d): \"%s\"\n", FormatTime(now_us),
+                    event.line, event.text.c_str());
+            }
+
+            expect_log.clear();
+            break;
+
+        case EVENT_QUIT:
+            finished = true;
+            break;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+static void ProcessEvents()
+{
+    while (next_event < events.size() && events[next_event].time <= now_us)
+    {
+        ScriptEvent event = events[next_event++];
+        ExecuteEvent(event);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** TIMER5 ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Okres przerwania porownania Timer5 w trybie CTC.
+ *  @return: Okres [us] lub 0 gdy przerwanie jest wylaczone.
+ */
+static uint64_t Timer5Period()
+{
+    static const uint16_t prescalers[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+    uint16_t prescaler = prescalers[TCCR5B & 0x07];
+
+    if (!(TIMSK5 & _BV(OCIE5A)) || prescaler == 0 || TIMER5_COMPA_vect == NULL)
+        return 0;
+
+    return ((uint64_t) OCR5A + 1) * prescaler * 1000000ULL / F_CPU;
+}
+
+//  ----------------------------------------------------------------------------
+static void DispatchInterrupts()
+{
+    if (!timer5_pending || in_interrupt || !(SREG & _BV(SREG_I)))
+        return;
+
+    timer5_pending = false;
+    in_interrupt = true;
+    counters.interrupts++;
+
+    //  Wejscie do przerwania zeruje flage I, reti przywraca ja po zakonczeniu obslugi.
+    now_us += 2;
+    SREG &= ~_BV(SREG_I);
+    TIMER5_COMPA_vect();
+    SREG |= _BV(SREG_I);
+    in_interrupt = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** TIME ***
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Emulator::Now()
+{
+    return now_us;
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::Charge(uint32_t us)
+{
+    AdvanceTo(now_us + us);
+}
+
+//  ----------------------------------------------------------------------------
+//  Przesuniecie czasu wirtualnego z obsluga zdarzen i przerwan w kolejnosci czasowej.
+void Emulator::AdvanceTo(uint64_t time)
+{
+    if (now_us > end_us + EMULATOR_HANG_LIMIT)
+    {
+        fprintf(stderr, "simulator: loop() did not return for %llu s of simulated time\n",
+            (unsigned long long) (EMULATOR_HANG_LIMIT / 1000000));
+        exit(2);
+    }
+
+    do
+    {
+        uint64_t period = Timer5Period();
+        uint64_t step = time;
+
+        if (period == 0)
+            timer5_next = 0;
+        else if (timer5_next == 0)
+            timer5_next = now_us + period;
+
+        if (timer5_next != 0 && timer5_next < step)
+            step = timer5_next;
+
+        if (next_event < events.size() && events[next_event].time < step)
+            step = events[next_event].time;
+
+        if (step > now_us)
+            now_us = step;
+
+        ProcessEvents();
+
+        if (timer5_next != 0 && now_us >= timer5_next)
+        {
+            timer5_next += period;
+            timer5_pending = true;
+        }
+
+        DispatchInterrupts();
+    }
+    while (now_us < time);
+}
+
+//  ----------------------------------------------------------------------------
+//  Uspienie w trybie IDLE - przerwanie Timer0 budzi procesor co 1 ms.
+void Emulator::Sleep()
+{
+    counters.sleeps++;
+    AdvanceTo((now_us / 1000 + 1) * 1000);
+}
+
+//  ----------------------------------------------------------------------------
+//  Oczekiwanie na dane portu szeregowego (Stream::timedRead).
+void Emulator::WaitForInput(uint64_t deadline)
+{
+    uint64_t target = deadline;
+
+    for (int i = 0; i < EMULATOR_SERIAL_PORTS; i++)
+        if (!ports[i].incoming.empty() && ports[i].next_arrival < target)
+            target = ports[i].next_arrival;
+
+    if (next_event < events.size() && events[next_event].time < target)
+        target = events[next_event].time;
+
+    AdvanceTo(max(target, now_us + EMULATOR_COST_CALL));
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::OnInterruptsEnabled()
+{
+    DispatchInterrupts();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** PINS ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Zmiana stanu pinu wyjsciowego - emulacja lancucha MAX7219 (DIN, CLK, LOAD).
+ *  @param pin: Zmieniony pin.
+ */
+void Emulator::OnPinWrite(uint8_t pin)
+{
+    if (pin != board.display_pin_clk && pin != board.display_pin_cs)
+        return;
+
+    bool clk = PinOutput(board.display_pin_clk);
+    bool cs = PinOutput(board.display_pin_cs);
+    int segments = board.display_segments;
+
+    //  Zbocze narastajace CLK - przesuniecie rejestrow (bit 15 przechodzi do kolejnego ukladu).
+    if (clk && !display.clk)
+    {
+        for (int k = segments - 1; k > 0; k--)
+            display.shift[k] = (display.shift[k] << 1) | (display.shift[k - 1] >> 15);
+
+        display.shift[0] = (display.shift[0] << 1) | (PinOutput(board.display_pin_din) ? 1 : 0);
+
+        if (++display.bits % 8 == 0)
+            counters.display_bytes++;
+    }
+
+    //  Zbocze narastajace LOAD - zapis rejestrow wszystkich ukladow.
+    if (cs && !display.cs)
+    {
+        counters.display_latches++;
+
+        for (int k = 0; k < segments; k++)
+        {
+            uint8_t address = (display.shift[k] >> 8) & 0x0F;
+            uint8_t data = display.shift[k] & 0xFF;
+
+            if (address == 0x00)
+                continue;
+
+            counters.display_register_writes++;
+
+            if (address <= 0x08)
+                display.digits[k][address - 1] = data;
+            else if (address == 0x0A)
+                display.intensity[k] = data & 0x0F;
+            else if (address == 0x0C)
+                display.shutdown[k] = (data & 0x01) == 0;
+        }
+    }
+
+    display.clk = clk;
+    display.cs = cs;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyznaczenie rejestrow PINx: wyjscia, rezystory podciagajace i zwarcia matrycy klawiatury.
+void Emulator::UpdateInputs()
+{
+    for (int port = 0; port < PORTS_COUNT; port++)
+        port_input[port] = port_output[port];
+
+    for (int row = 0; row < EMULATOR_KEYPAD_SIZE; row++)
+        for (int col = 0; col < EMULATOR_KEYPAD_SIZE; col++)
+        {
+            if (!keys[row][col])
+                continue;
+
+            int row_pin = board.keypad_pin_rows[row];
+            int col_pin = board.keypad_pin_cols[col];
+            bool row_low = PinIsOutput(row_pin) && !PinOutput(row_pin);
+            bool col_low = PinIsOutput(col_pin) && !PinOutput(col_pin);
+
+            if (col_low && !PinIsOutput(row_pin))
+                port_input[digitalPinToPort(row_pin)] &= ~digitalPinToBitMask(row_pin);
+
+            if (row_low && !PinIsOutput(col_pin))
+                port_input[digitalPinToPort(col_pin)] &= ~digitalPinToBitMask(col_pin);
+        }
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::ReadAnalog(uint8_t pin)
+{
+    std::map<int, int>::iterator value = analog_values.find(pin);
+    return value != analog_values.end() ? constrain(value->second, 0, 1023) : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SERIAL PORTS ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Przeniesienie bajtow, ktore dotarly do portu, do bufora odbiorczego (64 B).
+static void PumpReceiver(uint8_t port)
+{
+    SerialPortState & state = ports[port];
+    uint64_t byte_time = state.baudrate > 0 ? 10000000ULL / state.baudrate : 0;
+
+    while (!state.incoming.empty() && state.next_arrival <= now_us)
+    {
+        uint8_t value = state.incoming.front();
+        state.incoming.pop_front();
+
+        if (state.rx_count < SERIAL_RX_BUFFER_SIZE - 1)
+        {
+            state.rx[(state.rx_head + state.rx_count) % SERIAL_RX_BUFFER_SIZE] = value;
+            state.rx_count++;
+            counters.serial_rx[port]++;
+        }
+        else
+            counters.serial_overflows[port]++;
+
+        state.next_arrival += byte_time;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::SerialBegin(uint8_t port, unsigned long baudrate)
+{
+    SerialPortState & state = ports[port];
+
+    state.baudrate = baudrate;
+    state.rx_head = 0;
+    state.rx_count = 0;
+    state.tx_busy_until = now_us;
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::SerialEnd(uint8_t port)
+{
+    ports[port].baudrate = 0;
+    ports[port].rx_count = 0;
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::SerialAvailable(uint8_t port)
+{
+    PumpReceiver(port);
+    return ports[port].rx_count;
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::SerialAvailableForWrite(uint8_t port)
+{
+    SerialPortState & state = ports[port];
+
+    if (state.baudrate == 0 || state.tx_busy_until <= now_us)
+        return SERIAL_TX_BUFFER_SIZE - 1;
+
+    uint64_t byte_time = 10000000ULL / state.baudrate;
+    uint64_t queued = (state.tx_busy_until - now_us + byte_time - 1) / byte_time;
+    return queued >= SERIAL_TX_BUFFER_SIZE - 1 ? 0 : (int) (SERIAL_TX_BUFFER_SIZE - 1 - queued);
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::SerialPeek(uint8_t port)
+{
+    PumpReceiver(port);
+
+    if (ports[port].rx_count == 0)
+        return -1;
+
+    return ports[port].rx[ports[port].rx_head];
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::SerialRead(uint8_t port)
+{
+    SerialPortState & state = ports[port];
+    int value = SerialPeek(port);
+
+    if (value >= 0)
+    {
+        state.rx_head = (state.rx_head + 1) % SERIAL_RX_BUFFER_SIZE;
+        state.rx_count--;
+    }
+
+    return value;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyslanie bajtu. Przy pelnym buforze nadawczym zapis czeka (jak HardwareSerial::write).
+ *  Modul HC-06 odpowiada na polecenie AT+BAUDn i przechodzi na nowa predkosc.
+ */
+void Emulator::SerialWrite(uint8_t port, uint8_t value)
+{
+    SerialPortState & state = ports[port];
+
+    if (state.baudrate == 0)
+        return;
+
+    while (SerialAvailableForWrite(port) == 0)
+        AdvanceTo(now_us + 10000000ULL / state.baudrate);
+
+    state.tx_busy_until = max(state.tx_busy_until, now_us) + 10000000ULL / state.baudrate;
+    counters.serial_tx[port]++;
+
+    if (state.remote_baudrate != 0 && state.remote_baudrate != state.baudrate)
+        return;
+
+    if (value == '\n')
+    {
+        if (!state.line.empty() && state.line[state.line.length() - 1] == '\r')
+            state.line.erase(state.line.length() - 1);
+
+        PrintLine(port == EMULATOR_PORT_PC ? "pc<" : "bt<", state.line);
+        expect_log += state.line + "\n";
+        state.line.clear();
+    }
+    else
+        state.line += (char) value;
+
+    if (port != EMULATOR_PORT_BT)
+        return;
+
+    state.at_command += (char) value;
+
+    if (state.at_command.length() > 8)
+        state.at_command.erase(0, state.at_command.length() - 8);
+
+    if (state.at_command.length() == 8 && state.at_command.compare(0, 7, "AT+BAUD") == 0
+        && value >= '1' && value <= '8')
+    {
+        static const unsigned long baudrates[8] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+        unsigned long baudrate = baudrates[value - '1'];
+        char response[16];
+
+        snprintf(response, sizeof(response), "OK%lu", baudrate);
+        PrintLine("bt<", state.line);
+        state.line.clear();
+        state.at_command.clear();
+
+        //  Odpowiedz wysylana z dotychczasowa predkoscia, nastepnie zmiana predkosci modulu.
+        AddEvent(now_us + EMULATOR_AT_RESPONSE_DELAY * 1000ULL, EVENT_SERIAL_BYTES, response, port, baudrate);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::SerialFlush(uint8_t port)
+{
+    if (ports[port].baudrate > 0 && ports[port].tx_busy_until > now_us)
+        AdvanceTo(ports[port].tx_busy_until);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** DEVICES ***
+////////////////////////////////////////////////////////////////////////////////
+
+void Emulator::RtcGet(int & year, int & month, int & day, int & hour, int & minute, int & second, int & dow)
+{
+    int64_t time = RtcNow();
+    int64_t days = time >= 0 ? time / 86400 : (time - 86399) / 86400;
+    int64_t seconds = time - days * 86400;
+
+    CivilFromDays(days, year, month, day);
+    hour = (int) (seconds / 3600);
+    minute = (int) ((seconds / 60) % 60);
+    second = (int) (seconds % 60);
+
+    //  1970-01-01 byl czwartkiem (poniedzialek = 1).
+    dow = (int) (((days % 7) + 7 + 3) % 7) + 1;
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::RtcSetDate(int year, int month, int day)
+{
+    int64_t seconds = RtcNow() % 86400;
+
+    rtc_epoch = DaysFromCivil(year, month, day) * 86400 + seconds;
+    rtc_base_us = now_us - (now_us - rtc_base_us) % 1000000;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis rejestrow sekund zeruje licznik podsekundowy ukladu DS3231.
+void Emulator::RtcSetTime(int hour, int minute, int second)
+{
+    int64_t time = RtcNow();
+
+    rtc_epoch = time - time % 86400 + hour * 3600 + minute * 60 + second;
+    rtc_base_us = now_us;
+}
+
+//  ----------------------------------------------------------------------------
+int Emulator::SensorCount(uint8_t pin)
+{
+    int count = 0;
+
+    for (size_t i = 0; i < sensors.size(); i++)
+        if (sensors[i].pin == pin)
+            count++;
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+//  Kolejnosc czujnikow na magistrali odpowiada kolejnosci algorytmu Search ROM (rosnace adresy).
+bool Emulator::SensorAddress(uint8_t pin, uint8_t index, uint8_t * address)
+{
+    for (size_t i = 0; i < sensors.size(); i++)
+        if (sensors[i].pin == pin && index-- == 0)
+        {
+            memcpy(address, sensors[i].address, 8);
+            return true;
+        }
+
+    return false;
+}
+
+//  ----------------------------------------------------------------------------
+/*  Odczyt scratchpad czujnika. Przed zakonczeniem konwersji zwracany jest poprzedni wynik.
+ *  @return: Temperatura w jednostkach 1/128 C lub DEVICE_DISCONNECTED_RAW.
+ */
+int16_t Emulator::SensorRead(uint8_t pin, const uint8_t * address)
+{
+    for (size_t i = 0; i < sensors.size(); i++)
+    {
+        SensorState & sensor = sensors[i];
+
+        if (sensor.pin != pin || memcmp(sensor.address, address, 8) != 0)
+            continue;
+
+        if (sensor.ready_time != 0 && now_us >= sensor.ready_time)
+        {
+            sensor.scratchpad = sensor.pending;
+            sensor.ready_time = 0;
+        }
+
+        return sensor.scratchpad;
+    }
+
+    return DEVICE_DISCONNECTED_RAW;
+}
+
+//  ----------------------------------------------------------------------------
+//  Rozpoczecie konwersji wszystkich czujnikow magistrali (rozdzielczosc 12 bitow).
+void Emulator::SensorConvert(uint8_t pin, uint16_t conversion_ms)
+{
+    for (size_t i = 0; i < sensors.size(); i++)
+    {
+        SensorState & sensor = sensors[i];
+
+        if (sensor.pin != pin)
+            continue;
+
+        long raw = lround(sensor.celsius * 16.0) * 8;
+        sensor.pending = (int16_t) constrain(raw, -55L * 128, 125L * 128);
+        sensor.ready_time = now_us + (uint64_t) conversion_ms * 1000;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::Tone(uint8_t /* pin */, unsigned int frequency, unsigned long duration)
+{
+    if (frequency == 0)
+        return;
+
+    counters.tones++;
+
+    if (!quiet)
+        printf("[%s] tone %u Hz %lu ms\n", FormatTime(now_us), frequency, duration);
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::InfraredSend(uint32_t data, int repeats)
+{
+    counters.ir_frames++;
+
+    if (!quiet)
+        printf("[%s] ir 0x%08lX repeats %d\n", FormatTime(now_us), (unsigned long) data, repeats);
+}
+
+//  ----------------------------------------------------------------------------
+const char * Emulator::SdRoot()
+{
+    return sd_inserted ? sd_root.c_str() : NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** HEAP ***
+////////////////////////////////////////////////////////////////////////////////
+
+/*  Alokacja pamieci z rozliczaniem rozmiaru sterty (naglowek bloku jak w avr-libc).
+ *  @param size: Rozmiar bloku.
+ *  @return: Wskaznik na blok lub NULL.
+ */
+void * Emulator::HeapAllocate(size_t size)
+{
+    return HeapReallocate(NULL, size);
+}
+
+//  ----------------------------------------------------------------------------
+void * Emulator::HeapReallocate(void * pointer, size_t size)
+{
+    if (pointer != NULL)
+    {
+        std::map<void *, size_t>::iterator block = heap_blocks.find(pointer);
+
+        if (block != heap_blocks.end())
+        {
+            heap_used -= block->second;
+            heap_blocks.erase(block);
+        }
+    }
+
+    void * result = realloc(pointer, size);
+
+    if (result == NULL)
+        return NULL;
+
+    heap_blocks[result] = size + EMULATOR_MALLOC_HEADER;
+    heap_used += size + EMULATOR_MALLOC_HEADER;
+    heap_peak = max(heap_peak, heap_used);
+    counters.heap_allocations++;
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+void Emulator::HeapRelease(void * pointer)
+{
+    std::map<void *, size_t>::iterator block = heap_blocks.find(pointer);
+
+    if (block != heap_blocks.end())
+    {
+        heap_used -= block->second;
+        heap_blocks.erase(block);
+    }
+
+    free(pointer);
+}
+
+//  ----------------------------------------------------------------------------
+//  Rozmiar sterty - najwyzszy dotychczasowy poziom (sterta avr-libc nie maleje).
+size_t hostHeapSize()
+{
+    return heap_peak;
+}
+
+//  ----------------------------------------------------------------------------
+size_t hostHeapUsed()
+{
+    return heap_used;
+}
+
+//  ----------------------------------------------------------------------------
+EmulatorCounters & Emulator::Counters()
+{
+    return counters;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SIMULATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Usuniecie zawartosci katalogu karty SD (--sd-clean).
+static void CleanDirectory(const std::string & path)
+{
+    DIR * directory = opendir(path.c_str());
+    struct dirent * entry;
+
+    if (directory == NULL)
+        return;
+
+    while ((entry = readdir(directory)) != NULL)
+    {
+        std::string name = entry->d_name;
+        std::string child = path + "/" + name;
+        struct stat info;
+
+        if (name == "." || name == ".." || stat(child.c_str(), &info) != 0)
+            continue;
+
+        if (S_ISDIR(info.st_mode))
+        {
+            CleanDirectory(child);
+            rmdir(child.c_str());
+        }
+        else
+            unlink(child.c_str());
+    }
+
+    closedir(directory);
+}
+
+//  ----------------------------------------------------------------------------
+static void AddSensor(uint8_t pin, double celsius)
+{
+    SensorState sensor;
+
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.pin = pin;
+    sensor.celsius = celsius;
+    sensor.scratchpad = EMULATOR_TEMP_POWER_ON_RAW;
+    sensor.address[0] = 0x28;
+    sensor.address[1] = 0xFF;
+    sensor.address[2] = pin;
+    sensor.address[3] = (uint8_t) sensors.size();
+    sensor.address[7] = OneWire::crc8(sensor.address, 7);
+    sensors.push_back(sensor);
+}
+
+//  ----------------------------------------------------------------------------
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "usage: simulator [options]\n"
+        "  --script FILE     script of input events and expectations (\"-\" = stdin)\n"
+        "  --sd DIR          directory used as SD card contents (no card when omitted)\n"
+        "  --sd-clean        remove SD directory contents before start\n"
+        "  --time MS         simulated time (default: last script event + 2 s)\n"
+        "  --rtc \"Y-M-D h:m:s\" initial RTC time (default 2024-06-15 12:00:00)\n"
+        "  --frame           print display contents at the end\n"
+        "  --quiet           print summary only\n");
+}
+
+//  ----------------------------------------------------------------------------
+static void PrintSummary()
+{
+    printf("\n[%s] simulation finished\n", FormatTime(now_us));
+    printf("  loops %lu, sleeps %lu, interrupts %lu\n", counters.loops, counters.sleeps, counters.interrupts);
+    printf("  display: latches %lu, register writes %lu, bytes %lu\n",
+        counters.display_latches, counters.display_register_writes, counters.display_bytes);
+    printf("  sd: opens %lu, block reads %lu, block writes %lu, bytes read %lu, bytes written %lu\n",
+        counters.sd_opens, counters.sd_block_reads, counters.sd_block_writes,
+        counters.sd_bytes_read, counters.sd_bytes_written);
+
+    for (int i = 0; i < EMULATOR_SERIAL_PORTS; i++)
+        printf("  serial %s: rx %lu, tx %lu, dropped %lu\n", port_names[i],
+            counters.serial_rx[i], counters.serial_tx[i], counters.serial_overflows[i]);
+
+    printf("  heap: peak %lu B, in use %lu B, allocations %lu\n",
+        (unsigned long) heap_peak, (unsigned long) heap_used, counters.heap_allocations);
+    printf("  tones %lu, ir frames %lu\n", counters.tones, counters.ir_frames);
+
+    if (expect_passed + expect_failed > 0)
+        printf("  expect: %d passed, %d failed\n", expect_passed, expect_failed);
+}
+
+//  ----------------------------------------------------------------------------
+/*  Uruchomienie symulacji: setup(), a nastepnie loop() do uplywu czasu symulacji.
+ *  @param board: Polaczenia plytki.
+ *  @return: Kod wyjscia (0 - poprawnie, 1 - blad skryptu lub niespelnione oczekiwanie).
+ */
+int Emulator::Main(int argc, char ** argv, const EmulatorBoard & board_config)
+{
+    const char * script = NULL;
+    const char * rtc = "2024-06-15 12:00:00";
+    bool clean = false;
+    bool frame = false;
+    long time_ms = -1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (option == "--script" && has_value)
+            script = argv[++i];
+        else if (option == "--sd" && has_value)
+        {
+            sd_root = argv[++i];
+            sd_inserted = true;
+        }
+        else if (option == "--sd-clean")
+            clean = true;
+        else if (option == "--time" && has_value)
+            time_ms = atol(argv[++i]);
+        else if (option == "--rtc" && has_value)
+            rtc = argv[++i];
+        else if (option == "--frame")
+            frame = true;
+        else if (option == "--quiet")
+            quiet = true;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    board = board_config;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (!ParseRtc(rtc))
+    {
+        fprintf(stderr, "simulator: --rtc expects \"YYYY-MM-DD HH:MM:SS\"\n");
+        return 1;
+    }
+
+    if (sd_inserted)
+    {
+        mkdir(sd_root.c_str(), 0755);
+
+        if (clean)
+            CleanDirectory(sd_root);
+    }
+
+    if (script != NULL && !LoadScript(script))
+        return 1;
+
+    if (time_ms < 0)
+        time_ms = events.empty() ? EMULATOR_DEFAULT_TIME : (long) (events.back().time / 1000) + EMULATOR_SCRIPT_TAIL;
+
+    end_us = (uint64_t) time_ms * 1000;
+
+    //  Stan poczatkowy urzadzen zewnetrznych.
+    ports[EMULATOR_PORT_BT].remote_baudrate = EMULATOR_BT_DEFAULT_BAUDRATE;
+    analog_values[board.light_pin_left] = EMULATOR_LIGHT_DEFAULT;
+    analog_values[board.light_pin_right] = EMULATOR_LIGHT_DEFAULT;
+    AddSensor(board.temperature_pin_in, 21.5);
+    AddSensor(board.temperature_pin_out, 5.0);
+
+    setup();
+
+    while (!finished && now_us < end_us)
+    {
+        loop();
+        counters.loops++;
+        Charge(EMULATOR_COST_LOOP);
+    }
+
+    if (frame)
+        PrintFrame();
+
+    PrintSummary();
+    return expect_failed > 0 ? 1 : 0;
+}
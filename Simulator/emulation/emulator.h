@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATOR - VIRTUAL BOARD
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Czas wykonania operacji na ATmega2560 (16MHz) doliczany do czasu wirtualnego [us].
+//  Kod oprogramowania pomiedzy wywolaniami emulatora nie zajmuje czasu, wiec wyniki pomiarow
+//  (micros, /stats, /bench) sa powtarzalne i porownywalne pomiedzy przebiegami.
+#define EMULATOR_COST_CALL              1           //  Minimalny koszt wywolania funkcji rdzenia.
+#define EMULATOR_COST_MICROS            4
+#define EMULATOR_COST_DIGITAL_IO        4           //  digitalWrite, digitalRead, pinMode.
+#define EMULATOR_COST_ANALOG_READ       112         //  13 cykli ADC przy preskalerze 128.
+#define EMULATOR_COST_SERIAL_WRITE      5           //  Zapis do bufora UART.
+#define EMULATOR_COST_SPI_BYTE          1           //  8 taktow SPI przy F_CPU/2.
+#define EMULATOR_COST_SD_BLOCK_READ     700
+#define EMULATOR_COST_SD_BLOCK_WRITE    1500        //  Transfer i oczekiwanie na zapis karty.
+#define EMULATOR_COST_SD_OPEN           1200        //  Przeszukanie wpisow katalogu.
+#define EMULATOR_COST_SD_BYTE           2           //  Kopiowanie przez bufor sektora.
+#define EMULATOR_COST_RTC_READ          900         //  I2C 100kHz - 7 rejestrow.
+#define EMULATOR_COST_RTC_WRITE         600
+#define EMULATOR_COST_ONEWIRE_CONVERT   1100        //  Reset, Skip ROM, Convert T.
+#define EMULATOR_COST_ONEWIRE_READ      10600       //  Reset, Match ROM, odczyt 9 bajtow scratchpad.
+#define EMULATOR_COST_LOOP              5           //  Obsluga main() pomiedzy przebiegami loop().
+
+#define EMULATOR_SERIAL_PORTS           2
+#define EMULATOR_DISPLAY_MAX_SEGMENTS   16
+#define EMULATOR_KEYPAD_SIZE            4
+#define EMULATOR_SENSORS_MAX            4
+
+#define EMULATOR_PORT_PC                0
+#define EMULATOR_PORT_BT                1
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Polaczenia plytki (uzupelniane w simulator.cpp ze stalych profilu Board).
+struct EmulatorBoard
+{
+    int         display_pin_clk;
+    int         display_pin_cs;
+    int         display_pin_din;
+    int         display_segments;
+
+    uint8_t     keypad_pin_cols[EMULATOR_KEYPAD_SIZE];
+    uint8_t     keypad_pin_rows[EMULATOR_KEYPAD_SIZE];
+    char        keypad_map[EMULATOR_KEYPAD_SIZE][EMULATOR_KEYPAD_SIZE];
+
+    int         light_pin_left;
+    int         light_pin_right;
+    int         temperature_pin_in;
+    int         temperature_pin_out;
+    int         buzzer_pin;
+    int         sdcard_pin_cs;
+};
+
+//  ----------------------------------------------------------------------------
+//  Liczniki sprzetowe zbierane przez emulator (niezalezne od licznikow oprogramowania).
+struct EmulatorCounters
+{
+    unsigned long   loops;
+    unsigned long   sleeps;
+    unsigned long   interrupts;
+
+    unsigned long   display_latches;            //  Zbocza narastajace CS (LOAD).
+    unsigned long   display_register_writes;    //  Zapisy rejestrow (bez NO-OP) we wszystkich ukladach.
+    unsigned long   display_bytes;              //  Bajty przeslane linia DIN.
+
+    unsigned long   sd_opens;
+    unsigned long   sd_block_reads;
+    unsigned long   sd_block_writes;
+    unsigned long   sd_bytes_read;
+    unsigned long   sd_bytes_written;
+
+    unsigned long   serial_rx[EMULATOR_SERIAL_PORTS];
+    unsigned long   serial_tx[EMULATOR_SERIAL_PORTS];
+    unsigned long   serial_overflows[EMULATOR_SERIAL_PORTS];
+
+    unsigned long   heap_allocations;
+    unsigned long   tones;
+    unsigned long   ir_frames;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Wirtualna plytka: czas, przerwania, piny, urzadzenia zewnetrzne i skrypt zdarzen.
+//  Wszystkie metody sa statyczne - emulowany jest jeden mikrokontroler.
+class Emulator
+{
+    public:
+        //  Czas i przerwania.
+        static uint64_t     Now();
+        static void         Charge(uint32_t us);
+        static void         AdvanceTo(uint64_t time);
+        static void         Sleep();
+        static void         WaitForInput(uint64_t deadline);
+        static void         OnInterruptsEnabled();
+
+        //  Piny.
+        static void         OnPinWrite(uint8_t pin);
+        static void         UpdateInputs();
+        static int          ReadAnalog(uint8_t pin);
+
+        //  Porty szeregowe.
+        static void         SerialBegin(uint8_t port, unsigned long baudrate);
+        static void         SerialEnd(uint8_t port);
+        static int          SerialAvailable(uint8_t port);
+        static int          SerialAvailableForWrite(uint8_t port);
+        static int          SerialPeek(uint8_t port);
+        static int          SerialRead(uint8_t port);
+        static void         SerialWrite(uint8_t port, uint8_t value);
+        static void         SerialFlush(uint8_t port);
+
+        //  Urzadzenia.
+        static void         RtcGet(int & year, int & month, int & day, int & hour, int & minute, int & second, int & dow);
+        static void         RtcSetDate(int year, int month, int day);
+        static void         RtcSetTime(int hour, int minute, int second);
+        static int          SensorCount(uint8_t pin);
+        static bool         SensorAddress(uint8_t pin, uint8_t index, uint8_t * address);
+        static int16_t      SensorRead(uint8_t pin, const uint8_t * address);
+        static void         SensorConvert(uint8_t pin, uint16_t conversion_ms);
+        static void         Tone(uint8_t pin, unsigned int frequency, unsigned long duration);
+        static void         InfraredSend(uint32_t data, int repeats);
+
+        //  Karta SD (katalog na komputerze lub NULL gdy karta nie jest wlozona).
+        static const char * SdRoot();
+
+        //  Sterta.
+        static void       * HeapAllocate(size_t size);
+        static void       * HeapReallocate(void * pointer, size_t size);
+        static void         HeapRelease(void * pointer);
+
+        //  Liczniki.
+        static EmulatorCounters & Counters();
+
+        //  Uruchomienie symulacji.
+        static int          Main(int argc, char ** argv, const EmulatorBoard & board);
+};
+
+#endif
@@ -0,0 +1,588 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - PERIPHERAL LIBRARIES
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include <DS3231.h>
+#include <IRremote.h>
+#include <MaxMatrix.h>
+#include <OneWire.h>
+#include <SPI.h>
+#include "emulator.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** MAXMATRIX ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odwzorowanie biblioteki MaxMatrix 1.0 - pierwsza para bajtow trafia do najdalszego ukladu.
+MaxMatrix::MaxMatrix(byte data, byte load, byte clock, byte num)
+{
+    this->data = data;
+    this->load = load;
+    this->clock = clock;
+    this->num = num;
+
+    memset(this->buffer, 0, sizeof(this->buffer));
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::init()
+{
+    pinMode(this->data, OUTPUT);
+    pinMode(this->clock, OUTPUT);
+    pinMode(this->load, OUTPUT);
+    digitalWrite(this->clock, HIGH);
+
+    this->setCommand(max7219_reg_scanLimit, 0x07);
+    this->setCommand(max7219_reg_decodeMode, 0x00);
+    this->setCommand(max7219_reg_shutdown, 0x01);
+    this->setCommand(max7219_reg_displayTest, 0x00);
+
+    this->clear();
+    this->setIntensity(0x0f);
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::setIntensity(byte intensity)
+{
+    this->setCommand(max7219_reg_intensity, intensity);
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::clear()
+{
+    for (int i = 0; i < 8; i++)
+        this->setColumnAll(i, 0);
+
+    memset(this->buffer, 0, sizeof(this->buffer));
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::setCommand(byte command, byte value)
+{
+    digitalWrite(this->load, LOW);
+
+    for (int i = 0; i < this->num; i++)
+    {
+        shiftOut(this->data, this->clock, MSBFIRST, command);
+        shiftOut(this->data, this->clock, MSBFIRST, value);
+    }
+
+    digitalWrite(this->load, LOW);
+    digitalWrite(this->load, HIGH);
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::setColumn(byte col, byte value)
+{
+    int n = col / 8;
+    int c = col % 8;
+
+    digitalWrite(this->load, LOW);
+
+    for (int i = 0; i < this->num; i++)
+    {
+        if (i == n)
+        {
+            shiftOut(this->data, this->clock, MSBFIRST, c + 1);
+            shiftOut(this->data, this->clock, MSBFIRST, value);
+        }
+        else
+        {
+            shiftOut(this->data, this->clock, MSBFIRST, 0);
+            shiftOut(this->data, this->clock, MSBFIRST, 0);
+        }
+    }
+
+    digitalWrite(this->load, LOW);
+    digitalWrite(this->load, HIGH);
+
+    if (col < sizeof(this->buffer))
+        this->buffer[col] = value;
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::setColumnAll(byte col, byte value)
+{
+    digitalWrite(this->load, LOW);
+
+    for (int i = 0; i < this->num; i++)
+    {
+        shiftOut(this->data, this->clock, MSBFIRST, col + 1);
+        shiftOut(this->data, this->clock, MSBFIRST, value);
+
+        if (col + i * 8 < (int) sizeof(this->buffer))
+            this->buffer[col + i * 8] = value;
+    }
+
+    digitalWrite(this->load, LOW);
+    digitalWrite(this->load, HIGH);
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::setDot(byte col, byte row, byte value)
+{
+    if (col >= sizeof(this->buffer))
+        return;
+
+    bitWrite(this->buffer[col], row, value);
+
+    int n = col / 8;
+    int c = col % 8;
+
+    digitalWrite(this->load, LOW);
+
+    for (int i = 0; i < this->num; i++)
+    {
+        if (i == n)
+        {
+            shiftOut(this->data, this->clock, MSBFIRST, c + 1);
+            shiftOut(this->data, this->clock, MSBFIRST, this->buffer[col]);
+        }
+        else
+        {
+            shiftOut(this->data, this->clock, MSBFIRST, 0);
+            shiftOut(this->data, this->clock, MSBFIRST, 0);
+        }
+    }
+
+    digitalWrite(this->load, LOW);
+    digitalWrite(this->load, HIGH);
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::writeSprite(int x, int y, const byte * sprite)
+{
+    int w = sprite[0];
+    int h = sprite[1];
+
+    if (h == 8 && y == 0)
+    {
+        for (int i = 0; i < w; i++)
+        {
+            int c = x + i;
+
+            if (c >= 0 && c < 80)
+                this->setColumn(c, sprite[i + 2]);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < w; i++)
+            for (int j = 0; j < h; j++)
+            {
+                int c = x + i;
+
+                if (c >= 0 && c < 80 && y + j < 8)
+                    this->setDot(c, y + j, bitRead(sprite[i + 2], j));
+            }
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::reload()
+{
+    for (int i = 0; i < 8; i++)
+    {
+        int col = i;
+
+        digitalWrite(this->load, LOW);
+
+        for (int j = 0; j < this->num; j++)
+        {
+            shiftOut(this->data, this->clock, MSBFIRST, i + 1);
+            shiftOut(this->data, this->clock, MSBFIRST, this->buffer[col]);
+            col += 8;
+        }
+
+        digitalWrite(this->load, LOW);
+        digitalWrite(this->load, HIGH);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::shiftLeft(bool rotate, bool fill_zero)
+{
+    byte old = this->buffer[0];
+
+    for (int i = 0; i < 79; i++)
+        this->buffer[i] = this->buffer[i + 1];
+
+    this->buffer[79] = rotate ? old : (fill_zero ? 0 : this->buffer[79]);
+    this->reload();
+}
+
+//  ----------------------------------------------------------------------------
+void MaxMatrix::shiftRight(bool rotate, bool fill_zero)
+{
+    int last = this->num * 8 - 1;
+    byte old = this->buffer[last];
+
+    for (int i = 79; i > 0; i--)
+        this->buffer[i] = this->buffer[i - 1];
+
+    this->buffer[0] = rotate ? old : (fill_zero ? 0 : this->buffer[0]);
+    this->reload();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** DS3231 ***
+////////////////////////////////////////////////////////////////////////////////
+
+Time::Time()
+{
+    this->year = 2014;
+    this->mon = 1;
+    this->date = 1;
+    this->hour = 0;
+    this->min = 0;
+    this->sec = 0;
+    this->dow = 3;
+}
+
+//  ----------------------------------------------------------------------------
+DS3231::DS3231(uint8_t /* data_pin */, uint8_t /* sclk_pin */)
+{
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::begin()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+}
+
+//  ----------------------------------------------------------------------------
+Time DS3231::getTime()
+{
+    Time result;
+    int year, month, day, hour, minute, second, dow;
+
+    Emulator::Charge(EMULATOR_COST_RTC_READ);
+    Emulator::RtcGet(year, month, day, hour, minute, second, dow);
+
+    result.year = year;
+    result.mon = month;
+    result.date = day;
+    result.hour = hour;
+    result.min = minute;
+    result.sec = second;
+    result.dow = dow;
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::setTime(uint8_t hour, uint8_t min, uint8_t sec)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+
+    if (hour < 24 && min < 60 && sec < 60)
+        Emulator::RtcSetTime(hour, min, sec);
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::setDate(uint8_t date, uint8_t mon, uint16_t year)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+
+    if (date > 0 && date <= 31 && mon > 0 && mon <= 12 && year >= 2000 && year < 3000)
+        Emulator::RtcSetDate(year, mon, date);
+}
+
+//  ----------------------------------------------------------------------------
+//  Dzien tygodnia jest wyznaczany z daty przy kazdym odczycie.
+void DS3231::setDOW()
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::setDOW(uint8_t /* dow */)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+}
+
+//  ----------------------------------------------------------------------------
+//  Czas uniksowy bez stref czasowych (jak w bibliotece - liczba dni od 1970 roku).
+long DS3231::getUnixTime(Time time)
+{
+    static const uint8_t days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    long days = time.date - 1;
+
+    for (int year = 1970; year < time.year; year++)
+        days += (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 366 : 365;
+
+    for (int month = 1; month < time.mon; month++)
+        days += days_in_month[month - 1] + (month == 2 && time.year % 4 == 0
+            && (time.year % 100 != 0 || time.year % 400 == 0) ? 1 : 0);
+
+    return ((days * 24 + time.hour) * 60 + time.min) * 60L + time.sec;
+}
+
+//  ----------------------------------------------------------------------------
+float DS3231::getTemp()
+{
+    Emulator::Charge(EMULATOR_COST_RTC_READ);
+    return 25.0;
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::enable32KHz(bool /* enable */)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::setOutput(byte /* enable */)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+}
+
+//  ----------------------------------------------------------------------------
+void DS3231::setSQWRate(int /* rate */)
+{
+    Emulator::Charge(EMULATOR_COST_RTC_WRITE);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** ONEWIRE & DALLAS TEMPERATURE ***
+////////////////////////////////////////////////////////////////////////////////
+
+OneWire::OneWire(uint8_t pin)
+{
+    this->pin = pin;
+}
+
+//  ----------------------------------------------------------------------------
+//  Suma kontrolna Dallas/Maxim (wielomian x^8 + x^5 + x^4 + 1).
+uint8_t OneWire::crc8(const uint8_t * address, uint8_t length)
+{
+    uint8_t crc = 0;
+
+    while (length-- > 0)
+    {
+        uint8_t in_byte = *address++;
+
+        for (uint8_t i = 8; i > 0; i--)
+        {
+            uint8_t mix = (crc ^ in_byte) & 0x01;
+            crc >>= 1;
+
+            if (mix)
+                crc ^= 0x8C;
+
+            in_byte >>= 1;
+        }
+    }
+
+    return crc;
+}
+
+//  ----------------------------------------------------------------------------
+DallasTemperature::DallasTemperature()
+{
+    this->bus = NULL;
+}
+
+//  ----------------------------------------------------------------------------
+DallasTemperature::DallasTemperature(OneWire * bus)
+{
+    this->bus = bus;
+}
+
+//  ----------------------------------------------------------------------------
+void DallasTemperature::setOneWire(OneWire * bus)
+{
+    this->bus = bus;
+}
+
+//  ----------------------------------------------------------------------------
+//  Wyszukiwanie urzadzen - reset i przejscie algorytmu Search ROM dla kazdego czujnika.
+void DallasTemperature::begin()
+{
+    if (this->bus != NULL)
+        Emulator::Charge(EMULATOR_COST_ONEWIRE_READ * (Emulator::SensorCount(this->bus->getPin()) + 1));
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t DallasTemperature::getDeviceCount()
+{
+    return this->bus != NULL ? Emulator::SensorCount(this->bus->getPin()) : 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::getAddress(uint8_t * address, uint8_t index)
+{
+    Emulator::Charge(EMULATOR_COST_ONEWIRE_READ);
+    return this->bus != NULL && Emulator::SensorAddress(this->bus->getPin(), index, address);
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::validAddress(const uint8_t * address)
+{
+    return OneWire::crc8(address, 7) == address[7];
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::isConnected(const uint8_t * address)
+{
+    return this->getTemp(address) != DEVICE_DISCONNECTED_RAW;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t DallasTemperature::getResolution()
+{
+    return 12;
+}
+
+//  ----------------------------------------------------------------------------
+void DallasTemperature::setResolution(uint8_t /* resolution */)
+{
+    Emulator::Charge(EMULATOR_COST_ONEWIRE_READ);
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::setResolution(const uint8_t * /* address */, uint8_t /* resolution */, bool /* skip_global_calculation */)
+{
+    Emulator::Charge(EMULATOR_COST_ONEWIRE_READ);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+int16_t DallasTemperature::millisToWaitForConversion(uint8_t resolution)
+{
+    switch (resolution)
+    {
+        case 9:
+            return 94;
+        case 10:
+            return 188;
+        case 11:
+            return 375;
+        default:
+            return 750;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::isConversionComplete()
+{
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+void DallasTemperature::requestTemperatures()
+{
+    Emulator::Charge(EMULATOR_COST_ONEWIRE_CONVERT);
+
+    if (this->bus == NULL)
+        return;
+
+    Emulator::SensorConvert(this->bus->getPin(), this->millisToWaitForConversion(this->getResolution()));
+
+    if (this->wait_for_conversion)
+        delay(this->millisToWaitForConversion(this->getResolution()));
+}
+
+//  ----------------------------------------------------------------------------
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t * /* address */)
+{
+    this->requestTemperatures();
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+int16_t DallasTemperature::getTemp(const uint8_t * address)
+{
+    Emulator::Charge(EMULATOR_COST_ONEWIRE_READ);
+
+    if (this->bus == NULL)
+        return DEVICE_DISCONNECTED_RAW;
+
+    return Emulator::SensorRead(this->bus->getPin(), address);
+}
+
+//  ----------------------------------------------------------------------------
+float DallasTemperature::getTempC(const uint8_t * address)
+{
+    int16_t raw = this->getTemp(address);
+    return raw <= DEVICE_DISCONNECTED_RAW ? DEVICE_DISCONNECTED_C : raw / 128.0f;
+}
+
+//  ----------------------------------------------------------------------------
+float DallasTemperature::getTempCByIndex(uint8_t index)
+{
+    DeviceAddress address;
+
+    if (!this->getAddress(address, index))
+        return DEVICE_DISCONNECTED_C;
+
+    return this->getTempC(address);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** IRREMOTE ***
+////////////////////////////////////////////////////////////////////////////////
+
+IRsend IrSender;
+
+void IRsend::begin(uint8_t pin, bool /* enable_led_feedback */, uint8_t /* feedback_led_pin */)
+{
+    this->pin = pin;
+    pinMode(pin, OUTPUT);
+}
+
+//  ----------------------------------------------------------------------------
+//  Ramka NEC: naglowek 13.5 ms, 32 bity (~54 ms), powtorzenia co 110 ms.
+void IRsend::sendNECRaw(uint32_t data, int_fast8_t repeats)
+{
+    Emulator::InfraredSend(data, repeats);
+    delay(68 + (unsigned long) repeats * 110);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SPI ***
+////////////////////////////////////////////////////////////////////////////////
+
+SPIClass SPI;
+
+void SPIClass::begin()
+{
+    pinMode(SCK, OUTPUT);
+    pinMode(MOSI, OUTPUT);
+    pinMode(SS, OUTPUT);
+}
+
+//  ----------------------------------------------------------------------------
+void SPIClass::end()
+{
+}
+
+//  ----------------------------------------------------------------------------
+void SPIClass::beginTransaction(SPISettings /* settings */)
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+}
+
+//  ----------------------------------------------------------------------------
+void SPIClass::endTransaction()
+{
+    Emulator::Charge(EMULATOR_COST_CALL);
+}
+
+//  ----------------------------------------------------------------------------
+//  Linia MISO bez urzadzenia ma stan wysoki.
+uint8_t SPIClass::transfer(uint8_t /* data */)
+{
+    Emulator::Charge(EMULATOR_COST_SPI_BYTE);
+    return 0xFF;
+}
@@ -0,0 +1,10 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - PLACEMENT NEW
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEW_H
+#define NEW_H
+
+#include <new>
+
+#endif
@@ -0,0 +1,816 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - SD CARD (HOST DIRECTORY)
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <SD.h>
+#include "emulator.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+#define SD_BLOCK_SIZE           512
+#define SD_BLOCK_NONE           0xFFFFFFFFUL
+#define SD_EXTENTS_MAX          16
+#define SD_EXTENT_FIRST_BLOCK   0x00010000UL    //  Obszar danych za tablicami FAT.
+
+#define SD_CLUSTER_BLOCKS       8
+#define SD_CLUSTER_COUNT        1046016UL       //  ~4 GB.
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** STRUCTURES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Obszar pliku ciaglego widoczny przez Sd2Card::readBlock / writeBlock.
+struct SdExtent
+{
+    char        path[SDFILE_PATH_SIZE];
+    uint32_t    first_block;
+    uint32_t    blocks;
+};
+
+//  Bufor sektora wspolny dla wszystkich plikow (SdVolume::cacheBuffer_) - zapis sektora nastepuje
+//  przy przejsciu do innego sektora lub pliku oraz przy sync().
+struct SdVolumeCache
+{
+    char        path[SDFILE_PATH_SIZE];
+    uint32_t    block;
+    bool        dirty;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** VOLUME STATE ***
+////////////////////////////////////////////////////////////////////////////////
+
+static SdExtent         extents[SD_EXTENTS_MAX];
+static int              extent_count    =   0;
+static uint32_t         next_block      =   SD_EXTENT_FIRST_BLOCK;
+static SdVolumeCache    volume_cache    =   { "", SD_BLOCK_NONE, false };
+static bool             card_ready      =   false;
+
+//  Zapis sektora na karte (licznik i czas).
+static void ChargeBlockWrite()
+{
+    Emulator::Counters().sd_block_writes++;
+    Emulator::Charge(EMULATOR_COST_SD_BLOCK_WRITE);
+}
+
+//  ----------------------------------------------------------------------------
+static void ChargeBlockRead()
+{
+    Emulator::Counters().sd_block_reads++;
+    Emulator::Charge(EMULATOR_COST_SD_BLOCK_READ);
+}
+
+//  ----------------------------------------------------------------------------
+static void CacheFlush()
+{
+    if (volume_cache.dirty)
+    {
+        ChargeBlockWrite();
+        volume_cache.dirty = false;
+    }
+}
+
+//  ----------------------------------------------------------------------------
+/*  Dostep do sektora pliku przez bufor wolumenu.
+ *  @param path: Plik na komputerze.
+ *  @param block: Sektor pliku.
+ *  @param write: Modyfikacja sektora.
+ *  @param skip_read: Sektor jest nadpisywany od poczatku za koncem pliku (bez odczytu).
+ */
+static void CacheAccess(const char * path, uint32_t block, bool write, bool skip_read)
+{
+    if (volume_cache.block != block || strcmp(volume_cache.path, path) != 0)
+    {
+        CacheFlush();
+
+        if (!skip_read)
+            ChargeBlockRead();
+
+        strncpy(volume_cache.path, path, SDFILE_PATH_SIZE);
+        volume_cache.path[SDFILE_PATH_SIZE - 1] = '\0';
+        volume_cache.block = block;
+    }
+
+    if (write)
+        volume_cache.dirty = true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Sprawdzenie nazwy 8.3 (jak SdFile::make83Name).
+static bool IsValidName(const char * name)
+{
+    int base = 0;
+    int extension = -1;
+
+    for (const char * c = name; *c != '\0'; c++)
+    {
+        if (*c == '.')
+        {
+            if (extension >= 0 || base == 0)
+                return false;
+
+            extension = 0;
+            continue;
+        }
+
+        if (*c <= ' ' || *c >= 0x7F || strchr("|<>^+=?/[];,*\"\\", *c) != NULL)
+            return false;
+
+        if (extension >= 0)
+            extension++;
+        else
+            base++;
+    }
+
+    return base > 0 && base <= 8 && extension <= 3 && extension != 0;
+}
+
+//  ----------------------------------------------------------------------------
+//  Obszar pliku ciaglego (przydzielany przy pierwszym uzyciu w danym uruchomieniu).
+static SdExtent * FindExtent(const char * path, uint32_t blocks)
+{
+    for (int i = 0; i < extent_count; i++)
+        if (strcmp(extents[i].path, path) == 0)
+            return &extents[i];
+
+    if (extent_count >= SD_EXTENTS_MAX || blocks == 0)
+        return NULL;
+
+    SdExtent * extent = &extents[extent_count++];
+    strncpy(extent->path, path, SDFILE_PATH_SIZE - 1);
+    extent->path[SDFILE_PATH_SIZE - 1] = '\0';
+    extent->first_block = next_block;
+    extent->blocks = blocks;
+
+    //  Odstep pomiedzy obszarami - wyjscie poza plik nie trafia do sasiedniego pliku.
+    next_block += blocks + 64;
+    return extent;
+}
+
+//  ----------------------------------------------------------------------------
+static SdExtent * FindExtentByBlock(uint32_t block)
+{
+    for (int i = 0; i < extent_count; i++)
+        if (block >= extents[i].first_block && block < extents[i].first_block + extents[i].blocks)
+            return &extents[i];
+
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SD2CARD ***
+////////////////////////////////////////////////////////////////////////////////
+
+uint8_t Sd2Card::init(uint8_t /* sck_rate_id */, uint8_t chip_select_pin)
+{
+    struct stat info;
+
+    pinMode(chip_select_pin, OUTPUT);
+    digitalWrite(chip_select_pin, HIGH);
+
+    //  Inicjalizacja karty: 74 takty zegara, CMD0, CMD8, ACMD41 (~100 ms przy 250kHz).
+    delay(100);
+
+    const char * root = Emulator::SdRoot();
+    card_ready = root != NULL && stat(root, &info) == 0 && S_ISDIR(info.st_mode);
+    this->card_type = card_ready ? SD_CARD_TYPE_SDHC : 0;
+    return card_ready;
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t Sd2Card::cardSize()
+{
+    return card_ready ? SD_CLUSTER_COUNT * SD_CLUSTER_BLOCKS + SD_EXTENT_FIRST_BLOCK : 0;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t Sd2Card::errorCode() const
+{
+    return card_ready ? 0 : 1;
+}
+
+//  ----------------------------------------------------------------------------
+//  Odczyt sektora - obszary plikow ciaglych zwracaja zawartosc pliku, pozostale zera.
+uint8_t Sd2Card::readBlock(uint32_t block, uint8_t * destination)
+{
+    if (!card_ready)
+        return false;
+
+    ChargeBlockRead();
+    memset(destination, 0, SD_BLOCK_SIZE);
+
+    SdExtent * extent = FindExtentByBlock(block);
+
+    if (extent == NULL)
+        return true;
+
+    FILE * file = fopen(extent->path, "rb");
+
+    if (file == NULL)
+        return false;
+
+    fseek(file, (long) (block - extent->first_block) * SD_BLOCK_SIZE, SEEK_SET);
+    size_t count = fread(destination, 1, SD_BLOCK_SIZE, file);
+    fclose(file);
+
+    Emulator::Counters().sd_bytes_read += count;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis sektora - dozwolony tylko w obszarach plikow ciaglych (inne sektory naleza do FAT).
+uint8_t Sd2Card::writeBlock(uint32_t block, const uint8_t * source)
+{
+    if (!card_ready)
+        return false;
+
+    SdExtent * extent = FindExtentByBlock(block);
+
+    if (extent == NULL)
+    {
+        fprintf(stderr, "sd: write outside of contiguous files (block %lu) rejected\n", (unsigned long) block);
+        return false;
+    }
+
+    FILE * file = fopen(extent->path, "r+b");
+
+    if (file == NULL)
+        return false;
+
+    ChargeBlockWrite();
+    fseek(file, (long) (block - extent->first_block) * SD_BLOCK_SIZE, SEEK_SET);
+    size_t count = fwrite(source, 1, SD_BLOCK_SIZE, file);
+    fclose(file);
+
+    Emulator::Counters().sd_bytes_written += count;
+    return count == SD_BLOCK_SIZE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SDVOLUME ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Odczyt MBR i sektora rozruchowego partycji.
+uint8_t SdVolume::init(Sd2Card * card)
+{
+    return this->init(card, 1);
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdVolume::init(Sd2Card * card, uint8_t /* partition */)
+{
+    this->card = card;
+
+    if (!card_ready)
+        return false;
+
+    ChargeBlockRead();
+    ChargeBlockRead();
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdVolume::blocksPerCluster() const
+{
+    return SD_CLUSTER_BLOCKS;
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t SdVolume::clusterCount() const
+{
+    return SD_CLUSTER_COUNT;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdVolume::fatType() const
+{
+    return 32;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** SDFILE ***
+////////////////////////////////////////////////////////////////////////////////
+
+SdFile::SdFile()
+{
+    this->handle = NULL;
+    this->type = FAT_FILE_TYPE_CLOSED;
+    this->flags = 0;
+    this->path[0] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+/*  Wyszukanie wpisu katalogu bez rozrozniania wielkosci liter (nazwy FAT).
+ *  @param directory: Otwarty katalog.
+ *  @param name: Nazwa wpisu.
+ *  @param result: Sciezka na komputerze (istniejacego wpisu lub nowego - wielkimi literami).
+ *  @return: Wpis istnieje.
+ */
+bool SdFile::ResolvePath(SdFile * directory, const char * name, char * result)
+{
+    DIR * host_directory = opendir(directory->path);
+    bool found = false;
+
+    Emulator::Counters().sd_opens++;
+    Emulator::Charge(EMULATOR_COST_SD_OPEN);
+    CacheAccess(directory->path, 0, false, false);
+
+    if (host_directory != NULL)
+    {
+        struct dirent * entry;
+
+        while (!found && (entry = readdir(host_directory)) != NULL)
+        {
+            if (strcasecmp(entry->d_name, name) == 0)
+            {
+                //  Sciezka dluzsza niz bufor - plik traktowany jako nieistniejacy.
+                found = snprintf(result, SDFILE_PATH_SIZE, "%s/%s", directory->path, entry->d_name) < SDFILE_PATH_SIZE;
+            }
+        }
+
+        closedir(host_directory);
+    }
+
+    if (!found)
+    {
+        int length = snprintf(result, SDFILE_PATH_SIZE, "%s/", directory->path);
+
+        for (const char * c = name; *c != '\0' && length < SDFILE_PATH_SIZE - 1; c++)
+            result[length++] = toupper((unsigned char) *c);
+
+        result[length] = '\0';
+    }
+
+    return found;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::openRoot(SdVolume * /* volume */)
+{
+    const char * root = Emulator::SdRoot();
+
+    if (this->isOpen() || !card_ready || root == NULL)
+        return false;
+
+    strncpy(this->path, root, SDFILE_PATH_SIZE - 1);
+    this->path[SDFILE_PATH_SIZE - 1] = '\0';
+    this->type = FAT_FILE_TYPE_ROOT;
+    this->flags = O_READ;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::open(SdFile * directory, const char * name, uint8_t flags)
+{
+    char host_path[SDFILE_PATH_SIZE];
+    struct stat info;
+
+    if (this->isOpen() || directory == NULL || !directory->isDir() || !IsValidName(name))
+        return false;
+
+    bool exists = this->ResolvePath(directory, name, host_path);
+
+    if (exists && (flags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+        return false;
+
+    if (!exists && (!(flags & O_CREAT) || !(flags & O_WRITE)))
+        return false;
+
+    if (exists && stat(host_path, &info) == 0 && S_ISDIR(info.st_mode))
+    {
+        if (flags & O_WRITE)
+            return false;
+
+        strcpy(this->path, host_path);
+        this->type = FAT_FILE_TYPE_SUBDIR;
+        this->flags = flags;
+        return true;
+    }
+
+    const char * mode = (flags & O_WRITE) ? (exists ? "r+b" : "w+b") : "rb";
+    this->handle = fopen(host_path, mode);
+
+    if (this->handle == NULL)
+        return false;
+
+    strcpy(this->path, host_path);
+    this->type = FAT_FILE_TYPE_NORMAL;
+    this->flags = flags;
+
+    //  Nowy wpis katalogu lub obciecie pliku wymaga zapisu sektora katalogu.
+    if (!exists || ((flags & O_TRUNC) && (flags & O_WRITE)))
+    {
+        if (exists)
+            this->truncate(0);
+
+        CacheAccess(directory->path, 0, true, false);
+    }
+
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::close()
+{
+    if (!this->isOpen())
+        return false;
+
+    bool result = this->sync();
+
+    if (this->handle != NULL)
+        fclose(this->handle);
+
+    this->handle = NULL;
+    this->type = FAT_FILE_TYPE_CLOSED;
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::makeDir(SdFile * directory, const char * name)
+{
+    char host_path[SDFILE_PATH_SIZE];
+
+    if (this->isOpen() || directory == NULL || !directory->isDir() || !IsValidName(name))
+        return false;
+
+    if (this->ResolvePath(directory, name, host_path) || mkdir(host_path, 0755) != 0)
+        return false;
+
+    //  Wpis w katalogu nadrzednym oraz wyzerowany klaster nowego katalogu.
+    CacheAccess(directory->path, 0, true, false);
+    CacheFlush();
+
+    for (int i = 0; i < SD_CLUSTER_BLOCKS; i++)
+        ChargeBlockWrite();
+
+    strcpy(this->path, host_path);
+    this->type = FAT_FILE_TYPE_SUBDIR;
+    this->flags = O_READ;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+//  Usuniecie pustego katalogu (jak w bibliotece - katalog z plikami nie jest usuwany).
+uint8_t SdFile::rmDir()
+{
+    if (this->type != FAT_FILE_TYPE_SUBDIR)
+        return false;
+
+    bool result = rmdir(this->path) == 0;
+
+    if (result)
+        ChargeBlockWrite();
+
+    this->type = FAT_FILE_TYPE_CLOSED;
+    return result;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::remove()
+{
+    if (this->type != FAT_FILE_TYPE_NORMAL)
+        return false;
+
+    if (this->handle != NULL)
+        fclose(this->handle);
+
+    this->handle = NULL;
+    this->type = FAT_FILE_TYPE_CLOSED;
+
+    //  Zwolnienie lancucha FAT i wpisu katalogu.
+    ChargeBlockWrite();
+    ChargeBlockWrite();
+    return unlink(this->path) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::remove(SdFile * directory, const char * name)
+{
+    SdFile file;
+
+    if (!file.open(directory, name, O_WRITE))
+        return false;
+
+    return file.remove();
+}
+
+//  ----------------------------------------------------------------------------
+//  Utworzenie pliku o ciaglym obszarze sektorow (zawartosc nie jest zerowana na karcie -
+//  w emulacji nowy plik zawiera zera).
+uint8_t SdFile::createContiguous(SdFile * directory, const char * name, uint32_t size)
+{
+    if (size == 0 || !this->open(directory, name, O_READ | O_WRITE | O_CREAT | O_EXCL))
+        return false;
+
+    if (ftruncate(fileno(this->handle), size) != 0)
+    {
+        this->close();
+        return false;
+    }
+
+    //  Alokacja klastrow w tablicy FAT (jeden sektor FAT opisuje 128 klastrow).
+    uint32_t clusters = (size + SD_BLOCK_SIZE * SD_CLUSTER_BLOCKS - 1) / (SD_BLOCK_SIZE * SD_CLUSTER_BLOCKS);
+
+    for (uint32_t i = 0; i < clusters / 128 + 1; i++)
+        ChargeBlockWrite();
+
+    FindExtent(this->path, (size + SD_BLOCK_SIZE - 1) / SD_BLOCK_SIZE);
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::contiguousRange(uint32_t * first_block, uint32_t * last_block)
+{
+    if (this->type != FAT_FILE_TYPE_NORMAL)
+        return false;
+
+    uint32_t blocks = (this->fileSize() + SD_BLOCK_SIZE - 1) / SD_BLOCK_SIZE;
+    SdExtent * extent = FindExtent(this->path, blocks);
+
+    if (extent == NULL)
+        return false;
+
+    //  Plik powiekszony po przydzieleniu obszaru nie jest juz ciagly.
+    if (blocks > extent->blocks)
+        return false;
+
+    *first_block = extent->first_block;
+    *last_block = extent->first_block + extent->blocks - 1;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t SdFile::curPosition() const
+{
+    return this->handle != NULL ? (uint32_t) ftell(this->handle) : 0;
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t SdFile::fileSize() const
+{
+    struct stat info;
+
+    if (this->handle == NULL)
+        return 0;
+
+    fflush(this->handle);
+    return fstat(fileno(this->handle), &info) == 0 ? (uint32_t) info.st_size : 0;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::seekSet(uint32_t position)
+{
+    if (this->handle == NULL || position > this->fileSize())
+        return false;
+
+    Emulator::Charge(EMULATOR_COST_CALL);
+    return fseek(this->handle, position, SEEK_SET) == 0;
+}
+
+//  ----------------------------------------------------------------------------
+int16_t SdFile::read()
+{
+    uint8_t value;
+    return this->read(&value, 1) == 1 ? value : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int16_t SdFile::read(void * buffer, uint16_t size)
+{
+    if (this->handle == NULL || !(this->flags & O_READ))
+        return -1;
+
+    uint32_t position = this->curPosition();
+    size_t count = fread(buffer, 1, size, this->handle);
+
+    for (uint32_t block = position / SD_BLOCK_SIZE; count > 0 && block <= (position + count - 1) / SD_BLOCK_SIZE; block++)
+        CacheAccess(this->path, block, false, false);
+
+    Emulator::Counters().sd_bytes_read += count;
+    Emulator::Charge(EMULATOR_COST_CALL + EMULATOR_COST_SD_BYTE * count);
+    return (int16_t) count;
+}
+
+//  ----------------------------------------------------------------------------
+size_t SdFile::write(uint8_t value)
+{
+    return this->write(&value, 1);
+}
+
+//  ----------------------------------------------------------------------------
+size_t SdFile::write(const void * buffer, uint16_t size)
+{
+    if (this->handle == NULL || !(this->flags & O_WRITE))
+        return 0;
+
+    uint32_t file_size = this->fileSize();
+
+    if ((this->flags & O_APPEND) && this->curPosition() != file_size)
+        fseek(this->handle, 0, SEEK_END);
+
+    uint32_t position = this->curPosition();
+
+    //  Sektor zapisywany od poczatku za koncem pliku nie jest odczytywany z karty.
+    for (uint32_t offset = 0; offset < size; )
+    {
+        uint32_t block = (position + offset) / SD_BLOCK_SIZE;
+        uint32_t block_offset = (position + offset) % SD_BLOCK_SIZE;
+
+        CacheAccess(this->path, block, true, block_offset == 0 && position + offset >= file_size);
+        offset += SD_BLOCK_SIZE - block_offset;
+    }
+
+    size_t count = fwrite(buffer, 1, size, this->handle);
+
+    Emulator::Counters().sd_bytes_written += count;
+    Emulator::Charge(EMULATOR_COST_CALL + EMULATOR_COST_SD_BYTE * count);
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+//  Zapis bufora danych i aktualizacja wpisu katalogu (rozmiar pliku).
+uint8_t SdFile::sync()
+{
+    if (this->type != FAT_FILE_TYPE_NORMAL)
+        return this->isOpen();
+
+    bool data_dirty = volume_cache.dirty && strcmp(volume_cache.path, this->path) == 0;
+
+    if (this->handle != NULL)
+        fflush(this->handle);
+
+    if (!data_dirty || !(this->flags & O_WRITE))
+        return true;
+
+    CacheFlush();
+
+    //  Sektor katalogu z wpisem pliku.
+    ChargeBlockRead();
+    ChargeBlockWrite();
+    volume_cache.block = SD_BLOCK_NONE;
+    return true;
+}
+
+//  ----------------------------------------------------------------------------
+uint8_t SdFile::truncate(uint32_t size)
+{
+    if (this->handle == NULL || !(this->flags & O_WRITE) || size > this->fileSize())
+        return false;
+
+    fflush(this->handle);
+
+    if (ftruncate(fileno(this->handle), size) != 0)
+        return false;
+
+    fseek(this->handle, 0, SEEK_SET);
+    ChargeBlockWrite();
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** FILE ***
+////////////////////////////////////////////////////////////////////////////////
+
+File::File(SdFile file, const char * name)
+{
+    this->file = (SdFile *) Emulator::HeapAllocate(sizeof(SdFile));
+
+    if (this->file != NULL)
+        memcpy((void *) this->file, (const void *) &file, sizeof(SdFile));
+
+    strncpy(this->file_name, name, 12);
+    this->file_name[12] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+File::File()
+{
+    this->file = NULL;
+    this->file_name[0] = '\0';
+}
+
+//  ----------------------------------------------------------------------------
+size_t File::write(uint8_t value)
+{
+    return this->write(&value, 1);
+}
+
+//  ----------------------------------------------------------------------------
+size_t File::write(const uint8_t * buffer, size_t size)
+{
+    if (this->file == NULL)
+        return 0;
+
+    size_t count = this->file->write((const void *) buffer, (uint16_t) size);
+
+    if (this->file->flags & O_SYNC)
+        this->file->sync();
+
+    //  Jak biblioteka SD - blad zapisu jest zapamietywany w obiekcie File.
+    if (count != size)
+        this->setWriteError();
+
+    return count;
+}
+
+//  ----------------------------------------------------------------------------
+int File::availableForWrite()
+{
+    return this->file != NULL ? SD_BLOCK_SIZE - this->file->curPosition() % SD_BLOCK_SIZE : 0;
+}
+
+//  ----------------------------------------------------------------------------
+int File::read()
+{
+    return this->file != NULL ? this->file->read() : -1;
+}
+
+//  ----------------------------------------------------------------------------
+int File::peek()
+{
+    if (this->file == NULL)
+        return -1;
+
+    int c = this->file->read();
+
+    if (c != -1)
+        this->file->seekCur(-1);
+
+    return c;
+}
+
+//  ----------------------------------------------------------------------------
+int File::available()
+{
+    if (this->file == NULL)
+        return 0;
+
+    uint32_t count = this->size() - this->position();
+    return count > 0x7FFF ? 0x7FFF : count;
+}
+
+//  ----------------------------------------------------------------------------
+void File::flush()
+{
+    if (this->file != NULL)
+        this->file->sync();
+}
+
+//  ----------------------------------------------------------------------------
+int File::read(void * buffer, uint16_t size)
+{
+    return this->file != NULL ? this->file->read(buffer, size) : 0;
+}
+
+//  ----------------------------------------------------------------------------
+bool File::seek(uint32_t position)
+{
+    return this->file != NULL && this->file->seekSet(position);
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t File::position()
+{
+    return this->file != NULL ? this->file->curPosition() : 0;
+}
+
+//  ----------------------------------------------------------------------------
+uint32_t File::size()
+{
+    return this->file != NULL ? this->file->fileSize() : 0;
+}
+
+//  ----------------------------------------------------------------------------
+void File::close()
+{
+    if (this->file == NULL)
+        return;
+
+    this->file->close();
+    Emulator::HeapRelease(this->file);
+    this->file = NULL;
+}
+
+//  ----------------------------------------------------------------------------
+File::operator bool()
+{
+    return this->file != NULL && this->file->isOpen();
+}
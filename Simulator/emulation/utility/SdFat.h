@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//  EMULATION - SD LIBRARY LOW LEVEL (SD2CARD, SDVOLUME, SDFILE)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDFAT_H
+#define SDFAT_H
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <Arduino.h>
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CONFIGURATION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Flagi otwarcia jak w bibliotece SD (utility/SdFat.h) - rozne od O_* z fcntl.h.
+#define O_READ                  0x01
+#define O_RDONLY                O_READ
+#define O_WRITE                 0x02
+#define O_WRONLY                O_WRITE
+#define O_RDWR                  (O_READ | O_WRITE)
+#define O_ACCMODE               (O_READ | O_WRITE)
+#define O_APPEND                0x04
+#define O_SYNC                  0x08
+#define O_CREAT                 0x10
+#define O_EXCL                  0x20
+#define O_TRUNC                 0x40
+
+#define SPI_FULL_SPEED          0
+#define SPI_HALF_SPEED          1
+#define SPI_QUARTER_SPEED       2
+
+#define SD_CARD_TYPE_SD1        1
+#define SD_CARD_TYPE_SD2        2
+#define SD_CARD_TYPE_SDHC       3
+
+#define SDFILE_PATH_SIZE        256
+
+#define FAT_FILE_TYPE_CLOSED    0
+#define FAT_FILE_TYPE_NORMAL    1
+#define FAT_FILE_TYPE_ROOT      2
+#define FAT_FILE_TYPE_SUBDIR    3
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** CLASS DEFINITION ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Karta SD - katalog na komputerze (--sd). Bezposredni dostep do sektorow jest mozliwy tylko
+//  w obszarach plikow ciaglych (createContiguous / contiguousRange), ktore emulator
+//  odwzorowuje na zawartosc tych plikow.
+class Sd2Card
+{
+    private:
+        uint8_t     card_type   =   0;
+
+    public:
+        uint8_t     init(uint8_t sck_rate_id = SPI_FULL_SPEED, uint8_t chip_select_pin = SS);
+        uint32_t    cardSize();
+        uint8_t     errorCode() const;
+        uint8_t     type() const        { return this->card_type; }
+
+        uint8_t     readBlock(uint32_t block, uint8_t * destination);
+        uint8_t     writeBlock(uint32_t block, const uint8_t * source);
+};
+
+//  ----------------------------------------------------------------------------
+//  Partycja FAT32 o stalej geometrii (4 GB, 8 sektorow na klaster).
+class SdVolume
+{
+    private:
+        Sd2Card   * card    =   NULL;
+
+    public:
+        uint8_t     init(Sd2Card * card);
+        uint8_t     init(Sd2Card & card)    { return this->init(&card); }
+        uint8_t     init(Sd2Card * card, uint8_t partition);
+
+        uint8_t     blocksPerCluster() const;
+        uint32_t    clusterCount() const;
+        uint8_t     fatType() const;
+};
+
+//  ----------------------------------------------------------------------------
+//  Plik lub katalog. Obiekt jest kopiowany przez wartosc (jak w bibliotece), dlatego nie
+//  zamyka pliku w destruktorze - zamkniecie nastepuje tylko przez close().
+class SdFile : public Print
+{
+    friend class File;
+
+    private:
+        FILE      * handle;
+        uint8_t     type;
+        uint8_t     flags;
+        char        path[SDFILE_PATH_SIZE];
+
+        bool        ResolvePath(SdFile * directory, const char * name, char * result);
+
+    public:
+        SdFile();
+
+        uint8_t     openRoot(SdVolume * volume);
+        uint8_t     open(SdFile * directory, const char * name, uint8_t flags);
+        uint8_t     close();
+        uint8_t     isOpen() const      { return this->type != FAT_FILE_TYPE_CLOSED; }
+        uint8_t     isDir() const       { return this->type >= FAT_FILE_TYPE_ROOT; }
+        uint8_t     isFile() const      { return this->type == FAT_FILE_TYPE_NORMAL; }
+
+        uint8_t     makeDir(SdFile * directory, const char * name);
+        uint8_t     rmDir();
+        uint8_t     remove();
+        static uint8_t  remove(SdFile * directory, const char * name);
+
+        uint8_t     createContiguous(SdFile * directory, const char * name, uint32_t size);
+        uint8_t     contiguousRange(uint32_t * first_block, uint32_t * last_block);
+
+        uint32_t    curPosition() const;
+        uint32_t    fileSize() const;
+        uint8_t     seekCur(int32_t offset)     { return this->seekSet(this->curPosition() + offset); }
+        uint8_t     seekEnd()                   { return this->seekSet(this->fileSize()); }
+        uint8_t     seekSet(uint32_t position);
+        void        rewind()                    { this->seekSet(0); }
+
+        int16_t     read();
+        int16_t     read(void * buffer, uint16_t size);
+        virtual size_t  write(uint8_t value);
+        size_t      write(const void * buffer, uint16_t size);
+        uint8_t     sync();
+        uint8_t     truncate(uint32_t size);
+        using Print::write;
+};
+
+#endif
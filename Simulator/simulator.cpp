@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////////////////////////
+//  ARDUINO CLOCK 3.0 - HOST SIMULATOR
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** INCLUDED LIBRARIES ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Oprogramowanie jest kompilowane bez zmian jako jedna jednostka, tak jak przez Arduino IDE.
+#include "emulator.h"
+#include "../ArduinoClockOS/ArduinoClockOS.ino"
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  *** MAIN ***
+////////////////////////////////////////////////////////////////////////////////
+
+//  Polaczenia wirtualnej plytki pobierane z wybranego profilu (BOARD_VARIANT).
+//  Piny sa odczytywane przez makra kontrolerow, ktore rozwijaja sie do stalych Board::.
+int main(int argc, char ** argv)
+{
+    EmulatorBoard board;
+
+    board.display_pin_clk = DISPLAY_PIN_CLK;
+    board.display_pin_cs = DISPLAY_PIN_CS;
+    board.display_pin_din = DISPLAY_PIN_DIN;
+    board.display_segments = Board::DISPLAY_SEGMENTS;
+
+    for (int i = 0; i < EMULATOR_KEYPAD_SIZE; i++)
+    {
+        board.keypad_pin_cols[i] = Board::KEYPAD_PIN_COLS[i];
+        board.keypad_pin_rows[i] = Board::KEYPAD_PIN_ROWS[i];
+
+        for (int j = 0; j < EMULATOR_KEYPAD_SIZE; j++)
+            board.keypad_map[i][j] = KEYPAD_MAP[i][j];
+    }
+
+    board.light_pin_left = LIGHT_SENSOR_PIN_L;
+    board.light_pin_right = LIGHT_SENSOR_PIN_R;
+    board.temperature_pin_in = TEMPERATURE_SENSOR_PIN_IN;
+    board.temperature_pin_out = TEMPERATURE_SENSOR_PIN_OUT;
+    board.buzzer_pin = BUZZER_PIN_OUT;
+    board.sdcard_pin_cs = SDCARD_PIN_CS;
+
+    return Emulator::Main(argc, argv, board);
+}